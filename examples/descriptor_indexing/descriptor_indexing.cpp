@@ -139,7 +139,7 @@ public:
 
         gfx::GraphicsPipeline::Descriptor pipelineDesc = {
             .vertexLayout = gfx::VertexLayout{
-                .stride = sizeof(Vertex),
+                .buffers = { gfx::VertexBufferLayout{ .stride = sizeof(Vertex) } },
                 .attributes = {
                     gfx::VertexAttribute{ .format = gfx::VertexAttributeFormat::float2, .offset = offsetof(Vertex, pos) },
                 }
@@ -271,7 +271,6 @@ public:
                     .presentMode = gfx::PresentMode::fifo,
                 });
                 assert(m_swapchain);
-                m_device->waitIdle();
             }
 
             if (m_lastCommandBuffers.at(m_frameIdx) != nullptr) {
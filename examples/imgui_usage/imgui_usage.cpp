@@ -178,7 +178,6 @@ public:
                 };
                 m_swapchain = m_device->newSwapchain(swapchainDescriptor);
                 assert(m_swapchain);
-                m_device->waitIdle();
             }
 
             if (m_lastCommandBuffers.at(m_frameIdx) != nullptr) {
@@ -191,7 +191,7 @@ public:
 
         gfx::GraphicsPipeline::Descriptor gfxPipelineDescriptor = {
             .vertexLayout = gfx::VertexLayout{
-                .stride = sizeof(Vertex),
+                .buffers = { gfx::VertexBufferLayout{ .stride = sizeof(Vertex) } },
                 .attributes = {
                     gfx::VertexAttribute{
                         .format = gfx::VertexAttributeFormat::float3,
@@ -382,7 +382,6 @@ public:
                 };
                 for (auto i = 0; i < maxFrameInFlight; i++)
                     m_depthTexture.at(i) = m_device->newTexture(depthTextureDescriptor);
-                m_device->waitIdle();
             }
 
             if (m_lastCommandBuffers.at(m_frameIdx) != nullptr) {
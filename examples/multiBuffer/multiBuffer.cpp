@@ -129,7 +129,7 @@ public:
 
         gfx::GraphicsPipeline::Descriptor gfxPipelineDescriptor = {
             .vertexLayout = gfx::VertexLayout{
-                .stride = sizeof(float) * 6,
+                .buffers = { gfx::VertexBufferLayout{ .stride = sizeof(float) * 6 } },
                 .attributes = {
                     gfx::VertexAttribute{
                         .format = gfx::VertexAttributeFormat::float2,
@@ -199,7 +199,6 @@ public:
                 };
                 m_swapchain = m_device->newSwapchain(swapchainDescriptor);
                 assert(m_swapchain);
-                m_device->waitIdle();
             }
 
             if (m_lastCommandBuffers.at(m_frameIdx) != nullptr) {
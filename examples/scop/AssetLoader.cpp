@@ -329,6 +329,7 @@ constexpr unsigned int POST_PROCESSING_FLAGS = aiProcess_CalcTangentSpace      |
                                                aiProcess_Triangulate           |
                                                aiProcess_GenNormals            |
                                                aiProcess_OptimizeMeshes        |
+                                               aiProcess_GenBoundingBoxes      |
                                                aiProcess_FlipUVs;
 
 namespace
@@ -349,11 +350,17 @@ AssetLoader::AssetLoader(gfx::Device* device)
     : m_device(device)
 {
     assert(m_device);
+
+    // textures larger than a block (4k and more) get their own staging buffer, released once uploaded
+    m_stagingRing = m_device->newUploadRing(gfx::UploadRing::Descriptor{
+        .blockSize = static_cast<size_t>(16 * 1024 * 1024),
+        .usages = gfx::BufferUsage::copySource});
+    assert(m_stagingRing);
 }
 
 Mesh AssetLoader::builtinCube(const std::shared_ptr<Material>& material)
 {
-    std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = m_device->newCommandBufferPool();
+    std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = m_device->newCommandBufferPool(gfx::QueueType::transfer);
     assert(commandBufferPool);
 
     std::shared_ptr<gfx::CommandBuffer> commandBuffer = commandBufferPool->get();
@@ -368,6 +375,8 @@ Mesh AssetLoader::builtinCube(const std::shared_ptr<Material>& material)
                 .transform = glm::mat4x4(1),
                 .vertexBuffer = newVertexBuffer(cube_vertices, *commandBuffer),
                 .indexBuffer = newIndexBuffer(cube_indices, *commandBuffer),
+                .bBoxMin = {-0.5, -0.5, -0.5},
+                .bBoxMax = { 0.5,  0.5,  0.5},
                 .material = material ? material : std::make_shared<FlatColorMaterial>(*m_device),
             }
         }
@@ -389,7 +398,7 @@ Mesh AssetLoader::loadMesh(const std::filesystem::path& path, std::optional<std:
     if (scene == nullptr)
         throw std::runtime_error("fail to load the model using assimp");
 
-    std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = m_device->newCommandBufferPool();
+    std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = m_device->newCommandBufferPool(gfx::QueueType::transfer);
     assert(commandBufferPool);
 
     std::shared_ptr<gfx::CommandBuffer> commandBuffer = commandBufferPool->get();
@@ -488,6 +497,8 @@ Mesh AssetLoader::loadMesh(const std::filesystem::path& path, std::optional<std:
             .indexBuffer = newIndexBuffer(std::views::iota(0u, aiMesh->mNumFaces * 3) | std::views::transform([aiMesh](uint32_t i) -> uint32_t{
                 return aiMesh->mFaces[i / 3].mIndices[i % 3];
             }), *commandBuffer),
+            .bBoxMin = glm::vec3(aiMesh->mAABB.mMin.x, aiMesh->mAABB.mMin.y, aiMesh->mAABB.mMin.z),
+            .bBoxMax = glm::vec3(aiMesh->mAABB.mMax.x, aiMesh->mAABB.mMax.y, aiMesh->mAABB.mMax.z),
             .material = materials[aiMesh->mMaterialIndex],
             .subMeshes = {}
         };
@@ -577,7 +588,7 @@ Mesh AssetLoader::loadMesh(const std::filesystem::path& path, std::optional<std:
     for (auto& pos : positions)
         pos -= center;
 
-    std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = m_device->newCommandBufferPool();
+    std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = m_device->newCommandBufferPool(gfx::QueueType::transfer);
     assert(commandBufferPool);
 
     std::shared_ptr<gfx::CommandBuffer> commandBuffer = commandBufferPool->get();
@@ -610,6 +621,8 @@ Mesh AssetLoader::loadMesh(const std::filesystem::path& path, std::optional<std:
                     })
                     | std::ranges::to<std::vector>(), *commandBuffer),
                 .indexBuffer = newIndexBuffer(indices, *commandBuffer),
+                .bBoxMin = bBoxMin,
+                .bBoxMax = bBoxMax,
                 .material = material,
             }
         }
@@ -661,16 +674,11 @@ std::shared_ptr<gfx::Texture> AssetLoader::loadEmbeddedTexture(const aiTexture*
     });
     assert(texture);
 
-    std::shared_ptr<gfx::Buffer> stagingBuffer = m_device->newBuffer(gfx::Buffer::Descriptor{
-        .size = static_cast<size_t>(width) * static_cast<size_t>(height) * pixelFormatSize(gfx::PixelFormat::RGBA8Unorm),
-        .usages = gfx::BufferUsage::copySource,
-        .storageMode = gfx::ResourceStorageMode::hostVisible
-    });
-    assert(stagingBuffer);
+    gfx::BufferSlice stagingSlice = newStagingSlice(static_cast<size_t>(width) * static_cast<size_t>(height) * pixelFormatSize(gfx::PixelFormat::RGBA8Unorm));
 
-    std::memcpy(stagingBuffer->content<stbi_uc>(), bytes.get(), stagingBuffer->size());
+    std::memcpy(stagingSlice.content<stbi_uc>(), bytes.get(), stagingSlice.size);
 
-    commandBuffer.copyBufferToTexture(stagingBuffer, texture);
+    commandBuffer.copyBufferToTexture(stagingSlice, texture);
 
     return texture;
 }
@@ -696,16 +704,11 @@ std::shared_ptr<gfx::Texture> AssetLoader::loadTexture(const std::filesystem::pa
     });
     assert(texture);
 
-    std::shared_ptr<gfx::Buffer> stagingBuffer = m_device->newBuffer(gfx::Buffer::Descriptor{
-        .size = static_cast<size_t>(width) * static_cast<size_t>(height) * pixelFormatSize(gfx::PixelFormat::RGBA8Unorm),
-        .usages = gfx::BufferUsage::copySource,
-        .storageMode = gfx::ResourceStorageMode::hostVisible
-    });
-    assert(stagingBuffer);
+    gfx::BufferSlice stagingSlice = newStagingSlice(static_cast<size_t>(width) * static_cast<size_t>(height) * pixelFormatSize(gfx::PixelFormat::RGBA8Unorm));
 
-    std::memcpy(stagingBuffer->content<stbi_uc>(), bytes.get(), stagingBuffer->size());
+    std::memcpy(stagingSlice.content<stbi_uc>(), bytes.get(), stagingSlice.size);
 
-    commandBuffer.copyBufferToTexture(stagingBuffer, texture);
+    commandBuffer.copyBufferToTexture(stagingSlice, texture);
 
     return texture;
 }
@@ -746,14 +749,9 @@ std::shared_ptr<gfx::Texture> AssetLoader::loadCubeTexture(const std::filesystem
     assert(texture);
 
     size_t faceSize = static_cast<size_t>(width) * static_cast<size_t>(height) * pixelFormatSize(gfx::PixelFormat::RGBA8Unorm);
-    std::shared_ptr<gfx::Buffer> stagingBuffer = m_device->newBuffer(gfx::Buffer::Descriptor{
-        .size = faceSize * 6, // 6 faces
-        .usages = gfx::BufferUsage::copySource,
-        .storageMode = gfx::ResourceStorageMode::hostVisible
-    });
-    assert(stagingBuffer);
+    gfx::BufferSlice stagingSlice = newStagingSlice(faceSize * 6); // 6 faces
 
-    auto* bufferData = stagingBuffer->content<stbi_uc>();
+    auto* bufferData = stagingSlice.content<stbi_uc>();
     std::memcpy(bufferData + 0 * faceSize, bytes.at(right).get(), faceSize);  // +X (right)
     std::memcpy(bufferData + 1 * faceSize, bytes.at(left).get(), faceSize);   // -X (left)
     std::memcpy(bufferData + 2 * faceSize, bytes.at(top).get(), faceSize);    // +Y (top)
@@ -762,7 +760,7 @@ std::shared_ptr<gfx::Texture> AssetLoader::loadCubeTexture(const std::filesystem
     std::memcpy(bufferData + 5 * faceSize, bytes.at(back).get(), faceSize);   // -Z (back)
 
     for (int face = 0; face < 6; ++face)
-        commandBuffer.copyBufferToTexture(stagingBuffer, face * faceSize, texture, face);
+        commandBuffer.copyBufferToTexture(stagingSlice.buffer, stagingSlice.offset + face * faceSize, texture, face);
 
     return texture;
 }
@@ -786,24 +784,25 @@ std::shared_ptr<gfx::Texture> AssetLoader::getSolidColorTexture(const glm::vec4&
     });
     assert(texture);
 
-    std::shared_ptr<gfx::Buffer> stagingBuffer = m_device->newBuffer(gfx::Buffer::Descriptor{
-        .size = 4, // 1 pixel * 4 bytes (RGBA)
-        .usages = gfx::BufferUsage::copySource,
-        .storageMode = gfx::ResourceStorageMode::hostVisible
-    });
-    assert(stagingBuffer);
+    gfx::BufferSlice stagingSlice = newStagingSlice(4); // 1 pixel * 4 bytes (RGBA)
 
-    auto* pixelData = stagingBuffer->content<uint8_t>();
+    auto* pixelData = stagingSlice.content<uint8_t>();
     pixelData[0] = static_cast<uint8_t>(color.x * 255.0f);
     pixelData[1] = static_cast<uint8_t>(color.y * 255.0f);
     pixelData[2] = static_cast<uint8_t>(color.z * 255.0f);
     pixelData[3] = static_cast<uint8_t>(color.w * 255.0f);
 
-    commandBuffer.copyBufferToTexture(stagingBuffer, texture);
+    commandBuffer.copyBufferToTexture(stagingSlice, texture);
 
     m_solidColorTextureCache.emplace_back(color, texture);
 
     return texture;
 }
 
+gfx::BufferSlice AssetLoader::newStagingSlice(size_t size)
+{
+    std::scoped_lock lock(m_stagingRingMtx);
+    return m_stagingRing->allocate(size);
+}
+
 }
@@ -17,6 +17,7 @@
 #include <Graphics/CommandBuffer.hpp>
 #include <Graphics/Texture.hpp>
 #include <Graphics/Buffer.hpp>
+#include <Graphics/UploadRing.hpp>
 
 #if !defined (SCOP_MANDATORY)
     #include <glm/glm.hpp>
@@ -63,6 +64,9 @@ public:
 private:
     std::shared_ptr<gfx::Texture> loadEmbeddedTexture(const aiTexture*, gfx::CommandBuffer&);
 
+    // meshes are loaded from multiple threads, the ring is shared
+    gfx::BufferSlice newStagingSlice(size_t size);
+
     std::shared_ptr<gfx::Buffer> newVertexBuffer(const std::ranges::range auto& vertices, gfx::CommandBuffer& commandBuffer)
         requires std::same_as<std::ranges::range_value_t<decltype(vertices)>, Vertex>
     {
@@ -72,15 +76,11 @@ private:
             .storageMode = gfx::ResourceStorageMode::deviceLocal});
         assert(vertexBuffer);
 
-        std::shared_ptr<gfx::Buffer> stagingBuffer = m_device->newBuffer(gfx::Buffer::Descriptor{
-            .size = vertexBuffer->size(),
-            .usages = gfx::BufferUsage::copySource,
-            .storageMode = gfx::ResourceStorageMode::hostVisible});
-        assert(stagingBuffer);
+        gfx::BufferSlice stagingSlice = newStagingSlice(vertexBuffer->size());
 
-        std::ranges::copy(vertices, stagingBuffer->content<Vertex>());
+        std::ranges::copy(vertices, stagingSlice.content<Vertex>());
 
-        commandBuffer.copyBufferToBuffer(stagingBuffer, vertexBuffer, vertexBuffer->size());
+        commandBuffer.copyBufferToBuffer(stagingSlice, vertexBuffer);
 
         return vertexBuffer;
     }
@@ -94,20 +94,18 @@ private:
             .storageMode = gfx::ResourceStorageMode::deviceLocal});
         assert(indexBuffer);
 
-        std::shared_ptr<gfx::Buffer> stagingBuffer = m_device->newBuffer(gfx::Buffer::Descriptor{
-            .size = indexBuffer->size(),
-            .usages = gfx::BufferUsage::copySource,
-            .storageMode = gfx::ResourceStorageMode::hostVisible});
-        assert(stagingBuffer);
+        gfx::BufferSlice stagingSlice = newStagingSlice(indexBuffer->size());
 
-        std::ranges::copy(indices, stagingBuffer->content<uint32_t>());
+        std::ranges::copy(indices, stagingSlice.content<uint32_t>());
 
-        commandBuffer.copyBufferToBuffer(stagingBuffer, indexBuffer, indexBuffer->size());
+        commandBuffer.copyBufferToBuffer(stagingSlice, indexBuffer);
 
         return indexBuffer;
     }
 
     gfx::Device* m_device;
+    std::unique_ptr<gfx::UploadRing> m_stagingRing;
+    std::mutex m_stagingRingMtx;
     std::vector<std::pair<glm::vec4, std::shared_ptr<gfx::Texture>>> m_solidColorTextureCache;
     std::mutex m_solidColorTextureCacheMtx;
 
@@ -40,47 +40,38 @@ namespace scop
 
 FlatColorMaterial::FlatColorMaterial(const gfx::Device& device)
 {
-    auto pbLayout = s_parameterBlockLayout.lock();
-    if (!pbLayout) {
-        pbLayout = device.newParameterBlockLayout(gfx::ParameterBlockLayout::Descriptor{
-            .bindings = {
-                gfx::ParameterBlockBinding{ .type = gfx::BindingType::constantBuffer, .usages = gfx::BindingUsage::fragmentRead },
+    // the vulkan objects of the layout are shared by all the materials of the same type
+    m_parameterBlockLayout = device.newParameterBlockLayout(gfx::ParameterBlockLayout::Descriptor{
+        .bindings = {
+            gfx::ParameterBlockBinding{ .type = gfx::BindingType::constantBuffer, .usages = gfx::BindingUsage::fragmentRead },
+        }
+    });
+    assert(m_parameterBlockLayout);
+
+    std::shared_ptr<gfx::ShaderLib> shaderLib = Renderer::flatColorShaderLib(); // loaded once by the renderer
+    assert(shaderLib);
+    gfx::GraphicsPipeline::Descriptor gfxPipelineDescriptor = {
+        .vertexLayout = Renderer::withInstanceStream(gfx::VertexLayout{
+            .buffers = { gfx::VertexBufferLayout{ .stride = sizeof(Vertex) } },
+            .attributes = {
+                gfx::VertexAttribute{
+                    .format = gfx::VertexAttributeFormat::float3,
+                    .offset = offsetof(Vertex, pos)},
+                gfx::VertexAttribute{
+                    .format = gfx::VertexAttributeFormat::float3,
+                    .offset = offsetof(Vertex, normal)},
             }
-        });
-        assert(pbLayout);
-        s_parameterBlockLayout = pbLayout;
-    }
-    m_parameterBlockLayout = pbLayout;
-
-    auto pipeline = s_graphicsPipeline.lock();
-    if (!pipeline) {
-        std::unique_ptr<gfx::ShaderLib> shaderLib = device.newShaderLib(SHADER_DIR "/flat_color.slib");
-        assert(shaderLib);
-        gfx::GraphicsPipeline::Descriptor gfxPipelineDescriptor = {
-            .vertexLayout = gfx::VertexLayout{
-                .stride = sizeof(Vertex),
-                .attributes = {
-                    gfx::VertexAttribute{
-                        .format = gfx::VertexAttributeFormat::float3,
-                        .offset = offsetof(Vertex, pos)},
-                    gfx::VertexAttribute{
-                        .format = gfx::VertexAttributeFormat::float3,
-                        .offset = offsetof(Vertex, normal)},
-                }
-            },
-            .vertexShader = &shaderLib->getFunction("vertexMain"),
-            .fragmentShader = &shaderLib->getFunction("fragmentMain"),
-            .colorAttachmentPxFormats = {gfx::PixelFormat::BGRA8Unorm},
-            .depthAttachmentPxFormat = gfx::PixelFormat::Depth32Float,
-            .blendOperation = gfx::BlendOperation::blendingOff,
-            .cullMode = gfx::CullMode::back,
-            .parameterBlockLayouts = { Renderer::vpMatrixBpLayout(), Renderer::sceneDataBpLayout(), m_parameterBlockLayout }
-        };
-        pipeline = device.newGraphicsPipeline(gfxPipelineDescriptor);
-        assert(pipeline);
-        s_graphicsPipeline = pipeline;
-    }
-    m_graphicsPipeline = pipeline;
+        }),
+        .vertexShader = &shaderLib->getFunction("vertexMain"),
+        .fragmentShader = &shaderLib->getFunction("fragmentMain"),
+        .colorAttachmentPxFormats = {gfx::PixelFormat::BGRA8Unorm},
+        .depthAttachmentPxFormat = gfx::PixelFormat::Depth32Float,
+        .blendOperation = gfx::BlendOperation::blendingOff,
+        .cullMode = gfx::CullMode::back,
+        .parameterBlockLayouts = { Renderer::vpMatrixBpLayout(), Renderer::sceneDataBpLayout(), m_parameterBlockLayout }
+    };
+    m_graphicsPipeline = device.sharedGraphicsPipeline(gfxPipelineDescriptor); // compiled only if no material of the type is alive
+    assert(m_graphicsPipeline);
 
     m_materialData = device.newBuffer(gfx::Buffer::Descriptor{
         .size = sizeof(shader::flat_color::MaterialData),
@@ -101,56 +92,47 @@ void FlatColorMaterial::makeParameterBlock(gfx::ParameterBlockPool& pool)
 
 TexturedMaterial::TexturedMaterial(const gfx::Device& device)
 {
-    auto pbLayout = s_parameterBlockLayout.lock();
-    if (!pbLayout) {
-        pbLayout = device.newParameterBlockLayout(gfx::ParameterBlockLayout::Descriptor{
-            .bindings = {
-                gfx::ParameterBlockBinding{ .type = gfx::BindingType::sampler,        .usages = gfx::BindingUsage::fragmentRead },
-                gfx::ParameterBlockBinding{ .type = gfx::BindingType::sampledTexture, .usages = gfx::BindingUsage::fragmentRead },
-                gfx::ParameterBlockBinding{ .type = gfx::BindingType::sampledTexture, .usages = gfx::BindingUsage::fragmentRead },
-                gfx::ParameterBlockBinding{ .type = gfx::BindingType::sampledTexture, .usages = gfx::BindingUsage::fragmentRead },
-                gfx::ParameterBlockBinding{ .type = gfx::BindingType::constantBuffer,  .usages = gfx::BindingUsage::fragmentRead }
-            }
-        });
-        assert(pbLayout);
-        s_parameterBlockLayout = pbLayout;
-    }
-    m_parameterBlockLayout = pbLayout;
-
-    auto pipeline = s_graphicsPipeline.lock();
-    if (!pipeline) {
-        std::unique_ptr<gfx::ShaderLib> shaderLib = device.newShaderLib(SHADER_DIR "/textured.slib");
-        assert(shaderLib);
-        gfx::GraphicsPipeline::Descriptor gfxPipelineDescriptor = {
-            .vertexLayout = gfx::VertexLayout{
-                .stride = sizeof(Vertex),
-                .attributes = {
-                    gfx::VertexAttribute{
-                        .format = gfx::VertexAttributeFormat::float3,
-                        .offset = offsetof(Vertex, pos)},
-                    gfx::VertexAttribute{
-                        .format = gfx::VertexAttributeFormat::float2,
-                        .offset = offsetof(Vertex, uv)},
-                    gfx::VertexAttribute{
-                        .format = gfx::VertexAttributeFormat::float3,
-                        .offset = offsetof(Vertex, normal)},
-                    gfx::VertexAttribute{
-                        .format = gfx::VertexAttributeFormat::float3,
-                        .offset = offsetof(Vertex, tangent)}
-                }},
-            .vertexShader = &shaderLib->getFunction("vertexMain"),
-            .fragmentShader = &shaderLib->getFunction("fragmentMain"),
-            .colorAttachmentPxFormats = {gfx::PixelFormat::BGRA8Unorm},
-            .depthAttachmentPxFormat = gfx::PixelFormat::Depth32Float,
-            .blendOperation = gfx::BlendOperation::blendingOff,
-            .cullMode = gfx::CullMode::back,
-            .parameterBlockLayouts = { Renderer::vpMatrixBpLayout(), Renderer::sceneDataBpLayout(), m_parameterBlockLayout }
-        };
-        pipeline = device.newGraphicsPipeline(gfxPipelineDescriptor);
-        assert(pipeline);
-        s_graphicsPipeline = pipeline;
-    }
-    m_graphicsPipeline = pipeline;
+    // the vulkan objects of the layout are shared by all the materials of the same type
+    m_parameterBlockLayout = device.newParameterBlockLayout(gfx::ParameterBlockLayout::Descriptor{
+        .bindings = {
+            gfx::ParameterBlockBinding{ .type = gfx::BindingType::sampler,        .usages = gfx::BindingUsage::fragmentRead },
+            gfx::ParameterBlockBinding{ .type = gfx::BindingType::sampledTexture, .usages = gfx::BindingUsage::fragmentRead },
+            gfx::ParameterBlockBinding{ .type = gfx::BindingType::sampledTexture, .usages = gfx::BindingUsage::fragmentRead },
+            gfx::ParameterBlockBinding{ .type = gfx::BindingType::sampledTexture, .usages = gfx::BindingUsage::fragmentRead },
+            gfx::ParameterBlockBinding{ .type = gfx::BindingType::constantBuffer,  .usages = gfx::BindingUsage::fragmentRead }
+        }
+    });
+    assert(m_parameterBlockLayout);
+
+    std::shared_ptr<gfx::ShaderLib> shaderLib = Renderer::texturedShaderLib(); // loaded once by the renderer
+    assert(shaderLib);
+    gfx::GraphicsPipeline::Descriptor gfxPipelineDescriptor = {
+        .vertexLayout = Renderer::withInstanceStream(gfx::VertexLayout{
+            .buffers = { gfx::VertexBufferLayout{ .stride = sizeof(Vertex) } },
+            .attributes = {
+                gfx::VertexAttribute{
+                    .format = gfx::VertexAttributeFormat::float3,
+                    .offset = offsetof(Vertex, pos)},
+                gfx::VertexAttribute{
+                    .format = gfx::VertexAttributeFormat::float2,
+                    .offset = offsetof(Vertex, uv)},
+                gfx::VertexAttribute{
+                    .format = gfx::VertexAttributeFormat::float3,
+                    .offset = offsetof(Vertex, normal)},
+                gfx::VertexAttribute{
+                    .format = gfx::VertexAttributeFormat::float3,
+                    .offset = offsetof(Vertex, tangent)}
+            }}),
+        .vertexShader = &shaderLib->getFunction("vertexMain"),
+        .fragmentShader = &shaderLib->getFunction("fragmentMain"),
+        .colorAttachmentPxFormats = {gfx::PixelFormat::BGRA8Unorm},
+        .depthAttachmentPxFormat = gfx::PixelFormat::Depth32Float,
+        .blendOperation = gfx::BlendOperation::blendingOff,
+        .cullMode = gfx::CullMode::back,
+        .parameterBlockLayouts = { Renderer::vpMatrixBpLayout(), Renderer::sceneDataBpLayout(), m_parameterBlockLayout }
+    };
+    m_graphicsPipeline = device.sharedGraphicsPipeline(gfxPipelineDescriptor); // compiled only if no material of the type is alive
+    assert(m_graphicsPipeline);
 
     m_materialData = device.newBuffer(gfx::Buffer::Descriptor{
         .size = sizeof(shader::textured::MaterialData),
@@ -185,50 +167,41 @@ void TexturedMaterial::makeParameterBlock(gfx::ParameterBlockPool& pool)
 
 ScopMaterial::ScopMaterial(const gfx::Device& device)
 {
-    auto pbLayout = s_parameterBlockLayout.lock();
-    if (!pbLayout) {
-        pbLayout = device.newParameterBlockLayout(gfx::ParameterBlockLayout::Descriptor{
-            .bindings = {
-                gfx::ParameterBlockBinding{ .type = gfx::BindingType::sampler,        .usages = gfx::BindingUsage::fragmentRead },
-                gfx::ParameterBlockBinding{ .type = gfx::BindingType::sampledTexture, .usages = gfx::BindingUsage::fragmentRead },
-                gfx::ParameterBlockBinding{ .type = gfx::BindingType::constantBuffer,  .usages = gfx::BindingUsage::fragmentRead },
+    // the vulkan objects of the layout are shared by all the materials of the same type
+    m_parameterBlockLayout = device.newParameterBlockLayout(gfx::ParameterBlockLayout::Descriptor{
+        .bindings = {
+            gfx::ParameterBlockBinding{ .type = gfx::BindingType::sampler,        .usages = gfx::BindingUsage::fragmentRead },
+            gfx::ParameterBlockBinding{ .type = gfx::BindingType::sampledTexture, .usages = gfx::BindingUsage::fragmentRead },
+            gfx::ParameterBlockBinding{ .type = gfx::BindingType::constantBuffer,  .usages = gfx::BindingUsage::fragmentRead },
+        }
+    });
+    assert(m_parameterBlockLayout);
+
+    std::shared_ptr<gfx::ShaderLib> shaderLib = Renderer::scopShaderLib(); // loaded once by the renderer
+    assert(shaderLib);
+
+    gfx::GraphicsPipeline::Descriptor gfxPipelineDescriptor = {
+        .vertexLayout = Renderer::withInstanceStream(gfx::VertexLayout{
+            .buffers = { gfx::VertexBufferLayout{ .stride = sizeof(Vertex) } },
+            .attributes = {
+                gfx::VertexAttribute{
+                    .format = gfx::VertexAttributeFormat::float3,
+                    .offset = offsetof(Vertex, pos)},
+                gfx::VertexAttribute{
+                    .format = gfx::VertexAttributeFormat::float3,
+                    .offset = offsetof(Vertex, normal)},
             }
-        });
-        assert(pbLayout);
-        s_parameterBlockLayout = pbLayout;
-    }
-    m_parameterBlockLayout = pbLayout;
-
-    auto pipeline = s_graphicsPipeline.lock();
-    if (!pipeline) {
-        std::unique_ptr<gfx::ShaderLib> shaderLib = device.newShaderLib(SHADER_DIR "/scop.slib");
-        assert(shaderLib);
-
-        gfx::GraphicsPipeline::Descriptor gfxPipelineDescriptor = {
-            .vertexLayout = gfx::VertexLayout{
-                .stride = sizeof(Vertex),
-                .attributes = {
-                    gfx::VertexAttribute{
-                        .format = gfx::VertexAttributeFormat::float3,
-                        .offset = offsetof(Vertex, pos)},
-                    gfx::VertexAttribute{
-                        .format = gfx::VertexAttributeFormat::float3,
-                        .offset = offsetof(Vertex, normal)},
-                }
-            },
-            .vertexShader = &shaderLib->getFunction("vertexMain"),
-            .fragmentShader = &shaderLib->getFunction("fragmentMain"),
-            .colorAttachmentPxFormats = {gfx::PixelFormat::BGRA8Unorm},
-            .depthAttachmentPxFormat = gfx::PixelFormat::Depth32Float,
-            .blendOperation = gfx::BlendOperation::blendingOff,
-            .cullMode = gfx::CullMode::back,
-            .parameterBlockLayouts = { Renderer::vpMatrixBpLayout(), Renderer::sceneDataBpLayout(), m_parameterBlockLayout }
-        };
-        pipeline = device.newGraphicsPipeline(gfxPipelineDescriptor);
-        assert(pipeline);
-        s_graphicsPipeline = pipeline;
-    }
-    m_graphicsPipeline = pipeline;
+        }),
+        .vertexShader = &shaderLib->getFunction("vertexMain"),
+        .fragmentShader = &shaderLib->getFunction("fragmentMain"),
+        .colorAttachmentPxFormats = {gfx::PixelFormat::BGRA8Unorm},
+        .depthAttachmentPxFormat = gfx::PixelFormat::Depth32Float,
+        .blendOperation = gfx::BlendOperation::blendingOff,
+        .cullMode = gfx::CullMode::back,
+        .parameterBlockLayouts = { Renderer::vpMatrixBpLayout(), Renderer::sceneDataBpLayout(), m_parameterBlockLayout }
+    };
+    m_graphicsPipeline = device.sharedGraphicsPipeline(gfxPipelineDescriptor); // compiled only if no material of the type is alive
+    assert(m_graphicsPipeline);
 
     m_materialData = device.newBuffer(gfx::Buffer::Descriptor{
         .size = sizeof(shader::scop::MaterialData),
@@ -84,10 +84,7 @@ public:
     ~FlatColorMaterial() override = default;
 
 private:
-    inline static std::weak_ptr<gfx::ParameterBlockLayout> s_parameterBlockLayout;
     std::shared_ptr<gfx::ParameterBlockLayout> m_parameterBlockLayout;
-
-    inline static std::weak_ptr<gfx::GraphicsPipeline> s_graphicsPipeline;
     std::shared_ptr<gfx::GraphicsPipeline> m_graphicsPipeline;
 
     std::shared_ptr<gfx::ParameterBlock> m_parameterBlock;
@@ -140,10 +137,7 @@ public:
     ~TexturedMaterial() override = default;
 
 private:
-    inline static std::weak_ptr<gfx::ParameterBlockLayout> s_parameterBlockLayout;
     std::shared_ptr<gfx::ParameterBlockLayout> m_parameterBlockLayout;
-
-    inline static std::weak_ptr<gfx::GraphicsPipeline> s_graphicsPipeline;
     std::shared_ptr<gfx::GraphicsPipeline> m_graphicsPipeline;
 
     std::shared_ptr<gfx::ParameterBlock> m_parameterBlock;
@@ -188,10 +182,7 @@ public:
     ~ScopMaterial() override = default;
 
 private:
-    inline static std::weak_ptr<gfx::ParameterBlockLayout> s_parameterBlockLayout;
     std::shared_ptr<gfx::ParameterBlockLayout> m_parameterBlockLayout;
-
-    inline static std::weak_ptr<gfx::GraphicsPipeline> s_graphicsPipeline;
     std::shared_ptr<gfx::GraphicsPipeline> m_graphicsPipeline;
 
     std::shared_ptr<gfx::ParameterBlock> m_parameterBlock;
@@ -45,6 +45,8 @@ struct SubMesh
     glm::mat4x4 transform;
     std::shared_ptr<gfx::Buffer> vertexBuffer;
     std::shared_ptr<gfx::Buffer> indexBuffer;
+    glm::vec3 bBoxMin; // in the submesh space, used by the gpu culling
+    glm::vec3 bBoxMax;
     std::shared_ptr<Material> material;
     std::vector<SubMesh> subMeshes;
 };
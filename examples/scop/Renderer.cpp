@@ -13,7 +13,9 @@
 #include "shaders/Light.slang"
 
 #include <Graphics/Buffer.hpp>
+#include <Graphics/CommandBuffer.hpp>
 #include <Graphics/Enums.hpp>
+#include <Graphics/ShaderLib.hpp>
 
 #include <GLFW/glfw3.h>
 #if !defined (SCOP_MANDATORY)
@@ -41,6 +43,7 @@
 #include <functional>
 #include <cassert>
 #include <memory>
+#include <ranges>
 #include <utility>
 
 namespace scop
@@ -61,23 +64,18 @@ Renderer::Renderer(gfx::Device* device, GLFWwindow* window, gfx::Surface* surfac
 
         frameData.parameterBlockPool = m_device->newParameterBlockPool({
             .maxBindingCount = {
-                {gfx::BindingType::constantBuffer, 2},
+                {gfx::BindingType::constantBuffer, 3},
+                {gfx::BindingType::structuredBuffer, 3},
             }
         });
         assert(frameData.parameterBlockPool);
-
-        frameData.vpMatrix = m_device->newBuffer(gfx::Buffer::Descriptor{
-            .size = sizeof(glm::mat4x4),
-            .usages = gfx::BufferUsage::constantBuffer,
-            .storageMode = gfx::ResourceStorageMode::hostVisible});
-        assert(frameData.vpMatrix);
-
-        frameData.sceneDataBuffer = m_device->newBuffer(gfx::Buffer::Descriptor{
-            .size = sizeof(shader::SceneData),
-            .usages = gfx::BufferUsage::constantBuffer,
-            .storageMode = gfx::ResourceStorageMode::hostVisible});
     }
 
+    m_uploadRing = m_device->newUploadRing(gfx::UploadRing::Descriptor{
+        .blockSize = static_cast<size_t>(4 * 1024 * 1024), // the instances of a frame must fit in a block
+        .usages = gfx::BufferUsage::constantBuffer | gfx::BufferUsage::vertexBuffer | gfx::BufferUsage::structuredBuffer | gfx::BufferUsage::indirectBuffer});
+    assert(m_uploadRing);
+
     m_vpMatrixBpLayout = m_device->newParameterBlockLayout(gfx::ParameterBlockLayout::Descriptor{
         .bindings = {
             gfx::ParameterBlockBinding{ .type = gfx::BindingType::constantBuffer, .usages = gfx::BindingUsage::vertexRead }
@@ -94,6 +92,37 @@ Renderer::Renderer(gfx::Device* device, GLFWwindow* window, gfx::Surface* surfac
     assert(m_sceneDataBpLayout);
     s_sceneDataBpLayout = m_sceneDataBpLayout;
 
+    m_flatColorShaderLib = m_device->newShaderLib(SHADER_DIR "/flat_color.slib");
+    assert(m_flatColorShaderLib);
+    s_flatColorShaderLib = m_flatColorShaderLib;
+
+    m_texturedShaderLib = m_device->newShaderLib(SHADER_DIR "/textured.slib");
+    assert(m_texturedShaderLib);
+    s_texturedShaderLib = m_texturedShaderLib;
+
+    m_scopShaderLib = m_device->newShaderLib(SHADER_DIR "/scop.slib");
+    assert(m_scopShaderLib);
+    s_scopShaderLib = m_scopShaderLib;
+
+    m_cullBpLayout = m_device->newParameterBlockLayout(gfx::ParameterBlockLayout::Descriptor{
+        .bindings = {
+            gfx::ParameterBlockBinding{ .type = gfx::BindingType::constantBuffer, .usages = gfx::BindingUsage::computeRead },
+            gfx::ParameterBlockBinding{ .type = gfx::BindingType::structuredBuffer, .usages = gfx::BindingUsage::computeRead },
+            gfx::ParameterBlockBinding{ .type = gfx::BindingType::structuredBuffer, .usages = gfx::BindingUsage::computeRead | gfx::BindingUsage::computeWrite },
+            gfx::ParameterBlockBinding{ .type = gfx::BindingType::structuredBuffer, .usages = gfx::BindingUsage::computeWrite }
+        }
+    });
+    assert(m_cullBpLayout);
+
+    std::unique_ptr<gfx::ShaderLib> cullShaderLib = m_device->newShaderLib(SHADER_DIR "/cull.slib");
+    assert(cullShaderLib);
+    m_cullPipeline = m_device->newComputePipeline(gfx::ComputePipeline::Descriptor{
+        .computeShader = &cullShaderLib->getFunction("cullMain"),
+        .threadGroupSize = { CULL_THREAD_GROUP_SIZE, 1, 1 },
+        .parameterBlockLayouts = { m_cullBpLayout }
+    });
+    assert(m_cullPipeline);
+
 #if !defined (SCOP_MANDATORY)
     ImGui::CreateContext();
 
@@ -115,6 +144,23 @@ Renderer::Renderer(gfx::Device* device, GLFWwindow* window, gfx::Surface* surfac
 #endif
 }
 
+gfx::VertexLayout Renderer::withInstanceStream(gfx::VertexLayout meshLayout)
+{
+    assert(meshLayout.buffers.size() == instanceBufferIndex);
+    meshLayout.buffers.push_back(gfx::VertexBufferLayout{
+        .stride = sizeof(glm::mat4x4),
+        .stepFunction = gfx::VertexStepFunction::perInstance
+    });
+    for (uint32_t i = 0; i < 4; i++) {
+        meshLayout.attributes.push_back(gfx::VertexAttribute{
+            .format = gfx::VertexAttributeFormat::float4,
+            .offset = sizeof(glm::vec4) * i,
+            .bufferIndex = instanceBufferIndex
+        });
+    }
+    return meshLayout;
+}
+
 void Renderer::beginFrame(const glm::mat4x4& viewMatrix, float fov, float near, float far)
 {
     ZoneScoped;
@@ -141,7 +187,6 @@ void Renderer::beginFrame(const glm::mat4x4& viewMatrix, float fov, float near,
         };
         for (auto& frameData : m_frameDatas)
             frameData.depthTexture = m_device->newTexture(depthTextureDescriptor);
-        m_device->waitIdle();
     }
 
     if (cfd.lastCommandBuffer != nullptr) {
@@ -152,6 +197,9 @@ void Renderer::beginFrame(const glm::mat4x4& viewMatrix, float fov, float near,
     }
 
     cfd.renderables.clear();
+    cfd.instanceCount = 0;
+    cfd.vpMatrix = m_uploadRing->allocate(sizeof(glm::mat4x4));
+    cfd.sceneData = m_uploadRing->allocate(sizeof(shader::SceneData));
     cfsd = shader::SceneData{
         .cameraPosition = -viewMatrix[3],
         .ambientLightColor = glm::vec3(0),
@@ -165,7 +213,7 @@ void Renderer::beginFrame(const glm::mat4x4& viewMatrix, float fov, float near,
     ::glfwGetFramebufferSize(m_window, &width, &height);
     const float aspectRatio = static_cast<float>(width) / static_cast<float>(height == 0 ? 1 : height);
     glm::mat4 projectionMatrix = glm::perspective(glm::radians(fov), aspectRatio, near, far);
-    *cfd.vpMatrix->content<glm::mat4x4>() = projectionMatrix * viewMatrix;
+    *cfd.vpMatrix.content<glm::mat4x4>() = projectionMatrix * viewMatrix;
 
 #if !defined (SCOP_MANDATORY)
     {
@@ -186,7 +234,16 @@ void Renderer::addMesh(const Mesh& mesh, const glm::mat4x4& worlTransform)
         for (auto& childSubmesh : submesh.subMeshes)
             addSubmesh(childSubmesh, modelMatrix);
 
-        cfd.renderables[submesh.material->graphicsPipleine()][submesh.material][std::make_pair(submesh.vertexBuffer, submesh.indexBuffer)].push_back(modelMatrix);
+        cfd.renderables[submesh.material->graphicsPipleine()][submesh.material][std::make_pair(submesh.vertexBuffer, submesh.indexBuffer)].push_back(shader::cull::Instance{
+            .modelMatrix0 = modelMatrix[0],
+            .modelMatrix1 = modelMatrix[1],
+            .modelMatrix2 = modelMatrix[2],
+            .modelMatrix3 = modelMatrix[3],
+            .bBoxMin = glm::vec4(submesh.bBoxMin, 1.0f),
+            .bBoxMax = glm::vec4(submesh.bBoxMax, 1.0f),
+            .drawIndex = 0
+        });
+        cfd.instanceCount++;
     };
 
     for (auto& submesh : mesh.subMeshes)
@@ -240,33 +297,89 @@ void Renderer::endFrame()
         }
     };
 
+    // every (mesh, material) group is an indexed indirect draw, the culling pass writes its instance count
+    // and compacts the visible model matrices of the group in its range of the instance stream
+    gfx::BufferSlice instanceBuffer;
+    gfx::BufferSlice drawArgsBuffer;
+    if (cfd.instanceCount > 0)
+    {
+        ZoneScopedN("cullPass");
+        size_t drawCount = 0;
+        for (auto& [pipeline, renderables] : cfd.renderables) {
+            for (auto& [material, buffers] : renderables)
+                drawCount += buffers.size();
+        }
+
+        gfx::BufferSlice cullData = m_uploadRing->upload(shader::cull::CullData{
+            .vpMatrix = *cfd.vpMatrix.content<glm::mat4x4>(),
+            .instanceCount = static_cast<uint32_t>(cfd.instanceCount)
+        });
+        gfx::BufferSlice instances = m_uploadRing->allocate(cfd.instanceCount * sizeof(shader::cull::Instance));
+        drawArgsBuffer = m_uploadRing->allocate(drawCount * sizeof(gfx::CommandBuffer::DrawIndexedIndirectCommand));
+        instanceBuffer = m_uploadRing->allocate(cfd.instanceCount * sizeof(shader::cull::VisibleInstance));
+
+        auto* instance = instances.content<shader::cull::Instance>();
+        auto* drawArgs = drawArgsBuffer.content<gfx::CommandBuffer::DrawIndexedIndirectCommand>();
+        uint32_t drawIndex = 0;
+        uint32_t firstInstance = 0;
+        for (auto& [pipeline, renderables] : cfd.renderables) {
+            for (auto& [material, buffers] : renderables) {
+                for (auto& [vtxIdxBuffer, groupInstances] : buffers) {
+                    for (auto& groupInstance : groupInstances) {
+                        groupInstance.drawIndex = drawIndex;
+                        *instance++ = groupInstance;
+                    }
+                    drawArgs[drawIndex++] = gfx::CommandBuffer::DrawIndexedIndirectCommand{
+                        .indexCount = static_cast<uint32_t>(vtxIdxBuffer.second->size() / sizeof(uint32_t)),
+                        .instanceCount = 0,
+                        .firstIndex = 0,
+                        .vertexOffset = 0,
+                        .firstInstance = firstInstance
+                    };
+                    firstInstance += static_cast<uint32_t>(groupInstances.size());
+                }
+            }
+        }
+
+        std::shared_ptr<gfx::ParameterBlock> cullPBlock = cfd.parameterBlockPool->get(m_cullBpLayout);
+        cullPBlock->setBinding(0, cullData);
+        cullPBlock->setBinding(1, instances);
+        cullPBlock->setBinding(2, drawArgsBuffer);
+        cullPBlock->setBinding(3, instanceBuffer);
+
+        commandBuffer->beginComputePass();
+        commandBuffer->usePipeline(m_cullPipeline);
+        commandBuffer->setParameterBlock(cullPBlock, 0);
+        commandBuffer->dispatch(static_cast<uint32_t>((cfd.instanceCount + CULL_THREAD_GROUP_SIZE - 1) / CULL_THREAD_GROUP_SIZE));
+        commandBuffer->endComputePass();
+    }
+
     commandBuffer->beginRenderPass(framebuffer);
     {
         ZoneScopedN("renderPass");
+        size_t drawIndex = 0;
         std::shared_ptr<gfx::ParameterBlock> vpMatrixPBlock = cfd.parameterBlockPool->get(vpMatrixBpLayout());
         vpMatrixPBlock->setBinding(0, cfd.vpMatrix);
 
         std::shared_ptr<gfx::ParameterBlock> sceneDataPBlock = cfd.parameterBlockPool->get(sceneDataBpLayout());
-        sceneDataPBlock->setBinding(0, cfd.sceneDataBuffer);
+        sceneDataPBlock->setBinding(0, cfd.sceneData);
 
         for (auto& [pipeline, renderables] : cfd.renderables)
         {
             commandBuffer->usePipeline(pipeline);
             commandBuffer->setParameterBlock(vpMatrixPBlock, 0);
             commandBuffer->setParameterBlock(sceneDataPBlock, 1);
+            commandBuffer->useVertexBuffer(instanceBuffer, instanceBufferIndex);
 
             for (auto& [material, buffers] : renderables)
             {
                 commandBuffer->setParameterBlock(material->getParameterBlock(), 2);
-                for (auto& [vtxIdxBuffer, modelMatrices] : buffers)
+                for (auto& [vtxIdxBuffer, groupInstances] : buffers)
                 {
                     auto& [vertexBuffer, indexBuffer] = vtxIdxBuffer;
                     commandBuffer->useVertexBuffer(vertexBuffer);
-                    for (auto& modelMatrix : modelMatrices)
-                    {
-                        commandBuffer->setPushConstants(&modelMatrix);
-                        commandBuffer->drawIndexedVertices(indexBuffer);
-                    }
+                    commandBuffer->drawIndexedIndirect(indexBuffer, gfx::IndexType::uint32, drawArgsBuffer.buffer, drawArgsBuffer.offset + drawIndex * sizeof(gfx::CommandBuffer::DrawIndexedIndirectCommand));
+                    drawIndex++;
                 }
             }
         }
@@ -14,11 +14,16 @@
 #include "Mesh.hpp"
 
 #include "shaders/SceneData.slang"
+#include "shaders/cull.slang"
 
 #include <Graphics/Surface.hpp>
 #include <Graphics/Device.hpp>
 #include <Graphics/GraphicsPipeline.hpp>
+#include <Graphics/ComputePipeline.hpp>
 #include <Graphics/ParameterBlockLayout.hpp>
+#include <Graphics/ShaderLib.hpp>
+#include <Graphics/UploadRing.hpp>
+#include <Graphics/VertexLayout.hpp>
 
 #include <GLFW/glfw3.h>
 #if !defined (SCOP_MANDATORY)
@@ -38,7 +43,7 @@
 #include <cstddef>
 
 #define cfd m_frameDatas.at(m_frameIdx)
-#define cfsd (*cfd.sceneDataBuffer->content<shader::SceneData>())
+#define cfsd (*cfd.sceneData.content<shader::SceneData>())
 
 namespace scop
 {
@@ -57,6 +62,15 @@ public:
     static inline std::shared_ptr<gfx::ParameterBlockLayout> vpMatrixBpLayout() { return s_vpMatrixBpLayout.lock(); }
     static inline std::shared_ptr<gfx::ParameterBlockLayout> sceneDataBpLayout() { return s_sceneDataBpLayout.lock(); }
 
+    // the shader libraries of the materials, loaded once instead of by each material
+    static inline std::shared_ptr<gfx::ShaderLib> flatColorShaderLib() { return s_flatColorShaderLib.lock(); }
+    static inline std::shared_ptr<gfx::ShaderLib> texturedShaderLib() { return s_texturedShaderLib.lock(); }
+    static inline std::shared_ptr<gfx::ShaderLib> scopShaderLib() { return s_scopShaderLib.lock(); }
+
+    // the model matrices are a per instance vertex stream added after the mesh vertex buffers
+    static constexpr uint32_t instanceBufferIndex = 1;
+    static gfx::VertexLayout withInstanceStream(gfx::VertexLayout meshLayout);
+
     void beginFrame(const glm::mat4x4& viewMatrix, float fov, float near, float far);
 
     inline void setAmbientLightColor(glm::vec3 c) { cfsd.ambientLightColor = c; }
@@ -74,11 +88,11 @@ private:
         std::unique_ptr<gfx::CommandBufferPool> commandBufferPool;
         std::unique_ptr<gfx::ParameterBlockPool> parameterBlockPool;
 
-        std::shared_ptr<gfx::Buffer> vpMatrix;
+        gfx::BufferSlice vpMatrix;
 
         std::shared_ptr<gfx::Texture> depthTexture;
 
-        std::shared_ptr<gfx::Buffer> sceneDataBuffer;
+        gfx::BufferSlice sceneData;
 
         std::map<
             std::shared_ptr<gfx::GraphicsPipeline>,
@@ -86,8 +100,9 @@ private:
                 std::shared_ptr<Material>,
                 std::map<
                     std::pair<std::shared_ptr<gfx::Buffer>, std::shared_ptr<gfx::Buffer>>, // vertex buffer / index buffer
-                    std::vector<glm::mat4x4> // model matrix
+                    std::vector<shader::cull::Instance> // one each, the draw index is set at the end of the frame
         >>> renderables;
+        size_t instanceCount = 0;
 
         gfx::CommandBuffer* lastCommandBuffer = nullptr;
     };
@@ -98,6 +113,9 @@ private:
 
     std::unique_ptr<gfx::Swapchain> m_swapchain;
 
+    // per frame constants, the slices of a frame are released when the frame data is reused
+    std::unique_ptr<gfx::UploadRing> m_uploadRing;
+
     uint8_t m_frameIdx = 0;
     std::array<FrameData, maxFrameInFlight> m_frameDatas;
 
@@ -107,6 +125,19 @@ private:
     inline static std::weak_ptr<gfx::ParameterBlockLayout> s_sceneDataBpLayout;
     std::shared_ptr<gfx::ParameterBlockLayout> m_sceneDataBpLayout;
 
+    inline static std::weak_ptr<gfx::ShaderLib> s_flatColorShaderLib;
+    std::shared_ptr<gfx::ShaderLib> m_flatColorShaderLib;
+
+    inline static std::weak_ptr<gfx::ShaderLib> s_texturedShaderLib;
+    std::shared_ptr<gfx::ShaderLib> m_texturedShaderLib;
+
+    inline static std::weak_ptr<gfx::ShaderLib> s_scopShaderLib;
+    std::shared_ptr<gfx::ShaderLib> m_scopShaderLib;
+
+    // frustum culling of the instances, writes the per instance stream and the args of the indirect draws
+    std::shared_ptr<gfx::ParameterBlockLayout> m_cullBpLayout;
+    std::shared_ptr<gfx::ComputePipeline> m_cullPipeline;
+
 public:
     Renderer& operator=(const Renderer&) = delete;
     Renderer& operator=(Renderer&&) = delete;
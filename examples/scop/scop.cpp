@@ -47,6 +47,7 @@
 
 #include <cassert>
 #include <algorithm> // IWYU pragma: keep
+#include <chrono>
 #include <filesystem>
 #include <memory>
 #include <numbers> // IWYU pragma: keep
@@ -134,7 +135,9 @@ int main(int argc, char** argv)
                 .graphics = true,
                 .compute = true,
                 .transfer = true,
-                .present = {surface.get()}}};
+                .present = {surface.get()}},
+            .asyncTransfer = true, // assets are loaded while rendering
+            .pipelineCachePath = std::filesystem::temp_directory_path() / "scop_pipeline_cache.bin"};
         std::unique_ptr<gfx::Device> device = instance->newDevice(deviceDescriptor);
         assert(device);
 
@@ -209,6 +212,12 @@ int main(int argc, char** argv)
             object->setRotation({-std::numbers::pi_v<float> / 2, 0.0f, 0.0f});
         entities.push_back(object);
 
+        // the pipelines are created while loading the scene, a warm cache should only have hits
+        gfx::Device::PipelineCacheStatistics pipelineCacheStats = device->pipelineCacheStatistics();
+        std::println("pipeline cache: {} hits ({}), {} misses ({})",
+            pipelineCacheStats.hitCount, std::chrono::duration_cast<std::chrono::milliseconds>(pipelineCacheStats.hitDuration),
+            pipelineCacheStats.missCount, std::chrono::duration_cast<std::chrono::milliseconds>(pipelineCacheStats.missDuration));
+
         while (true)
         {
             TracyCZoneN(glfwPollEventsCtx, "glfwPollEvents()", true);
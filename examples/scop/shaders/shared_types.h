@@ -22,9 +22,12 @@ namespace glm = scop::math;
 #  endif
 # endif
 
+# include <cstdint>
+
 using float2 = glm::vec2;
 using float3 = glm::vec3;
 using float4 = glm::vec4;
+using float4x4 = glm::mat4x4;
 
 # define SLAND_PUBLIC
 # define CPP_ALIGNAS(n) alignas(n) // NOLINT(cppcoreguidelines-macro-usage)
@@ -10,6 +10,7 @@
 #include "Graphics/Buffer.hpp"
 #include "Graphics/CommandBuffer.hpp"
 #include "Graphics/Drawable.hpp"
+#include "Graphics/FrameContext.hpp"
 #include "Graphics/Framebuffer.hpp"
 #include "Graphics/GraphicsPipeline.hpp"
 #include "Graphics/Instance.hpp"
@@ -48,8 +49,6 @@ constexpr std::array<Vertex, 3> vertices = {
     Vertex{ .pos=glm::vec2(-0.5f, -0.5f), .color=glm::vec3(0.0f, 0.0f, 1.0f) }
 };
 
-constexpr uint8_t maxFrameInFlight = 3;
-
 class Application
 {
 public:
@@ -96,7 +95,7 @@ public:
 
         gfx::GraphicsPipeline::Descriptor gfxPipelineDescriptor = {
             .vertexLayout = gfx::VertexLayout{
-                .stride = sizeof(Vertex),
+                .buffers = { gfx::VertexBufferLayout{ .stride = sizeof(Vertex) } },
                 .attributes = {
                     gfx::VertexAttribute{
                         .format = gfx::VertexAttributeFormat::float2,
@@ -115,9 +114,7 @@ public:
         m_graphicsPipeline = m_device->newGraphicsPipeline(gfxPipelineDescriptor);
         assert(m_graphicsPipeline);
 
-        for (uint8_t i = 0; i < maxFrameInFlight; i++) {
-            m_commandBufferPools.at(i) = m_device->newCommandBufferPool();
-        }
+        m_frameContext = std::make_unique<gfx::FrameContext>(*m_device, gfx::FrameContext::Descriptor{});
 
         m_vertexBuffer = m_device->newBuffer(gfx::Buffer::Descriptor{
             .size = sizeof(Vertex) * vertices.size(),
@@ -135,11 +132,13 @@ public:
 
         std::ranges::copy(vertices, stagingBuffer->content<Vertex>());
 
-        std::shared_ptr<gfx::CommandBuffer> commandBuffer = m_commandBufferPools.at(m_frameIdx)->get();
+        std::unique_ptr<gfx::CommandBufferPool> uploadPool = m_device->newCommandBufferPool();
+        std::shared_ptr<gfx::CommandBuffer> commandBuffer = uploadPool->get();
         commandBuffer->beginBlitPass();
         commandBuffer->copyBufferToBuffer(stagingBuffer, m_vertexBuffer, stagingBuffer->size());
         commandBuffer->endBlitPass();
         m_device->submitCommandBuffers(commandBuffer);
+        m_device->waitCommandBuffer(*commandBuffer);
     }
 
     void loop()
@@ -166,15 +165,13 @@ public:
                 m_device->waitIdle();
             }
 
-            if (m_lastCommandBuffers.at(m_frameIdx) != nullptr) {
-                m_device->waitCommandBuffer(*m_lastCommandBuffers.at(m_frameIdx));
-                m_commandBufferPools.at(m_frameIdx)->reset();
-            }
+            m_frameContext->beginFrame();
 
-            std::shared_ptr<gfx::CommandBuffer> commandBuffer = m_commandBufferPools.at(m_frameIdx)->get();
+            std::shared_ptr<gfx::CommandBuffer> commandBuffer = m_frameContext->get();
 
             std::shared_ptr<gfx::Drawable> drawable = m_swapchain->nextDrawable();
             if (drawable == nullptr) {
+                m_frameContext->endFrame();
                 m_swapchain = nullptr;
                 continue;
             }
@@ -198,10 +195,9 @@ public:
             commandBuffer->endRenderPass();
             commandBuffer->presentDrawable(drawable);
 
-            m_lastCommandBuffers.at(m_frameIdx) = commandBuffer.get();
             m_device->submitCommandBuffers(commandBuffer);
 
-            m_frameIdx = (m_frameIdx + 1) % maxFrameInFlight;
+            m_frameContext->endFrame();
         }
     }
 
@@ -219,9 +215,7 @@ private:
     std::shared_ptr<gfx::GraphicsPipeline> m_graphicsPipeline;
     std::unique_ptr<gfx::Swapchain> m_swapchain;
     std::shared_ptr<gfx::Buffer> m_vertexBuffer;
-    uint8_t m_frameIdx = 0;
-    std::array<std::unique_ptr<gfx::CommandBufferPool>, maxFrameInFlight> m_commandBufferPools;
-    std::array<gfx::CommandBuffer*, maxFrameInFlight> m_lastCommandBuffers = {};
+    std::unique_ptr<gfx::FrameContext> m_frameContext;
 };
 
 int main()
@@ -12,7 +12,10 @@
 
 #include "Graphics/Enums.hpp"
 
+#include <cassert>
 #include <cstddef>
+#include <cstring>
+#include <memory>
 
 namespace gfx
 {
@@ -55,6 +58,18 @@ protected:
     Buffer& operator = (Buffer&&) = default;
 };
 
+// a range of a buffer, the offset respect the alignment it was allocated with
+struct BufferSlice
+{
+    std::shared_ptr<Buffer> buffer;
+    size_t offset = 0;
+    size_t size = 0;
+
+    template<typename T> inline T* content() const { return (T*)(buffer->content<std::byte>() + offset); }
+    inline void setContent(const void* data, size_t s) const { assert(s <= size); std::memcpy(content<std::byte>(), data, s); }
+    inline void setContent(const auto& data) const { setContent(&data, sizeof(data)); }
+};
+
 }
 
 #endif // BUFFER_HPP
@@ -12,11 +12,15 @@
 
 #include "Graphics/Framebuffer.hpp"
 #include "Graphics/GraphicsPipeline.hpp"
+#include "Graphics/ComputePipeline.hpp"
 #include "Graphics/Buffer.hpp"
 #include "Graphics/ParameterBlock.hpp"
 #include "Graphics/Drawable.hpp"
+#include "Graphics/Enums.hpp"
 
 #include <memory>
+#include <cassert>
+#include <compare>
 #include <cstdint>
 
 #if defined(GFX_IMGUI_ENABLED)
@@ -28,22 +32,97 @@ namespace gfx
 
 class CommandBufferPool;
 
+// identify a submit, the values increase with every submit of the device.
+// the submits of a queue complete in order, the ones of different queues do not.
+// the default ticket identify nothing and is always completed
+struct SubmitTicket
+{
+    uint64_t value = 0;
+    QueueType queueType = QueueType::graphics;
+
+    auto operator<=>(const SubmitTicket&) const = default;
+};
+
 class CommandBuffer
 {
+public:
+    struct Statistics
+    {
+        uint32_t barrierCount = 0;      // memory barriers recorded for the command buffer, including the ones added at submit time (at every submit if reusable)
+        uint32_t barrierBatchCount = 0; // pipeline barrier commands used to record them
+
+        auto operator<=>(const Statistics&) const = default;
+    };
+
+    // layouts of the commands read by the indirect draws, same as VkDrawIndirectCommand / MTLDrawPrimitivesIndirectArguments
+    struct DrawIndirectCommand
+    {
+        uint32_t vertexCount;
+        uint32_t instanceCount;
+        uint32_t firstVertex;
+        uint32_t firstInstance;
+    };
+
+    struct DrawIndexedIndirectCommand
+    {
+        uint32_t indexCount;
+        uint32_t instanceCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+        uint32_t firstInstance;
+    };
+
+    // thread group counts read by dispatchIndirect, same as VkDispatchIndirectCommand / MTLDispatchThreadgroupsIndirectArguments
+    struct DispatchIndirectCommand
+    {
+        uint32_t x;
+        uint32_t y;
+        uint32_t z;
+    };
+
 public:
     CommandBuffer(const CommandBuffer&) = delete;
 
-    virtual void beginRenderPass(const Framebuffer&) = 0;
+    // the resources used in a render pass are synchronized with the commands preceding it, not between the draws of the pass.
+    // a pass must not write a resource it also read or write elsewhere in the pass (except its attachments)
+    virtual void beginRenderPass(const Framebuffer&, RenderPassContents) = 0;
+    inline void beginRenderPass(const Framebuffer& framebuffer) { beginRenderPass(framebuffer, RenderPassContents::inlined); }
+
+    // command buffer recording a part of the current render pass, the pass must use RenderPassContents::secondaryCommandBuffers.
+    // they are created in order by the thread recording this command buffer and can then be recorded by any thread.
+    // endRenderPass execute them in creation order, it must be called once they are all recorded.
+    // a secondary command buffer only record render pass commands and is not submitted itself.
+    // the secondaries are synchronized with the commands preceding the render pass, not with each other, no barrier is recorded in them
+    virtual std::shared_ptr<CommandBuffer> newSecondaryCommandBuffer() = 0;
 
     virtual void usePipeline(const std::shared_ptr<const GraphicsPipeline>&) = 0;
-    virtual void useVertexBuffer(const std::shared_ptr<Buffer>&) = 0;
+    inline void usePipeline(const GraphicsPipelineFuture& pipeline) { usePipeline(pipeline.get()); } // wait for the compilation if needed
+    virtual void useVertexBuffer(const std::shared_ptr<Buffer>&, size_t offset, uint32_t bufferIndex) = 0; // bufferIndex is the index of the VertexBufferLayout
+    inline void useVertexBuffer(const std::shared_ptr<Buffer>& buffer, size_t offset = 0) { useVertexBuffer(buffer, offset, 0); }
+    inline void useVertexBuffer(const BufferSlice& slice, uint32_t bufferIndex = 0) { useVertexBuffer(slice.buffer, slice.offset, bufferIndex); }
 
     virtual void setParameterBlock(const std::shared_ptr<const ParameterBlock>&, uint32_t index) = 0;
     virtual void setPushConstants(const void* data, size_t size) = 0;
     void setPushConstants(const auto* data) { setPushConstants(data, sizeof(decltype(*data))); }
 
-    virtual void drawVertices(uint32_t start, uint32_t count) = 0;
-    virtual void drawIndexedVertices(const std::shared_ptr<Buffer>& idxBuffer) = 0;
+    // firstInstance offsets the elements fetched from the perInstance vertex buffers
+    virtual void drawVertices(uint32_t start, uint32_t count, uint32_t instanceCount, uint32_t firstInstance) = 0;
+    inline void drawVertices(uint32_t start, uint32_t count) { drawVertices(start, count, 1, 0); }
+    // vertexOffset is added to each index before fetching the vertex, so meshes packed in a same vertex buffer can keep local indices
+    virtual void drawIndexedVertices(const std::shared_ptr<Buffer>& idxBuffer, IndexType, uint32_t indexCount, uint32_t firstIndex = 0, int32_t vertexOffset = 0, uint32_t instanceCount = 1, uint32_t firstInstance = 0) = 0;
+    inline void drawIndexedVertices(const std::shared_ptr<Buffer>& idxBuffer) { drawIndexedVertices(idxBuffer, IndexType::uint32, static_cast<uint32_t>(idxBuffer->size() / sizeof(uint32_t))); }
+    inline void drawIndexedVertices(const BufferSlice& idxBuffer, IndexType type = IndexType::uint32, uint32_t instanceCount = 1, uint32_t firstInstance = 0) // draw all the indices of the slice
+    {
+        assert(idxBuffer.offset % indexTypeSize(type) == 0);
+        drawIndexedVertices(idxBuffer.buffer, type, static_cast<uint32_t>(idxBuffer.size / indexTypeSize(type)), static_cast<uint32_t>(idxBuffer.offset / indexTypeSize(type)), 0, instanceCount, firstInstance);
+    }
+
+    // the indirect buffers contain drawCount tightly packed commands starting at offset, they need the indirectBuffer usage
+    virtual void drawIndirect(const std::shared_ptr<Buffer>& indirectBuffer, size_t offset, uint32_t drawCount = 1) = 0;
+    virtual void drawIndexedIndirect(const std::shared_ptr<Buffer>& idxBuffer, IndexType, const std::shared_ptr<Buffer>& indirectBuffer, size_t offset, uint32_t drawCount = 1) = 0;
+    // the draw count is the uint32_t at countOffset in countBuffer, clamped to maxDrawCount. need Device::supportsDrawIndirectCount()
+    virtual void drawIndirectCount(const std::shared_ptr<Buffer>& indirectBuffer, size_t offset, const std::shared_ptr<Buffer>& countBuffer, size_t countOffset, uint32_t maxDrawCount) = 0;
+    virtual void drawIndexedIndirectCount(const std::shared_ptr<Buffer>& idxBuffer, IndexType, const std::shared_ptr<Buffer>& indirectBuffer, size_t offset, const std::shared_ptr<Buffer>& countBuffer, size_t countOffset, uint32_t maxDrawCount) = 0;
 
 #if defined(GFX_IMGUI_ENABLED)
     virtual void imGuiRenderDrawData(ImDrawData*) const = 0;
@@ -52,11 +131,30 @@ public:
     virtual void endRenderPass() = 0;
 
 
+    // the writes of a dispatch are visible to the next commands using the same resources, in the pass or after it
+    virtual void beginComputePass() = 0;
+
+    virtual void usePipeline(const std::shared_ptr<const ComputePipeline>&) = 0;
+
+    // the counts are thread groups, not threads
+    virtual void dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1) = 0;
+    virtual void dispatchIndirect(const std::shared_ptr<Buffer>& indirectBuffer, size_t offset) = 0;
+
+    virtual void endComputePass() = 0;
+
+
     virtual void beginBlitPass() = 0;
 
-    virtual void copyBufferToBuffer(const std::shared_ptr<Buffer>& src, const std::shared_ptr<Buffer>& dst, size_t size) = 0;
+    virtual void copyBufferToBuffer(const std::shared_ptr<Buffer>& src, size_t srcOffset, const std::shared_ptr<Buffer>& dst, size_t dstOffset, size_t size) = 0;
+    inline void copyBufferToBuffer(const std::shared_ptr<Buffer>& src, const std::shared_ptr<Buffer>& dst, size_t size) { copyBufferToBuffer(src, 0, dst, 0, size); }
+    inline void copyBufferToBuffer(const BufferSlice& src, const std::shared_ptr<Buffer>& dst, size_t dstOffset = 0) { copyBufferToBuffer(src.buffer, src.offset, dst, dstOffset, src.size); } // copy the whole slice
     virtual void copyBufferToTexture(const std::shared_ptr<Buffer>& buffer, size_t bufferOffset, const std::shared_ptr<Texture>& texture, uint32_t layerIndex = 0) = 0;
     inline void copyBufferToTexture(const std::shared_ptr<Buffer>& buffer, const std::shared_ptr<Texture>& texture) { copyBufferToTexture(buffer, 0, texture); }
+    inline void copyBufferToTexture(const BufferSlice& slice, const std::shared_ptr<Texture>& texture, uint32_t layerIndex = 0) { copyBufferToTexture(slice.buffer, slice.offset, texture, layerIndex); }
+    // the rows are tightly packed in the buffer. a ResourceStorageMode::readback buffer can be read once the command buffer is completed
+    virtual void copyTextureToBuffer(const std::shared_ptr<Texture>& texture, const std::shared_ptr<Buffer>& buffer, size_t bufferOffset, uint32_t layerIndex = 0) = 0;
+    inline void copyTextureToBuffer(const std::shared_ptr<Texture>& texture, const std::shared_ptr<Buffer>& buffer) { copyTextureToBuffer(texture, buffer, 0); }
+    inline void copyTextureToBuffer(const std::shared_ptr<Texture>& texture, const BufferSlice& slice, uint32_t layerIndex = 0) { copyTextureToBuffer(texture, slice.buffer, slice.offset, layerIndex); }
 
     virtual void endBlitPass() = 0;
 
@@ -64,6 +162,14 @@ public:
 
     virtual void addSampledTexture(const std::shared_ptr<Texture>&) = 0; // for imgui
 
+    virtual Statistics statistics() const = 0;
+
+    // ticket of the last submit, the default one if the command buffer is not submitted or completed and reused since.
+    // a submit enqueued for the submission thread is waited to be done
+    virtual SubmitTicket submitTicket() const = 0;
+    // never block, a submit still in the queue of the submission thread or deferred is not completed
+    virtual bool isCompleted() const = 0;
+
     virtual ~CommandBuffer() = default;
 
 protected:
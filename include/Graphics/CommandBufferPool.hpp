@@ -23,8 +23,8 @@ public:
     CommandBufferPool(const CommandBufferPool&) = delete;
     CommandBufferPool(CommandBufferPool&&) = delete;
 
-    // do not call get() and reset() concurently.
-    // should have one pool per thead so no problem
+    // not synchronized, a pool and its command buffers are used by one thread at a time.
+    // use one pool per recording thread, reset() once the command buffers it returned are completed
 
     virtual std::shared_ptr<CommandBuffer> get() = 0;
     virtual void reset() = 0;
@@ -0,0 +1,55 @@
+/*
+ * ---------------------------------------------------
+ * ComputePipeline.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 09:12:44
+ * ---------------------------------------------------
+ */
+
+#ifndef COMPUTEPIPELINE_HPP
+#define COMPUTEPIPELINE_HPP
+
+#include "Graphics/ShaderFunction.hpp"
+#include "Graphics/ParameterBlockLayout.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <memory>
+
+namespace gfx
+{
+
+class ComputePipeline
+{
+public:
+    struct Descriptor
+    {
+        ShaderFunction* computeShader;
+
+        // threads per group, must match the [numthreads] of the shader. only used by metal, vulkan read it from the shader
+        std::array<uint32_t, 3> threadGroupSize = { 1, 1, 1 };
+
+        std::vector<std::shared_ptr<ParameterBlockLayout>> parameterBlockLayouts;
+
+        auto operator<=>(const Descriptor&) const = default;
+    };
+
+public:
+    ComputePipeline(const ComputePipeline&) = delete;
+    ComputePipeline(ComputePipeline&&) = delete;
+
+    virtual ~ComputePipeline() = default;
+
+protected:
+    ComputePipeline() = default;
+
+public:
+    ComputePipeline& operator=(const ComputePipeline&) = delete;
+    ComputePipeline& operator=(ComputePipeline&&) = delete;
+};
+
+} // namespace gfx
+
+#endif // COMPUTEPIPELINE_HPP
@@ -14,46 +14,136 @@
 #include "Graphics/Swapchain.hpp"
 #include "Graphics/ShaderLib.hpp"
 #include "Graphics/GraphicsPipeline.hpp"
+#include "Graphics/ComputePipeline.hpp"
 #include "Graphics/Buffer.hpp"
 #include "Graphics/Texture.hpp"
 #include "Graphics/CommandBufferPool.hpp"
 #include "Graphics/ParameterBlockPool.hpp"
 #include "Graphics/CommandBuffer.hpp"
 #include "Graphics/Enums.hpp"
+#include "Graphics/UploadRing.hpp"
 #include "ParameterBlockLayout.hpp"
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <filesystem>
+#include <functional>
 #include <optional>
+#include <span>
 #include <vector>
 
 namespace gfx
 {
 
+// threading model:
+//  - the Device functions can be called from any thread, submits are serialized in the order they are called
+//  - pools, command buffers and upload rings are not synchronized, each one must be used by one thread at a time.
+//    N threads can record N command buffers from N pools in parallel (see PerThreadPools) and submit them
+//    together with a single submitCommandBuffers call, the command buffers are executed in the order of the vector
+//  - a command buffer can use resources used by command buffers recorded on other threads, the synchronization
+//    between them is resolved at submit time
+//  - with Descriptor::submissionThread, submitCommandBuffers only enqueue the command buffers and the
+//    synchronization is resolved by a device thread. waits never block the submits
 class Device
 {
 public:
     struct Descriptor
     {
         QueueCapabilities queueCaps;
+        // submit the command buffers of the QueueType::compute pools to a second queue so compute overlap graphics.
+        // the graphics queue is used when the device does not have a second compute capable queue
+        bool asyncCompute = false;
+        // submit the command buffers of the QueueType::transfer pools to a transfer only queue so uploads overlap rendering.
+        // the graphics queue is used when the device does not have a dedicated transfer queue family
+        bool asyncTransfer = false;
+        // submitCommandBuffers push the command buffers in a queue and return, a device thread resolve the synchronization,
+        // submit and present them in order. an error of the thread is thrown by the next submit or wait (vulkan only),
+        // call waitIdle() before destroying the device to get the last one
+        bool submissionThread = false;
+        // the synchronization is resolved by submitCommandBuffers but the command buffers are only given to the driver
+        // by flushSubmits (typically once per frame), presents and waits. every queue get a single vkQueueSubmit2 (vulkan only)
+        bool deferredSubmits = false;
+        // the vulkan objects of the destroyed resources are destroyed by a device thread instead of the next submits (vulkan only)
+        bool backgroundDestruction = false;
+        // if not empty, compiled pipelines are loaded from this file at creation and saved to it at destruction.
+        // an incompatible file is ignored, a failed save at destruction too (savePipelineCache() throw the error)
+        std::filesystem::path pipelineCachePath = {};
         auto operator<=>(const Descriptor&) const = default;
     };
 
+    struct PipelineCacheStatistics
+    {
+        uint32_t hitCount = 0;
+        uint32_t missCount = 0;
+        std::chrono::nanoseconds hitDuration{0};
+        std::chrono::nanoseconds missDuration{0};
+        auto operator<=>(const PipelineCacheStatistics&) const = default;
+    };
+
+    struct SubmitStatistics
+    {
+        uint32_t submitCount = 0;
+        // from the submitCommandBuffers call to the handoff of its command buffers to the driver,
+        // include the time spent in the queue of the submission thread
+        std::chrono::nanoseconds totalLatency{0};
+        std::chrono::nanoseconds maxLatency{0};
+        auto operator<=>(const SubmitStatistics&) const = default;
+    };
+
+    // the vulkan objects of destroyed buffers, textures, samplers, pipelines and parameter block pools are only
+    // destroyed once every submit done before is completed. the counters are since the creation of the device,
+    // the difference between two frames give the objects freed during the frame
+    struct DestructionStatistics
+    {
+        uint32_t pendingCount = 0; // destroyed resources waiting for the gpu
+        uint32_t freedCount = 0;
+        auto operator<=>(const DestructionStatistics&) const = default;
+    };
+
 public:
     Device(const Device&) = delete;
     Device(Device&&) = delete;
 
     virtual Backend backend() const = 0;
+    // CommandBuffer::drawIndirectCount and drawIndexedIndirectCount can be used
+    virtual bool supportsDrawIndirectCount() const = 0;
+    // Swapchain::waitPresents wait for the display instead of the end of the rendering
+    virtual bool supportsPresentWait() const = 0;
 
     virtual std::unique_ptr<Swapchain> newSwapchain(const Swapchain::Descriptor&) const = 0;
     virtual std::unique_ptr<ShaderLib> newShaderLib(const std::filesystem::path&) const = 0;
     virtual std::unique_ptr<ParameterBlockLayout> newParameterBlockLayout(const ParameterBlockLayout::Descriptor&) const = 0;
     virtual std::unique_ptr<GraphicsPipeline> newGraphicsPipeline(const GraphicsPipeline::Descriptor&) const = 0;
+    // compiled on worker threads, the shader functions of the descriptors must outlive the returned futures.
+    // a batch is split in at most a few groups of at least 8 pipelines, each group is compiled by a single driver call
+    // and an error fail every pipeline of its group
+    virtual GraphicsPipelineFuture newGraphicsPipelineAsync(const GraphicsPipeline::Descriptor&) const = 0;
+    virtual std::vector<GraphicsPipelineFuture> newGraphicsPipelines(std::span<const GraphicsPipeline::Descriptor>) const = 0;
+    // return the living pipeline created from an equivalent descriptor if there is one, a new pipeline otherwise.
+    // shaders are compared by code and entry point, so pipelines are shared between shader libs loaded from the same file
+    virtual std::shared_ptr<GraphicsPipeline> sharedGraphicsPipeline(const GraphicsPipeline::Descriptor&) const = 0;
+    virtual std::unique_ptr<ComputePipeline> newComputePipeline(const ComputePipeline::Descriptor&) const = 0;
     virtual std::unique_ptr<Buffer> newBuffer(const Buffer::Descriptor&) const = 0;
     virtual std::unique_ptr<Texture> newTexture(const Texture::Descriptor&) const = 0;
-    virtual std::unique_ptr<CommandBufferPool> newCommandBufferPool() const = 0;
+    // command buffers submitted to different queues are ordered through the resources they share
+    virtual std::unique_ptr<CommandBufferPool> newCommandBufferPool(QueueType) const = 0;
+    inline std::unique_ptr<CommandBufferPool> newCommandBufferPool() const { return newCommandBufferPool(QueueType::graphics); }
+    // command buffer recorded once and submitted any number of times, for the content identical every frame.
+    // the recording end at the first submit, the barriers it need are computed again at each submit.
+    // the resources it use are kept alive as long as it is, it cannot present drawables.
+    // not supported by the metal backend
+    virtual std::shared_ptr<CommandBuffer> newReusableCommandBuffer(QueueType) const = 0;
+    inline std::shared_ptr<CommandBuffer> newReusableCommandBuffer() const { return newReusableCommandBuffer(QueueType::graphics); }
     virtual std::unique_ptr<ParameterBlockPool> newParameterBlockPool(const ParameterBlockPool::Descriptor&) const = 0;
     virtual std::unique_ptr<Sampler> newSampler(const Sampler::Descriptor&) const = 0;
+    virtual std::unique_ptr<UploadRing> newUploadRing(const UploadRing::Descriptor&) const = 0;
+
+    virtual PipelineCacheStatistics pipelineCacheStatistics() const = 0;
+    virtual void savePipelineCache() const = 0;
+
+    virtual SubmitStatistics submitStatistics() const = 0;
+    virtual DestructionStatistics destructionStatistics() const = 0;
 
 #if defined(GFX_IMGUI_ENABLED)
     virtual void imguiInit(std::vector<PixelFormat> colorAttachmentPxFormats, std::optional<PixelFormat> depthAttachmentPxFormat = std::nullopt) const = 0;
@@ -63,10 +153,23 @@ public:
 
     virtual void submitCommandBuffers(const std::shared_ptr<CommandBuffer>&) = 0;
     virtual void submitCommandBuffers(const std::vector<std::shared_ptr<CommandBuffer>>&) = 0;
+    // give the deferred submits to the driver, nothing to do without Descriptor::deferredSubmits
+    virtual void flushSubmits() = 0;
 
     virtual void waitCommandBuffer(const CommandBuffer&) = 0;
+    // return false if the timeout expire before the command buffer is completed
+    virtual bool waitCommandBuffer(const CommandBuffer&, std::chrono::nanoseconds timeout) = 0;
     virtual void waitIdle() = 0;
 
+    // the tickets of every queue can be checked and waited, a deferred submit is flushed by the wait
+    virtual bool isCompleted(const SubmitTicket&) const = 0;
+    virtual bool waitSubmit(const SubmitTicket&, std::chrono::nanoseconds timeout) = 0;
+    // the handler is called by a device thread once the submit is completed, handlers are not ordered between them.
+    // it is called even if the ticket is already completed, and must not destroy the device. an exception of the
+    // handler is thrown by the next submit or wait (vulkan only). the handlers still waiting when the device is destroyed are
+    // called by the destructor, including the ones of tickets that were never submitted
+    virtual void addCompletedHandler(const SubmitTicket&, std::function<void()>) = 0;
+
     virtual ~Device() = default;
 
 protected:
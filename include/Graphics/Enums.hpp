@@ -101,7 +101,9 @@ enum class PixelFormat : uint8_t
 enum class PresentMode : uint8_t
 {
     fifo,
-    mailbox
+    mailbox,
+    immediate,  // no vsync, lowest latency but the frames can tear
+    fifoRelaxed // vsync, a late frame is presented immediately instead of waiting the next vblank
 };
 
 enum class LoadAction : uint8_t
@@ -110,6 +112,13 @@ enum class LoadAction : uint8_t
     clear
 };
 
+// commands of a render pass are recorded in the command buffer itself or in secondary command buffers, not both
+enum class RenderPassContents : uint8_t
+{
+    inlined,
+    secondaryCommandBuffers
+};
+
 enum class BlendOperation : uint8_t
 {
     blendingOff,
@@ -121,10 +130,17 @@ enum class VertexAttributeFormat : uint8_t
 {
     float2,
     float3,
+    float4,
     uchar4,
     uint
 };
 
+enum class VertexStepFunction : uint8_t
+{
+    perVertex,
+    perInstance
+};
+
 enum class BufferUsage : uint8_t
 {
     vertexBuffer     = 1 << 0,
@@ -132,7 +148,8 @@ enum class BufferUsage : uint8_t
     constantBuffer   = 1 << 2,
     structuredBuffer = 1 << 3,
     copySource       = 1 << 4,
-    copyDestination  = 1 << 5
+    copyDestination  = 1 << 5,
+    indirectBuffer   = 1 << 6
 };
 GFX_ENABLE_BITMASK_OPERATORS(BufferUsage);
 using BufferUsages = Flags<BufferUsage>;
@@ -141,6 +158,7 @@ enum class ResourceStorageMode : uint8_t
 {
     deviceLocal,
     hostVisible,
+    readback, // host cached, for the buffers the gpu copy into and the cpu read
 };
 
 enum class Backend : uint8_t
@@ -157,7 +175,8 @@ enum class BindingType : uint8_t
     constantBuffer,
     structuredBuffer,
     sampledTexture,
-    sampler
+    sampler,
+    storageTexture // read and written without a sampler, need TextureUsage::shaderWrite
 };
 
 enum class BindingUsage : uint8_t
@@ -165,7 +184,9 @@ enum class BindingUsage : uint8_t
     vertexRead    = 1 << 1,
     vertexWrite   = 1 << 2,
     fragmentRead  = 1 << 3,
-    fragmentWrite = 1 << 4
+    fragmentWrite = 1 << 4,
+    computeRead   = 1 << 5,
+    computeWrite  = 1 << 6
 };
 GFX_ENABLE_BITMASK_OPERATORS(BindingUsage);
 using BindingUsages = Flags<BindingUsage>;
@@ -175,7 +196,9 @@ enum class TextureUsage : uint8_t
     shaderRead             = 1 << 0,
     colorAttachment        = 1 << 1,
     depthStencilAttachment = 1 << 2,
-    copyDestination        = 1 << 3
+    copyDestination        = 1 << 3,
+    shaderWrite            = 1 << 4,
+    copySource             = 1 << 5
 };
 GFX_ENABLE_BITMASK_OPERATORS(TextureUsage);
 using TextureUsages = Flags<TextureUsage>;
@@ -206,6 +229,20 @@ enum class CullMode : uint8_t
     back
 };
 
+// queue the command buffers of a pool are submitted to
+enum class QueueType : uint8_t
+{
+    graphics,
+    compute,
+    transfer // blit passes only
+};
+
+enum class IndexType : uint8_t
+{
+    uint16,
+    uint32
+};
+
 constexpr inline size_t pixelFormatSize(PixelFormat format)
 {
     switch (format)
@@ -220,6 +257,19 @@ constexpr inline size_t pixelFormatSize(PixelFormat format)
     }
 }
 
+constexpr inline size_t indexTypeSize(IndexType type)
+{
+    switch (type)
+    {
+    case IndexType::uint16:
+        return 2;
+    case IndexType::uint32:
+        return 4;
+    default:
+        throw std::runtime_error("not implemented");
+    }
+}
+
 } // namespace gfx
 
 #endif // GFX_ENUMS_HPP
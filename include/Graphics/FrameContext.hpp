@@ -0,0 +1,111 @@
+/*
+ * ---------------------------------------------------
+ * FrameContext.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 21:48:27
+ * ---------------------------------------------------
+ */
+
+#ifndef FRAMECONTEXT_HPP
+#define FRAMECONTEXT_HPP
+
+#include "Graphics/CommandBuffer.hpp"
+#include "Graphics/ParameterBlockPool.hpp"
+#include "Graphics/PerThreadPools.hpp"
+#include "Graphics/UploadRing.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace gfx
+{
+
+class Device;
+
+// the resources of the frames in flight: per thread command buffer and parameter block pools for each frame,
+// and an upload ring for the transient data of every frame. beginFrame wait for the gpu to be done with
+// the last use of the frame resources and reset them, so nothing got during a frame must be kept after it
+class FrameContext
+{
+public:
+    struct Descriptor
+    {
+        uint32_t frameInFlightCount = 3;
+        PerThreadPools::Descriptor pools;
+        std::optional<UploadRing::Descriptor> uploadRing; // no upload ring if not set
+        auto operator<=>(const Descriptor&) const = default;
+    };
+
+    struct Statistics
+    {
+        uint32_t frameCount = 0;
+        // time beginFrame spent waiting for the gpu
+        std::chrono::nanoseconds lastWaitDuration{0};
+        std::chrono::nanoseconds totalWaitDuration{0};
+        std::chrono::nanoseconds maxWaitDuration{0};
+        auto operator<=>(const Statistics&) const = default;
+    };
+
+public:
+    FrameContext() = delete;
+    FrameContext(const FrameContext&) = delete;
+    FrameContext(FrameContext&&) = delete;
+
+    FrameContext(Device&, const Descriptor&);
+
+    void beginFrame();
+
+    // command buffer of the current frame from the pool of the calling thread, the frame wait for all of them
+    std::shared_ptr<CommandBuffer> get();
+    ParameterBlockPool& parameterBlockPool();
+    UploadRing& uploadRing(); // only used by one thread at a time
+
+    void endFrame();
+
+    // must be called outside of a frame, the frames removed are waited. the next frames are the new ones
+    // when the count grow, so the frame indices are not kept
+    void setFrameInFlightCount(uint32_t);
+    inline uint32_t frameInFlightCount() const { return static_cast<uint32_t>(m_frames.size()); }
+    // index of the current frame, for the per frame data of the application
+    inline uint32_t frameIndex() const { return m_frameIndex; }
+
+    inline Statistics statistics() const { return m_statistics; }
+
+    // wait for every frame
+    ~FrameContext();
+
+private:
+    struct Frame
+    {
+        std::unique_ptr<PerThreadPools> pools;
+        std::vector<std::shared_ptr<CommandBuffer>> commandBuffers; // got during the frame, their last submit of each queue is waited
+    };
+
+    Device* m_device;
+    Descriptor m_descriptor;
+
+    std::vector<Frame> m_frames;
+    uint32_t m_frameIndex = 0;
+    bool m_isInFrame = false;
+    std::mutex m_commandBuffersMtx; // get can be called by several threads
+
+    std::unique_ptr<UploadRing> m_uploadRing;
+
+    Statistics m_statistics;
+
+    Frame newFrame() const;
+    void waitFrame(Frame&);
+
+public:
+    FrameContext& operator=(const FrameContext&) = delete;
+    FrameContext& operator=(FrameContext&&) = delete;
+};
+
+} // namespace gfx
+
+#endif // FRAMECONTEXT_HPP
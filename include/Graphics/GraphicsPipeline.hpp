@@ -18,6 +18,7 @@
 #include <vector>
 #include <optional>
 #include <memory>
+#include <future>
 
 namespace gfx
 {
@@ -57,6 +58,9 @@ public:
     GraphicsPipeline& operator=(GraphicsPipeline&&) = delete;
 };
 
+// handle to a pipeline compiled in the background, get() block until the compilation is done
+using GraphicsPipelineFuture = std::shared_future<std::shared_ptr<GraphicsPipeline>>;
+
 } // namespace gfx
 
 #endif // GRAPHICSPIPELINE_HPP
@@ -29,7 +29,10 @@ public:
 
     virtual std::shared_ptr<ParameterBlockLayout> layout() const = 0;
 
-    virtual void setBinding(uint32_t idx, const std::shared_ptr<Buffer>&) = 0;
+    // the offset must respect the constant/structured buffer offset alignment of the device (256 bytes is always enough)
+    virtual void setBinding(uint32_t idx, const std::shared_ptr<Buffer>&, size_t offset, size_t size) = 0;
+    inline void setBinding(uint32_t idx, const std::shared_ptr<Buffer>& buffer) { setBinding(idx, buffer, 0, buffer->size()); }
+    inline void setBinding(uint32_t idx, const BufferSlice& slice) { setBinding(idx, slice.buffer, slice.offset, slice.size); }
 
     virtual void setBinding(uint32_t idx, const std::shared_ptr<Texture>&) = 0;
     virtual void setBinding(uint32_t idx, uint32_t arrayIndex, const std::shared_ptr<Texture>&) = 0;
@@ -34,6 +34,7 @@ public:
     ParameterBlockPool(const ParameterBlockPool&) = delete;
     ParameterBlockPool(ParameterBlockPool&&) = delete;
 
+    // not synchronized, same as CommandBufferPool
     virtual std::shared_ptr<ParameterBlock> get(const std::shared_ptr<ParameterBlockLayout>&) = 0;
     virtual void reset() = 0;
 
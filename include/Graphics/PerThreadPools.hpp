@@ -0,0 +1,88 @@
+/*
+ * ---------------------------------------------------
+ * PerThreadPools.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 18:42:05
+ * ---------------------------------------------------
+ */
+
+#ifndef PERTHREADPOOLS_HPP
+#define PERTHREADPOOLS_HPP
+
+#include "Graphics/CommandBufferPool.hpp"
+#include "Graphics/Enums.hpp"
+#include "Graphics/ParameterBlockPool.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace gfx
+{
+
+class Device;
+
+// a CommandBufferPool (and optionally a ParameterBlockPool) for each thread that record command buffers,
+// created the first time the thread use them. typically one instance per frame in flight, reset once the
+// command buffers of the frame are completed. the pools of the calling thread can be used concurrently with
+// the pools of the other threads, reset() must not be called while a thread is using its pools.
+// the pools of a finished thread are destroyed by the next reset(), a new thread always get new pools
+class PerThreadPools
+{
+public:
+    struct Descriptor
+    {
+        QueueType queueType = QueueType::graphics;
+        std::optional<ParameterBlockPool::Descriptor> parameterBlockPool; // no parameter block pools if not set
+        auto operator<=>(const Descriptor&) const = default;
+    };
+
+public:
+    PerThreadPools() = delete;
+    PerThreadPools(const PerThreadPools&) = delete;
+    PerThreadPools(PerThreadPools&&) = delete;
+
+    PerThreadPools(const Device&, const Descriptor&);
+
+    // pools of the calling thread
+    CommandBufferPool& commandBufferPool();
+    ParameterBlockPool& parameterBlockPool();
+
+    inline std::shared_ptr<CommandBuffer> get() { return commandBufferPool().get(); }
+
+    // reset the pools of every thread and destroy the ones of the finished threads
+    void reset();
+
+    // threads with pools, including the finished ones until the next reset()
+    size_t threadCount() const;
+
+    ~PerThreadPools() = default;
+
+private:
+    struct ThreadPools
+    {
+        std::unique_ptr<CommandBufferPool> commandBufferPool;
+        std::unique_ptr<ParameterBlockPool> parameterBlockPool;
+        std::weak_ptr<const void> thread; // expire when the thread is finished
+    };
+
+    ThreadPools& threadPools();
+
+    const Device* m_device;
+    Descriptor m_descriptor;
+
+    // the lock is only held to find the pools of a thread, the pools are not shared
+    mutable std::mutex m_mtx;
+    std::unordered_map<uint64_t, ThreadPools> m_threadPools; // keyed by a thread key never reused, unlike std::thread::id
+
+public:
+    PerThreadPools& operator=(const PerThreadPools&) = delete;
+    PerThreadPools& operator=(PerThreadPools&&) = delete;
+};
+
+} // namespace gfx
+
+#endif // PERTHREADPOOLS_HPP
@@ -0,0 +1,104 @@
+/*
+ * ---------------------------------------------------
+ * ReadbackRing.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 23:58:16
+ * ---------------------------------------------------
+ */
+
+#ifndef READBACKRING_HPP
+#define READBACKRING_HPP
+
+#include "Graphics/Buffer.hpp"
+#include "Graphics/CommandBuffer.hpp"
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace gfx
+{
+
+class Device;
+
+// fixed number of slots in a ResourceStorageMode::readback buffer, to stream gpu results (captures, test images...) to the cpu
+// without waiting for the gpu. a slot is acquired, written by copies recorded in a command buffer, committed with the ticket
+// of its submit, then read and released in acquisition order once the submit is completed.
+// when every slot is in use acquire fail and the readback is dropped instead of stalling.
+// a ring is not thread safe
+class ReadbackRing
+{
+public:
+    struct Descriptor
+    {
+        size_t slotSize = 0; // rounded up to slotAlignment
+        uint32_t slotCount = 3;
+        auto operator<=>(const Descriptor&) const = default;
+    };
+
+    struct Statistics
+    {
+        uint32_t readCount = 0; // released slots
+        uint32_t droppedCount = 0; // failed acquire
+        auto operator<=>(const Statistics&) const = default;
+    };
+
+    // valid copy offset for every pixel format
+    static constexpr size_t slotAlignment = 256;
+
+public:
+    ReadbackRing() = delete;
+    ReadbackRing(const ReadbackRing&) = delete;
+    ReadbackRing(ReadbackRing&&) = delete;
+
+    ReadbackRing(Device&, const Descriptor&);
+
+    // nullopt if no slot is available
+    std::optional<BufferSlice> acquire();
+    // the slots acquired since the last commit are written by the submit of the ticket
+    void commit(const SubmitTicket&);
+
+    // oldest committed slot if its submit is completed, nullopt otherwise. never block.
+    // the slot is not reused until it is released
+    std::optional<BufferSlice> tryRead() const;
+    void release();
+
+    inline uint32_t slotCount() const { return static_cast<uint32_t>(m_slots.size()); }
+    inline Statistics statistics() const { return m_statistics; }
+
+    ~ReadbackRing() = default;
+
+private:
+    enum class SlotState : uint8_t
+    {
+        available,
+        acquired,
+        committed
+    };
+
+    struct Slot
+    {
+        BufferSlice slice;
+        SubmitTicket ticket;
+        SlotState state = SlotState::available;
+    };
+
+    Device* m_device;
+    std::vector<Slot> m_slots;
+    uint32_t m_oldestSlot = 0;
+    uint32_t m_usedSlotCount = 0; // the used slots follow the oldest one
+
+    Statistics m_statistics;
+
+public:
+    ReadbackRing& operator=(const ReadbackRing&) = delete;
+    ReadbackRing& operator=(ReadbackRing&&) = delete;
+};
+
+} // namespace gfx
+
+#endif // READBACKRING_HPP
@@ -15,6 +15,8 @@
 #include "Graphics/Drawable.hpp"
 #include "Graphics/Texture.hpp"
 
+#include <chrono>
+#include <compare>
 #include <cstdint>
 #include <memory>
 
@@ -35,6 +37,15 @@ public:
         auto operator<=>(const Descriptor&) const = default;
     };
 
+    // updated by nextDrawable and waitPresents
+    struct FrameStatistics
+    {
+        std::chrono::nanoseconds acquireDuration{0}; // time blocked in the last nextDrawable
+        std::chrono::nanoseconds presentToDisplayDuration{0}; // of the last present known to be displayed, zero without Device::supportsPresentWait
+        uint32_t queueDepth = 0; // presents queued and not displayed yet (not rendered yet without Device::supportsPresentWait)
+        auto operator<=>(const FrameStatistics&) const = default;
+    };
+
 public:
     Swapchain(const Swapchain&) = delete;
     Swapchain(Swapchain&&) = delete;
@@ -42,7 +53,19 @@ public:
     // descriptor used to create textures for drawables
     virtual const Texture::Descriptor& drawablesTextureDescriptor() const = 0;
 
-    virtual std::shared_ptr<Drawable> nextDrawable() = 0;
+    // return nullptr if no image is available before the timeout (0 does not block) or if the swapchain is out of date
+    virtual std::shared_ptr<Drawable> nextDrawable(std::chrono::nanoseconds timeout) = 0;
+    inline std::shared_ptr<Drawable> nextDrawable() { return nextDrawable(std::chrono::nanoseconds::max()); }
+
+    // the surface changed, nextDrawable return nullptr until the swapchain is recreated
+    virtual bool isOutOfDate() const = 0;
+
+    // wait until at most maxPendingPresents of the queued presents are not displayed, 0 wait the last one.
+    // without Device::supportsPresentWait the end of their rendering is waited instead. return false on timeout
+    virtual bool waitPresents(uint32_t maxPendingPresents, std::chrono::nanoseconds timeout) = 0;
+    inline bool waitPresents(uint32_t maxPendingPresents) { return waitPresents(maxPendingPresents, std::chrono::nanoseconds::max()); }
+
+    virtual FrameStatistics frameStatistics() const = 0;
 
     virtual ~Swapchain() = default;
 
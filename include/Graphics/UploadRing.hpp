@@ -0,0 +1,70 @@
+/*
+ * ---------------------------------------------------
+ * UploadRing.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 18:04:51
+ * ---------------------------------------------------
+ */
+
+#ifndef UPLOADRING_HPP
+#define UPLOADRING_HPP
+
+#include "Graphics/Buffer.hpp"
+#include "Graphics/Enums.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gfx
+{
+
+// linear allocator of transient data (per frame constants, staging data, dynamic vertices...).
+// slices are sub-allocated from a few large persistently mapped buffers, a buffer is reused
+// once the gpu is done with it and no slice of it is alive anymore.
+// a ring is not thread safe, use one ring per recording thread
+class UploadRing
+{
+public:
+    struct Descriptor
+    {
+        size_t blockSize = static_cast<size_t>(4 * 1024 * 1024); // allocation larger than a block get their own buffer
+        BufferUsages usages = BufferUsage::vertexBuffer | BufferUsage::indexBuffer | BufferUsage::constantBuffer | BufferUsage::copySource;
+
+        auto operator<=>(const Descriptor&) const = default;
+    };
+
+    // largest minUniformBufferOffsetAlignment allowed by vulkan, also valid for vertex, index and copy offsets
+    static constexpr size_t defaultAlignment = 256;
+
+public:
+    UploadRing(const UploadRing&) = delete;
+    UploadRing(UploadRing&&) = delete;
+
+    // alignment must be a power of two
+    virtual BufferSlice allocate(size_t size, size_t alignment = defaultAlignment) = 0;
+
+    inline BufferSlice upload(const void* data, size_t size, size_t alignment = defaultAlignment)
+    {
+        BufferSlice slice = allocate(size, alignment);
+        slice.setContent(data, size);
+        return slice;
+    }
+    inline BufferSlice upload(const auto& data) { return upload(&data, sizeof(data)); }
+
+    // number of buffers created by the ring, stop growing once the ring is large enough for the frames in flight
+    virtual uint32_t blockCount() const = 0;
+
+    virtual ~UploadRing() = default;
+
+protected:
+    UploadRing() = default;
+
+public:
+    UploadRing& operator=(const UploadRing&) = delete;
+    UploadRing& operator=(UploadRing&&) = delete;
+};
+
+} // namespace gfx
+
+#endif // UPLOADRING_HPP
@@ -13,6 +13,7 @@
 #include "Graphics/Enums.hpp"
 
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace gfx
@@ -22,15 +23,21 @@ struct VertexAttribute
 {
     VertexAttributeFormat format;
     size_t offset;
-    // bufferIndex
+    uint32_t bufferIndex = 0; // index of the VertexBufferLayout, attribute locations are the attribute index
     auto operator<=>(const VertexAttribute&) const = default;
 };
 
-struct VertexLayout
+struct VertexBufferLayout
 {
     size_t stride;
-    // stepFunction
-    // stepRate
+    VertexStepFunction stepFunction = VertexStepFunction::perVertex;
+    uint32_t stepRate = 1; // perInstance only, number of instances using the same element
+    auto operator<=>(const VertexBufferLayout&) const = default;
+};
+
+struct VertexLayout
+{
+    std::vector<VertexBufferLayout> buffers; // buffer i is bound with useVertexBuffer(..., i)
     std::vector<VertexAttribute> attributes;
 
     auto operator<=>(const VertexLayout&) const = default;
@@ -0,0 +1,125 @@
+/*
+ * ---------------------------------------------------
+ * FrameContext.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 22:03:54
+ * ---------------------------------------------------
+ */
+
+#include "Graphics/FrameContext.hpp"
+#include "Graphics/Device.hpp"
+
+namespace gfx
+{
+
+FrameContext::FrameContext(Device& device, const Descriptor& descriptor)
+    : m_device(&device), m_descriptor(descriptor)
+{
+    assert(descriptor.frameInFlightCount > 0);
+    for (uint32_t i = 0; i < descriptor.frameInFlightCount; i++)
+        m_frames.push_back(newFrame());
+    m_frameIndex = descriptor.frameInFlightCount - 1; // the first beginFrame use the frame 0
+    if (descriptor.uploadRing.has_value())
+        m_uploadRing = m_device->newUploadRing(*descriptor.uploadRing);
+}
+
+void FrameContext::beginFrame()
+{
+    ZoneScoped;
+    assert(m_isInFrame == false);
+    m_frameIndex = (m_frameIndex + 1) % frameInFlightCount();
+    Frame& frame = m_frames[m_frameIndex];
+
+    const auto waitStart = std::chrono::steady_clock::now();
+    waitFrame(frame);
+    const auto waitDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - waitStart);
+
+    frame.pools->reset();
+    frame.commandBuffers.clear();
+
+    m_statistics.frameCount++;
+    m_statistics.lastWaitDuration = waitDuration;
+    m_statistics.totalWaitDuration += waitDuration;
+    m_statistics.maxWaitDuration = std::max(m_statistics.maxWaitDuration, waitDuration);
+    m_isInFrame = true;
+}
+
+std::shared_ptr<CommandBuffer> FrameContext::get()
+{
+    assert(m_isInFrame);
+    Frame& frame = m_frames[m_frameIndex];
+    std::shared_ptr<CommandBuffer> commandBuffer = frame.pools->get();
+    std::scoped_lock lock(m_commandBuffersMtx);
+    frame.commandBuffers.push_back(commandBuffer);
+    return commandBuffer;
+}
+
+ParameterBlockPool& FrameContext::parameterBlockPool()
+{
+    assert(m_isInFrame);
+    return m_frames[m_frameIndex].pools->parameterBlockPool();
+}
+
+UploadRing& FrameContext::uploadRing()
+{
+    if (m_uploadRing == nullptr)
+        throw std::runtime_error("FrameContext created without upload ring descriptor");
+    return *m_uploadRing;
+}
+
+void FrameContext::endFrame()
+{
+    assert(m_isInFrame);
+    m_isInFrame = false;
+}
+
+void FrameContext::setFrameInFlightCount(uint32_t count)
+{
+    assert(m_isInFrame == false);
+    assert(count > 0);
+    // oldest frame first, the current one last
+    std::ranges::rotate(m_frames, m_frames.begin() + m_frameIndex + 1);
+    if (count < m_frames.size()) {
+        const auto removedCount = static_cast<std::ptrdiff_t>(m_frames.size() - count);
+        for (auto it = m_frames.begin(); it != m_frames.begin() + removedCount; ++it)
+            waitFrame(*it);
+        m_frames.erase(m_frames.begin(), m_frames.begin() + removedCount);
+    }
+    else {
+        // the new frames are used first, they have nothing to wait
+        std::vector<Frame> newFrames;
+        for (size_t i = m_frames.size(); i < count; i++)
+            newFrames.push_back(newFrame());
+        m_frames.insert(m_frames.begin(), std::make_move_iterator(newFrames.begin()), std::make_move_iterator(newFrames.end()));
+    }
+    m_frameIndex = count - 1;
+    m_descriptor.frameInFlightCount = count;
+}
+
+FrameContext::~FrameContext()
+{
+    for (Frame& frame : m_frames)
+        waitFrame(frame);
+}
+
+FrameContext::Frame FrameContext::newFrame() const
+{
+    return Frame{ .pools = std::make_unique<PerThreadPools>(*m_device, m_descriptor.pools), .commandBuffers = {} };
+}
+
+void FrameContext::waitFrame(Frame& frame)
+{
+    // the submits of a queue are completed in order, only the last one of each queue type is waited
+    constexpr size_t queueTypeCount = 3;
+    std::array<SubmitTicket, queueTypeCount> lastTickets = {};
+    for (const std::shared_ptr<CommandBuffer>& commandBuffer : frame.commandBuffers) {
+        const SubmitTicket ticket = commandBuffer->submitTicket();
+        SubmitTicket& lastTicket = lastTickets.at(static_cast<size_t>(ticket.queueType));
+        lastTicket = std::max(lastTicket, ticket);
+    }
+    for (const SubmitTicket& ticket : lastTickets)
+        m_device->waitSubmit(ticket, std::chrono::nanoseconds::max());
+}
+
+} // namespace gfx
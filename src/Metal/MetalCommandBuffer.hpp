@@ -18,6 +18,7 @@
 
 #include "Metal/MetalBuffer.hpp"
 #include "Metal/MetalGraphicsPipeline.hpp"
+#include "Metal/MetalComputePipeline.hpp"
 #include "Metal/MetalParameterBlock.hpp"
 #include "Metal/MetalTexture.hpp"
 #include "Metal/MetalSampler.hpp"
@@ -40,16 +41,28 @@ public:
 
     MetalCommandBuffer(const id<MTLCommandQueue>&);
 
-    void beginRenderPass(const Framebuffer&) override;
+    using CommandBuffer::beginRenderPass;
+    void beginRenderPass(const Framebuffer&, RenderPassContents) override;
 
+    std::shared_ptr<CommandBuffer> newSecondaryCommandBuffer() override;
+
+    using CommandBuffer::usePipeline;
     void usePipeline(const std::shared_ptr<const GraphicsPipeline>&) override;
-    void useVertexBuffer(const std::shared_ptr<Buffer>&) override;
+    using CommandBuffer::useVertexBuffer;
+    void useVertexBuffer(const std::shared_ptr<Buffer>&, size_t offset, uint32_t bufferIndex) override;
 
     void setParameterBlock(const std::shared_ptr<const ParameterBlock>&, uint32_t index) override;
     void setPushConstants(const void* data, size_t size) override;
 
-    void drawVertices(uint32_t start, uint32_t count) override;
-    void drawIndexedVertices(const std::shared_ptr<Buffer>& idxBuffer) override;
+    using CommandBuffer::drawVertices;
+    void drawVertices(uint32_t start, uint32_t count, uint32_t instanceCount, uint32_t firstInstance) override;
+    using CommandBuffer::drawIndexedVertices;
+    void drawIndexedVertices(const std::shared_ptr<Buffer>& idxBuffer, IndexType, uint32_t indexCount, uint32_t firstIndex = 0, int32_t vertexOffset = 0, uint32_t instanceCount = 1, uint32_t firstInstance = 0) override;
+
+    void drawIndirect(const std::shared_ptr<Buffer>& indirectBuffer, size_t offset, uint32_t drawCount = 1) override;
+    void drawIndexedIndirect(const std::shared_ptr<Buffer>& idxBuffer, IndexType, const std::shared_ptr<Buffer>& indirectBuffer, size_t offset, uint32_t drawCount = 1) override;
+    void drawIndirectCount(const std::shared_ptr<Buffer>& indirectBuffer, size_t offset, const std::shared_ptr<Buffer>& countBuffer, size_t countOffset, uint32_t maxDrawCount) override;
+    void drawIndexedIndirectCount(const std::shared_ptr<Buffer>& idxBuffer, IndexType, const std::shared_ptr<Buffer>& indirectBuffer, size_t offset, const std::shared_ptr<Buffer>& countBuffer, size_t countOffset, uint32_t maxDrawCount) override;
 
 #if defined(GFX_IMGUI_ENABLED)
     void imGuiRenderDrawData(ImDrawData*) const override;
@@ -58,10 +71,24 @@ public:
     void endRenderPass() override;
 
 
+    void beginComputePass() override;
+
+    void usePipeline(const std::shared_ptr<const ComputePipeline>&) override;
+
+    void dispatch(uint32_t x, uint32_t y = 1, uint32_t z = 1) override;
+    void dispatchIndirect(const std::shared_ptr<Buffer>& indirectBuffer, size_t offset) override;
+
+    void endComputePass() override;
+
+
     void beginBlitPass() override;
 
-    void copyBufferToBuffer(const std::shared_ptr<Buffer>& src, const std::shared_ptr<Buffer>& dst, size_t size) override;
+    using CommandBuffer::copyBufferToBuffer;
+    void copyBufferToBuffer(const std::shared_ptr<Buffer>& src, size_t srcOffset, const std::shared_ptr<Buffer>& dst, size_t dstOffset, size_t size) override;
+    using CommandBuffer::copyBufferToTexture;
     void copyBufferToTexture(const std::shared_ptr<Buffer>& buffer, size_t bufferOffset, const std::shared_ptr<Texture>& texture, uint32_t layerIndex = 0) override;
+    using CommandBuffer::copyTextureToBuffer;
+    void copyTextureToBuffer(const std::shared_ptr<Texture>& texture, const std::shared_ptr<Buffer>& buffer, size_t bufferOffset, uint32_t layerIndex = 0) override;
 
     void endBlitPass() override;
 
@@ -70,6 +97,12 @@ public:
 
     void addSampledTexture(const std::shared_ptr<Texture>&) override;
 
+    inline Statistics statistics() const override { return Statistics{}; } // metal track the hazards itself, no barrier is recorded
+
+    // every submit go to the same queue
+    inline SubmitTicket submitTicket() const override { return SubmitTicket{ .value = m_signaledSharedEventValue, .queueType = QueueType::graphics }; }
+    bool isCompleted() const override;
+
 
     inline id<MTLCommandBuffer> mtlCommandBuffer() const { return m_mtlCommandBuffer; }
     inline id<MTLCommandEncoder> commandEncoder() const { return m_commandEncoder; }
@@ -84,6 +117,8 @@ private:
     id<MTLCommandEncoder> m_commandEncoder = nil;
 
     std::set<std::shared_ptr<const MetalGraphicsPipeline>> m_usedPipelines;
+    std::set<std::shared_ptr<const MetalComputePipeline>> m_usedComputePipelines;
+    const MetalComputePipeline* m_boundComputePipeline = nullptr; // metal takes the threadgroup size at dispatch
 
     std::set<std::shared_ptr<MetalTexture>> m_usedTextures;
     std::set<std::shared_ptr<MetalBuffer>> m_usedBuffers;
@@ -91,6 +126,10 @@ private:
 
     std::set<std::shared_ptr<const MetalParameterBlock>> m_usedPBlock;
 
+    // render command encoders of a parallel encoder, kept alive with the resources they use until the command buffer is done
+    std::vector<std::shared_ptr<MetalCommandBuffer>> m_secondaries;
+    size_t m_passFirstSecondary = 0;
+
     uint64_t m_signaledSharedEventValue = 0;
 
 public:
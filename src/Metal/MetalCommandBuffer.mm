@@ -24,6 +24,7 @@
 # include "Metal/imgui_impl_metal.h"
 #endif
 #include "Metal/MetalGraphicsPipeline.hpp"
+#include "Metal/MetalComputePipeline.hpp"
 #include "Metal/MetalParameterBlock.hpp"
 #include "Metal/MetalDrawable.hpp"
 #include "Metal/MetalCommandBufferPool.hpp"
@@ -38,10 +39,14 @@ MetalCommandBuffer::MetalCommandBuffer(MetalCommandBuffer&& other) noexcept
       m_mtlCommandBuffer(std::exchange(other.m_mtlCommandBuffer, nil)),
       m_commandEncoder(std::exchange(other.m_commandEncoder, nil)),
       m_usedPipelines(std::move(other.m_usedPipelines)),
+      m_usedComputePipelines(std::move(other.m_usedComputePipelines)),
+      m_boundComputePipeline(std::exchange(other.m_boundComputePipeline, nullptr)),
       m_usedTextures(std::move(other.m_usedTextures)),
       m_usedBuffers(std::move(other.m_usedBuffers)),
       m_usedSamplers(std::move(other.m_usedSamplers)),
-      m_usedPBlock(std::move(other.m_usedPBlock))
+      m_usedPBlock(std::move(other.m_usedPBlock)),
+      m_secondaries(std::move(other.m_secondaries)),
+      m_passFirstSecondary(std::exchange(other.m_passFirstSecondary, 0))
 {
 }
 
@@ -50,7 +55,7 @@ MetalCommandBuffer::MetalCommandBuffer(const id<MTLCommandQueue>& queue) { @auto
     m_mtlCommandBuffer = [queue commandBuffer];
 }}
 
-void MetalCommandBuffer::beginRenderPass(const Framebuffer& framebuffer) { @autoreleasepool
+void MetalCommandBuffer::beginRenderPass(const Framebuffer& framebuffer, RenderPassContents contents) { @autoreleasepool
 {
     assert(m_commandEncoder == nil);
 
@@ -79,7 +84,25 @@ void MetalCommandBuffer::beginRenderPass(const Framebuffer& framebuffer) { @auto
         m_usedTextures.insert(texture);
     }
     TracyMetalZone(MetalDevice::s_tracyMtlContext, renderPassDescriptor, "renderPass");
-    m_commandEncoder = [m_mtlCommandBuffer renderCommandEncoderWithDescriptor: renderPassDescriptor];
+    if (contents == RenderPassContents::secondaryCommandBuffers) {
+        m_commandEncoder = [m_mtlCommandBuffer parallelRenderCommandEncoderWithDescriptor: renderPassDescriptor];
+        m_passFirstSecondary = m_secondaries.size();
+    }
+    else
+        m_commandEncoder = [m_mtlCommandBuffer renderCommandEncoderWithDescriptor: renderPassDescriptor];
+}}
+
+std::shared_ptr<CommandBuffer> MetalCommandBuffer::newSecondaryCommandBuffer() { @autoreleasepool
+{
+    assert([m_commandEncoder conformsToProtocol:@protocol(MTLParallelRenderCommandEncoder)]);
+    auto parallelCommandEncoder = (id<MTLParallelRenderCommandEncoder>)m_commandEncoder;
+
+    // the encoders of a parallel encoder are executed in creation order
+    auto secondary = std::make_shared<MetalCommandBuffer>();
+    secondary->m_mtlCommandBuffer = m_mtlCommandBuffer;
+    secondary->m_commandEncoder = [parallelCommandEncoder renderCommandEncoder];
+    m_secondaries.push_back(secondary);
+    return secondary;
 }}
 
 void MetalCommandBuffer::usePipeline(const std::shared_ptr<const GraphicsPipeline>& _graphicsPipeline) { @autoreleasepool
@@ -99,7 +122,7 @@ void MetalCommandBuffer::usePipeline(const std::shared_ptr<const GraphicsPipelin
     m_usedPipelines.insert(graphicsPipeline);
 }}
 
-void MetalCommandBuffer::useVertexBuffer(const std::shared_ptr<Buffer>& aBuffer) { @autoreleasepool
+void MetalCommandBuffer::useVertexBuffer(const std::shared_ptr<Buffer>& aBuffer, size_t offset, uint32_t bufferIndex) { @autoreleasepool
 {
     auto buffer = std::dynamic_pointer_cast<MetalBuffer>(aBuffer);
     assert(buffer);
@@ -107,7 +130,7 @@ void MetalCommandBuffer::useVertexBuffer(const std::shared_ptr<Buffer>& aBuffer)
     assert([m_commandEncoder conformsToProtocol:@protocol(MTLRenderCommandEncoder)]);
     auto renderCommandEncoder = (id<MTLRenderCommandEncoder>)m_commandEncoder;
 
-    [renderCommandEncoder setVertexBuffer:buffer->mtlBuffer() offset:0 atIndex:5];
+    [renderCommandEncoder setVertexBuffer:buffer->mtlBuffer() offset:offset atIndex:MetalGraphicsPipeline::vertexBufferIndex(bufferIndex)];
 
     m_usedBuffers.insert(buffer);
 }}
@@ -116,6 +139,22 @@ void MetalCommandBuffer::setParameterBlock(const std::shared_ptr<const Parameter
 {
     const auto& pBlock = std::dynamic_pointer_cast<const MetalParameterBlock>(aPBlock);
 
+    m_usedBuffers.insert_range(pBlock->encodedBuffers()   | std::views::transform([](const auto& encodedBuffer)  -> std::shared_ptr<MetalBuffer>  { return encodedBuffer.resource;  }));
+    m_usedTextures.insert_range(pBlock->encodedTextures() | std::views::transform([](const auto& encodedTexture) -> std::shared_ptr<MetalTexture> { return encodedTexture.resource; }));
+    m_usedSamplers.insert_range(pBlock->encodedSamplers() | std::views::transform([](const auto& encodedSampler) -> std::shared_ptr<MetalSampler> { return encodedSampler.resource; }));
+    m_usedPBlock.insert(pBlock);
+
+    if ([m_commandEncoder conformsToProtocol:@protocol(MTLComputeCommandEncoder)])
+    {
+        auto computeCommandEncoder = (id<MTLComputeCommandEncoder>)m_commandEncoder;
+        for (const auto& encodedBuffer : pBlock->encodedBuffers())
+            [computeCommandEncoder useResource:encodedBuffer.resource->mtlBuffer() usage:toMTLResourceUsage(encodedBuffer.binding.usages)];
+        for (const auto& encodedTexture : pBlock->encodedTextures())
+            [computeCommandEncoder useResource:encodedTexture.resource->mtltexture() usage:toMTLResourceUsage(encodedTexture.binding.usages)];
+        [computeCommandEncoder setBuffer:pBlock->argumentBuffer().mtlBuffer() offset:pBlock->offset() atIndex:index];
+        return;
+    }
+
     assert([m_commandEncoder conformsToProtocol:@protocol(MTLRenderCommandEncoder)]);
     auto renderCommandEncoder = (id<MTLRenderCommandEncoder>)m_commandEncoder;
 
@@ -138,15 +177,15 @@ void MetalCommandBuffer::setParameterBlock(const std::shared_ptr<const Parameter
     {
         [renderCommandEncoder setFragmentBuffer:pBlock->argumentBuffer().mtlBuffer() offset:pBlock->offset() atIndex:index];
     }
-
-    m_usedBuffers.insert_range(pBlock->encodedBuffers()   | std::views::transform([](const auto& encodedBuffer)  -> std::shared_ptr<MetalBuffer>  { return encodedBuffer.resource;  }));
-    m_usedTextures.insert_range(pBlock->encodedTextures() | std::views::transform([](const auto& encodedTexture) -> std::shared_ptr<MetalTexture> { return encodedTexture.resource; }));
-    m_usedSamplers.insert_range(pBlock->encodedSamplers() | std::views::transform([](const auto& encodedSampler) -> std::shared_ptr<MetalSampler> { return encodedSampler.resource; }));
-    m_usedPBlock.insert(pBlock);
 }}
 
 void MetalCommandBuffer::setPushConstants(const void* data, size_t size) { @autoreleasepool
 {
+    if ([m_commandEncoder conformsToProtocol:@protocol(MTLComputeCommandEncoder)]) {
+        [(id<MTLComputeCommandEncoder>)m_commandEncoder setBytes:data length:size atIndex:6];
+        return;
+    }
+
     assert([m_commandEncoder conformsToProtocol:@protocol(MTLRenderCommandEncoder)]);
     auto renderCommandEncoder = (id<MTLRenderCommandEncoder>)m_commandEncoder;
 
@@ -155,31 +194,89 @@ void MetalCommandBuffer::setPushConstants(const void* data, size_t size) { @auto
     [renderCommandEncoder setFragmentBytes:data length:size atIndex:6];
 }}
 
-void MetalCommandBuffer::drawVertices(uint32_t start, uint32_t count) { @autoreleasepool
+void MetalCommandBuffer::drawVertices(uint32_t start, uint32_t count, uint32_t instanceCount, uint32_t firstInstance) { @autoreleasepool
 {
     assert([m_commandEncoder conformsToProtocol:@protocol(MTLRenderCommandEncoder)]);
     auto renderCommandEncoder = (id<MTLRenderCommandEncoder>)m_commandEncoder;
 
-    [renderCommandEncoder drawPrimitives:MTLPrimitiveTypeTriangle vertexStart:start vertexCount:count];
+    [renderCommandEncoder drawPrimitives:MTLPrimitiveTypeTriangle vertexStart:start vertexCount:count instanceCount:instanceCount baseInstance:firstInstance];
 }}
 
-void MetalCommandBuffer::drawIndexedVertices(const std::shared_ptr<Buffer>& buffer) { @autoreleasepool
+void MetalCommandBuffer::drawIndexedVertices(const std::shared_ptr<Buffer>& buffer, IndexType indexType, uint32_t indexCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t instanceCount, uint32_t firstInstance) { @autoreleasepool
 {
     auto idxBuffer = std::dynamic_pointer_cast<MetalBuffer>(buffer);
     assert(idxBuffer);
+    assert((static_cast<size_t>(firstIndex) + indexCount) * indexTypeSize(indexType) <= idxBuffer->size());
 
     assert([m_commandEncoder conformsToProtocol:@protocol(MTLRenderCommandEncoder)]);
     auto renderCommandEncoder = (id<MTLRenderCommandEncoder>)m_commandEncoder;
 
     [renderCommandEncoder drawIndexedPrimitives:MTLPrimitiveTypeTriangle
-                                     indexCount:idxBuffer->size() / sizeof(uint32_t)
-                                      indexType:MTLIndexTypeUInt32
+                                     indexCount:indexCount
+                                      indexType:toMTLIndexType(indexType)
                                     indexBuffer:idxBuffer->mtlBuffer()
-                              indexBufferOffset:0];
+                              indexBufferOffset:firstIndex * indexTypeSize(indexType)
+                                  instanceCount:instanceCount
+                                     baseVertex:vertexOffset
+                                   baseInstance:firstInstance];
 
     m_usedBuffers.insert(idxBuffer);
 }}
 
+void MetalCommandBuffer::drawIndirect(const std::shared_ptr<Buffer>& aIndirectBuffer, size_t offset, uint32_t drawCount) { @autoreleasepool
+{
+    auto indirectBuffer = std::dynamic_pointer_cast<MetalBuffer>(aIndirectBuffer);
+    assert(indirectBuffer);
+    assert(offset + static_cast<size_t>(drawCount) * sizeof(DrawIndirectCommand) <= indirectBuffer->size());
+
+    assert([m_commandEncoder conformsToProtocol:@protocol(MTLRenderCommandEncoder)]);
+    auto renderCommandEncoder = (id<MTLRenderCommandEncoder>)m_commandEncoder;
+
+    // metal indirect draws read a single command
+    for (uint32_t i = 0; i < drawCount; i++) {
+        [renderCommandEncoder drawPrimitives:MTLPrimitiveTypeTriangle
+                              indirectBuffer:indirectBuffer->mtlBuffer()
+                        indirectBufferOffset:offset + i * sizeof(DrawIndirectCommand)];
+    }
+
+    m_usedBuffers.insert(indirectBuffer);
+}}
+
+void MetalCommandBuffer::drawIndexedIndirect(const std::shared_ptr<Buffer>& aIdxBuffer, IndexType indexType, const std::shared_ptr<Buffer>& aIndirectBuffer, size_t offset, uint32_t drawCount) { @autoreleasepool
+{
+    auto idxBuffer = std::dynamic_pointer_cast<MetalBuffer>(aIdxBuffer);
+    auto indirectBuffer = std::dynamic_pointer_cast<MetalBuffer>(aIndirectBuffer);
+    assert(idxBuffer);
+    assert(indirectBuffer);
+    assert(offset + static_cast<size_t>(drawCount) * sizeof(DrawIndexedIndirectCommand) <= indirectBuffer->size());
+
+    assert([m_commandEncoder conformsToProtocol:@protocol(MTLRenderCommandEncoder)]);
+    auto renderCommandEncoder = (id<MTLRenderCommandEncoder>)m_commandEncoder;
+
+    for (uint32_t i = 0; i < drawCount; i++) {
+        [renderCommandEncoder drawIndexedPrimitives:MTLPrimitiveTypeTriangle
+                                          indexType:toMTLIndexType(indexType)
+                                        indexBuffer:idxBuffer->mtlBuffer()
+                                  indexBufferOffset:0
+                                     indirectBuffer:indirectBuffer->mtlBuffer()
+                               indirectBufferOffset:offset + i * sizeof(DrawIndexedIndirectCommand)];
+    }
+
+    m_usedBuffers.insert(idxBuffer);
+    m_usedBuffers.insert(indirectBuffer);
+}}
+
+void MetalCommandBuffer::drawIndirectCount(const std::shared_ptr<Buffer>&, size_t, const std::shared_ptr<Buffer>&, size_t, uint32_t)
+{
+    // would need an indirect command buffer encoded by a compute pass
+    throw std::runtime_error("draw indirect count is not supported by the metal backend");
+}
+
+void MetalCommandBuffer::drawIndexedIndirectCount(const std::shared_ptr<Buffer>&, IndexType, const std::shared_ptr<Buffer>&, size_t, const std::shared_ptr<Buffer>&, size_t, uint32_t)
+{
+    throw std::runtime_error("draw indirect count is not supported by the metal backend");
+}
+
 #if defined(GFX_IMGUI_ENABLED)
 void MetalCommandBuffer::imGuiRenderDrawData(ImDrawData* drawData) const { @autoreleasepool
 {
@@ -190,10 +287,67 @@ void MetalCommandBuffer::imGuiRenderDrawData(ImDrawData* drawData) const { @auto
 #endif
 
 void MetalCommandBuffer::endRenderPass() { @autoreleasepool
+{
+    assert(m_commandEncoder);
+    for (size_t i = m_passFirstSecondary; i < m_secondaries.size(); i++) {
+        [m_secondaries[i]->m_commandEncoder endEncoding];
+        m_secondaries[i]->m_commandEncoder = nil;
+    }
+    m_passFirstSecondary = m_secondaries.size();
+    [m_commandEncoder endEncoding];
+    m_commandEncoder = nil;
+}}
+
+void MetalCommandBuffer::beginComputePass() { @autoreleasepool
+{
+    assert(m_commandEncoder == nil);
+    MTLComputePassDescriptor* computePassDescriptor = [[MTLComputePassDescriptor alloc] init];
+    TracyMetalZone(MetalDevice::s_tracyMtlContext, computePassDescriptor, "computePass");
+    m_commandEncoder = [m_mtlCommandBuffer computeCommandEncoderWithDescriptor:computePassDescriptor];
+}}
+
+void MetalCommandBuffer::usePipeline(const std::shared_ptr<const ComputePipeline>& aComputePipeline) { @autoreleasepool
+{
+    auto computePipeline = std::dynamic_pointer_cast<const MetalComputePipeline>(aComputePipeline);
+    assert(computePipeline);
+
+    assert([m_commandEncoder conformsToProtocol:@protocol(MTLComputeCommandEncoder)]);
+    [(id<MTLComputeCommandEncoder>)m_commandEncoder setComputePipelineState:computePipeline->computePipelineState()];
+
+    m_boundComputePipeline = computePipeline.get();
+    m_usedComputePipelines.insert(computePipeline);
+}}
+
+void MetalCommandBuffer::dispatch(uint32_t x, uint32_t y, uint32_t z) { @autoreleasepool
+{
+    assert(m_boundComputePipeline);
+    assert([m_commandEncoder conformsToProtocol:@protocol(MTLComputeCommandEncoder)]);
+
+    [(id<MTLComputeCommandEncoder>)m_commandEncoder dispatchThreadgroups:MTLSizeMake(x, y, z) threadsPerThreadgroup:m_boundComputePipeline->threadGroupSize()];
+}}
+
+void MetalCommandBuffer::dispatchIndirect(const std::shared_ptr<Buffer>& aIndirectBuffer, size_t offset) { @autoreleasepool
+{
+    auto indirectBuffer = std::dynamic_pointer_cast<MetalBuffer>(aIndirectBuffer);
+    assert(indirectBuffer);
+    assert(offset + sizeof(DispatchIndirectCommand) <= indirectBuffer->size());
+
+    assert(m_boundComputePipeline);
+    assert([m_commandEncoder conformsToProtocol:@protocol(MTLComputeCommandEncoder)]);
+
+    [(id<MTLComputeCommandEncoder>)m_commandEncoder dispatchThreadgroupsWithIndirectBuffer:indirectBuffer->mtlBuffer()
+                                                                      indirectBufferOffset:offset
+                                                                     threadsPerThreadgroup:m_boundComputePipeline->threadGroupSize()];
+
+    m_usedBuffers.insert(indirectBuffer);
+}}
+
+void MetalCommandBuffer::endComputePass() { @autoreleasepool
 {
     assert(m_commandEncoder);
     [m_commandEncoder endEncoding];
     m_commandEncoder = nil;
+    m_boundComputePipeline = nullptr;
 }}
 
 void MetalCommandBuffer::beginBlitPass() { @autoreleasepool
@@ -204,7 +358,7 @@ void MetalCommandBuffer::beginBlitPass() { @autoreleasepool
     m_commandEncoder = [m_mtlCommandBuffer blitCommandEncoderWithDescriptor:blitPassDescriptor];
 }}
 
-void MetalCommandBuffer::copyBufferToBuffer(const std::shared_ptr<Buffer>& aSrc, const std::shared_ptr<Buffer>& aDst, size_t size) { @autoreleasepool
+void MetalCommandBuffer::copyBufferToBuffer(const std::shared_ptr<Buffer>& aSrc, size_t srcOffset, const std::shared_ptr<Buffer>& aDst, size_t dstOffset, size_t size) { @autoreleasepool
 {
     auto src = std::dynamic_pointer_cast<MetalBuffer>(aSrc);
     assert(src);
@@ -213,11 +367,12 @@ void MetalCommandBuffer::copyBufferToBuffer(const std::shared_ptr<Buffer>& aSrc,
     assert(dst);
 
     assert(src->usages() & BufferUsage::copySource && dst->usages() & BufferUsage::copyDestination);
+    assert(srcOffset + size <= src->size() && dstOffset + size <= dst->size());
 
     assert([m_commandEncoder conformsToProtocol:@protocol(MTLBlitCommandEncoder)]);
     auto blitCommandEncoder = (id<MTLBlitCommandEncoder>)m_commandEncoder;
 
-    [blitCommandEncoder copyFromBuffer:src->mtlBuffer() sourceOffset:0 toBuffer:dst->mtlBuffer() destinationOffset:0 size:size];
+    [blitCommandEncoder copyFromBuffer:src->mtlBuffer() sourceOffset:srcOffset toBuffer:dst->mtlBuffer() destinationOffset:dstOffset size:size];
 
     m_usedBuffers.insert(src);
     m_usedBuffers.insert(dst);
@@ -253,6 +408,37 @@ void MetalCommandBuffer::copyBufferToTexture(const std::shared_ptr<Buffer>& aBuf
     m_usedTextures.insert(texture);
 }}
 
+void MetalCommandBuffer::copyTextureToBuffer(const std::shared_ptr<Texture>& aTexture, const std::shared_ptr<Buffer>& aBuffer, size_t bufferOffset, uint32_t layerIndex) { @autoreleasepool
+{
+    auto texture = std::dynamic_pointer_cast<MetalTexture>(aTexture);
+    assert(texture);
+
+    auto buffer = std::dynamic_pointer_cast<MetalBuffer>(aBuffer);
+    assert(buffer);
+
+    assert([m_commandEncoder conformsToProtocol:@protocol(MTLBlitCommandEncoder)]);
+
+    size_t bytesPerPixel = pixelFormatSize(texture->pixelFormat());
+    size_t bytesPerRow = bytesPerPixel * texture->width();
+    size_t bytesPerImage = bytesPerRow * texture->height();
+
+    assert(bufferOffset + bytesPerImage <= buffer->size());
+
+    // the readback buffers are shared, the blit writes are visible to the cpu once the command buffer is completed
+    [(id<MTLBlitCommandEncoder>)m_commandEncoder copyFromTexture:texture->mtltexture()
+                                                     sourceSlice:layerIndex
+                                                     sourceLevel:0
+                                                    sourceOrigin:MTLOrigin{0, 0, 0}
+                                                      sourceSize:MTLSizeMake(texture->width(), texture->height(), 1)
+                                                        toBuffer:buffer->mtlBuffer()
+                                               destinationOffset:bufferOffset
+                                          destinationBytesPerRow:bytesPerRow
+                                        destinationBytesPerImage:bytesPerImage];
+
+    m_usedBuffers.insert(buffer);
+    m_usedTextures.insert(texture);
+}}
+
 void MetalCommandBuffer::endBlitPass() { @autoreleasepool
 {
     assert(m_commandEncoder);
@@ -265,6 +451,7 @@ void MetalCommandBuffer::presentDrawable(const std::shared_ptr<Drawable>& aDrawa
     auto drawable = std::dynamic_pointer_cast<MetalDrawable>(aDrawable);
     assert(drawable);
 
+    drawable->addToPresentHistory();
     [m_mtlCommandBuffer presentDrawable:drawable->mtlDrawable()];
 }}
 
@@ -274,6 +461,14 @@ void MetalCommandBuffer::addSampledTexture(const std::shared_ptr<Texture>& aText
     m_usedTextures.insert(texture);
 }
 
+bool MetalCommandBuffer::isCompleted() const
+{
+    if (m_signaledSharedEventValue == 0)
+        return true; // not submitted
+    const MTLCommandBufferStatus status = m_mtlCommandBuffer.status;
+    return status == MTLCommandBufferStatusCompleted || status == MTLCommandBufferStatusError;
+}
+
 MetalCommandBuffer& MetalCommandBuffer::operator = (MetalCommandBuffer&& other) noexcept { @autoreleasepool
 {
     if (this != &other)
@@ -281,10 +476,14 @@ MetalCommandBuffer& MetalCommandBuffer::operator = (MetalCommandBuffer&& other)
         m_mtlCommandBuffer = std::exchange(other.m_mtlCommandBuffer, nil);
         m_commandEncoder = std::exchange(other.m_commandEncoder, nil);
         m_usedPipelines = std::move(other.m_usedPipelines);
+        m_usedComputePipelines = std::move(other.m_usedComputePipelines);
+        m_boundComputePipeline = std::exchange(other.m_boundComputePipeline, nullptr);
         m_usedTextures = std::move(other.m_usedTextures);
         m_usedBuffers = std::move(other.m_usedBuffers);
         m_usedSamplers = std::move(other.m_usedSamplers);
         m_usedPBlock = std::move(other.m_usedPBlock);
+        m_secondaries = std::move(other.m_secondaries);
+        m_passFirstSecondary = std::exchange(other.m_passFirstSecondary, 0);
     }
     return *this;
 }}
@@ -0,0 +1,49 @@
+/*
+ * ---------------------------------------------------
+ * MetalComputePipeline.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 09:48:21
+ * ---------------------------------------------------
+ */
+
+#ifndef METALCOMPUTEPIPELINE_HPP
+#define METALCOMPUTEPIPELINE_HPP
+
+#include "Graphics/ComputePipeline.hpp"
+
+#if !defined(__OBJC__)
+#error this file can only by used in objective c
+#endif
+
+namespace gfx
+{
+
+class MetalDevice;
+
+class MetalComputePipeline : public ComputePipeline
+{
+public:
+    MetalComputePipeline() = delete;
+    MetalComputePipeline(const MetalComputePipeline&) = delete;
+    MetalComputePipeline(MetalComputePipeline&&) = delete;
+
+    MetalComputePipeline(const MetalDevice&, const ComputePipeline::Descriptor&);
+
+    inline id<MTLComputePipelineState> computePipelineState() const { return m_computePipelineState; }
+    inline MTLSize threadGroupSize() const { return m_threadGroupSize; }
+
+    ~MetalComputePipeline() override = default;
+
+private:
+    id<MTLComputePipelineState> m_computePipelineState = nil;
+    MTLSize m_threadGroupSize = MTLSizeMake(1, 1, 1);
+
+public:
+    MetalComputePipeline& operator=(const MetalComputePipeline&) = delete;
+    MetalComputePipeline& operator=(MetalComputePipeline&&) = delete;
+};
+
+} // namespace gfx
+
+#endif // METALCOMPUTEPIPELINE_HPP
@@ -0,0 +1,32 @@
+/*
+ * ---------------------------------------------------
+ * MetalComputePipeline.mm
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 09:52:07
+ * ---------------------------------------------------
+ */
+
+#include "Graphics/ComputePipeline.hpp"
+
+#include "Metal/MetalComputePipeline.hpp"
+#include "Metal/MetalDevice.hpp"
+#include "Metal/MetalShaderFunction.hpp"
+
+namespace gfx
+{
+
+MetalComputePipeline::MetalComputePipeline(const MetalDevice& device, const ComputePipeline::Descriptor& desc) { @autoreleasepool
+{
+    assert(desc.computeShader != nullptr);
+
+    NSError* error = nil;
+    m_computePipelineState = [device.mtlDevice() newComputePipelineStateWithFunction:dynamic_cast<MetalShaderFunction&>(*desc.computeShader).mtlFunction() error:&error];
+    if (m_computePipelineState == nil)
+        throw std::runtime_error("failed to create the ComputePipelineState");
+
+    m_threadGroupSize = MTLSizeMake(desc.threadGroupSize[0], desc.threadGroupSize[1], desc.threadGroupSize[2]);
+    assert(m_threadGroupSize.width * m_threadGroupSize.height * m_threadGroupSize.depth <= m_computePipelineState.maxTotalThreadsPerThreadgroup);
+}}
+
+}
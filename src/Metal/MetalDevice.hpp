@@ -14,6 +14,7 @@
 #include "Graphics/Swapchain.hpp"
 #include "Graphics/ShaderLib.hpp"
 #include "Graphics/GraphicsPipeline.hpp"
+#include "Graphics/ComputePipeline.hpp"
 #include "Graphics/Buffer.hpp"
 #include "Graphics/Texture.hpp"
 #include "Graphics/CommandBufferPool.hpp"
@@ -22,6 +23,9 @@
 #include "Graphics/Enums.hpp"
 
 #include "Metal/MetalCommandBuffer.hpp"
+#include "Metal/MetalShaderLib.hpp"
+
+#include <unordered_map>
 
 #if !defined(__OBJC__)
 #error this file can only by used in objective c
@@ -40,16 +44,32 @@ public:
     MetalDevice(id<MTLDevice>, const Device::Descriptor&);
 
     inline Backend backend() const override { return Backend::metal; }
+    inline bool supportsDrawIndirectCount() const override { return false; }
+    inline bool supportsPresentWait() const override { return true; } // presented handlers
 
     std::unique_ptr<Swapchain> newSwapchain(const Swapchain::Descriptor&) const override;
     std::unique_ptr<ShaderLib> newShaderLib(const std::filesystem::path&) const override;
     std::unique_ptr<ParameterBlockLayout> newParameterBlockLayout(const ParameterBlockLayout::Descriptor&) const override;
     std::unique_ptr<GraphicsPipeline> newGraphicsPipeline(const GraphicsPipeline::Descriptor&) const override;
+    GraphicsPipelineFuture newGraphicsPipelineAsync(const GraphicsPipeline::Descriptor&) const override;
+    std::vector<GraphicsPipelineFuture> newGraphicsPipelines(std::span<const GraphicsPipeline::Descriptor>) const override;
+    std::shared_ptr<GraphicsPipeline> sharedGraphicsPipeline(const GraphicsPipeline::Descriptor&) const override;
+    std::unique_ptr<ComputePipeline> newComputePipeline(const ComputePipeline::Descriptor&) const override;
     std::unique_ptr<Buffer> newBuffer(const Buffer::Descriptor&) const override;
     std::unique_ptr<Texture> newTexture(const Texture::Descriptor&) const override;
-    std::unique_ptr<CommandBufferPool> newCommandBufferPool() const override;
+    using Device::newCommandBufferPool;
+    std::unique_ptr<CommandBufferPool> newCommandBufferPool(QueueType) const override;
+    using Device::newReusableCommandBuffer;
+    std::shared_ptr<CommandBuffer> newReusableCommandBuffer(QueueType) const override;
     std::unique_ptr<ParameterBlockPool> newParameterBlockPool(const ParameterBlockPool::Descriptor&) const override;
     std::unique_ptr<Sampler> newSampler(const Sampler::Descriptor&) const override;
+    std::unique_ptr<UploadRing> newUploadRing(const UploadRing::Descriptor&) const override;
+
+    // pipeline caching is left to the metal driver
+    inline PipelineCacheStatistics pipelineCacheStatistics() const override { return PipelineCacheStatistics{}; }
+    inline SubmitStatistics submitStatistics() const override { return SubmitStatistics{}; } // not measured, commit is done by the calling thread
+    inline void savePipelineCache() const override {}
+    inline DestructionStatistics destructionStatistics() const override { return DestructionStatistics{}; } // the command buffers retain the metal objects they use
 
 #if defined (GFX_IMGUI_ENABLED)
     void imguiInit(std::vector<PixelFormat> colorAttachmentPxFormats, std::optional<PixelFormat> depthAttachmentPxFormat) const override;
@@ -59,12 +79,21 @@ public:
 
     void submitCommandBuffers(const std::shared_ptr<CommandBuffer>&) override;
     void submitCommandBuffers(const std::vector<std::shared_ptr<CommandBuffer>>&) override;
+    inline void flushSubmits() override {} // every submit is committed
 
     void waitCommandBuffer(const CommandBuffer&) override;
+    bool waitCommandBuffer(const CommandBuffer&, std::chrono::nanoseconds timeout) override;
     void waitIdle() override;
 
+    bool isCompleted(const SubmitTicket&) const override;
+    bool waitSubmit(const SubmitTicket&, std::chrono::nanoseconds timeout) override;
+    void addCompletedHandler(const SubmitTicket&, std::function<void()>) override;
+
     inline id<MTLDevice> mtlDevice() const { return m_mtlDevice; }
 
+    // libraries loaded from identical bytes get the same id while one of them is alive
+    std::shared_ptr<const MetalShaderLib::LibraryId> shaderLibraryId(const std::vector<std::byte>& metalBytes) const;
+
     ~MetalDevice() override;
 
 public:
@@ -77,8 +106,32 @@ private:
 
     std::deque<std::shared_ptr<MetalCommandBuffer>> m_submittedCommandBuffers;
     id<MTLSharedEvent> m_sharedEvent = nil;
+    MTLSharedEventListener* m_sharedEventListener = nil; // call the completed handlers on its own dispatch queue
     uint64_t m_nextSharedEventValue = 1;
 
+    struct GraphicsPipelineKey
+    {
+        uint64_t vertexLibraryId;
+        std::string vertexFunctionName;
+        uint64_t fragmentLibraryId;
+        std::string fragmentFunctionName;
+        std::optional<VertexLayout> vertexLayout;
+        std::vector<PixelFormat> colorAttachmentPxFormats;
+        std::optional<PixelFormat> depthAttachmentPxFormat;
+        BlendOperation blendOperation;
+        CullMode cullMode;
+        std::vector<std::vector<ParameterBlockBinding>> parameterBlockBindings;
+
+        auto operator<=>(const GraphicsPipelineKey&) const = default;
+    };
+
+    mutable std::mutex m_sharedObjectsMtx;
+    mutable uint64_t m_nextShaderLibraryId = 1;
+    mutable std::unordered_multimap<size_t, std::weak_ptr<const MetalShaderLib::LibraryId>> m_shaderLibraryIds; // keyed by the hash of the bytes
+    mutable std::map<GraphicsPipelineKey, std::weak_ptr<GraphicsPipeline>> m_graphicsPipelines;
+    static constexpr size_t minPruneSize = 64;
+    mutable size_t m_graphicsPipelinesPruneSize = minPruneSize;
+
 public:
     MetalDevice& operator=(const MetalDevice&) = delete;
     MetalDevice& operator=(MetalDevice&&) = delete;
@@ -18,6 +18,7 @@
 #include "Metal/MetalBuffer.hpp"
 #include "Metal/MetalCommandBufferPool.hpp"
 #include "Metal/MetalGraphicsPipeline.hpp"
+#include "Metal/MetalComputePipeline.hpp"
 #include "Metal/MetalParameterBlockPool.hpp"
 #include "Metal/MetalSwapchain.hpp"
 #include "Metal/MetalCommandBuffer.hpp"
@@ -29,9 +30,13 @@
 #endif
 #include "Metal/MetalTexture.hpp"
 #include "Metal/MetalSampler.hpp"
+#include "Metal/MetalUploadRing.hpp"
 
 #import "Metal/MetalEnums.hpp"
 
+#include <bit>
+#include <string_view>
+
 namespace gfx
 {
 
@@ -40,6 +45,7 @@ MetalDevice::MetalDevice(id<MTLDevice> device, const Device::Descriptor&)
 {
     m_queue = [m_mtlDevice newCommandQueue];
     m_sharedEvent = [m_mtlDevice newSharedEvent];
+    m_sharedEventListener = [[MTLSharedEventListener alloc] initWithDispatchQueue:dispatch_queue_create("gfx.completedHandlers", DISPATCH_QUEUE_SERIAL)];
     s_tracyMtlContext = TracyMetalContext(device);
 }}
 
@@ -63,6 +69,76 @@ std::unique_ptr<GraphicsPipeline> MetalDevice::newGraphicsPipeline(const Graphic
     return std::make_unique<MetalGraphicsPipeline>(*this, desc);
 }
 
+GraphicsPipelineFuture MetalDevice::newGraphicsPipelineAsync(const GraphicsPipeline::Descriptor& desc) const
+{
+    // compiled synchronously, the returned future is always ready
+    std::promise<std::shared_ptr<GraphicsPipeline>> promise;
+    try {
+        promise.set_value(newGraphicsPipeline(desc));
+    }
+    catch (...) {
+        promise.set_exception(std::current_exception());
+    }
+    return promise.get_future().share();
+}
+
+std::vector<GraphicsPipelineFuture> MetalDevice::newGraphicsPipelines(std::span<const GraphicsPipeline::Descriptor> descs) const
+{
+    std::vector<GraphicsPipelineFuture> futures;
+    futures.reserve(descs.size());
+    for (const auto& desc : descs)
+        futures.push_back(newGraphicsPipelineAsync(desc));
+    return futures;
+}
+
+std::shared_ptr<GraphicsPipeline> MetalDevice::sharedGraphicsPipeline(const GraphicsPipeline::Descriptor& desc) const
+{
+    auto* vertFunc = dynamic_cast<MetalShaderFunction*>(desc.vertexShader);
+    auto* fragFunc = dynamic_cast<MetalShaderFunction*>(desc.fragmentShader);
+    assert(vertFunc && fragFunc);
+
+    GraphicsPipelineKey key = {
+        .vertexLibraryId = vertFunc->libraryId(),
+        .vertexFunctionName = vertFunc->name(),
+        .fragmentLibraryId = fragFunc->libraryId(),
+        .fragmentFunctionName = fragFunc->name(),
+        .vertexLayout = desc.vertexLayout,
+        .colorAttachmentPxFormats = desc.colorAttachmentPxFormats,
+        .depthAttachmentPxFormat = desc.depthAttachmentPxFormat,
+        .blendOperation = desc.blendOperation,
+        .cullMode = desc.cullMode,
+        .parameterBlockBindings = {}
+    };
+    for (const auto& pbl : desc.parameterBlockLayouts)
+        key.parameterBlockBindings.push_back(pbl->bindings());
+
+    std::scoped_lock lock(m_sharedObjectsMtx);
+
+    auto it = m_graphicsPipelines.find(key);
+    if (it != m_graphicsPipelines.end()) {
+        if (std::shared_ptr<GraphicsPipeline> pipeline = it->second.lock())
+            return pipeline;
+    }
+
+    std::shared_ptr<GraphicsPipeline> pipeline = newGraphicsPipeline(desc);
+    if (it != m_graphicsPipelines.end())
+        it->second = pipeline;
+    else {
+        m_graphicsPipelines.emplace(std::move(key), pipeline);
+        // expired entries are replaced when looked up, the other ones are removed each time the map double
+        if (m_graphicsPipelines.size() >= m_graphicsPipelinesPruneSize) {
+            std::erase_if(m_graphicsPipelines, [](const auto& entry) { return entry.second.expired(); });
+            m_graphicsPipelinesPruneSize = std::max(minPruneSize, m_graphicsPipelines.size() * 2);
+        }
+    }
+    return pipeline;
+}
+
+std::unique_ptr<ComputePipeline> MetalDevice::newComputePipeline(const ComputePipeline::Descriptor& desc) const
+{
+    return std::make_unique<MetalComputePipeline>(*this, desc);
+}
+
 std::unique_ptr<Buffer> MetalDevice::newBuffer(const Buffer::Descriptor& desc) const
 {
     return std::make_unique<MetalBuffer>(*this, desc);
@@ -73,11 +149,18 @@ std::unique_ptr<Texture> MetalDevice::newTexture(const Texture::Descriptor& desc
     return std::make_unique<MetalTexture>(*this, desc);
 }
 
-std::unique_ptr<CommandBufferPool> MetalDevice::newCommandBufferPool() const
+std::unique_ptr<CommandBufferPool> MetalDevice::newCommandBufferPool(QueueType) const
 {
+    // every queue type use the device queue, metal track the hazards between compute and render encoders itself
     return std::make_unique<MetalCommandBufferPool>(&m_queue);
 }
 
+std::shared_ptr<CommandBuffer> MetalDevice::newReusableCommandBuffer(QueueType) const
+{
+    // a MTLCommandBuffer can only be committed once
+    throw std::runtime_error("reusable command buffers are not supported by the metal backend");
+}
+
 std::unique_ptr<ParameterBlockPool> MetalDevice::newParameterBlockPool(const ParameterBlockPool::Descriptor& descriptor) const
 {
     return std::make_unique<MetalParameterBlockPool>(this, descriptor);
@@ -88,6 +171,11 @@ std::unique_ptr<Sampler> MetalDevice::newSampler(const Sampler::Descriptor& desc
     return std::make_unique<MetalSampler>(*this, desc);
 }
 
+std::unique_ptr<UploadRing> MetalDevice::newUploadRing(const UploadRing::Descriptor& desc) const
+{
+    return std::make_unique<MetalUploadRing>(*this, desc);
+}
+
 #if defined (GFX_IMGUI_ENABLED)
 void MetalDevice::imguiInit(std::vector<PixelFormat> colorPixelFomats, std::optional<PixelFormat> depthPixelFormat) const { @autoreleasepool
 {
@@ -145,16 +233,70 @@ void MetalDevice::waitCommandBuffer(const CommandBuffer& aCommandBuffer) { @auto
     }
 }}
 
+bool MetalDevice::waitCommandBuffer(const CommandBuffer& commandBuffer, std::chrono::nanoseconds timeout)
+{
+    if (waitSubmit(commandBuffer.submitTicket(), timeout) == false)
+        return false;
+    waitCommandBuffer(commandBuffer); // completed, only release the command buffers
+    return true;
+}
+
+bool MetalDevice::isCompleted(const SubmitTicket& ticket) const
+{
+    return ticket.value <= m_sharedEvent.signaledValue;
+}
+
+bool MetalDevice::waitSubmit(const SubmitTicket& ticket, std::chrono::nanoseconds timeout) { @autoreleasepool
+{
+    ZoneScoped;
+    // the timeout is in milliseconds, rounded up so a short timeout still wait
+    const auto timeoutMS = std::chrono::ceil<std::chrono::milliseconds>(std::max(timeout, std::chrono::nanoseconds(0)));
+    return [m_sharedEvent waitUntilSignaledValue:ticket.value timeoutMS:static_cast<uint64_t>(timeoutMS.count())];
+}}
+
+void MetalDevice::addCompletedHandler(const SubmitTicket& ticket, std::function<void()> handler) { @autoreleasepool
+{
+    // the listener call the block immediately if the value is already signaled
+    [m_sharedEvent notifyListener:m_sharedEventListener atValue:ticket.value block:^(id<MTLSharedEvent>, uint64_t) {
+        handler();
+    }];
+}}
+
 void MetalDevice::waitIdle()
 {
     if (m_submittedCommandBuffers.empty() == false)
         waitCommandBuffer(*m_submittedCommandBuffers.back());
 }
 
-MetalDevice::~MetalDevice()
+std::shared_ptr<const MetalShaderLib::LibraryId> MetalDevice::shaderLibraryId(const std::vector<std::byte>& metalBytes) const
+{
+    const size_t hash = std::hash<std::string_view>{}(std::string_view(std::bit_cast<const char*>(metalBytes.data()), metalBytes.size()));
+
+    std::scoped_lock lock(m_sharedObjectsMtx);
+
+    auto [begin, end] = m_shaderLibraryIds.equal_range(hash);
+    for (auto it = begin; it != end;) {
+        if (std::shared_ptr<const MetalShaderLib::LibraryId> libraryId = it->second.lock()) {
+            if (libraryId->metalBytes == metalBytes)
+                return libraryId;
+            ++it;
+        }
+        else
+            it = m_shaderLibraryIds.erase(it);
+    }
+
+    auto libraryId = std::make_shared<const MetalShaderLib::LibraryId>(MetalShaderLib::LibraryId{ .value = m_nextShaderLibraryId++, .metalBytes = metalBytes });
+    m_shaderLibraryIds.emplace(hash, libraryId);
+    return libraryId;
+}
+
+MetalDevice::~MetalDevice() { @autoreleasepool
 {
     waitIdle();
+    // the handlers of the tickets never submitted are notified too, then their queue is drained
+    m_sharedEvent.signaledValue = std::numeric_limits<uint64_t>::max();
+    dispatch_sync(m_sharedEventListener.dispatchQueue, ^{});
     TracyMetalDestroy(s_tracyMtlContext);
-}
+}}
 
 }
@@ -24,6 +24,16 @@ namespace gfx
 
 class MetalDevice;
 
+// presents of a swapchain, shared by the swapchain and its drawables, updated by the presented handlers
+struct MetalPresentHistory
+{
+    std::mutex mtx;
+    std::condition_variable presentedCv;
+    uint64_t queuedCount = 0;
+    uint64_t presentedCount = 0; // the dropped drawables are counted as presented
+    std::chrono::nanoseconds lastPresentToDisplayDuration{0};
+};
+
 class MetalDrawable : public Drawable
 {
 public:
@@ -31,18 +41,22 @@ public:
     MetalDrawable(const MetalDrawable&) = delete;
     MetalDrawable(MetalDrawable&&) = delete;
 
-    MetalDrawable(const Texture::Descriptor&);
+    MetalDrawable(const Texture::Descriptor&, const std::shared_ptr<MetalPresentHistory>&);
 
     std::shared_ptr<Texture> texture() const override;
 
     inline id<CAMetalDrawable> mtlDrawable() const { return m_mtlDrawable; }
     void setMtlDrawable(const id<CAMetalDrawable>& d);
 
+    // called by the command buffer before it schedule the present
+    void addToPresentHistory();
+
     ~MetalDrawable() override = default;
 
 private:
     id<CAMetalDrawable> m_mtlDrawable = nil;
     std::shared_ptr<MetalTexture> m_texture = nullptr;
+    std::shared_ptr<MetalPresentHistory> m_presentHistory;
 
 public:
     MetalDrawable& operator=(const MetalDrawable&) = delete;
@@ -19,8 +19,8 @@
 namespace gfx
 {
 
-MetalDrawable::MetalDrawable(const Texture::Descriptor& textureDescriptor)
-    : m_texture(std::make_shared<MetalTexture>(textureDescriptor))
+MetalDrawable::MetalDrawable(const Texture::Descriptor& textureDescriptor, const std::shared_ptr<MetalPresentHistory>& presentHistory)
+    : m_texture(std::make_shared<MetalTexture>(textureDescriptor)), m_presentHistory(presentHistory)
 {
 }
 
@@ -36,4 +36,22 @@ void MetalDrawable::setMtlDrawable(const id<CAMetalDrawable>& drawable)
     m_texture->setMtlTexture(nil);
 }
 
+void MetalDrawable::addToPresentHistory() { @autoreleasepool
+{
+    {
+        std::scoped_lock lock(m_presentHistory->mtx);
+        m_presentHistory->queuedCount++;
+    }
+    // presentedTime use the CACurrentMediaTime clock, it is 0 if the drawable was never presented
+    const CFTimeInterval queueTime = CACurrentMediaTime();
+    std::shared_ptr<MetalPresentHistory> presentHistory = m_presentHistory;
+    [m_mtlDrawable addPresentedHandler:^(id<MTLDrawable> presentedDrawable) {
+        std::scoped_lock lock(presentHistory->mtx);
+        presentHistory->presentedCount++;
+        if (presentedDrawable.presentedTime != 0)
+            presentHistory->lastPresentToDisplayDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(presentedDrawable.presentedTime - queueTime));
+        presentHistory->presentedCv.notify_all();
+    }];
+}}
+
 }
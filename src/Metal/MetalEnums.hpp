@@ -72,6 +72,8 @@ constexpr MTLVertexFormat toMetalVertexAttributeFormat(VertexAttributeFormat for
         return MTLVertexFormatFloat2;
     case VertexAttributeFormat::float3:
         return MTLVertexFormatFloat3;
+    case VertexAttributeFormat::float4:
+        return MTLVertexFormatFloat4;
     case VertexAttributeFormat::uchar4:
         return MTLVertexFormatUChar4;
     case VertexAttributeFormat::uint:
@@ -81,6 +83,19 @@ constexpr MTLVertexFormat toMetalVertexAttributeFormat(VertexAttributeFormat for
     }
 }
 
+constexpr MTLVertexStepFunction toMTLVertexStepFunction(VertexStepFunction stepFunction)
+{
+    switch (stepFunction)
+    {
+    case VertexStepFunction::perVertex:
+        return MTLVertexStepFunctionPerVertex;
+    case VertexStepFunction::perInstance:
+        return MTLVertexStepFunctionPerInstance;
+    default:
+        throw std::runtime_error("not implemented");
+    }
+}
+
 constexpr MTLResourceUsage toMTLResourceUsage(BindingUsages usages)
 {
     MTLResourceUsage mtlResourceUsage = 0;
@@ -93,6 +108,10 @@ constexpr MTLResourceUsage toMTLResourceUsage(BindingUsages usages)
         mtlResourceUsage |= MTLResourceUsageRead;
     if (usages & BindingUsage::fragmentWrite)
         mtlResourceUsage |= MTLResourceUsageWrite;
+    if (usages & BindingUsage::computeRead)
+        mtlResourceUsage |= MTLResourceUsageRead;
+    if (usages & BindingUsage::computeWrite)
+        mtlResourceUsage |= MTLResourceUsageWrite;
 
     return mtlResourceUsage;
 }
@@ -123,6 +142,8 @@ constexpr MTLTextureUsage toMTLTextureUsage(TextureUsages use)
         mtlTextureUsage |= MTLTextureUsageRenderTarget;
     if (use & TextureUsage::depthStencilAttachment)
         mtlTextureUsage |= MTLTextureUsageRenderTarget;
+    if (use & TextureUsage::shaderWrite)
+        mtlTextureUsage |= MTLTextureUsageShaderWrite;
 
     return mtlTextureUsage;
 }
@@ -196,6 +217,19 @@ constexpr MTLCullMode toMTLCullMode(CullMode cullMode)
     }
 }
 
+constexpr MTLIndexType toMTLIndexType(IndexType type)
+{
+    switch (type)
+    {
+    case IndexType::uint16:
+        return MTLIndexTypeUInt16;
+    case IndexType::uint32:
+        return MTLIndexTypeUInt32;
+    default:
+        throw std::runtime_error("not implemented");
+    }
+}
+
 }
 
 #endif
@@ -34,6 +34,9 @@ public:
     inline id<MTLDepthStencilState> depthStencilState() const { return m_depthStencilState; }
     inline CullMode cullMode() const { return m_cullMode; }
 
+    // parameter blocks use the indices 0 to 4 and push constants the index 6, vertex buffer 0 keeps the index 5
+    static constexpr NSUInteger vertexBufferIndex(uint32_t bufferIndex) { return bufferIndex == 0 ? 5 : 6 + bufferIndex; }
+
     ~MetalGraphicsPipeline() override = default;
 
 private:
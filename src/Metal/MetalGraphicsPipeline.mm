@@ -37,12 +37,20 @@ MetalGraphicsPipeline::MetalGraphicsPipeline(const MetalDevice& device, const Gr
     if (auto& vertexLayout = desc.vertexLayout)
     {
         MTLVertexDescriptor* vertexDescriptor = [MTLVertexDescriptor vertexDescriptor];
-        vertexDescriptor.layouts[5].stride = vertexLayout->stride;
+        for (uint32_t i = 0; const auto& buffer : vertexLayout->buffers)
+        {
+            const NSUInteger index = vertexBufferIndex(i);
+            vertexDescriptor.layouts[index].stride = buffer.stride;
+            vertexDescriptor.layouts[index].stepFunction = toMTLVertexStepFunction(buffer.stepFunction);
+            vertexDescriptor.layouts[index].stepRate = buffer.stepRate;
+            i++;
+        }
         for (uint32_t i = 0; const auto& element : vertexLayout->attributes)
         {
+            assert(element.bufferIndex < vertexLayout->buffers.size());
             vertexDescriptor.attributes[i].format = (MTLVertexFormat)toMetalVertexAttributeFormat(element.format);
             vertexDescriptor.attributes[i].offset = element.offset;
-            vertexDescriptor.attributes[i].bufferIndex = 5;
+            vertexDescriptor.attributes[i].bufferIndex = vertexBufferIndex(element.bufferIndex);
             i++;
         }
         renderPipelineDescriptor.vertexDescriptor = vertexDescriptor;
@@ -44,7 +44,8 @@ public:
 
     inline std::shared_ptr<ParameterBlockLayout> layout() const override { return m_layout; }
 
-    void setBinding(uint32_t idx, const std::shared_ptr<Buffer>&) override;
+    using ParameterBlock::setBinding;
+    void setBinding(uint32_t idx, const std::shared_ptr<Buffer>&, size_t offset, size_t size) override;
 
     void setBinding(uint32_t idx, const std::shared_ptr<Texture>&) override;
     void setBinding(uint32_t idx, uint32_t arrayIndex, const std::shared_ptr<Texture>&) override;
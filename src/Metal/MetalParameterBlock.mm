@@ -51,13 +51,14 @@ MetalParameterBlock::MetalParameterBlock(const std::shared_ptr<MetalParameterBlo
     m_encodedSamplers.resize(m_layout->bindings().size());
 }
 
-void MetalParameterBlock::setBinding(uint32_t idx, const std::shared_ptr<Buffer>& aBuffer) { @autoreleasepool
+void MetalParameterBlock::setBinding(uint32_t idx, const std::shared_ptr<Buffer>& aBuffer, size_t offset, size_t size) { @autoreleasepool
 {
     auto buffer = std::dynamic_pointer_cast<MetalBuffer>(aBuffer);
     assert(buffer);
+    assert(offset + size <= buffer->size());
 
     auto* content = std::bit_cast<uint64_t*>(m_argumentBuffer->content<std::byte>() + m_offset);
-    content[bindingOffset(*m_layout, idx)] = buffer->mtlBuffer().gpuAddress;
+    content[bindingOffset(*m_layout, idx)] = buffer->mtlBuffer().gpuAddress + offset;
     auto& encodedBuffers = m_encodedBuffers.at(idx);
     encodedBuffers.insert_or_assign(0, EncodedResource<MetalBuffer>{
         .resource = buffer,
@@ -77,7 +78,7 @@ void MetalParameterBlock::setBinding(uint32_t idx, uint32_t arrayIndex, const st
 
 void MetalParameterBlock::setBinding(uint32_t idx, uint32_t firstArrayIndex, std::span<const std::shared_ptr<Texture>> textures) { @autoreleasepool
 {
-    assert(m_layout->bindings().at(idx).type == BindingType::sampledTexture);
+    assert(m_layout->bindings().at(idx).type == BindingType::sampledTexture || m_layout->bindings().at(idx).type == BindingType::storageTexture);
     assert(firstArrayIndex + textures.size() <= m_layout->bindings().at(idx).count);
 
     auto* content = std::bit_cast<MTLResourceID*>(m_argumentBuffer->content<std::byte>() + m_offset);
@@ -131,6 +132,7 @@ void MetalParameterBlock::clearBinding(uint32_t idx, uint32_t firstArrayIndex, u
         eraseBindingRange(m_encodedBuffers.at(idx));
         break;
     case BindingType::sampledTexture:
+    case BindingType::storageTexture:
         eraseBindingRange(m_encodedTextures.at(idx));
         break;
     case BindingType::sampler:
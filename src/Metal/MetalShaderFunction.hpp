@@ -26,14 +26,19 @@ public:
     MetalShaderFunction(const MetalShaderFunction&) = delete;
     MetalShaderFunction(MetalShaderFunction&&) noexcept ;
 
-    MetalShaderFunction(const id<MTLLibrary>&, const std::string&);
+    MetalShaderFunction(const id<MTLLibrary>&, uint64_t libraryId, const std::string&);
 
     inline id<MTLFunction> mtlFunction() { return m_mtlFunction; }
+    // identical libraries share the same id, used to find equivalent pipelines
+    inline uint64_t libraryId() const { return m_libraryId; }
+    inline const std::string& name() const { return m_name; }
 
     ~MetalShaderFunction() override = default;
 
 private:
     id<MTLFunction> m_mtlFunction;
+    uint64_t m_libraryId;
+    std::string m_name;
 
 public:
     MetalShaderFunction& operator=(const MetalShaderFunction&) = delete;
@@ -14,11 +14,12 @@ namespace gfx
 {
 
 MetalShaderFunction::MetalShaderFunction(MetalShaderFunction&& other) noexcept
-    : m_mtlFunction(other.m_mtlFunction)
+    : m_mtlFunction(other.m_mtlFunction), m_libraryId(other.m_libraryId), m_name(std::move(other.m_name))
 {
 }
 
-MetalShaderFunction::MetalShaderFunction(const id<MTLLibrary>& mtlLibrary, const std::string& name) { @autoreleasepool
+MetalShaderFunction::MetalShaderFunction(const id<MTLLibrary>& mtlLibrary, uint64_t libraryId, const std::string& name)
+    : m_libraryId(libraryId), m_name(name) { @autoreleasepool
 {
     NSString* functionNameNSString = [[NSString alloc] initWithCString:name.c_str() encoding:NSUTF8StringEncoding];
     m_mtlFunction = [mtlLibrary newFunctionWithName:functionNameNSString];
@@ -32,6 +33,8 @@ MetalShaderFunction& MetalShaderFunction::operator=(MetalShaderFunction&& other)
     {
         ShaderFunction::operator=(std::move(other));
         m_mtlFunction = other.m_mtlFunction;
+        m_libraryId = other.m_libraryId;
+        m_name = std::move(other.m_name);
     }
     return *this;
 }}
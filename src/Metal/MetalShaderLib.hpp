@@ -14,6 +14,8 @@
 
 #include "Metal/MetalShaderFunction.hpp"
 
+#include <memory>
+
 #if !defined(__OBJC__)
 #error this file can only by used in objective c
 #endif
@@ -25,6 +27,14 @@ class MetalDevice;
 
 class MetalShaderLib : public ShaderLib
 {
+public:
+    // shared by the libraries loaded from identical bytes while one of them is alive
+    struct LibraryId
+    {
+        uint64_t value; // never reused, so pipelines of a destroyed library are never matched
+        std::vector<std::byte> metalBytes;
+    };
+
 public:
     MetalShaderLib() = delete;
     MetalShaderLib(const MetalShaderLib&) = delete;
@@ -38,6 +48,7 @@ public:
 
 private:
     id<MTLLibrary> m_mtlLibrary;
+    std::shared_ptr<const LibraryId> m_libraryId;
 
     std::map<std::string, MetalShaderFunction> m_shaderFunctions;
 
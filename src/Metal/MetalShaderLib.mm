@@ -27,6 +27,8 @@ MetalShaderLib::MetalShaderLib(const MetalDevice& device, const std::filesystem:
 
     if (error != nil)
         throw std::runtime_error([error.localizedDescription cStringUsingEncoding:NSUTF8StringEncoding]);
+
+    m_libraryId = device.shaderLibraryId(m_metalBytes);
 }}
 
 MetalShaderFunction& MetalShaderLib::getFunction(const std::string& name) { @autoreleasepool
@@ -34,7 +36,7 @@ MetalShaderFunction& MetalShaderLib::getFunction(const std::string& name) { @aut
     auto it = m_shaderFunctions.find(name);
     if (it == m_shaderFunctions.end())
     {
-        auto [newIt, res] = m_shaderFunctions.emplace(name, MetalShaderFunction(m_mtlLibrary, name));
+        auto [newIt, res] = m_shaderFunctions.emplace(name, MetalShaderFunction(m_mtlLibrary, m_libraryId->value, name));
         assert(res);
         it = newIt;
     }
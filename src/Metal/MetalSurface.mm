@@ -36,8 +36,10 @@ const std::set<PixelFormat> MetalSurface::supportedPixelFormats(const Device&) c
 
 const std::set<PresentMode> MetalSurface::supportedPresentModes(const Device&) const
 {
+    // displaySyncEnabled only choose between vsync and no vsync
     return {
-        PresentMode::fifo
+        PresentMode::fifo,
+        PresentMode::immediate
     };
 }
 
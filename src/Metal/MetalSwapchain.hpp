@@ -34,7 +34,16 @@ public:
 
     inline const Texture::Descriptor& drawablesTextureDescriptor() const override { return m_swapchainImagesDescriptor; }
 
-    std::shared_ptr<Drawable> nextDrawable() override;
+    using Swapchain::nextDrawable;
+    std::shared_ptr<Drawable> nextDrawable(std::chrono::nanoseconds timeout) override;
+
+    // the layer resize its drawables itself
+    inline bool isOutOfDate() const override { return false; }
+
+    using Swapchain::waitPresents;
+    bool waitPresents(uint32_t maxPendingPresents, std::chrono::nanoseconds timeout) override;
+
+    FrameStatistics frameStatistics() const override;
 
     ~MetalSwapchain() override = default;
 
@@ -45,6 +54,9 @@ private:
     std::vector<std::shared_ptr<MetalDrawable>> m_drawables;
     uint32_t m_nextDrawableIndex = 0;
 
+    std::shared_ptr<MetalPresentHistory> m_presentHistory;
+    std::chrono::nanoseconds m_lastAcquireDuration{0};
+
 public:
     MetalSwapchain& operator=(const MetalSwapchain&) = delete;
     MetalSwapchain& operator=(MetalSwapchain&&) = delete;
@@ -40,21 +40,56 @@ MetalSwapchain::MetalSwapchain(const MetalDevice& device, const Swapchain::Descr
         m_mtlLayer.device = device.mtlDevice();
         m_mtlLayer.drawableSize = CGSize{CGFloat(desc.width), CGFloat(desc.height)};
         m_mtlLayer.pixelFormat = toMTLPixelFormat(desc.pixelFormat);
+        if (desc.presentMode == PresentMode::mailbox || desc.presentMode == PresentMode::fifoRelaxed)
+            throw std::runtime_error("mailbox and fifo relaxed present modes are not supported by the metal backend");
+        m_mtlLayer.displaySyncEnabled = desc.presentMode == PresentMode::immediate ? NO : YES;
 
+        m_presentHistory = std::make_shared<MetalPresentHistory>();
         m_drawables.resize(desc.drawableCount);
         for (auto& drawable : m_drawables)
-            drawable = std::make_shared<MetalDrawable>(m_swapchainImagesDescriptor);
+            drawable = std::make_shared<MetalDrawable>(m_swapchainImagesDescriptor, m_presentHistory);
 
     }
 }
 
-std::shared_ptr<Drawable> MetalSwapchain::nextDrawable() { @autoreleasepool
+std::shared_ptr<Drawable> MetalSwapchain::nextDrawable(std::chrono::nanoseconds timeout) { @autoreleasepool
 {
     ZoneScoped;
+    // the layer can only time out after one second, any finite timeout use it
+    m_mtlLayer.allowsNextDrawableTimeout = timeout == std::chrono::nanoseconds::max() ? NO : YES;
+
+    const auto acquireStart = std::chrono::steady_clock::now();
+    id<CAMetalDrawable> mtlDrawable = [m_mtlLayer nextDrawable];
+    m_lastAcquireDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - acquireStart);
+    if (mtlDrawable == nil)
+        return nullptr;
+
     std::shared_ptr<MetalDrawable> nextDrawable = m_drawables.at(m_nextDrawableIndex);
     m_nextDrawableIndex = (m_nextDrawableIndex + 1) % m_drawables.size();
-    nextDrawable->setMtlDrawable([m_mtlLayer nextDrawable]);
+    nextDrawable->setMtlDrawable(mtlDrawable);
     return nextDrawable;
 }}
 
+bool MetalSwapchain::waitPresents(uint32_t maxPendingPresents, std::chrono::nanoseconds timeout)
+{
+    ZoneScoped;
+    std::unique_lock lock(m_presentHistory->mtx);
+    auto isDone = [&]() { return m_presentHistory->queuedCount - m_presentHistory->presentedCount <= maxPendingPresents; };
+    if (timeout == std::chrono::nanoseconds::max()) {
+        m_presentHistory->presentedCv.wait(lock, isDone);
+        return true;
+    }
+    return m_presentHistory->presentedCv.wait_for(lock, timeout, isDone);
+}
+
+Swapchain::FrameStatistics MetalSwapchain::frameStatistics() const
+{
+    std::scoped_lock lock(m_presentHistory->mtx);
+    return FrameStatistics{
+        .acquireDuration = m_lastAcquireDuration,
+        .presentToDisplayDuration = m_presentHistory->lastPresentToDisplayDuration,
+        .queueDepth = static_cast<uint32_t>(m_presentHistory->queuedCount - m_presentHistory->presentedCount)
+    };
+}
+
 }
@@ -29,6 +29,7 @@ MetalTexture::MetalTexture(const Texture::Descriptor& desc)
 MetalTexture::MetalTexture(const MetalDevice& device, const Texture::Descriptor& desc)
     : m_usages(desc.usages), m_storageMode(desc.storageMode) { @autoreleasepool
 {
+    assert(desc.storageMode != ResourceStorageMode::readback); // textures are read back through a buffer
     MTLTextureDescriptor* mtlTextureDescriptor = [[MTLTextureDescriptor alloc] init];
     mtlTextureDescriptor.textureType = toMTLTextureType(desc.type);
     mtlTextureDescriptor.pixelFormat = toMTLPixelFormat(desc.pixelFormat);
@@ -0,0 +1,61 @@
+/*
+ * ---------------------------------------------------
+ * MetalUploadRing.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 18:40:05
+ * ---------------------------------------------------
+ */
+
+#ifndef METALUPLOADRING_HPP
+#define METALUPLOADRING_HPP
+
+#include "Graphics/UploadRing.hpp"
+#include "Graphics/Buffer.hpp"
+
+#include "Metal/MetalBuffer.hpp"
+
+#if !defined(__OBJC__)
+#error this file can only by used in objective c
+#endif
+
+namespace gfx
+{
+
+class MetalDevice;
+
+class MetalUploadRing : public UploadRing
+{
+public:
+    MetalUploadRing() = delete;
+    MetalUploadRing(const MetalUploadRing&) = delete;
+    MetalUploadRing(MetalUploadRing&&) = delete;
+
+    MetalUploadRing(const MetalDevice&, const UploadRing::Descriptor&);
+
+    BufferSlice allocate(size_t size, size_t alignment = defaultAlignment) override;
+
+    inline uint32_t blockCount() const override { return static_cast<uint32_t>(m_blocks.size()); }
+
+    ~MetalUploadRing() override = default;
+
+private:
+    const MetalDevice* m_device;
+    UploadRing::Descriptor m_descriptor;
+
+    // command buffers keep their used buffers until they are waited,
+    // so a block only referenced by the ring is not used by the gpu anymore
+    std::vector<std::shared_ptr<MetalBuffer>> m_blocks;
+    size_t m_currentBlockIdx = 0;
+    size_t m_currentOffset = 0;
+
+    std::shared_ptr<MetalBuffer> newBlock(size_t size) const;
+
+public:
+    MetalUploadRing& operator=(const MetalUploadRing&) = delete;
+    MetalUploadRing& operator=(MetalUploadRing&&) = delete;
+};
+
+} // namespace gfx
+
+#endif // METALUPLOADRING_HPP
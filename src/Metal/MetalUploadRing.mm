@@ -0,0 +1,66 @@
+/*
+ * ---------------------------------------------------
+ * MetalUploadRing.mm
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 18:44:52
+ * ---------------------------------------------------
+ */
+
+#include "Graphics/UploadRing.hpp"
+#include "Graphics/Buffer.hpp"
+
+#include "Metal/MetalUploadRing.hpp"
+#include "Metal/MetalBuffer.hpp"
+#include "Metal/MetalDevice.hpp"
+
+namespace gfx
+{
+
+MetalUploadRing::MetalUploadRing(const MetalDevice& device, const UploadRing::Descriptor& desc)
+    : m_device(&device), m_descriptor(desc)
+{
+    assert(m_descriptor.blockSize > 0);
+
+    m_blocks.push_back(newBlock(m_descriptor.blockSize));
+}
+
+BufferSlice MetalUploadRing::allocate(size_t size, size_t alignment)
+{
+    assert(size > 0);
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    if (size > m_descriptor.blockSize)
+        return BufferSlice{ .buffer = newBlock(size), .offset = 0, .size = size };
+
+    size_t offset = (m_currentOffset + alignment - 1) & ~(alignment - 1);
+    if (offset + size > m_descriptor.blockSize)
+    {
+        size_t i = 1;
+        for (; i <= m_blocks.size(); i++) {
+            if (m_blocks[(m_currentBlockIdx + i) % m_blocks.size()].use_count() == 1)
+                break;
+        }
+        if (i <= m_blocks.size())
+            m_currentBlockIdx = (m_currentBlockIdx + i) % m_blocks.size();
+        else {
+            m_currentBlockIdx++;
+            m_blocks.insert(std::next(m_blocks.begin(), static_cast<std::ptrdiff_t>(m_currentBlockIdx)), newBlock(m_descriptor.blockSize));
+        }
+        offset = 0;
+    }
+
+    m_currentOffset = offset + size;
+    return BufferSlice{ .buffer = m_blocks[m_currentBlockIdx], .offset = offset, .size = size };
+}
+
+std::shared_ptr<MetalBuffer> MetalUploadRing::newBlock(size_t size) const
+{
+    return std::make_shared<MetalBuffer>(*m_device, Buffer::Descriptor{
+        .size = size,
+        .usages = m_descriptor.usages,
+        .storageMode = ResourceStorageMode::hostVisible
+    });
+}
+
+} // namespace gfx
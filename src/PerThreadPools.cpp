@@ -0,0 +1,91 @@
+/*
+ * ---------------------------------------------------
+ * PerThreadPools.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 18:51:30
+ * ---------------------------------------------------
+ */
+
+#include "Graphics/PerThreadPools.hpp"
+#include "Graphics/Device.hpp"
+
+#include <atomic>
+
+namespace gfx
+{
+
+namespace
+{
+
+// owned by a thread_local, so it is destroyed when its thread is finished
+struct ThreadLifetime
+{
+    uint64_t key;
+};
+
+std::atomic<uint64_t> s_nextThreadKey = 1;
+
+const std::shared_ptr<const ThreadLifetime>& threadLifetime()
+{
+    thread_local const std::shared_ptr<const ThreadLifetime> lifetime = std::make_shared<const ThreadLifetime>(ThreadLifetime{ .key = s_nextThreadKey++ });
+    return lifetime;
+}
+
+}
+
+PerThreadPools::PerThreadPools(const Device& device, const Descriptor& descriptor)
+    : m_device(&device), m_descriptor(descriptor)
+{
+}
+
+CommandBufferPool& PerThreadPools::commandBufferPool()
+{
+    return *threadPools().commandBufferPool;
+}
+
+ParameterBlockPool& PerThreadPools::parameterBlockPool()
+{
+    ThreadPools& pools = threadPools();
+    if (pools.parameterBlockPool == nullptr)
+        throw std::runtime_error("PerThreadPools created without parameter block pool descriptor");
+    return *pools.parameterBlockPool;
+}
+
+void PerThreadPools::reset()
+{
+    std::scoped_lock lock(m_mtx);
+    // the command buffers of a finished thread are completed like the other ones, its pools are not needed anymore
+    std::erase_if(m_threadPools, [](const auto& entry) { return entry.second.thread.expired(); });
+    for (auto& [threadKey, pools] : m_threadPools) {
+        pools.commandBufferPool->reset();
+        if (pools.parameterBlockPool != nullptr)
+            pools.parameterBlockPool->reset();
+    }
+}
+
+size_t PerThreadPools::threadCount() const
+{
+    std::scoped_lock lock(m_mtx);
+    return m_threadPools.size();
+}
+
+PerThreadPools::ThreadPools& PerThreadPools::threadPools()
+{
+    const std::shared_ptr<const ThreadLifetime>& lifetime = threadLifetime();
+
+    std::scoped_lock lock(m_mtx);
+    // references to the elements of an unordered_map stay valid when other elements are inserted
+    auto it = m_threadPools.find(lifetime->key);
+    if (it != m_threadPools.end())
+        return it->second;
+
+    ThreadPools pools;
+    pools.thread = lifetime;
+    pools.commandBufferPool = m_device->newCommandBufferPool(m_descriptor.queueType);
+    if (m_descriptor.parameterBlockPool.has_value())
+        pools.parameterBlockPool = m_device->newParameterBlockPool(*m_descriptor.parameterBlockPool);
+    return m_threadPools.emplace(lifetime->key, std::move(pools)).first->second;
+}
+
+} // namespace gfx
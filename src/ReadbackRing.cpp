@@ -0,0 +1,81 @@
+/*
+ * ---------------------------------------------------
+ * ReadbackRing.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/18 00:07:41
+ * ---------------------------------------------------
+ */
+
+#include "Graphics/ReadbackRing.hpp"
+#include "Graphics/Device.hpp"
+
+namespace gfx
+{
+
+ReadbackRing::ReadbackRing(Device& device, const Descriptor& descriptor)
+    : m_device(&device)
+{
+    assert(descriptor.slotSize > 0);
+    assert(descriptor.slotCount > 0);
+    const size_t slotSize = (descriptor.slotSize + slotAlignment - 1) & ~(slotAlignment - 1);
+
+    // a single buffer, the slots are ranges of it
+    std::shared_ptr<Buffer> buffer = m_device->newBuffer(Buffer::Descriptor{
+        .size = slotSize * descriptor.slotCount,
+        .usages = BufferUsage::copyDestination,
+        .storageMode = ResourceStorageMode::readback
+    });
+
+    m_slots.resize(descriptor.slotCount);
+    for (size_t i = 0; i < m_slots.size(); i++)
+        m_slots[i].slice = BufferSlice{ .buffer = buffer, .offset = i * slotSize, .size = descriptor.slotSize };
+}
+
+std::optional<BufferSlice> ReadbackRing::acquire()
+{
+    if (m_usedSlotCount == slotCount()) {
+        m_statistics.droppedCount++;
+        return std::nullopt;
+    }
+    Slot& slot = m_slots[(m_oldestSlot + m_usedSlotCount) % slotCount()];
+    assert(slot.state == SlotState::available);
+    slot.state = SlotState::acquired;
+    m_usedSlotCount++;
+    return slot.slice;
+}
+
+void ReadbackRing::commit(const SubmitTicket& ticket)
+{
+    // the acquired slots are the newest ones
+    for (uint32_t i = m_usedSlotCount; i > 0; i--)
+    {
+        Slot& slot = m_slots[(m_oldestSlot + i - 1) % slotCount()];
+        if (slot.state != SlotState::acquired)
+            break;
+        slot.ticket = ticket;
+        slot.state = SlotState::committed;
+    }
+}
+
+std::optional<BufferSlice> ReadbackRing::tryRead() const
+{
+    if (m_usedSlotCount == 0)
+        return std::nullopt;
+    const Slot& slot = m_slots[m_oldestSlot];
+    if (slot.state != SlotState::committed || m_device->isCompleted(slot.ticket) == false)
+        return std::nullopt;
+    return slot.slice;
+}
+
+void ReadbackRing::release()
+{
+    assert(tryRead().has_value());
+    m_slots[m_oldestSlot].state = SlotState::available;
+    m_slots[m_oldestSlot].ticket = SubmitTicket{};
+    m_oldestSlot = (m_oldestSlot + 1) % slotCount();
+    m_usedSlotCount--;
+    m_statistics.readCount++;
+}
+
+} // namespace gfx
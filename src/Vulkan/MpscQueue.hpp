@@ -0,0 +1,79 @@
+/*
+ * ---------------------------------------------------
+ * MpscQueue.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 19:47:12
+ * ---------------------------------------------------
+ */
+
+#ifndef MPSCQUEUE_HPP
+#define MPSCQUEUE_HPP
+
+namespace gfx
+{
+
+// unbounded multi producer single consumer queue, push never take a lock.
+// a push is only visible once it is linked to the previous one, so pop can return nothing
+// while an other push is in progress even if later pushes are done
+template<typename T>
+class MpscQueue
+{
+public:
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue(MpscQueue&&) = delete;
+
+    MpscQueue()
+        : m_head(new Node), m_tail(m_head.load(std::memory_order_relaxed))
+    {
+    }
+
+    // can be called by any thread
+    void push(T value)
+    {
+        auto* node = new Node; // NOLINT(cppcoreguidelines-owning-memory)
+        node->value.emplace(std::move(value));
+        Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // only called by the consumer thread
+    std::optional<T> pop()
+    {
+        Node* next = m_tail->next.load(std::memory_order_acquire);
+        if (next == nullptr)
+            return std::nullopt;
+        std::optional<T> value = std::move(next->value);
+        next->value.reset();
+        delete m_tail; // NOLINT(cppcoreguidelines-owning-memory)
+        m_tail = next; // the popped node is the new stub
+        return value;
+    }
+
+    ~MpscQueue()
+    {
+        while (m_tail != nullptr) {
+            Node* next = m_tail->next.load(std::memory_order_relaxed);
+            delete m_tail; // NOLINT(cppcoreguidelines-owning-memory)
+            m_tail = next;
+        }
+    }
+
+private:
+    struct Node
+    {
+        std::atomic<Node*> next = nullptr;
+        std::optional<T> value;
+    };
+
+    std::atomic<Node*> m_head; // last pushed node
+    Node* m_tail;              // stub node, its next is the first value to pop
+
+public:
+    MpscQueue& operator=(const MpscQueue&) = delete;
+    MpscQueue& operator=(MpscQueue&&) = delete;
+};
+
+} // namespace gfx
+
+#endif // MPSCQUEUE_HPP
@@ -0,0 +1,248 @@
+/*
+ * ---------------------------------------------------
+ * ObjectCache.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 17:31:02
+ * ---------------------------------------------------
+ */
+
+#include "Vulkan/ObjectCache.hpp"
+#include "Vulkan/VulkanDevice.hpp"
+#include "Vulkan/VulkanEnums.hpp"
+#include "Vulkan/VulkanGraphicsPipeline.hpp"
+#include "Vulkan/VulkanShaderFunction.hpp"
+
+#include <string_view>
+
+namespace gfx
+{
+
+namespace
+{
+
+template<typename T>
+void hashCombine(size_t& seed, const T& value)
+{
+    seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+}
+
+ObjectCache::ObjectCache(const VulkanDevice* device)
+    : m_device(device)
+{
+    assert(m_device);
+}
+
+std::shared_ptr<const ObjectCache::ShaderModule> ObjectCache::shaderModule(std::span<const std::byte> spirv)
+{
+    const size_t hash = Hash{}(spirv);
+
+    std::scoped_lock lock(m_shaderModulesMtx);
+
+    auto [begin, end] = m_shaderModules.equal_range(hash);
+    for (auto it = begin; it != end;) {
+        if (std::shared_ptr<const ShaderModule> shaderModule = it->second.lock()) {
+            if (std::ranges::equal(shaderModule->code, spirv))
+                return shaderModule;
+            ++it;
+        }
+        else
+            it = m_shaderModules.erase(it);
+    }
+
+    std::vector<std::byte> code(spirv.begin(), spirv.end());
+
+    auto shaderModuleCreateInfo = vk::ShaderModuleCreateInfo{}
+        .setCodeSize(code.size())
+        .setPCode(std::bit_cast<const uint32_t*>(code.data()));
+
+    vk::ShaderModule vkShaderModule = m_device->vkDevice().createShaderModule(shaderModuleCreateInfo);
+
+    auto shaderModule = std::shared_ptr<const ShaderModule>(
+        new ShaderModule{ .vkShaderModule = vkShaderModule, .id = m_nextShaderModuleId++, .code = std::move(code) },
+        [device = m_device](const ShaderModule* ptr) {
+            device->vkDevice().destroyShaderModule(ptr->vkShaderModule);
+            delete ptr; // NOLINT(cppcoreguidelines-owning-memory)
+        });
+    m_shaderModules.emplace(hash, shaderModule);
+    return shaderModule;
+}
+
+vk::DescriptorSetLayout ObjectCache::descriptorSetLayout(const ParameterBlockLayout::Descriptor& desc)
+{
+    std::scoped_lock lock(m_layoutsMtx);
+
+    auto it = m_descriptorSetLayouts.find(desc.bindings);
+    if (it != m_descriptorSetLayouts.end())
+        return it->second;
+
+    std::vector<vk::DescriptorSetLayoutBinding> vkBindings;
+    std::vector<vk::DescriptorBindingFlags> bindingFlags;
+    vkBindings.reserve(desc.bindings.size());
+    bindingFlags.reserve(desc.bindings.size());
+
+    for (uint32_t i = 0; const auto& binding : desc.bindings) {
+        assert(binding.count > 0);
+        assert(binding.type == BindingType::sampledTexture || binding.count == 1);
+
+        vkBindings.push_back(vk::DescriptorSetLayoutBinding{}
+            .setBinding(i++)
+            .setDescriptorType(toVkDescriptorType(binding.type))
+            .setDescriptorCount(binding.count)
+            .setStageFlags(toVkShaderStageFlags(binding.usages)));
+
+        if (binding.count > 1)
+            bindingFlags.push_back(vk::DescriptorBindingFlagBits::eUpdateAfterBind | vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending | vk::DescriptorBindingFlagBits::ePartiallyBound);
+        else
+            bindingFlags.emplace_back();
+    }
+
+    auto bindingFlagsCreateInfo = vk::DescriptorSetLayoutBindingFlagsCreateInfo{}
+        .setBindingFlags(bindingFlags);
+
+    auto descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo{}
+        .setPNext(&bindingFlagsCreateInfo)
+        .setBindings(vkBindings);
+
+    if (std::ranges::any_of(bindingFlags, [](const vk::DescriptorBindingFlags& e) -> bool { return static_cast<bool>(e);}))
+        descriptorSetLayoutCreateInfo.setFlags(vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool);
+
+    vk::DescriptorSetLayout descriptorSetLayout = m_device->vkDevice().createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
+    m_descriptorSetLayouts.emplace(desc.bindings, descriptorSetLayout);
+    return descriptorSetLayout;
+}
+
+vk::PipelineLayout ObjectCache::pipelineLayout(std::span<const vk::DescriptorSetLayout> descriptorSetLayouts)
+{
+    std::vector<vk::DescriptorSetLayout> key(descriptorSetLayouts.begin(), descriptorSetLayouts.end());
+
+    std::scoped_lock lock(m_layoutsMtx);
+
+    auto it = m_pipelineLayouts.find(key);
+    if (it != m_pipelineLayouts.end())
+        return it->second;
+
+    auto pushConstantRange = vk::PushConstantRange{}
+        .setStageFlags(pushConstantStages)
+        .setOffset(0)
+        .setSize(128);
+
+    auto pipelineLayoutCreateInfo = vk::PipelineLayoutCreateInfo{}
+        .setSetLayouts(descriptorSetLayouts)
+        .setPushConstantRanges(pushConstantRange);
+
+    vk::PipelineLayout pipelineLayout = m_device->vkDevice().createPipelineLayout(pipelineLayoutCreateInfo);
+    m_pipelineLayouts.emplace(std::move(key), pipelineLayout);
+    return pipelineLayout;
+}
+
+std::shared_ptr<GraphicsPipeline> ObjectCache::graphicsPipeline(const GraphicsPipeline::Descriptor& desc)
+{
+    auto* vertFunc = dynamic_cast<VulkanShaderFunction*>(desc.vertexShader);
+    auto* fragFunc = dynamic_cast<VulkanShaderFunction*>(desc.fragmentShader);
+    assert(vertFunc && fragFunc);
+
+    GraphicsPipelineKey key = {
+        .vertexModuleId = vertFunc->shaderModuleId(),
+        .vertexEntryPoint = vertFunc->name(),
+        .fragmentModuleId = fragFunc->shaderModuleId(),
+        .fragmentEntryPoint = fragFunc->name(),
+        .vertexLayout = desc.vertexLayout,
+        .colorAttachmentPxFormats = desc.colorAttachmentPxFormats,
+        .depthAttachmentPxFormat = desc.depthAttachmentPxFormat,
+        .blendOperation = desc.blendOperation,
+        .cullMode = desc.cullMode,
+        .pipelineLayout = VulkanGraphicsPipeline::sharedPipelineLayout(m_device, desc)
+    };
+
+    {
+        std::scoped_lock lock(m_graphicsPipelinesMtx);
+        auto it = m_graphicsPipelines.find(key);
+        if (it != m_graphicsPipelines.end()) {
+            if (std::shared_ptr<GraphicsPipeline> pipeline = it->second.lock())
+                return pipeline;
+        }
+    }
+
+    // compiled without the lock so lookups of other pipelines are not blocked
+    std::shared_ptr<GraphicsPipeline> pipeline = std::make_shared<VulkanGraphicsPipeline>(m_device, desc);
+
+    std::scoped_lock lock(m_graphicsPipelinesMtx);
+    auto [it, inserted] = m_graphicsPipelines.try_emplace(std::move(key), pipeline);
+    if (inserted == false) {
+        if (std::shared_ptr<GraphicsPipeline> existing = it->second.lock())
+            return existing; // an equivalent pipeline was created by an other thread in the meantime
+        it->second = pipeline;
+    }
+    else if (m_graphicsPipelines.size() >= m_graphicsPipelinesPruneSize) {
+        // expired entries are replaced when looked up, the other ones are removed each time the map double
+        std::erase_if(m_graphicsPipelines, [](const auto& entry) { return entry.second.expired(); });
+        m_graphicsPipelinesPruneSize = std::max(minPruneSize, m_graphicsPipelines.size() * 2);
+    }
+    return pipeline;
+}
+
+ObjectCache::~ObjectCache()
+{
+    for (auto& [_, pipelineLayout] : m_pipelineLayouts)
+        m_device->vkDevice().destroyPipelineLayout(pipelineLayout);
+    for (auto& [_, descriptorSetLayout] : m_descriptorSetLayouts)
+        m_device->vkDevice().destroyDescriptorSetLayout(descriptorSetLayout);
+}
+
+size_t ObjectCache::Hash::operator()(std::span<const std::byte> bytes) const
+{
+    return std::hash<std::string_view>{}(std::string_view(std::bit_cast<const char*>(bytes.data()), bytes.size()));
+}
+
+size_t ObjectCache::Hash::operator()(const std::vector<ParameterBlockBinding>& bindings) const
+{
+    size_t seed = bindings.size();
+    for (const auto& binding : bindings) {
+        hashCombine(seed, static_cast<VkDescriptorType>(toVkDescriptorType(binding.type)));
+        hashCombine(seed, static_cast<VkShaderStageFlags>(toVkShaderStageFlags(binding.usages)));
+        hashCombine(seed, binding.count);
+    }
+    return seed;
+}
+
+size_t ObjectCache::Hash::operator()(const std::vector<vk::DescriptorSetLayout>& descriptorSetLayouts) const
+{
+    size_t seed = descriptorSetLayouts.size();
+    for (const auto& descriptorSetLayout : descriptorSetLayouts)
+        hashCombine(seed, static_cast<VkDescriptorSetLayout>(descriptorSetLayout));
+    return seed;
+}
+
+size_t ObjectCache::Hash::operator()(const GraphicsPipelineKey& key) const
+{
+    size_t seed = 0;
+    hashCombine(seed, key.vertexModuleId);
+    hashCombine(seed, key.vertexEntryPoint);
+    hashCombine(seed, key.fragmentModuleId);
+    hashCombine(seed, key.fragmentEntryPoint);
+    if (key.vertexLayout.has_value()) {
+        for (const auto& buffer : key.vertexLayout->buffers) {
+            hashCombine(seed, buffer.stride);
+            hashCombine(seed, buffer.stepFunction);
+            hashCombine(seed, buffer.stepRate);
+        }
+        for (const auto& attribute : key.vertexLayout->attributes) {
+            hashCombine(seed, attribute.format);
+            hashCombine(seed, attribute.offset);
+            hashCombine(seed, attribute.bufferIndex);
+        }
+    }
+    for (const auto& pxFormat : key.colorAttachmentPxFormats)
+        hashCombine(seed, pxFormat);
+    if (key.depthAttachmentPxFormat.has_value())
+        hashCombine(seed, key.depthAttachmentPxFormat.value());
+    hashCombine(seed, key.blendOperation);
+    hashCombine(seed, key.cullMode);
+    hashCombine(seed, static_cast<VkPipelineLayout>(key.pipelineLayout));
+    return seed;
+}
+
+} // namespace gfx
@@ -0,0 +1,105 @@
+/*
+ * ---------------------------------------------------
+ * ObjectCache.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 17:12:40
+ * ---------------------------------------------------
+ */
+
+#ifndef OBJECTCACHE_HPP
+#define OBJECTCACHE_HPP
+
+#include "Graphics/GraphicsPipeline.hpp"
+#include "Graphics/ParameterBlockLayout.hpp"
+
+#include <unordered_map>
+
+namespace gfx
+{
+
+class VulkanDevice;
+
+// device wide deduplication of the immutable objects created from equivalent descriptors.
+// lookups are hash based, so getting an existing object cost a hash and a comparison
+class ObjectCache
+{
+public:
+    struct ShaderModule
+    {
+        vk::ShaderModule vkShaderModule;
+        uint64_t id; // never reused, unlike the handle
+        std::vector<std::byte> code;
+    };
+
+    // every pipeline layout has a single push constant range visible to all the stages, so graphics and compute pipelines can share layouts
+    static constexpr vk::ShaderStageFlags pushConstantStages = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eCompute;
+
+public:
+    ObjectCache() = delete;
+    ObjectCache(const ObjectCache&) = delete;
+    ObjectCache(ObjectCache&&) = delete;
+
+    ObjectCache(const VulkanDevice*);
+
+    // modules with identical SPIR-V are created once and shared while alive
+    std::shared_ptr<const ShaderModule> shaderModule(std::span<const std::byte> spirv);
+
+    // layouts are owned by the cache and destroyed with the device
+    vk::DescriptorSetLayout descriptorSetLayout(const ParameterBlockLayout::Descriptor&);
+    vk::PipelineLayout pipelineLayout(std::span<const vk::DescriptorSetLayout>);
+
+    // return a living pipeline created with an equivalent descriptor, or create a new one.
+    // shader functions are compared by module and entry point, parameter block layouts by their vk::DescriptorSetLayout
+    std::shared_ptr<GraphicsPipeline> graphicsPipeline(const GraphicsPipeline::Descriptor&);
+
+    ~ObjectCache();
+
+private:
+    struct GraphicsPipelineKey
+    {
+        uint64_t vertexModuleId;
+        std::string vertexEntryPoint;
+        uint64_t fragmentModuleId;
+        std::string fragmentEntryPoint;
+        std::optional<VertexLayout> vertexLayout;
+        std::vector<PixelFormat> colorAttachmentPxFormats;
+        std::optional<PixelFormat> depthAttachmentPxFormat;
+        BlendOperation blendOperation;
+        CullMode cullMode;
+        vk::PipelineLayout pipelineLayout;
+
+        bool operator==(const GraphicsPipelineKey&) const = default;
+    };
+
+    struct Hash
+    {
+        size_t operator()(std::span<const std::byte>) const;
+        size_t operator()(const std::vector<ParameterBlockBinding>&) const;
+        size_t operator()(const std::vector<vk::DescriptorSetLayout>&) const;
+        size_t operator()(const GraphicsPipelineKey&) const;
+    };
+
+    const VulkanDevice* m_device;
+
+    std::mutex m_shaderModulesMtx;
+    uint64_t m_nextShaderModuleId = 1;
+    std::unordered_multimap<size_t, std::weak_ptr<const ShaderModule>> m_shaderModules; // keyed by the hash of the code
+
+    std::mutex m_layoutsMtx;
+    std::unordered_map<std::vector<ParameterBlockBinding>, vk::DescriptorSetLayout, Hash> m_descriptorSetLayouts;
+    std::unordered_map<std::vector<vk::DescriptorSetLayout>, vk::PipelineLayout, Hash> m_pipelineLayouts;
+
+    std::mutex m_graphicsPipelinesMtx;
+    std::unordered_map<GraphicsPipelineKey, std::weak_ptr<GraphicsPipeline>, Hash> m_graphicsPipelines;
+    static constexpr size_t minPruneSize = 64;
+    size_t m_graphicsPipelinesPruneSize = minPruneSize;
+
+public:
+    ObjectCache& operator=(const ObjectCache&) = delete;
+    ObjectCache& operator=(ObjectCache&&) = delete;
+};
+
+} // namespace gfx
+
+#endif // OBJECTCACHE_HPP
@@ -0,0 +1,97 @@
+/*
+ * ---------------------------------------------------
+ * PipelineCache.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 15:24:09
+ * ---------------------------------------------------
+ */
+
+#include "Vulkan/PipelineCache.hpp"
+#include "Vulkan/VulkanDevice.hpp"
+#include "Vulkan/VulkanPhysicalDevice.hpp"
+
+namespace gfx
+{
+
+PipelineCache::PipelineCache(const VulkanDevice* device, const std::filesystem::path& path, bool hasCreationFeedback)
+    : m_device(device), m_path(path), m_hasCreationFeedback(hasCreationFeedback)
+{
+    std::vector<char> initialData;
+    if (m_path.empty() == false && std::filesystem::exists(m_path))
+    {
+        std::ifstream file(m_path, std::ios::binary | std::ios::ate);
+        if (file.is_open()) {
+            initialData.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            if (!file.read(initialData.data(), static_cast<std::streamsize>(initialData.size())))
+                initialData.clear();
+        }
+        // some drivers do not validate the data and crash on a cache created by another device or driver version,
+        // the cache start empty and the file is overwritten by the next save
+        if (isCompatible(initialData) == false)
+            initialData.clear();
+    }
+
+    m_vkPipelineCache = m_device->vkDevice().createPipelineCache(vk::PipelineCacheCreateInfo{}
+        .setInitialDataSize(initialData.size())
+        .setPInitialData(initialData.data()));
+}
+
+void PipelineCache::recordCreation(bool cacheHit, std::chrono::nanoseconds duration)
+{
+    std::scoped_lock lock(m_statisticsMtx);
+    if (cacheHit) {
+        m_statistics.hitCount++;
+        m_statistics.hitDuration += duration;
+    } else {
+        m_statistics.missCount++;
+        m_statistics.missDuration += duration;
+    }
+}
+
+void PipelineCache::save() const
+{
+    if (m_path.empty())
+        return;
+
+    std::vector<uint8_t> data = m_device->vkDevice().getPipelineCacheData(m_vkPipelineCache);
+
+    // write a temporary file first so a crash during the write cannot leave a truncated cache behind
+    std::filesystem::path tmpPath = m_path;
+    tmpPath += ".tmp";
+    if (m_path.has_parent_path())
+        std::filesystem::create_directories(m_path.parent_path());
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            throw std::runtime_error("failed to open " + tmpPath.string());
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file)
+            throw std::runtime_error("failed to write " + tmpPath.string());
+    }
+    std::filesystem::rename(tmpPath, m_path);
+}
+
+PipelineCache::~PipelineCache()
+{
+    if (m_device != nullptr && m_vkPipelineCache)
+        m_device->vkDevice().destroyPipelineCache(m_vkPipelineCache);
+}
+
+bool PipelineCache::isCompatible(const std::vector<char>& data) const
+{
+    VkPipelineCacheHeaderVersionOne header{};
+    if (data.size() < sizeof(header))
+        return false;
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    const vk::PhysicalDeviceProperties properties = m_device->physicalDevice().getProperties();
+    return header.headerSize >= sizeof(header)
+        && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+        && header.vendorID == properties.vendorID
+        && header.deviceID == properties.deviceID
+        && std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+}
+
+} // namespace gfx
@@ -0,0 +1,64 @@
+/*
+ * ---------------------------------------------------
+ * PipelineCache.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 15:10:42
+ * ---------------------------------------------------
+ */
+
+#ifndef PIPELINECACHE_HPP
+#define PIPELINECACHE_HPP
+
+#include "Graphics/Device.hpp"
+
+namespace gfx
+{
+
+class VulkanDevice;
+
+// device wide vk::PipelineCache, optionally persisted to a file.
+// the file content is only used if its header match the physical device, otherwise the cache start empty
+class PipelineCache
+{
+public:
+    PipelineCache() = default;
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache(PipelineCache&&) = delete;
+
+    PipelineCache(const VulkanDevice*, const std::filesystem::path&, bool hasCreationFeedback);
+
+    inline const vk::PipelineCache& vkPipelineCache() const { return m_vkPipelineCache; }
+
+    // when supported, pipelines created with this chained in their create info report if the cache was hit
+    inline bool hasCreationFeedback() const { return m_hasCreationFeedback; }
+
+    // record the creation of a pipeline, a pipeline without creation feedback is counted as a miss
+    void recordCreation(bool cacheHit, std::chrono::nanoseconds duration);
+
+    inline Device::PipelineCacheStatistics statistics() const { std::scoped_lock lock(m_statisticsMtx); return m_statistics; }
+
+    // write the cache content to the file, does nothing if no path was given
+    void save() const;
+
+    ~PipelineCache();
+
+private:
+    const VulkanDevice* m_device = nullptr;
+    std::filesystem::path m_path;
+    vk::PipelineCache m_vkPipelineCache;
+    bool m_hasCreationFeedback = false;
+
+    mutable std::mutex m_statisticsMtx;
+    Device::PipelineCacheStatistics m_statistics;
+
+    bool isCompatible(const std::vector<char>& data) const;
+
+public:
+    PipelineCache& operator=(const PipelineCache&) = delete;
+    PipelineCache& operator=(PipelineCache&&) = delete;
+};
+
+} // namespace gfx
+
+#endif // PIPELINECACHE_HPP
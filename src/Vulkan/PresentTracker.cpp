@@ -0,0 +1,70 @@
+/*
+ * ---------------------------------------------------
+ * PresentTracker.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 23:44:52
+ * ---------------------------------------------------
+ */
+
+#include "Vulkan/PresentTracker.hpp"
+
+namespace gfx
+{
+
+uint64_t PresentTracker::queuePresent(uint64_t timelineValue)
+{
+    std::scoped_lock lock(m_mtx);
+    m_lastQueuedId++;
+    m_presents[m_lastQueuedId % historySize] = Present{
+        .timelineValue = timelineValue,
+        .queueTime = std::chrono::steady_clock::now()
+    };
+    return m_lastQueuedId;
+}
+
+void PresentTracker::setCompleted(uint64_t presentId, bool isDisplayed)
+{
+    const auto now = std::chrono::steady_clock::now();
+    std::scoped_lock lock(m_mtx);
+    assert(presentId <= m_lastQueuedId);
+    if (presentId <= m_lastCompletedId)
+        return;
+    m_lastCompletedId = presentId;
+    if (isDisplayed)
+        m_lastPresentToDisplayDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_presents[presentId % historySize].queueTime);
+}
+
+uint64_t PresentTracker::lastQueuedId() const
+{
+    std::scoped_lock lock(m_mtx);
+    return m_lastQueuedId;
+}
+
+uint64_t PresentTracker::lastCompletedId() const
+{
+    std::scoped_lock lock(m_mtx);
+    return m_lastCompletedId;
+}
+
+uint32_t PresentTracker::pendingCount() const
+{
+    std::scoped_lock lock(m_mtx);
+    return static_cast<uint32_t>(m_lastQueuedId - m_lastCompletedId);
+}
+
+uint64_t PresentTracker::timelineValue(uint64_t presentId) const
+{
+    std::scoped_lock lock(m_mtx);
+    if (presentId == 0 || presentId + historySize <= m_lastQueuedId)
+        return 0;
+    return m_presents[presentId % historySize].timelineValue;
+}
+
+std::chrono::nanoseconds PresentTracker::lastPresentToDisplayDuration() const
+{
+    std::scoped_lock lock(m_mtx);
+    return m_lastPresentToDisplayDuration;
+}
+
+} // namespace gfx
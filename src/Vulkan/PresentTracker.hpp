@@ -0,0 +1,70 @@
+/*
+ * ---------------------------------------------------
+ * PresentTracker.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 23:41:08
+ * ---------------------------------------------------
+ */
+
+#ifndef PRESENTTRACKER_HPP
+#define PRESENTTRACKER_HPP
+
+namespace gfx
+{
+
+// presents of a swapchain, shared by the swapchain and its drawables.
+// the ids are given by the thread presenting and completed by the thread calling nextDrawable or waitPresents.
+// a present is completed once displayed with the present wait extension, once rendered otherwise
+class PresentTracker
+{
+public:
+    PresentTracker() = default;
+    PresentTracker(const PresentTracker&) = delete;
+    PresentTracker(PresentTracker&&) = delete;
+
+    // ids start at 1 and are chained to the present with VkPresentIdKHR, timelineValue is the value of the presented batch
+    uint64_t queuePresent(uint64_t timelineValue);
+    // every present up to the id is completed, the present ids are completed in order
+    void setCompleted(uint64_t presentId, bool isDisplayed);
+
+    uint64_t lastQueuedId() const;
+    uint64_t lastCompletedId() const;
+    uint32_t pendingCount() const;
+    // 0 if the present is too old to be in the history, it is completed then
+    uint64_t timelineValue(uint64_t presentId) const;
+    std::chrono::nanoseconds lastPresentToDisplayDuration() const;
+
+    inline void setOutOfDate() { m_isOutOfDate.store(true, std::memory_order_relaxed); }
+    inline bool isOutOfDate() const { return m_isOutOfDate.load(std::memory_order_relaxed); }
+
+    // vkQueuePresentKHR and vkWaitForPresentKHR require the swapchain to be externally synchronized
+    inline std::mutex& swapchainMtx() { return m_swapchainMtx; }
+
+    ~PresentTracker() = default;
+
+private:
+    struct Present
+    {
+        uint64_t timelineValue = 0;
+        std::chrono::steady_clock::time_point queueTime;
+    };
+    // more than the presents that can be pending, a swapchain has less images than that
+    static constexpr size_t historySize = 16;
+
+    mutable std::mutex m_mtx;
+    std::array<Present, historySize> m_presents; // indexed by id % historySize
+    uint64_t m_lastQueuedId = 0;
+    uint64_t m_lastCompletedId = 0;
+    std::chrono::nanoseconds m_lastPresentToDisplayDuration{0};
+    std::atomic<bool> m_isOutOfDate = false;
+    std::mutex m_swapchainMtx;
+
+public:
+    PresentTracker& operator=(const PresentTracker&) = delete;
+    PresentTracker& operator=(PresentTracker&&) = delete;
+};
+
+} // namespace gfx
+
+#endif // PRESENTTRACKER_HPP
@@ -0,0 +1,188 @@
+/*
+ * ---------------------------------------------------
+ * RangeMap.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 14:02:18
+ * ---------------------------------------------------
+ */
+
+#ifndef RANGEMAP_HPP
+#define RANGEMAP_HPP
+
+// does not depend on the pch so it can be unit tested without vulkan
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace gfx
+{
+
+// associate values to disjoint half open ranges [begin, end).
+// ranges are kept sorted in a vector and adjacent ranges with equal values are merged,
+// a buffer usually have a handful of ranges so a vector is faster than a tree
+template<typename T>
+class RangeMap
+{
+public:
+    struct Range
+    {
+        uint64_t begin;
+        uint64_t end;
+        T value;
+
+        bool operator==(const Range&) const = default;
+    };
+
+public:
+    RangeMap() = default;
+    RangeMap(const RangeMap&) = default;
+    RangeMap(RangeMap&&) = default;
+
+    RangeMap(uint64_t begin, uint64_t end, const T& value)
+    {
+        assign(begin, end, value);
+    }
+
+    // set the value of [begin, end), overwriting the overlapped parts of existing ranges
+    void assign(uint64_t begin, uint64_t end, const T& value)
+    {
+        if (begin >= end)
+            return;
+
+        auto first = firstOverlapping(begin);
+        auto last = first;
+        while (last != m_ranges.end() && last->begin < end)
+            ++last;
+
+        if (first == last) {
+            size_t idx = std::distance(m_ranges.begin(), first);
+            m_ranges.insert(first, Range{ .begin = begin, .end = end, .value = value });
+            coalesce(idx);
+            return;
+        }
+
+        // first and last overlapping ranges can be partially covered
+        const bool keepLeft = first->begin < begin;
+        const bool keepRight = std::prev(last)->end > end;
+        Range left = *first;
+        left.end = begin;
+        Range right = *std::prev(last);
+        right.begin = end;
+
+        size_t idx = std::distance(m_ranges.begin(), first);
+        size_t overlappedCount = std::distance(first, last);
+        size_t newCount = 1 + (keepLeft ? 1 : 0) + (keepRight ? 1 : 0);
+
+        // reuse the overlapped elements instead of erasing and inserting
+        if (newCount > overlappedCount)
+            m_ranges.insert(m_ranges.begin() + static_cast<std::ptrdiff_t>(idx), newCount - overlappedCount, Range{ .begin = 0, .end = 0, .value = value });
+        else if (newCount < overlappedCount)
+            m_ranges.erase(m_ranges.begin() + static_cast<std::ptrdiff_t>(idx + newCount), m_ranges.begin() + static_cast<std::ptrdiff_t>(idx + overlappedCount));
+
+        size_t i = idx;
+        if (keepLeft)
+            m_ranges[i++] = left;
+        size_t assignedIdx = i;
+        m_ranges[i++] = Range{ .begin = begin, .end = end, .value = value };
+        if (keepRight)
+            m_ranges[i++] = right;
+
+        coalesce(assignedIdx);
+    }
+
+    // set the value of the parts of [begin, end) that are not already in a range
+    void fillGaps(uint64_t begin, uint64_t end, const T& value)
+    {
+        uint64_t cursor = begin;
+        size_t i = std::distance(m_ranges.begin(), firstOverlapping(begin));
+        while (cursor < end)
+        {
+            if (i == m_ranges.size() || m_ranges[i].begin >= end) {
+                m_ranges.insert(m_ranges.begin() + static_cast<std::ptrdiff_t>(i), Range{ .begin = cursor, .end = end, .value = value });
+                coalesce(i);
+                return;
+            }
+            if (m_ranges[i].begin > cursor) {
+                m_ranges.insert(m_ranges.begin() + static_cast<std::ptrdiff_t>(i), Range{ .begin = cursor, .end = m_ranges[i].begin, .value = value });
+                i = coalesce(i);
+            }
+            cursor = m_ranges[i].end;
+            i++;
+        }
+    }
+
+    // call f(const Range&) for every range overlapping [begin, end), clipped to [begin, end)
+    template<typename F>
+    void forEachOverlap(uint64_t begin, uint64_t end, F&& f) const
+    {
+        for (auto it = firstOverlapping(begin); it != m_ranges.end() && it->begin < end; ++it)
+            f(Range{ .begin = std::max(it->begin, begin), .end = std::min(it->end, end), .value = it->value });
+    }
+
+    // replace every value by f(value), adjacent ranges that become equal are merged
+    template<typename F>
+    void transformValues(F&& f)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < m_ranges.size(); i++)
+        {
+            m_ranges[i].value = f(m_ranges[i].value);
+            if (count > 0 && m_ranges[count - 1].end == m_ranges[i].begin && m_ranges[count - 1].value == m_ranges[i].value)
+                m_ranges[count - 1].end = m_ranges[i].end;
+            else
+                m_ranges[count++] = m_ranges[i];
+        }
+        m_ranges.erase(m_ranges.begin() + static_cast<std::ptrdiff_t>(count), m_ranges.end());
+    }
+
+    inline const std::vector<Range>& ranges() const { return m_ranges; }
+    inline bool empty() const { return m_ranges.empty(); }
+    inline void clear() { m_ranges.clear(); } // keep the capacity
+
+    ~RangeMap() = default;
+
+private:
+    std::vector<Range> m_ranges;
+
+    inline typename std::vector<Range>::iterator firstOverlapping(uint64_t begin)
+    {
+        return std::ranges::upper_bound(m_ranges, begin, {}, &Range::end);
+    }
+
+    inline typename std::vector<Range>::const_iterator firstOverlapping(uint64_t begin) const
+    {
+        return std::ranges::upper_bound(m_ranges, begin, {}, &Range::end);
+    }
+
+    // merge the range at idx with its neighbours if they are contiguous and have the same value.
+    // return the new index of the range
+    size_t coalesce(size_t idx)
+    {
+        assert(idx < m_ranges.size());
+        if (idx + 1 < m_ranges.size() && m_ranges[idx].end == m_ranges[idx + 1].begin && m_ranges[idx].value == m_ranges[idx + 1].value) {
+            m_ranges[idx].end = m_ranges[idx + 1].end;
+            m_ranges.erase(m_ranges.begin() + static_cast<std::ptrdiff_t>(idx + 1));
+        }
+        if (idx > 0 && m_ranges[idx - 1].end == m_ranges[idx].begin && m_ranges[idx - 1].value == m_ranges[idx].value) {
+            m_ranges[idx - 1].end = m_ranges[idx].end;
+            m_ranges.erase(m_ranges.begin() + static_cast<std::ptrdiff_t>(idx));
+            return idx - 1;
+        }
+        return idx;
+    }
+
+public:
+    RangeMap& operator=(const RangeMap&) = default;
+    RangeMap& operator=(RangeMap&&) = default;
+
+    bool operator==(const RangeMap&) const = default;
+};
+
+} // namespace gfx
+
+#endif // RANGEMAP_HPP
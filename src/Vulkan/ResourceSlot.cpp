@@ -0,0 +1,36 @@
+/*
+ * ---------------------------------------------------
+ * ResourceSlot.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 10:20:07
+ * ---------------------------------------------------
+ */
+
+#include "Vulkan/ResourceSlot.hpp"
+
+namespace gfx
+{
+
+ResourceSlot ResourceSlotAllocator::allocate()
+{
+    std::scoped_lock lock(m_mtx);
+    if (m_freeIndices.empty() == false) {
+        uint32_t index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+        return ResourceSlot{ .index = index, .generation = m_generations[index] };
+    }
+    m_generations.push_back(0);
+    return ResourceSlot{ .index = static_cast<uint32_t>(m_generations.size() - 1), .generation = 0 };
+}
+
+void ResourceSlotAllocator::release(const ResourceSlot& slot)
+{
+    std::scoped_lock lock(m_mtx);
+    assert(slot.index < m_generations.size());
+    assert(m_generations[slot.index] == slot.generation);
+    m_generations[slot.index]++;
+    m_freeIndices.push_back(slot.index);
+}
+
+} // namespace gfx
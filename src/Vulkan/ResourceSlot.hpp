@@ -0,0 +1,50 @@
+/*
+ * ---------------------------------------------------
+ * ResourceSlot.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 10:12:41
+ * ---------------------------------------------------
+ */
+
+#ifndef RESOURCESLOT_HPP
+#define RESOURCESLOT_HPP
+
+namespace gfx
+{
+
+// small integer identifying a buffer or a texture for the lifetime of the resource.
+// indices are recycled when resources are destroyed, the generation tell apart two resources that used the same index
+struct ResourceSlot
+{
+    uint32_t index = std::numeric_limits<uint32_t>::max();
+    uint32_t generation = 0;
+
+    bool operator==(const ResourceSlot&) const = default;
+};
+
+class ResourceSlotAllocator
+{
+public:
+    ResourceSlotAllocator() = default;
+    ResourceSlotAllocator(const ResourceSlotAllocator&) = delete;
+    ResourceSlotAllocator(ResourceSlotAllocator&&) = delete;
+
+    ResourceSlot allocate();
+    void release(const ResourceSlot&);
+
+    ~ResourceSlotAllocator() = default;
+
+private:
+    std::mutex m_mtx;
+    std::vector<uint32_t> m_generations;
+    std::vector<uint32_t> m_freeIndices;
+
+public:
+    ResourceSlotAllocator& operator=(const ResourceSlotAllocator&) = delete;
+    ResourceSlotAllocator& operator=(ResourceSlotAllocator&&) = delete;
+};
+
+} // namespace gfx
+
+#endif // RESOURCESLOT_HPP
@@ -0,0 +1,90 @@
+/*
+ * ---------------------------------------------------
+ * ResourceSyncTable.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 10:34:52
+ * ---------------------------------------------------
+ */
+
+#ifndef RESOURCESYNCTABLE_HPP
+#define RESOURCESYNCTABLE_HPP
+
+#include "Vulkan/ResourceSlot.hpp"
+
+namespace gfx
+{
+
+// per command buffer tracking of the resources used, indexed by the resource slot.
+// entries are stored densely in insertion order, the sparse vector map a slot index to its entry.
+// a stale sparse value is detected by checking the slot stored in the entry, so clear() only need to drop the resources
+template<typename Resource, typename SyncRequest, typename SyncState>
+class ResourceSyncTable
+{
+public:
+    struct Entry
+    {
+        ResourceSlot slot;
+        std::shared_ptr<Resource> resource;
+        SyncRequest syncRequest; // the first usage in the command buffer
+        SyncState finalSyncState; // the state at the end of the command buffer
+    };
+
+public:
+    ResourceSyncTable() = default;
+    ResourceSyncTable(const ResourceSyncTable&) = delete;
+    ResourceSyncTable(ResourceSyncTable&&) = default;
+
+    // return the entry of the resource or nullptr if the resource is not used yet
+    inline Entry* find(const ResourceSlot& slot)
+    {
+        if (slot.index < m_sparse.size()) {
+            uint32_t entryIdx = m_sparse[slot.index];
+            if (entryIdx < m_entryCount && m_entries[entryIdx].slot == slot)
+                return &m_entries[entryIdx];
+        }
+        return nullptr;
+    }
+
+    // entries from a previous use of the table are recycled so the storage owned by
+    // syncRequest and finalSyncState is reused, the caller must overwrite both
+    inline Entry& insert(const std::shared_ptr<Resource>& resource)
+    {
+        const ResourceSlot& slot = resource->slot();
+        assert(find(slot) == nullptr);
+        if (slot.index >= m_sparse.size())
+            m_sparse.resize(slot.index + 1, std::numeric_limits<uint32_t>::max());
+        m_sparse[slot.index] = m_entryCount;
+        if (m_entryCount == m_entries.size())
+            m_entries.emplace_back();
+        Entry& entry = m_entries[m_entryCount++];
+        entry.slot = slot;
+        entry.resource = resource;
+        return entry;
+    }
+
+    inline std::span<const Entry> entries() const { return std::span(m_entries.data(), m_entryCount); }
+
+    // keep the entries storage so a reused command buffer does not allocate
+    inline void clear()
+    {
+        for (uint32_t i = 0; i < m_entryCount; i++)
+            m_entries[i].resource.reset();
+        m_entryCount = 0;
+    }
+
+    ~ResourceSyncTable() = default;
+
+private:
+    std::vector<uint32_t> m_sparse;
+    std::vector<Entry> m_entries;
+    uint32_t m_entryCount = 0;
+
+public:
+    ResourceSyncTable& operator=(const ResourceSyncTable&) = delete;
+    ResourceSyncTable& operator=(ResourceSyncTable&&) = default;
+};
+
+} // namespace gfx
+
+#endif // RESOURCESYNCTABLE_HPP
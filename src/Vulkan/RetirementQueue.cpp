@@ -0,0 +1,83 @@
+/*
+ * ---------------------------------------------------
+ * RetirementQueue.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 21:19:02
+ * ---------------------------------------------------
+ */
+
+#include "Vulkan/RetirementQueue.hpp"
+#include "Vulkan/VulkanDevice.hpp"
+
+namespace gfx
+{
+
+RetirementQueue::RetirementQueue(const VulkanDevice* device)
+    : m_device(device)
+{
+}
+
+void RetirementQueue::retire(uint64_t timelineValue, Object object)
+{
+    std::scoped_lock lock(m_entriesMtx);
+    m_entries.push_back(Entry{ .timelineValue = timelineValue, .object = std::move(object) });
+    m_pendingCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RetirementQueue::collect(uint64_t completedValue)
+{
+    ZoneScoped;
+    std::scoped_lock collectLock(m_collectMtx);
+    {
+        std::scoped_lock lock(m_entriesMtx);
+        while (m_entries.empty() == false && m_entries.front().timelineValue <= completedValue) {
+            m_collectedObjects.push_back(std::move(m_entries.front().object));
+            m_entries.pop_front();
+        }
+    }
+    for (const Object& object : m_collectedObjects)
+        destroy(object);
+    const auto collectedCount = static_cast<uint32_t>(m_collectedObjects.size());
+    m_collectedObjects.clear();
+    m_pendingCount.fetch_sub(collectedCount, std::memory_order_relaxed);
+    m_freedCount.fetch_add(collectedCount, std::memory_order_relaxed);
+}
+
+bool RetirementQueue::hasCollectable(uint64_t completedValue) const
+{
+    std::scoped_lock lock(m_entriesMtx);
+    return m_entries.empty() == false && m_entries.front().timelineValue <= completedValue;
+}
+
+RetirementQueue::~RetirementQueue()
+{
+    assert(m_entries.empty()); // collected by the device destructor, while the allocator is alive
+}
+
+void RetirementQueue::destroy(const Object& object)
+{
+    const vk::Device& vkDevice = m_device->vkDevice();
+    if (const auto* buffer = std::get_if<Buffer>(&object)) {
+        m_device->resourceSlotAllocator().release(buffer->slot);
+        vmaDestroyBuffer(m_device->allocator(), buffer->vkBuffer, buffer->allocation);
+    }
+    else if (const auto* texture = std::get_if<Texture>(&object)) {
+        m_device->resourceSlotAllocator().release(texture->slot);
+        vkDevice.destroyImageView(texture->vkImageView);
+        if (texture->allocation != VK_NULL_HANDLE)
+            vmaDestroyImage(m_device->allocator(), texture->vkImage, texture->allocation);
+    }
+    else if (const auto* pipeline = std::get_if<vk::Pipeline>(&object))
+        vkDevice.destroyPipeline(*pipeline);
+    else if (const auto* sampler = std::get_if<vk::Sampler>(&object))
+        vkDevice.destroySampler(*sampler);
+    else if (const auto* descriptorPool = std::get_if<vk::DescriptorPool>(&object))
+        vkDevice.destroyDescriptorPool(*descriptorPool);
+    else if (const auto* semaphore = std::get_if<vk::Semaphore>(&object))
+        vkDevice.destroySemaphore(*semaphore);
+    else if (const auto* swapchain = std::get_if<vk::SwapchainKHR>(&object))
+        vkDevice.destroySwapchainKHR(*swapchain);
+}
+
+} // namespace gfx
@@ -0,0 +1,89 @@
+/*
+ * ---------------------------------------------------
+ * RetirementQueue.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 21:12:36
+ * ---------------------------------------------------
+ */
+
+#ifndef RETIREMENTQUEUE_HPP
+#define RETIREMENTQUEUE_HPP
+
+#include "Vulkan/ResourceSlot.hpp"
+
+namespace gfx
+{
+
+class VulkanDevice;
+
+// vulkan objects of the destroyed resources, kept until the gpu reach the timeline value they are retired with
+// and then destroyed in bulk, so the thread dropping the last reference never call the driver
+class RetirementQueue
+{
+public:
+    struct Buffer
+    {
+        vk::Buffer vkBuffer;
+        VmaAllocation allocation;
+        ResourceSlot slot;
+    };
+
+    struct Texture
+    {
+        vk::Image vkImage;
+        vk::ImageView vkImageView;
+        VmaAllocation allocation; // VK_NULL_HANDLE if the image is not owned (swapchain images)
+        ResourceSlot slot;
+    };
+
+    using Object = std::variant<Buffer, Texture, vk::Pipeline, vk::Sampler, vk::DescriptorPool, vk::Semaphore, vk::SwapchainKHR>;
+
+public:
+    RetirementQueue() = delete;
+    RetirementQueue(const RetirementQueue&) = delete;
+    RetirementQueue(RetirementQueue&&) = delete;
+
+    RetirementQueue(const VulkanDevice*);
+
+    // can be called by any thread, the values do not need to be retired in order
+    void retire(uint64_t timelineValue, Object);
+    // destroy the objects retired with a value lower or equal to completedValue.
+    // an object is only destroyed once the ones retired before it are
+    void collect(uint64_t completedValue);
+    bool hasCollectable(uint64_t completedValue) const;
+
+    inline uint32_t pendingCount() const { return m_pendingCount.load(std::memory_order_relaxed); }
+    inline uint32_t freedCount() const { return m_freedCount.load(std::memory_order_relaxed); }
+
+    ~RetirementQueue();
+
+private:
+    struct Entry
+    {
+        uint64_t timelineValue;
+        Object object;
+    };
+
+    const VulkanDevice* m_device;
+
+    mutable std::mutex m_entriesMtx;
+    std::deque<Entry> m_entries;
+
+    // the objects are destroyed without m_entriesMtx locked so the retiring threads never wait for the driver
+    std::mutex m_collectMtx;
+    std::vector<Object> m_collectedObjects;
+
+    std::atomic<uint32_t> m_pendingCount = 0;
+    std::atomic<uint32_t> m_freedCount = 0;
+
+    void destroy(const Object&);
+
+public:
+    RetirementQueue& operator=(const RetirementQueue&) = delete;
+    RetirementQueue& operator=(RetirementQueue&&) = delete;
+};
+
+} // namespace gfx
+
+#endif // RETIREMENTQUEUE_HPP
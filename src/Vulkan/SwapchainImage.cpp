@@ -17,6 +17,7 @@ namespace gfx
 SwapchainImage::SwapchainImage(const VulkanDevice* device, vk::Image&& image, const std::shared_ptr<vk::SwapchainKHR>& swapchain, const Texture::Descriptor& desc)
     : VulkanTexture(device, std::move(image), desc), m_swapchain(swapchain)
 {
+    m_isSwapchainImage = true;
     m_imagePresentableSemaphore = m_device->vkDevice().createSemaphore(vk::SemaphoreCreateInfo{});
 
 #if !defined(NDEBUG)
@@ -30,7 +31,10 @@ SwapchainImage::SwapchainImage(const VulkanDevice* device, vk::Image&& image, co
 
 SwapchainImage::~SwapchainImage()
 {
-    m_device->vkDevice().destroySemaphore(m_imagePresentableSemaphore);
+    // the last present of the image can still be waiting the semaphore
+    m_device->retire(RetirementQueue::Texture{ .vkImage = m_vkImage, .vkImageView = m_vkImageView, .allocation = VK_NULL_HANDLE, .slot = m_slot });
+    m_device->retire(m_imagePresentableSemaphore);
+    m_swapchain.reset();
 }
 
 }
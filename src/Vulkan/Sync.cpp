@@ -12,9 +12,16 @@
 namespace gfx
 {
 
+// the acquire barriers of the ownership transfers do not know the next use of the resources
+static constexpr ResourceSyncState ownershipAcquireState = {
+    .stageMask = vk::PipelineStageFlagBits2::eAllCommands,
+    .accessMask = vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite
+};
+
 std::optional<vk::MemoryBarrier2> syncResource(const ResourceSyncState& state, const ResourceSyncRequest& request)
 {
     constexpr vk::AccessFlags2 writeMask = vk::AccessFlagBits2::eShaderWrite
+        | vk::AccessFlagBits2::eShaderStorageWrite
         | vk::AccessFlagBits2::eTransferWrite
         | vk::AccessFlagBits2::eColorAttachmentWrite
         | vk::AccessFlagBits2::eDepthStencilAttachmentWrite
@@ -45,7 +52,7 @@ ResourceSyncState resourceStateAfterSync(const ResourceSyncRequest& request)
     };
 }
 
-std::optional<vk::ImageMemoryBarrier2> syncImage(ImageSyncState& state, const ImageSyncRequest& request)
+static std::optional<vk::ImageMemoryBarrier2> syncImageSubresource(const ImageSubresourceSyncState& state, const ImageSubresourceSyncRequest& request)
 {
     std::optional<vk::MemoryBarrier2> memoryBarrier = syncResource(state, request);
     std::optional<vk::ImageMemoryBarrier2> imageMemoryBarrier;
@@ -77,38 +84,169 @@ std::optional<vk::ImageMemoryBarrier2> syncImage(ImageSyncState& state, const Im
             .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
             .setDstQueueFamilyIndex(vk::QueueFamilyIgnored);
     }
-    state = imageStateAfterSync(request);
     return imageMemoryBarrier;
 }
 
-ImageSyncState imageStateAfterSync(const ImageSyncRequest& request)
+ImageSyncState newImageSyncState(uint32_t mipLevelCount, uint32_t arrayLayerCount)
+{
+    ImageSyncState state;
+    state.mipLevelCount = mipLevelCount;
+    state.arrayLayerCount = arrayLayerCount;
+    state.subresources.assign(0, static_cast<uint64_t>(mipLevelCount) * arrayLayerCount, ImageSubresourceSyncState{});
+    return state;
+}
+
+void syncImage(ImageSyncState& state, const ImageSyncRequest& request, std::vector<vk::ImageMemoryBarrier2>& outBarriers)
+{
+    forEachImageSyncRange(state, request, [&](uint64_t begin, uint64_t end) {
+        syncImageSubresources(state, begin, end, request, outBarriers);
+    });
+}
+
+// split a range of subresource indices in vulkan subresource ranges, complete mip levels are grouped
+template<typename F>
+static void forEachSubresourceRange(uint64_t layers, uint64_t begin, uint64_t end, F&& f)
+{
+    uint64_t idx = begin;
+    while (idx < end)
+    {
+        const auto mipLevel = static_cast<uint32_t>(idx / layers);
+        const auto arrayLayer = static_cast<uint32_t>(idx % layers);
+        auto subresourceRange = vk::ImageSubresourceRange{}
+            .setBaseMipLevel(mipLevel)
+            .setBaseArrayLayer(arrayLayer);
+        if (arrayLayer == 0 && end - idx >= layers) {
+            const auto levelCount = static_cast<uint32_t>((end - idx) / layers);
+            subresourceRange.setLevelCount(levelCount).setLayerCount(static_cast<uint32_t>(layers));
+            idx += levelCount * layers;
+        }
+        else {
+            const auto layerCount = static_cast<uint32_t>(std::min(end - idx, layers - arrayLayer));
+            subresourceRange.setLevelCount(1).setLayerCount(layerCount);
+            idx += layerCount;
+        }
+        f(subresourceRange);
+    }
+}
+
+void syncImageSubresources(ImageSyncState& state, uint64_t begin, uint64_t end, const ImageSubresourceSyncRequest& request, std::vector<vk::ImageMemoryBarrier2>& outBarriers)
+{
+    state.subresources.forEachOverlap(begin, end, [&](const RangeMap<ImageSubresourceSyncState>::Range& range) {
+        std::optional<vk::ImageMemoryBarrier2> barrier = syncImageSubresource(range.value, request);
+        if (barrier.has_value() == false)
+            return;
+        forEachSubresourceRange(state.arrayLayerCount, range.begin, range.end, [&](const vk::ImageSubresourceRange& subresourceRange) {
+            outBarriers.push_back(vk::ImageMemoryBarrier2(*barrier).setSubresourceRange(subresourceRange));
+        });
+    });
+    state.subresources.assign(begin, end, imageSubresourceStateAfterSync(request));
+}
+
+void transferImageOwnership(ImageSyncState& state, uint32_t srcQueueFamily, uint32_t dstQueueFamily, std::vector<vk::ImageMemoryBarrier2>& outReleaseBarriers, std::vector<vk::ImageMemoryBarrier2>& outAcquireBarriers)
+{
+    for (const auto& range : state.subresources.ranges())
+    {
+        // undefined content does not need to be transferred
+        if (range.value.layout == vk::ImageLayout::eUndefined)
+            continue;
+        // the layout is not changed by the transfer, the barriers of the command buffer do it
+        const auto releaseBarrier = vk::ImageMemoryBarrier2{}
+            .setSrcStageMask(range.value.stageMask)
+            .setSrcAccessMask(range.value.accessMask)
+            .setOldLayout(range.value.layout)
+            .setNewLayout(range.value.layout)
+            .setSrcQueueFamilyIndex(srcQueueFamily)
+            .setDstQueueFamilyIndex(dstQueueFamily);
+        const auto acquireBarrier = vk::ImageMemoryBarrier2(releaseBarrier)
+            .setSrcStageMask(vk::PipelineStageFlagBits2::eNone)
+            .setSrcAccessMask(vk::AccessFlagBits2::eNone)
+            .setDstStageMask(ownershipAcquireState.stageMask)
+            .setDstAccessMask(ownershipAcquireState.accessMask);
+        forEachSubresourceRange(state.arrayLayerCount, range.begin, range.end, [&](const vk::ImageSubresourceRange& subresourceRange) {
+            outReleaseBarriers.push_back(vk::ImageMemoryBarrier2(releaseBarrier).setSubresourceRange(subresourceRange));
+            outAcquireBarriers.push_back(vk::ImageMemoryBarrier2(acquireBarrier).setSubresourceRange(subresourceRange));
+        });
+    }
+    // the next uses are synchronized with the acquire barriers like with any other write
+    state.subresources.transformValues([](const ImageSubresourceSyncState& value) {
+        if (value.layout == vk::ImageLayout::eUndefined)
+            return value;
+        ImageSubresourceSyncState newState(ownershipAcquireState);
+        newState.layout = value.layout;
+        return newState;
+    });
+}
+
+ImageSubresourceSyncState imageSubresourceStateAfterSync(const ImageSubresourceSyncRequest& request)
 {
-    ImageSyncState newState(resourceStateAfterSync(request));
+    ImageSubresourceSyncState newState(resourceStateAfterSync(request));
     newState.layout = request.layout;
     return newState;
 }
 
+uint64_t bufferSyncRangeEnd(const BufferSyncRequest& request)
+{
+    if (request.size == vk::WholeSize)
+        return std::numeric_limits<uint64_t>::max();
+    return request.offset + request.size;
+}
+
 std::optional<vk::BufferMemoryBarrier2> syncBuffer(BufferSyncState& state, const BufferSyncRequest& request)
 {
-    std::optional<vk::MemoryBarrier2> memoryBarrier = syncResource(state, request);
+    const uint64_t end = bufferSyncRangeEnd(request);
+
     std::optional<vk::BufferMemoryBarrier2> bufferMemoryBarrier;
-    if (memoryBarrier.has_value())
+    state.ranges.forEachOverlap(request.offset, end, [&](const RangeMap<ResourceSyncState>::Range& range) {
+        std::optional<vk::MemoryBarrier2> memoryBarrier = syncResource(range.value, request);
+        if (memoryBarrier.has_value() == false)
+            return;
+        if (bufferMemoryBarrier.has_value() == false) {
+            bufferMemoryBarrier = vk::BufferMemoryBarrier2{}
+                .setDstStageMask(memoryBarrier->dstStageMask)
+                .setDstAccessMask(memoryBarrier->dstAccessMask)
+                .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+                .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+                .setOffset(request.offset)
+                .setSize(request.size);
+        }
+        bufferMemoryBarrier->srcStageMask |= memoryBarrier->srcStageMask;
+        bufferMemoryBarrier->srcAccessMask |= memoryBarrier->srcAccessMask;
+    });
+    state.ranges.assign(request.offset, end, resourceStateAfterSync(request));
+    return bufferMemoryBarrier;
+}
+
+std::optional<std::pair<vk::BufferMemoryBarrier2, vk::BufferMemoryBarrier2>> transferBufferOwnership(BufferSyncState& state, uint32_t srcQueueFamily, uint32_t dstQueueFamily)
+{
+    std::optional<vk::BufferMemoryBarrier2> releaseBarrier;
+    for (const auto& range : state.ranges.ranges())
     {
-        bufferMemoryBarrier = vk::BufferMemoryBarrier2{}
-            .setSrcStageMask(memoryBarrier->srcStageMask)
-            .setSrcAccessMask(memoryBarrier->srcAccessMask)
-            .setDstStageMask(memoryBarrier->dstStageMask)
-            .setDstAccessMask(memoryBarrier->dstAccessMask)
-            .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
-            .setDstQueueFamilyIndex(vk::QueueFamilyIgnored);
+        if (releaseBarrier.has_value() == false) {
+            releaseBarrier = vk::BufferMemoryBarrier2{}
+                .setSrcQueueFamilyIndex(srcQueueFamily)
+                .setDstQueueFamilyIndex(dstQueueFamily)
+                .setOffset(0)
+                .setSize(vk::WholeSize);
+        }
+        releaseBarrier->srcStageMask |= range.value.stageMask;
+        releaseBarrier->srcAccessMask |= range.value.accessMask;
     }
-    state = bufferStateAfterSync(request);
-    return bufferMemoryBarrier;
+    if (releaseBarrier.has_value() == false)
+        return std::nullopt;
+
+    const auto acquireBarrier = vk::BufferMemoryBarrier2(*releaseBarrier)
+        .setSrcStageMask(vk::PipelineStageFlagBits2::eNone)
+        .setSrcAccessMask(vk::AccessFlagBits2::eNone)
+        .setDstStageMask(ownershipAcquireState.stageMask)
+        .setDstAccessMask(ownershipAcquireState.accessMask);
+    state.ranges.transformValues([](const ResourceSyncState&) { return ownershipAcquireState; });
+    return std::make_pair(*releaseBarrier, acquireBarrier);
 }
 
 BufferSyncState bufferStateAfterSync(const BufferSyncRequest& request)
 {
-    BufferSyncState newState(resourceStateAfterSync(request));
+    BufferSyncState newState;
+    newState.ranges.assign(request.offset, bufferSyncRangeEnd(request), resourceStateAfterSync(request));
     return newState;
 }
 
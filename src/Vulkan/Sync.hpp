@@ -10,6 +10,8 @@
 #ifndef SYNC_HPP
 #define SYNC_HPP
 
+#include "Vulkan/RangeMap.hpp"
+
 namespace gfx
 {
 
@@ -17,38 +19,120 @@ struct ResourceSyncRequest
 {
     vk::PipelineStageFlags2 stageMask;
     vk::AccessFlags2 accessMask;
+
+    bool operator==(const ResourceSyncRequest&) const = default;
 };
 
 struct ResourceSyncState
 {
     vk::PipelineStageFlags2 stageMask;
     vk::AccessFlags2 accessMask;
+
+    bool operator==(const ResourceSyncState&) const = default;
 };
 
-struct ImageSyncRequest : public ResourceSyncRequest
+struct ImageSubresourceSyncRequest : public ResourceSyncRequest
 {
     vk::ImageLayout layout = vk::ImageLayout::eUndefined;
     bool preserveContent = true;
+
+    bool operator==(const ImageSubresourceSyncRequest&) const = default;
+};
+
+struct ImageSyncRequest : public ImageSubresourceSyncRequest
+{
+    // the subresources used, the whole image by default
+    uint32_t baseMipLevel = 0;
+    uint32_t levelCount = vk::RemainingMipLevels;
+    uint32_t baseArrayLayer = 0;
+    uint32_t layerCount = vk::RemainingArrayLayers;
 };
 
-struct ImageSyncState : public ResourceSyncState
+struct ImageSubresourceSyncState : public ResourceSyncState
 {
     vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+
+    bool operator==(const ImageSubresourceSyncState&) const = default;
 };
 
-struct BufferSyncRequest : public ResourceSyncRequest { };
+// the first usage of each subresource of an image in a command buffer
+using ImageSyncRequests = RangeMap<ImageSubresourceSyncRequest>;
+
+// images are tracked per subresource so independent layers or mip levels do not wait for each other.
+// a subresource is identified by mipLevel * arrayLayerCount + arrayLayer, so the layers of a mip level
+// are contiguous and the whole image is a single range when all subresources share a state.
+// a subresource never used is not in the map
+struct ImageSyncState
+{
+    uint32_t mipLevelCount = 1;
+    uint32_t arrayLayerCount = 1;
+    RangeMap<ImageSubresourceSyncState> subresources;
+};
+
+struct BufferSyncRequest : public ResourceSyncRequest
+{
+    vk::DeviceSize offset = 0;
+    vk::DeviceSize size = vk::WholeSize;
+};
 
-struct BufferSyncState : public ResourceSyncState { };
+// the first usage of each byte range of a buffer in a command buffer
+using BufferSyncRequests = RangeMap<ResourceSyncRequest>;
+
+// buffers are tracked per byte range so writes to disjoint parts of a same buffer
+// do not wait for each other. a range never used is not in the map
+struct BufferSyncState
+{
+    RangeMap<ResourceSyncState> ranges;
+};
 
 std::optional<vk::MemoryBarrier2> syncResource(const ResourceSyncState&, const ResourceSyncRequest&);
 ResourceSyncState resourceStateAfterSync(const ResourceSyncRequest&);
 
-std::optional<vk::ImageMemoryBarrier2> syncImage(ImageSyncState&, const ImageSyncRequest&);
-ImageSyncState imageStateAfterSync(const ImageSyncRequest&);
+// state of an image that was never used, all subresources are in the undefined layout
+ImageSyncState newImageSyncState(uint32_t mipLevelCount, uint32_t arrayLayerCount);
+
+// call f(begin, end) for each contiguous range of subresource indices used by the request
+template<typename F>
+void forEachImageSyncRange(const ImageSyncState& state, const ImageSyncRequest& request, F&& f)
+{
+    const uint32_t levelEnd = request.levelCount == vk::RemainingMipLevels ? state.mipLevelCount : request.baseMipLevel + request.levelCount;
+    const uint32_t layerEnd = request.layerCount == vk::RemainingArrayLayers ? state.arrayLayerCount : request.baseArrayLayer + request.layerCount;
+    assert(levelEnd <= state.mipLevelCount && layerEnd <= state.arrayLayerCount);
+
+    const uint64_t layers = state.arrayLayerCount;
+    if (request.baseArrayLayer == 0 && layerEnd == state.arrayLayerCount)
+        f(request.baseMipLevel * layers, levelEnd * layers);
+    else {
+        for (uint64_t mipLevel = request.baseMipLevel; mipLevel < levelEnd; mipLevel++)
+            f(mipLevel * layers + request.baseArrayLayer, mipLevel * layers + layerEnd);
+    }
+}
 
+// append the barriers required for the request, one per subresource range with a different state.
+// the image and the aspect mask of the barriers are left for the caller to set
+void syncImage(ImageSyncState&, const ImageSyncRequest&, std::vector<vk::ImageMemoryBarrier2>& outBarriers);
+
+// same as syncImage for a range of subresource indices
+void syncImageSubresources(ImageSyncState&, uint64_t begin, uint64_t end, const ImageSubresourceSyncRequest&, std::vector<vk::ImageMemoryBarrier2>& outBarriers);
+
+// queue family ownership transfer of the defined subresources. the release barriers are executed by a queue of srcQueueFamily
+// and the acquire ones by a queue of dstQueueFamily, the image and the aspect mask of the barriers are left for the caller to set.
+// the subresources keep their layout, the next uses wait for the acquire barriers
+void transferImageOwnership(ImageSyncState&, uint32_t srcQueueFamily, uint32_t dstQueueFamily, std::vector<vk::ImageMemoryBarrier2>& outReleaseBarriers, std::vector<vk::ImageMemoryBarrier2>& outAcquireBarriers);
+
+ImageSubresourceSyncState imageSubresourceStateAfterSync(const ImageSubresourceSyncRequest&);
+
+// end of the request range, vk::WholeSize extend to the end of the buffer whatever its size
+uint64_t bufferSyncRangeEnd(const BufferSyncRequest&);
+
+// a single barrier covering the request range is returned, its source scope is the union of the overlapped ranges that need it
 std::optional<vk::BufferMemoryBarrier2> syncBuffer(BufferSyncState&, const BufferSyncRequest&);
 BufferSyncState bufferStateAfterSync(const BufferSyncRequest&);
 
+// same as transferImageOwnership for the whole buffer, (release, acquire) or nothing if the buffer was never used.
+// the buffer of the barriers is left for the caller to set
+std::optional<std::pair<vk::BufferMemoryBarrier2, vk::BufferMemoryBarrier2>> transferBufferOwnership(BufferSyncState&, uint32_t srcQueueFamily, uint32_t dstQueueFamily);
+
 }
 
 #endif // SYNC_HPP
@@ -23,20 +23,24 @@ VulkanBuffer::VulkanBuffer(const VulkanDevice* device, const Buffer::Descriptor&
     VkBufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo{}
         .setSize(static_cast<vk::DeviceSize>(desc.size))
         .setUsage(toVkBufferUsageFlags(desc.usages))
-        .setSharingMode(vk::SharingMode::eExclusive);
+        .setSharingMode(vk::SharingMode::eExclusive); // the device transfer the ownership when an other queue family use it
 
     VmaAllocationCreateInfo allocInfo = { .usage = VMA_MEMORY_USAGE_AUTO, };
     if (m_storageMode == ResourceStorageMode::hostVisible)
         allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    if (m_storageMode == ResourceStorageMode::readback)
+        allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT; // host cached if there is such memory
 
     VkBuffer buffer = VK_NULL_HANDLE;
     vmaCreateBuffer(m_device->allocator(), &bufferCreateInfo, &allocInfo, &buffer, &m_allocation, &m_allocInfo);
     m_vkBuffer = std::exchange(buffer, VK_NULL_HANDLE);
+
+    m_slot = m_device->resourceSlotAllocator().allocate();
 }
 
 void VulkanBuffer::setContent(const void* data, size_t size)
 {
-    assert(m_storageMode == ResourceStorageMode::hostVisible);
+    assert(m_storageMode != ResourceStorageMode::deviceLocal);
 
     VkResult res = vmaCopyMemoryToAllocation(m_device->allocator(), data, m_allocation, 0, size);
     if (res != VK_SUCCESS)
@@ -45,12 +49,15 @@ void VulkanBuffer::setContent(const void* data, size_t size)
 
 VulkanBuffer::~VulkanBuffer()
 {
-    vmaDestroyBuffer(m_device->allocator(), m_vkBuffer, m_allocation);
+    m_device->retire(RetirementQueue::Buffer{ .vkBuffer = m_vkBuffer, .allocation = m_allocation, .slot = m_slot });
 }
 
 void* VulkanBuffer::contentVoid()
 {
-    assert(m_storageMode == ResourceStorageMode::hostVisible);
+    assert(m_storageMode != ResourceStorageMode::deviceLocal);
+    // host cached memory is not always coherent, the gpu writes are invalidated each time the content is read
+    if (m_storageMode == ResourceStorageMode::readback && vmaInvalidateAllocation(m_device->allocator(), m_allocation, 0, VK_WHOLE_SIZE) != VK_SUCCESS)
+        throw std::runtime_error("vmaInvalidateAllocation failed");
     return m_allocInfo.pMappedData;
 }
 
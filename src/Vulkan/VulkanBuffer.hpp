@@ -14,6 +14,7 @@
 #include "Graphics/Enums.hpp"
 
 #include "Vulkan/Sync.hpp"
+#include "Vulkan/ResourceSlot.hpp"
 
 namespace gfx
 {
@@ -39,6 +40,15 @@ public:
     inline BufferSyncState& syncState() { return m_syncState; }
     inline const BufferSyncState& syncState() const { return m_syncState; }
 
+    inline const ResourceSlot& slot() const { return m_slot; }
+
+    // timeline value signaled by the last submit using the buffer, the gpu is done with it once the value is reached
+    inline uint64_t lastSubmitTimelineValue() const { return m_lastSubmitTimelineValue.load(std::memory_order_acquire); }
+    inline void setLastSubmitTimelineValue(uint64_t v) { m_lastSubmitTimelineValue.store(v, std::memory_order_release); }
+    // queue of the last submit, a submit to an other queue wait for it. only used by the submit thread
+    inline size_t lastSubmitQueueIndex() const { return m_lastSubmitQueueIndex; }
+    inline void setLastSubmitQueueIndex(size_t i) { m_lastSubmitQueueIndex = i; }
+
     ~VulkanBuffer() override;
 
 protected:
@@ -55,6 +65,10 @@ private:
     VmaAllocationInfo m_allocInfo = {};
 
     BufferSyncState m_syncState;
+    ResourceSlot m_slot;
+
+    std::atomic<uint64_t> m_lastSubmitTimelineValue = 0;
+    size_t m_lastSubmitQueueIndex = 0;
 
 public:
     VulkanBuffer& operator=(const VulkanBuffer&) = delete;
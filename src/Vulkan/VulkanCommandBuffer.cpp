@@ -26,37 +26,44 @@
 # include "Vulkan/imgui_impl_vulkan.h"
 #endif
 #include "Vulkan/VulkanGraphicsPipeline.hpp"
+#include "Vulkan/VulkanComputePipeline.hpp"
 #include "Vulkan/VulkanCommandBufferPool.hpp"
 #include "Vulkan/VulkanDevice.hpp"
 
 #define m_usedPipelines m_nonReusedRessources.usedPipelines
 #define m_boundPipeline m_nonReusedRessources.boundPipeline
+#define m_usedComputePipelines m_nonReusedRessources.usedComputePipelines
+#define m_boundComputePipeline m_nonReusedRessources.boundComputePipeline
+#define m_isInComputePass m_nonReusedRessources.isInComputePass
+#define m_computePBlocks m_nonReusedRessources.computePBlocks
 #define m_usedPBlock m_nonReusedRessources.usedPBlock
-#define m_imageSyncRequests m_nonReusedRessources.imageSyncRequests
-#define m_imageFinalSyncStates m_nonReusedRessources.imageFinalSyncStates
-#define m_bufferSyncRequests m_nonReusedRessources.bufferSyncRequests
-#define m_bufferFinalSyncStates m_nonReusedRessources.bufferFinalSyncStates
+#define m_imageSyncTable m_nonReusedRessources.imageSyncTable
+#define m_bufferSyncTable m_nonReusedRessources.bufferSyncTable
 #define m_presentedDrawables m_nonReusedRessources.presentedDrawables
 
 namespace gfx
 {
 
-VulkanCommandBuffer::VulkanCommandBuffer(const VulkanDevice* device, const std::shared_ptr<vk::CommandPool>& commandPool)
+VulkanCommandBuffer::VulkanCommandBuffer(const VulkanDevice* device, const std::shared_ptr<vk::CommandPool>& commandPool, QueueType queueType, vk::CommandBufferLevel level, bool isReusable)
     : m_device(device),
-      m_vkCommandPool(commandPool)
+      m_vkCommandPool(commandPool),
+      m_queueType(queueType),
+      m_level(level),
+      m_isReusable(isReusable)
 {
     assert(m_device);
     assert(m_vkCommandPool);
 
     auto commandBufferAllocateInfo = vk::CommandBufferAllocateInfo{}
         .setCommandPool(*m_vkCommandPool)
-        .setLevel(vk::CommandBufferLevel::ePrimary)
+        .setLevel(m_level)
         .setCommandBufferCount(1);
     m_vkCommandBuffer = m_device->vkDevice().allocateCommandBuffers(commandBufferAllocateInfo).front();
 }
 
-VulkanCommandBuffer::VulkanCommandBuffer(const VulkanDevice* device, const vk::CommandPool& commandPool)
-    : m_device(device)
+VulkanCommandBuffer::VulkanCommandBuffer(const VulkanDevice* device, const vk::CommandPool& commandPool, QueueType queueType)
+    : m_device(device),
+      m_queueType(queueType)
 {
     assert(m_device);
 
@@ -67,12 +74,14 @@ VulkanCommandBuffer::VulkanCommandBuffer(const VulkanDevice* device, const vk::C
     m_vkCommandBuffer = m_device->vkDevice().allocateCommandBuffers(commandBufferAllocateInfo).front();
 }
 
-void VulkanCommandBuffer::beginRenderPass(const Framebuffer& framebuffer)
+void VulkanCommandBuffer::beginRenderPass(const Framebuffer& framebuffer, RenderPassContents contents)
 {
+    assert(m_queueType == QueueType::graphics);
+    assert(isSecondary() == false);
+    assert(m_isInRenderPass == false);
     TracyVkZone_begin(VulkanDevice::s_tracyVkContext, m_vkCommandBuffer, "renderPass", m_tracyVkCtxScope, true);
     std::vector<vk::RenderingAttachmentInfo> colorAttachmentInfos(framebuffer.colorAttachments.size());
     std::optional<vk::RenderingAttachmentInfo> depthAttachmentInfo;
-    std::vector<vk::ImageMemoryBarrier2> imageMemoryBarriers;
 
     for (size_t i = 0; auto& colorAttachment : framebuffer.colorAttachments)
     {
@@ -95,18 +104,7 @@ void VulkanCommandBuffer::beginRenderPass(const Framebuffer& framebuffer)
         syncReq.layout = vk::ImageLayout::eColorAttachmentOptimal;
         syncReq.preserveContent = colorAttachment.loadAction == LoadAction::load;
 
-        auto it = m_imageFinalSyncStates.find(texture);
-        if (it != m_imageFinalSyncStates.end()) {
-            auto barrier = syncImage(it->second, syncReq);
-            if (barrier.has_value()) {
-                barrier->setImage(texture->vkImage());
-                barrier->setSubresourceRange(texture->subresourceRange());
-                imageMemoryBarriers.push_back(barrier.value());
-            }
-        } else {
-            m_imageSyncRequests[texture] = syncReq;
-            m_imageFinalSyncStates[texture] = imageStateAfterSync(syncReq);
-        }
+        syncImageUse(texture, syncReq);
     }
 
     if (auto& depthAttachment = framebuffer.depthAttachment)
@@ -126,58 +124,52 @@ void VulkanCommandBuffer::beginRenderPass(const Framebuffer& framebuffer)
         syncReq.layout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
         syncReq.preserveContent = depthAttachment->loadAction == LoadAction::load;
 
-        auto it = m_imageFinalSyncStates.find(texture);
-        if (it != m_imageFinalSyncStates.end()) {
-            auto barrier = syncImage(it->second, syncReq);
-            if (barrier.has_value()) {
-                barrier->setImage(texture->vkImage());
-                barrier->setSubresourceRange(texture->subresourceRange());
-                imageMemoryBarriers.push_back(barrier.value());
-            }
-        } else {
-            m_imageSyncRequests[texture] = syncReq;
-            m_imageFinalSyncStates[texture] = imageStateAfterSync(syncReq);
-        }
-    }
-
-    if (imageMemoryBarriers.empty() == false) {
-        m_vkCommandBuffer.pipelineBarrier2(vk::DependencyInfo{}
-            .setDependencyFlags(vk::DependencyFlags{}) // TODO ?
-            .setImageMemoryBarriers(imageMemoryBarriers));
+        syncImageUse(texture, syncReq);
     }
 
-    m_vkCommandBuffer.setViewport(0, vk::Viewport{}
-        .setX(0)
-        .setY(0)
-        .setWidth(static_cast<float>(framebuffer.colorAttachments[0].texture->width()))
-        .setHeight(static_cast<float>(framebuffer.colorAttachments[0].texture->height()))
-        .setMinDepth(0)
-        .setMaxDepth(1));
-
-    m_vkCommandBuffer.setScissor(0, vk::Rect2D{}
-        .setOffset({.x=0, .y=0})
-        .setExtent({
-            .width = framebuffer.colorAttachments[0].texture->width(),
-            .height = framebuffer.colorAttachments[0].texture->height()
-        }));
+    // the barriers of the attachments are recorded with the ones of the pass commands at endRenderPass
+    m_secondaryRenderPass.colorAttachments = std::move(colorAttachmentInfos);
+    m_secondaryRenderPass.depthAttachment = depthAttachmentInfo;
+    m_secondaryRenderPass.colorAttachmentFormats.clear();
+    for (auto& colorAttachment : framebuffer.colorAttachments)
+        m_secondaryRenderPass.colorAttachmentFormats.push_back(toVkFormat(colorAttachment.texture->pixelFormat()));
+    m_secondaryRenderPass.depthAttachmentFormat = framebuffer.depthAttachment ? toVkFormat(framebuffer.depthAttachment->texture->pixelFormat()) : vk::Format::eUndefined;
+    m_secondaryRenderPass.extent = vk::Extent2D{
+        .width = framebuffer.colorAttachments[0].texture->width(),
+        .height = framebuffer.colorAttachments[0].texture->height()
+    };
+
+    m_isInRenderPass = true;
+    m_renderPassContents = contents;
+    m_passFirstSecondary = m_usedSecondaryCount;
+    if (contents == RenderPassContents::inlined)
+        m_inlinedPassCommandBuffer = beginPassSecondary().get();
+}
 
-    auto renderingInfo = vk::RenderingInfo{}
-        .setRenderArea(vk::Rect2D{}
-            .setOffset({.x=0, .y=0})
-            .setExtent({
-                .width = framebuffer.colorAttachments[0].texture->width(),
-                .height = framebuffer.colorAttachments[0].texture->height()
-            }))
-        .setLayerCount(1)
-        .setViewMask(0)
-        .setColorAttachments(colorAttachmentInfos)
-        .setPDepthAttachment(depthAttachmentInfo ? &depthAttachmentInfo.value() : nullptr);
+std::shared_ptr<CommandBuffer> VulkanCommandBuffer::newSecondaryCommandBuffer()
+{
+    assert(m_isInRenderPass && m_renderPassContents == RenderPassContents::secondaryCommandBuffers);
+    return beginPassSecondary();
+}
 
-    m_vkCommandBuffer.beginRendering(renderingInfo);
+std::shared_ptr<VulkanCommandBuffer> VulkanCommandBuffer::beginPassSecondary()
+{
+    if (m_usedSecondaryCount == m_secondaries.size())
+    {
+        // the secondaries of a reusable command buffer are executed at each of its submits, their pool is not transient
+        auto commandPool = m_device->newVkCommandPool(m_queueType, m_isReusable ? vk::CommandPoolCreateFlags{} : vk::CommandPoolCreateFlagBits::eTransient);
+        m_secondaries.push_back(std::make_shared<VulkanCommandBuffer>(m_device, commandPool, m_queueType, vk::CommandBufferLevel::eSecondary, m_isReusable));
+    }
+    std::shared_ptr<VulkanCommandBuffer>& secondary = m_secondaries[m_usedSecondaryCount++];
+    secondary->beginSecondary(m_secondaryRenderPass);
+    return secondary;
 }
 
 void VulkanCommandBuffer::usePipeline(const std::shared_ptr<const GraphicsPipeline>& _graphicsPipeline)
 {
+    if (m_inlinedPassCommandBuffer != nullptr)
+        return m_inlinedPassCommandBuffer->usePipeline(_graphicsPipeline);
+
     auto graphicsPipeline = std::dynamic_pointer_cast<const VulkanGraphicsPipeline>(_graphicsPipeline);
 
     m_vkCommandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, graphicsPipeline->vkPipeline());
@@ -186,194 +178,323 @@ void VulkanCommandBuffer::usePipeline(const std::shared_ptr<const GraphicsPipeli
     m_boundPipeline = graphicsPipeline.get();
 }
 
-void VulkanCommandBuffer::useVertexBuffer(const std::shared_ptr<Buffer>& aBuffer)
+void VulkanCommandBuffer::useVertexBuffer(const std::shared_ptr<Buffer>& aBuffer, size_t offset, uint32_t bufferIndex)
 {
+    if (m_inlinedPassCommandBuffer != nullptr)
+        return m_inlinedPassCommandBuffer->useVertexBuffer(aBuffer, offset, bufferIndex);
+
     auto buffer = std::dynamic_pointer_cast<VulkanBuffer>(aBuffer);
+    assert(buffer);
+    assert(offset < buffer->size());
 
+    // the vertices fetched are not known until the draw, everything after the offset is synchronized
     BufferSyncRequest syncReq{};
     syncReq.stageMask = vk::PipelineStageFlagBits2::eVertexInput;
     syncReq.accessMask = vk::AccessFlagBits2::eVertexAttributeRead;
+    syncReq.offset = offset;
 
-    auto it = m_bufferFinalSyncStates.find(buffer);
-    if (it != m_bufferFinalSyncStates.end()) {
-        auto barrier = syncBuffer(it->second, syncReq); // will update the final sync state
-        if (barrier.has_value()) {
-            barrier->setBuffer(buffer->vkBuffer());
-            barrier->setOffset(0);
-            barrier->setSize(vk::WholeSize);
-            m_vkCommandBuffer.pipelineBarrier2(vk::DependencyInfo{}
-               .setDependencyFlags(vk::DependencyFlags{})
-               .setBufferMemoryBarriers(*barrier));
-        }
-    } else {
-        m_bufferSyncRequests[buffer] = syncReq;
-        m_bufferFinalSyncStates[buffer] = bufferStateAfterSync(syncReq);
-    }
+    syncBufferUse(buffer, syncReq);
 
-    m_vkCommandBuffer.bindVertexBuffers(0, buffer->vkBuffer(), {0});
+    m_vkCommandBuffer.bindVertexBuffers(bufferIndex, buffer->vkBuffer(), {offset});
 }
 
 void VulkanCommandBuffer::setParameterBlock(const std::shared_ptr<const ParameterBlock>& aPblock, uint32_t index)
 {
-    const auto& pBlock = std::dynamic_pointer_cast<const VulkanParameterBlock>(aPblock);
-    std::vector<vk::BufferMemoryBarrier2> bufferMemoryBarriers;
-    std::vector<vk::ImageMemoryBarrier2> imageMemoryBarriers;
-
-    for (auto& [buffer, binding] : pBlock->usedBuffers())
-    {
-        BufferSyncRequest syncReq{};
+    if (m_inlinedPassCommandBuffer != nullptr)
+        return m_inlinedPassCommandBuffer->setParameterBlock(aPblock, index);
 
-        if ((binding.usages & BindingUsage::vertexRead) || (binding.usages & BindingUsage::vertexWrite))
-            syncReq.stageMask |= vk::PipelineStageFlagBits2::eVertexShader;
-        if ((binding.usages & BindingUsage::fragmentRead) || (binding.usages & BindingUsage::fragmentWrite))
-            syncReq.stageMask |= vk::PipelineStageFlagBits2::eFragmentShader;
-
-        if (static_cast<bool>(binding.usages & (BindingUsage::vertexRead | BindingUsage::fragmentRead)))
-        {
-            switch (binding.type)
-            {
-                case BindingType::constantBuffer:
-                    syncReq.accessMask |= vk::AccessFlagBits2::eUniformRead;
-                    break;
-                case BindingType::structuredBuffer:
-                    syncReq.accessMask |= vk::AccessFlagBits2::eShaderStorageRead;
-                    break;
-                default:
-                    std::unreachable();
-            }
-        }
-        if (static_cast<bool>(binding.usages & (BindingUsage::vertexWrite | BindingUsage::fragmentWrite))) {
-            throw std::runtime_error("not implemented");
-        }
-
-        auto it = m_bufferFinalSyncStates.find(buffer);
-        if (it != m_bufferFinalSyncStates.end()) {
-            auto barrier = syncBuffer(it->second, syncReq); // will update the final sync state
-            if (barrier.has_value()) {
-                barrier->setBuffer(buffer->vkBuffer());
-                barrier->setOffset(0);
-                barrier->setSize(vk::WholeSize);
-                bufferMemoryBarriers.push_back(*barrier);
-            }
-        } else {
-            m_bufferSyncRequests[buffer] = syncReq;
-            m_bufferFinalSyncStates[buffer] = bufferStateAfterSync(syncReq);
-        }
-    }
+    const auto& pBlock = std::dynamic_pointer_cast<const VulkanParameterBlock>(aPblock);
 
-    for (auto& [texture, binding] : pBlock->usedTextures())
+    if (m_isInComputePass)
     {
-        ImageSyncRequest syncReq{};
-
-        if ((binding.usages & BindingUsage::vertexRead) || (binding.usages & BindingUsage::vertexWrite))
-            syncReq.stageMask |= vk::PipelineStageFlagBits2::eVertexShader;
-        if ((binding.usages & BindingUsage::fragmentRead) || (binding.usages & BindingUsage::fragmentWrite))
-            syncReq.stageMask |= vk::PipelineStageFlagBits2::eFragmentShader;
+        assert(m_boundComputePipeline != nullptr);
+        m_vkCommandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_boundComputePipeline->pipelineLayout(), index, pBlock->descriptorSet(), {});
 
-        if (static_cast<bool>(binding.usages & (BindingUsage::vertexRead | BindingUsage::fragmentRead))) {
-            assert(binding.type == BindingType::sampledTexture);
-            syncReq.accessMask |= vk::AccessFlagBits2::eShaderRead;
-            syncReq.layout = vk::ImageLayout::eShaderReadOnlyOptimal;
-            syncReq.preserveContent = true;
-        }
-        if (static_cast<bool>(binding.usages & (BindingUsage::vertexWrite | BindingUsage::fragmentWrite))) {
-            syncReq.accessMask |= vk::AccessFlagBits2::eShaderWrite;
-            syncReq.layout = vk::ImageLayout::eGeneral; // allow read and write;
-            syncReq.preserveContent = true;
-            throw std::runtime_error("not implemented"); // never tested, because never had use case
-        }
-
-        auto it = m_imageFinalSyncStates.find(texture);
-        if (it != m_imageFinalSyncStates.end()) {
-            auto barrier = syncImage(it->second, syncReq); // will update the final sync state
-            if (barrier.has_value()) {
-                barrier->setImage(texture->vkImage());
-                barrier->setSubresourceRange(texture->subresourceRange());
-                imageMemoryBarriers.push_back(*barrier);
-            }
-        } else {
-            m_imageSyncRequests[texture] = syncReq;
-            m_imageFinalSyncStates[texture] = imageStateAfterSync(syncReq);
-        }
+        // synchronized by the next dispatch
+        if (m_computePBlocks.size() <= index)
+            m_computePBlocks.resize(index + 1, nullptr);
+        m_computePBlocks[index] = pBlock.get();
     }
-
-    if (bufferMemoryBarriers.empty() == false || imageMemoryBarriers.empty() == false)
+    else
     {
-        auto dependencyInfo = vk::DependencyInfo{}
-            .setDependencyFlags(vk::DependencyFlags{});
-
-        if (bufferMemoryBarriers.empty() == false)
-            dependencyInfo.setBufferMemoryBarriers(bufferMemoryBarriers);
-        if (imageMemoryBarriers.empty() == false)
-            dependencyInfo.setImageMemoryBarriers(imageMemoryBarriers);
+        syncParameterBlockUse(*pBlock, BindingUsage::vertexRead | BindingUsage::vertexWrite | BindingUsage::fragmentRead | BindingUsage::fragmentWrite);
 
-        m_vkCommandBuffer.pipelineBarrier2(dependencyInfo);
+        assert(m_boundPipeline != nullptr);
+        m_vkCommandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_boundPipeline->pipelineLayout(), index, pBlock->descriptorSet(), {});
     }
 
-    assert(m_boundPipeline != nullptr);
-    m_vkCommandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_boundPipeline->pipelineLayout(), index, pBlock->descriptorSet(), {});
-
     m_usedPBlock.insert(pBlock);
 }
 
 void VulkanCommandBuffer::setPushConstants(const void* data, size_t size)
 {
-    assert(m_boundPipeline != nullptr);
-    m_vkCommandBuffer.pushConstants(m_boundPipeline->pipelineLayout(), vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0, (uint32_t)size, data);
+    if (m_inlinedPassCommandBuffer != nullptr)
+        return m_inlinedPassCommandBuffer->setPushConstants(data, size);
+
+    assert(m_isInComputePass ? m_boundComputePipeline != nullptr : m_boundPipeline != nullptr);
+    const vk::PipelineLayout& pipelineLayout = m_isInComputePass ? m_boundComputePipeline->pipelineLayout() : m_boundPipeline->pipelineLayout();
+    m_vkCommandBuffer.pushConstants(pipelineLayout, ObjectCache::pushConstantStages, 0, (uint32_t)size, data);
 }
 
-void VulkanCommandBuffer::drawVertices(uint32_t start, uint32_t count)
+void VulkanCommandBuffer::drawVertices(uint32_t start, uint32_t count, uint32_t instanceCount, uint32_t firstInstance)
 {
-    m_vkCommandBuffer.draw(count, 1, start, 0);
+    if (m_inlinedPassCommandBuffer != nullptr)
+        return m_inlinedPassCommandBuffer->drawVertices(start, count, instanceCount, firstInstance);
+
+    flushBarriers();
+    m_vkCommandBuffer.draw(count, instanceCount, start, firstInstance);
 }
 
-void VulkanCommandBuffer::drawIndexedVertices(const std::shared_ptr<Buffer>& aBuffer)
+void VulkanCommandBuffer::drawIndexedVertices(const std::shared_ptr<Buffer>& aBuffer, IndexType indexType, uint32_t indexCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t instanceCount, uint32_t firstInstance)
 {
+    if (m_inlinedPassCommandBuffer != nullptr)
+        return m_inlinedPassCommandBuffer->drawIndexedVertices(aBuffer, indexType, indexCount, firstIndex, vertexOffset, instanceCount, firstInstance);
+
     auto buffer = std::dynamic_pointer_cast<VulkanBuffer>(aBuffer);
+    assert(buffer);
+
+    const size_t indexSize = indexTypeSize(indexType);
+    assert((static_cast<size_t>(firstIndex) + indexCount) * indexSize <= buffer->size());
 
     BufferSyncRequest syncReq{};
     syncReq.stageMask = vk::PipelineStageFlagBits2::eVertexInput;
     syncReq.accessMask = vk::AccessFlagBits2::eIndexRead;
+    syncReq.offset = static_cast<vk::DeviceSize>(firstIndex) * indexSize;
+    syncReq.size = static_cast<vk::DeviceSize>(indexCount) * indexSize;
 
-    auto it = m_bufferFinalSyncStates.find(buffer);
-    if (it != m_bufferFinalSyncStates.end()) {
-        auto barrier = syncBuffer(it->second, syncReq); // will update the final sync state
-        if (barrier.has_value()) {
-            barrier->setBuffer(buffer->vkBuffer());
-            barrier->setOffset(0);
-            barrier->setSize(vk::WholeSize);
-            m_vkCommandBuffer.pipelineBarrier2(vk::DependencyInfo{}
-               .setDependencyFlags(vk::DependencyFlags{})
-               .setBufferMemoryBarriers(*barrier));
-        }
-    } else {
-        m_bufferSyncRequests[buffer] = syncReq;
-        m_bufferFinalSyncStates[buffer] = bufferStateAfterSync(syncReq);
+    syncBufferUse(buffer, syncReq);
+
+    flushBarriers();
+
+    m_vkCommandBuffer.bindIndexBuffer(buffer->vkBuffer(), 0, toVkIndexType(indexType));
+    m_vkCommandBuffer.drawIndexed(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+}
+
+static_assert(sizeof(CommandBuffer::DrawIndirectCommand) == sizeof(vk::DrawIndirectCommand));
+static_assert(sizeof(CommandBuffer::DrawIndexedIndirectCommand) == sizeof(vk::DrawIndexedIndirectCommand));
+
+void VulkanCommandBuffer::drawIndirect(const std::shared_ptr<Buffer>& aIndirectBuffer, size_t offset, uint32_t drawCount)
+{
+    if (m_inlinedPassCommandBuffer != nullptr)
+        return m_inlinedPassCommandBuffer->drawIndirect(aIndirectBuffer, offset, drawCount);
+
+    auto indirectBuffer = std::dynamic_pointer_cast<VulkanBuffer>(aIndirectBuffer);
+    assert(indirectBuffer);
+    assert(offset % 4 == 0);
+    if (drawCount == 0)
+        return;
+
+    constexpr auto stride = static_cast<uint32_t>(sizeof(DrawIndirectCommand));
+    syncIndirectBufferUse(indirectBuffer, offset, static_cast<size_t>(drawCount) * stride);
+
+    flushBarriers();
+
+    if (drawCount <= 1 || m_device->hasMultiDrawIndirect())
+        m_vkCommandBuffer.drawIndirect(indirectBuffer->vkBuffer(), offset, drawCount, stride);
+    else {
+        for (uint32_t i = 0; i < drawCount; i++)
+            m_vkCommandBuffer.drawIndirect(indirectBuffer->vkBuffer(), offset + static_cast<size_t>(i) * stride, 1, stride);
     }
+}
 
-    m_vkCommandBuffer.bindIndexBuffer(buffer->vkBuffer(), 0, vk::IndexType::eUint32);
-    m_vkCommandBuffer.drawIndexed(static_cast<uint32_t>(buffer->size() / sizeof(uint32_t)), 1, 0, 0, 0);
+void VulkanCommandBuffer::drawIndexedIndirect(const std::shared_ptr<Buffer>& aIdxBuffer, IndexType indexType, const std::shared_ptr<Buffer>& aIndirectBuffer, size_t offset, uint32_t drawCount)
+{
+    if (m_inlinedPassCommandBuffer != nullptr)
+        return m_inlinedPassCommandBuffer->drawIndexedIndirect(aIdxBuffer, indexType, aIndirectBuffer, offset, drawCount);
+
+    auto idxBuffer = std::dynamic_pointer_cast<VulkanBuffer>(aIdxBuffer);
+    auto indirectBuffer = std::dynamic_pointer_cast<VulkanBuffer>(aIndirectBuffer);
+    assert(idxBuffer);
+    assert(indirectBuffer);
+    assert(offset % 4 == 0);
+    if (drawCount == 0)
+        return;
+
+    constexpr auto stride = static_cast<uint32_t>(sizeof(DrawIndexedIndirectCommand));
+    syncIndexBufferUse(idxBuffer);
+    syncIndirectBufferUse(indirectBuffer, offset, static_cast<size_t>(drawCount) * stride);
+
+    flushBarriers();
+
+    m_vkCommandBuffer.bindIndexBuffer(idxBuffer->vkBuffer(), 0, toVkIndexType(indexType));
+    if (drawCount <= 1 || m_device->hasMultiDrawIndirect())
+        m_vkCommandBuffer.drawIndexedIndirect(indirectBuffer->vkBuffer(), offset, drawCount, stride);
+    else {
+        for (uint32_t i = 0; i < drawCount; i++)
+            m_vkCommandBuffer.drawIndexedIndirect(indirectBuffer->vkBuffer(), offset + static_cast<size_t>(i) * stride, 1, stride);
+    }
+}
+
+void VulkanCommandBuffer::drawIndirectCount(const std::shared_ptr<Buffer>& aIndirectBuffer, size_t offset, const std::shared_ptr<Buffer>& aCountBuffer, size_t countOffset, uint32_t maxDrawCount)
+{
+    if (m_inlinedPassCommandBuffer != nullptr)
+        return m_inlinedPassCommandBuffer->drawIndirectCount(aIndirectBuffer, offset, aCountBuffer, countOffset, maxDrawCount);
+
+    assert(m_device->supportsDrawIndirectCount());
+    auto indirectBuffer = std::dynamic_pointer_cast<VulkanBuffer>(aIndirectBuffer);
+    auto countBuffer = std::dynamic_pointer_cast<VulkanBuffer>(aCountBuffer);
+    assert(indirectBuffer);
+    assert(countBuffer);
+    assert(offset % 4 == 0 && countOffset % 4 == 0);
+    if (maxDrawCount == 0)
+        return;
+
+    constexpr auto stride = static_cast<uint32_t>(sizeof(DrawIndirectCommand));
+    syncIndirectBufferUse(indirectBuffer, offset, static_cast<size_t>(maxDrawCount) * stride);
+    syncIndirectBufferUse(countBuffer, countOffset, sizeof(uint32_t));
+
+    flushBarriers();
+
+    m_vkCommandBuffer.drawIndirectCount(indirectBuffer->vkBuffer(), offset, countBuffer->vkBuffer(), countOffset, maxDrawCount, stride);
+}
+
+void VulkanCommandBuffer::drawIndexedIndirectCount(const std::shared_ptr<Buffer>& aIdxBuffer, IndexType indexType, const std::shared_ptr<Buffer>& aIndirectBuffer, size_t offset, const std::shared_ptr<Buffer>& aCountBuffer, size_t countOffset, uint32_t maxDrawCount)
+{
+    if (m_inlinedPassCommandBuffer != nullptr)
+        return m_inlinedPassCommandBuffer->drawIndexedIndirectCount(aIdxBuffer, indexType, aIndirectBuffer, offset, aCountBuffer, countOffset, maxDrawCount);
+
+    assert(m_device->supportsDrawIndirectCount());
+    auto idxBuffer = std::dynamic_pointer_cast<VulkanBuffer>(aIdxBuffer);
+    auto indirectBuffer = std::dynamic_pointer_cast<VulkanBuffer>(aIndirectBuffer);
+    auto countBuffer = std::dynamic_pointer_cast<VulkanBuffer>(aCountBuffer);
+    assert(idxBuffer);
+    assert(indirectBuffer);
+    assert(countBuffer);
+    assert(offset % 4 == 0 && countOffset % 4 == 0);
+    if (maxDrawCount == 0)
+        return;
+
+    constexpr auto stride = static_cast<uint32_t>(sizeof(DrawIndexedIndirectCommand));
+    syncIndexBufferUse(idxBuffer);
+    syncIndirectBufferUse(indirectBuffer, offset, static_cast<size_t>(maxDrawCount) * stride);
+    syncIndirectBufferUse(countBuffer, countOffset, sizeof(uint32_t));
+
+    flushBarriers();
+
+    m_vkCommandBuffer.bindIndexBuffer(idxBuffer->vkBuffer(), 0, toVkIndexType(indexType));
+    m_vkCommandBuffer.drawIndexedIndirectCount(indirectBuffer->vkBuffer(), offset, countBuffer->vkBuffer(), countOffset, maxDrawCount, stride);
 }
 
 #if defined(GFX_IMGUI_ENABLED)
 void VulkanCommandBuffer::imGuiRenderDrawData(ImDrawData* drawData) const
 {
+    if (m_inlinedPassCommandBuffer != nullptr)
+        return m_inlinedPassCommandBuffer->imGuiRenderDrawData(drawData);
+
     ImGui_ImplVulkan_RenderDrawData(drawData, m_vkCommandBuffer);
 }
 #endif
 
 void VulkanCommandBuffer::endRenderPass()
 {
+    assert(isSecondary() == false);
+    assert(m_isInRenderPass);
+    m_isInRenderPass = false;
+    m_inlinedPassCommandBuffer = nullptr;
+
+    m_secondaryVkCommandBuffers.clear();
+    for (size_t i = m_passFirstSecondary; i < m_usedSecondaryCount; i++)
+    {
+        VulkanCommandBuffer& secondary = *m_secondaries[i];
+        secondary.end();
+        mergeSecondaryUses(secondary);
+        m_secondaryVkCommandBuffers.push_back(secondary.vkCommandBuffer());
+    }
+    m_passFirstSecondary = m_usedSecondaryCount;
+    m_renderPassContents = RenderPassContents::inlined;
+
+    // only vkCmdExecuteCommands is recorded in the render pass, the barriers of the attachments
+    // and of the first uses of the secondaries are recorded in a single batch before it
+    flushBarriers();
+
+    auto renderingInfo = vk::RenderingInfo{}
+        .setFlags(vk::RenderingFlagBits::eContentsSecondaryCommandBuffers)
+        .setRenderArea(vk::Rect2D{}
+            .setOffset({.x=0, .y=0})
+            .setExtent(m_secondaryRenderPass.extent))
+        .setLayerCount(1)
+        .setViewMask(0)
+        .setColorAttachments(m_secondaryRenderPass.colorAttachments)
+        .setPDepthAttachment(m_secondaryRenderPass.depthAttachment ? &m_secondaryRenderPass.depthAttachment.value() : nullptr);
+
+    m_vkCommandBuffer.beginRendering(renderingInfo);
+    if (m_secondaryVkCommandBuffers.empty() == false)
+        m_vkCommandBuffer.executeCommands(m_secondaryVkCommandBuffers);
     m_vkCommandBuffer.endRendering();
     TracyVkZone_end(m_tracyVkCtxScope);
 }
 
+void VulkanCommandBuffer::beginComputePass()
+{
+    assert(m_isInComputePass == false);
+    assert(m_queueType != QueueType::transfer);
+    TracyVkZone_begin(VulkanDevice::s_tracyVkContext, m_vkCommandBuffer, "computePass", m_tracyVkCtxScope, true);
+    m_isInComputePass = true;
+}
+
+void VulkanCommandBuffer::usePipeline(const std::shared_ptr<const ComputePipeline>& aComputePipeline)
+{
+    auto computePipeline = std::dynamic_pointer_cast<const VulkanComputePipeline>(aComputePipeline);
+    assert(computePipeline);
+    assert(m_isInComputePass);
+
+    m_vkCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, computePipeline->vkPipeline());
+
+    m_usedComputePipelines.insert(computePipeline);
+    m_boundComputePipeline = computePipeline.get();
+}
+
+void VulkanCommandBuffer::dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+{
+    assert(m_isInComputePass);
+    assert(m_boundComputePipeline != nullptr);
+
+    for (const VulkanParameterBlock* pBlock : m_computePBlocks) {
+        if (pBlock != nullptr)
+            syncParameterBlockUse(*pBlock, BindingUsage::computeRead | BindingUsage::computeWrite);
+    }
+
+    flushBarriers();
+
+    m_vkCommandBuffer.dispatch(groupCountX, groupCountY, groupCountZ);
+}
+
+static_assert(sizeof(CommandBuffer::DispatchIndirectCommand) == sizeof(vk::DispatchIndirectCommand));
+
+void VulkanCommandBuffer::dispatchIndirect(const std::shared_ptr<Buffer>& aIndirectBuffer, size_t offset)
+{
+    auto indirectBuffer = std::dynamic_pointer_cast<VulkanBuffer>(aIndirectBuffer);
+    assert(indirectBuffer);
+    assert(offset % 4 == 0);
+    assert(m_isInComputePass);
+    assert(m_boundComputePipeline != nullptr);
+
+    for (const VulkanParameterBlock* pBlock : m_computePBlocks) {
+        if (pBlock != nullptr)
+            syncParameterBlockUse(*pBlock, BindingUsage::computeRead | BindingUsage::computeWrite);
+    }
+    syncIndirectBufferUse(indirectBuffer, offset, sizeof(DispatchIndirectCommand));
+
+    flushBarriers();
+
+    m_vkCommandBuffer.dispatchIndirect(indirectBuffer->vkBuffer(), offset);
+}
+
+void VulkanCommandBuffer::endComputePass()
+{
+    assert(m_isInComputePass);
+    m_isInComputePass = false;
+    m_boundComputePipeline = nullptr;
+    m_computePBlocks.clear();
+    TracyVkZone_end(m_tracyVkCtxScope);
+}
+
 void VulkanCommandBuffer::beginBlitPass()
 {
     // nothing
 }
 
-void VulkanCommandBuffer::copyBufferToBuffer(const std::shared_ptr<Buffer>& aSrc, const std::shared_ptr<Buffer>& aDst, size_t size)
+void VulkanCommandBuffer::copyBufferToBuffer(const std::shared_ptr<Buffer>& aSrc, size_t srcOffset, const std::shared_ptr<Buffer>& aDst, size_t dstOffset, size_t size)
 {
     auto src = std::dynamic_pointer_cast<VulkanBuffer>(aSrc);
     assert(src);
@@ -382,58 +503,36 @@ void VulkanCommandBuffer::copyBufferToBuffer(const std::shared_ptr<Buffer>& aSrc
 
     assert(src->usages() & BufferUsage::copySource);
     assert(dst->usages() & BufferUsage::copyDestination);
-
-    std::vector<vk::BufferMemoryBarrier2> bufferMemoryBarriers;
+    assert(srcOffset + size <= src->size());
+    assert(dstOffset + size <= dst->size());
 
     BufferSyncRequest srcBufferSyncReq{};
     srcBufferSyncReq.stageMask = vk::PipelineStageFlagBits2::eTransfer;
     srcBufferSyncReq.accessMask = vk::AccessFlagBits2::eTransferRead;
+    srcBufferSyncReq.offset = srcOffset;
+    srcBufferSyncReq.size = size;
 
-    auto srcBufferIt = m_bufferFinalSyncStates.find(src);
-    if (srcBufferIt != m_bufferFinalSyncStates.end()) {
-        auto barrier = syncBuffer(srcBufferIt->second, srcBufferSyncReq); // will update the final sync state
-        if (barrier.has_value()) {
-            barrier->setBuffer(src->vkBuffer());
-            barrier->setOffset(0);
-            barrier->setSize(vk::WholeSize);
-            bufferMemoryBarriers.push_back(*barrier);
-        }
-    } else {
-        m_bufferSyncRequests[src] = srcBufferSyncReq;
-        m_bufferFinalSyncStates[src] = bufferStateAfterSync(srcBufferSyncReq);
-    }
+    syncBufferUse(src, srcBufferSyncReq);
 
     BufferSyncRequest dstBufferSyncReq{};
     dstBufferSyncReq.stageMask = vk::PipelineStageFlagBits2::eTransfer;
     dstBufferSyncReq.accessMask = vk::AccessFlagBits2::eTransferWrite;
+    dstBufferSyncReq.offset = dstOffset;
+    dstBufferSyncReq.size = size;
 
-    auto dstBufferIt = m_bufferFinalSyncStates.find(dst);
-    if (dstBufferIt != m_bufferFinalSyncStates.end()) {
-        auto barrier = syncBuffer(dstBufferIt->second, dstBufferSyncReq); // will update the final sync state
-        if (barrier.has_value()) {
-            barrier->setBuffer(dst->vkBuffer());
-            barrier->setOffset(0);
-            barrier->setSize(vk::WholeSize);
-            bufferMemoryBarriers.push_back(*barrier);
-        }
-    } else {
-        m_bufferSyncRequests[dst] = dstBufferSyncReq;
-        m_bufferFinalSyncStates[dst] = bufferStateAfterSync(dstBufferSyncReq);
-    }
+    syncBufferUse(dst, dstBufferSyncReq);
 
-    if (bufferMemoryBarriers.empty() == false)
-    {
-        m_vkCommandBuffer.pipelineBarrier2(vk::DependencyInfo{}
-            .setDependencyFlags(vk::DependencyFlags{})
-            .setBufferMemoryBarriers(bufferMemoryBarriers));
-    }
+    flushBarriers();
 
     auto bufferCopy = vk::BufferCopy{}
-        .setSrcOffset(0)
-        .setDstOffset(0)
+        .setSrcOffset(srcOffset)
+        .setDstOffset(dstOffset)
         .setSize(size);
 
     m_vkCommandBuffer.copyBuffer(src->vkBuffer(), dst->vkBuffer(), bufferCopy);
+
+    if (dst->storageMode() == ResourceStorageMode::readback)
+        syncReadbackBufferCopy(dst, dstOffset, size);
 }
 
 void VulkanCommandBuffer::copyBufferToTexture(const std::shared_ptr<Buffer>& aBuffer, size_t bufferOffset, const std::shared_ptr<Texture>& aTexture, uint32_t layerIndex)
@@ -447,58 +546,28 @@ void VulkanCommandBuffer::copyBufferToTexture(const std::shared_ptr<Buffer>& aBu
     assert(texture->usages() & TextureUsage::copyDestination);
     assert(bufferOffset + pixelFormatSize(texture->pixelFormat()) * texture->width() * texture->height() <= buffer->size());
 
-    std::vector<vk::BufferMemoryBarrier2> bufferMemoryBarriers;
-    std::vector<vk::ImageMemoryBarrier2> imageMemoryBarriers;
-
     BufferSyncRequest bufferSyncReq{};
     bufferSyncReq.stageMask = vk::PipelineStageFlagBits2::eTransfer;
     bufferSyncReq.accessMask = vk::AccessFlagBits2::eTransferRead;
+    bufferSyncReq.offset = bufferOffset;
+    bufferSyncReq.size = pixelFormatSize(texture->pixelFormat()) * texture->width() * texture->height();
 
-    auto it1 = m_bufferFinalSyncStates.find(buffer);
-    if (it1 != m_bufferFinalSyncStates.end()) {
-        auto barrier = syncBuffer(it1->second, bufferSyncReq); // will update the final sync state
-        if (barrier.has_value()) {
-            barrier->setBuffer(buffer->vkBuffer());
-            barrier->setOffset(0);
-            barrier->setSize(vk::WholeSize);
-            bufferMemoryBarriers.push_back(*barrier);
-        }
-    } else {
-        m_bufferSyncRequests[buffer] = bufferSyncReq;
-        m_bufferFinalSyncStates[buffer] = bufferStateAfterSync(bufferSyncReq);
-    }
+    syncBufferUse(buffer, bufferSyncReq);
 
     ImageSyncRequest imageSyncReq{};
     imageSyncReq.stageMask = vk::PipelineStageFlagBits2::eTransfer;
     imageSyncReq.accessMask = vk::AccessFlagBits2::eTransferWrite;
     imageSyncReq.layout = vk::ImageLayout::eTransferDstOptimal;
     imageSyncReq.preserveContent = false;
+    // only the first mip is written, the other ones keep their layout and content
+    imageSyncReq.baseMipLevel = 0;
+    imageSyncReq.levelCount = 1;
+    imageSyncReq.baseArrayLayer = layerIndex;
+    imageSyncReq.layerCount = 1;
 
-    auto it2 = m_imageFinalSyncStates.find(texture);
-    if (it2 != m_imageFinalSyncStates.end()) {
-        auto barrier = syncImage(it2->second, imageSyncReq); // will update the final sync state
-        if (barrier.has_value()) {
-            barrier->setImage(texture->vkImage());
-            barrier->setSubresourceRange(texture->subresourceRange());
-            imageMemoryBarriers.push_back(*barrier);
-        }
-    } else {
-        m_imageSyncRequests[texture] = imageSyncReq;
-        m_imageFinalSyncStates[texture] = imageStateAfterSync(imageSyncReq);
-    }
-
-    if (bufferMemoryBarriers.empty() == false || imageMemoryBarriers.empty() == false)
-    {
-        auto dependencyInfo = vk::DependencyInfo{}
-            .setDependencyFlags(vk::DependencyFlags{});
+    syncImageUse(texture, imageSyncReq);
 
-        if (bufferMemoryBarriers.empty() == false)
-            dependencyInfo.setBufferMemoryBarriers(bufferMemoryBarriers);
-        if (imageMemoryBarriers.empty() == false)
-            dependencyInfo.setImageMemoryBarriers(imageMemoryBarriers);
-
-        m_vkCommandBuffer.pipelineBarrier2(dependencyInfo);
-    }
+    flushBarriers();
 
     auto bufferImageCopy = vk::BufferImageCopy{}
         .setBufferOffset(bufferOffset)
@@ -519,6 +588,62 @@ void VulkanCommandBuffer::copyBufferToTexture(const std::shared_ptr<Buffer>& aBu
         bufferImageCopy);
 }
 
+void VulkanCommandBuffer::copyTextureToBuffer(const std::shared_ptr<Texture>& aTexture, const std::shared_ptr<Buffer>& aBuffer, size_t bufferOffset, uint32_t layerIndex)
+{
+    auto texture = std::dynamic_pointer_cast<VulkanTexture>(aTexture);
+    assert(texture);
+    auto buffer = std::dynamic_pointer_cast<VulkanBuffer>(aBuffer);
+    assert(buffer);
+
+    const size_t imageSize = pixelFormatSize(texture->pixelFormat()) * texture->width() * texture->height();
+    assert(texture->usages() & TextureUsage::copySource);
+    assert(buffer->usages() & BufferUsage::copyDestination);
+    assert(bufferOffset + imageSize <= buffer->size());
+
+    ImageSyncRequest imageSyncReq{};
+    imageSyncReq.stageMask = vk::PipelineStageFlagBits2::eTransfer;
+    imageSyncReq.accessMask = vk::AccessFlagBits2::eTransferRead;
+    imageSyncReq.layout = vk::ImageLayout::eTransferSrcOptimal;
+    imageSyncReq.preserveContent = true;
+    imageSyncReq.baseMipLevel = 0; // only the first mip is read
+    imageSyncReq.levelCount = 1;
+    imageSyncReq.baseArrayLayer = layerIndex;
+    imageSyncReq.layerCount = 1;
+
+    syncImageUse(texture, imageSyncReq);
+
+    BufferSyncRequest bufferSyncReq{};
+    bufferSyncReq.stageMask = vk::PipelineStageFlagBits2::eTransfer;
+    bufferSyncReq.accessMask = vk::AccessFlagBits2::eTransferWrite;
+    bufferSyncReq.offset = bufferOffset;
+    bufferSyncReq.size = imageSize;
+
+    syncBufferUse(buffer, bufferSyncReq);
+
+    flushBarriers();
+
+    auto bufferImageCopy = vk::BufferImageCopy{}
+        .setBufferOffset(bufferOffset)
+        .setImageSubresource(vk::ImageSubresourceLayers{}
+            .setAspectMask(texture->subresourceRange().aspectMask)
+            .setMipLevel(0)
+            .setBaseArrayLayer(layerIndex)
+            .setLayerCount(1))
+        .setImageExtent(vk::Extent3D{}
+            .setWidth(texture->width())
+            .setHeight(texture->height())
+            .setDepth(1));
+
+    m_vkCommandBuffer.copyImageToBuffer(
+        texture->vkImage(),
+        vk::ImageLayout::eTransferSrcOptimal,
+        buffer->vkBuffer(),
+        bufferImageCopy);
+
+    if (buffer->storageMode() == ResourceStorageMode::readback)
+        syncReadbackBufferCopy(buffer, bufferOffset, imageSize);
+}
+
 void VulkanCommandBuffer::endBlitPass()
 {
     // nothing
@@ -526,12 +651,16 @@ void VulkanCommandBuffer::endBlitPass()
 
 void VulkanCommandBuffer::presentDrawable(const std::shared_ptr<Drawable>& aDrawable)
 {
+    assert(m_isReusable == false); // the drawable is a different one each frame
     auto drawable = std::dynamic_pointer_cast<VulkanDrawable>(aDrawable);
     m_presentedDrawables.insert(drawable);
 }
 
 void VulkanCommandBuffer::addSampledTexture(const std::shared_ptr<Texture>& aTexture)
 {
+    if (m_inlinedPassCommandBuffer != nullptr)
+        return m_inlinedPassCommandBuffer->addSampledTexture(aTexture);
+
     auto texture = std::dynamic_pointer_cast<VulkanTexture>(aTexture);
 
     ImageSyncRequest syncReq{};
@@ -540,20 +669,329 @@ void VulkanCommandBuffer::addSampledTexture(const std::shared_ptr<Texture>& aTex
     syncReq.layout = vk::ImageLayout::eShaderReadOnlyOptimal;
     syncReq.preserveContent = true;
 
-    auto it = m_imageFinalSyncStates.find(texture);
-    if (it != m_imageFinalSyncStates.end()) {
-        auto barrier = syncImage(it->second, syncReq); // will update the final sync state
-        if (barrier.has_value()) {
-            barrier->setImage(texture->vkImage());
-            barrier->setSubresourceRange(texture->subresourceRange());
-            m_vkCommandBuffer.pipelineBarrier2(vk::DependencyInfo{}
-               .setDependencyFlags(vk::DependencyFlags{})
-               .setImageMemoryBarriers(*barrier));
+    syncImageUse(texture, syncReq);
+
+    // imGuiRenderDrawData is const and cannot flush, the texture is sampled by the next imgui draw
+    flushBarriers();
+}
+
+SubmitTicket VulkanCommandBuffer::submitTicket() const
+{
+    waitPendingSubmits();
+    const uint64_t value = signaledTimeValue();
+    if (value == 0)
+        return SubmitTicket{};
+    return SubmitTicket{ .value = value, .queueType = m_queueType };
+}
+
+bool VulkanCommandBuffer::isCompleted() const
+{
+    if (hasPendingSubmits())
+        return false;
+    const uint64_t value = signaledTimeValue();
+    return value == 0 || m_device->isCompleted(SubmitTicket{ .value = value, .queueType = m_queueType });
+}
+
+void VulkanCommandBuffer::reuse()
+{
+    // clear instead of reassigning so the sync tables keep their capacity
+    m_usedPipelines.clear();
+    m_boundPipeline = nullptr;
+    m_usedComputePipelines.clear();
+    m_boundComputePipeline = nullptr;
+    m_isInComputePass = false;
+    m_computePBlocks.clear();
+    m_usedPBlock.clear();
+    m_imageSyncTable.clear();
+    m_bufferSyncTable.clear();
+    m_presentedDrawables.clear();
+    m_nonReusedRessources.signaledTimeValue = 0;
+    m_nonReusedRessources.statistics = Statistics{};
+    m_pendingImageBarriers.clear();
+    m_pendingBufferBarriers.clear();
+
+    // secondaries are only reused with their primary, so they are completed too
+    for (size_t i = 0; i < m_usedSecondaryCount; i++)
+        m_secondaries[i]->reuse();
+    m_usedSecondaryCount = 0;
+    m_passFirstSecondary = 0;
+    m_renderPassContents = RenderPassContents::inlined;
+    m_isInRenderPass = false;
+    m_inlinedPassCommandBuffer = nullptr;
+    if (isSecondary())
+        m_device->vkDevice().resetCommandPool(*m_vkCommandPool); // the pool is owned by this command buffer
+}
+
+void VulkanCommandBuffer::beginSecondary(const SecondaryRenderPass& inheritance)
+{
+    auto inheritanceRenderingInfo = vk::CommandBufferInheritanceRenderingInfo{}
+        .setColorAttachmentFormats(inheritance.colorAttachmentFormats)
+        .setDepthAttachmentFormat(inheritance.depthAttachmentFormat)
+        .setRasterizationSamples(vk::SampleCountFlagBits::e1);
+
+    auto inheritanceInfo = vk::CommandBufferInheritanceInfo{}
+        .setPNext(&inheritanceRenderingInfo);
+
+    m_isRecording = true;
+    m_vkCommandBuffer.begin(vk::CommandBufferBeginInfo{}
+        .setFlags(usageFlags() | vk::CommandBufferUsageFlagBits::eRenderPassContinue)
+        .setPInheritanceInfo(&inheritanceInfo));
+
+    // the dynamic states are not inherited
+    m_vkCommandBuffer.setViewport(0, vk::Viewport{}
+        .setX(0)
+        .setY(0)
+        .setWidth(static_cast<float>(inheritance.extent.width))
+        .setHeight(static_cast<float>(inheritance.extent.height))
+        .setMinDepth(0)
+        .setMaxDepth(1));
+    m_vkCommandBuffer.setScissor(0, vk::Rect2D{}
+        .setOffset({.x=0, .y=0})
+        .setExtent(inheritance.extent));
+}
+
+void VulkanCommandBuffer::mergeSecondaryUses(const VulkanCommandBuffer& secondary)
+{
+    assert(secondary.presentedDrawables().empty());
+
+    // the first uses of the secondary are synchronized against the state of this command buffer like any other use,
+    // then the final state of the secondary become the one of this command buffer
+    for (const auto& [slot, texture, syncReqs, finalSyncState] : secondary.imageSyncTable().entries())
+    {
+        ImageSyncTable::Entry& entry = imageSyncEntry(texture);
+        m_imageBarriersScratch.clear();
+        for (const auto& range : syncReqs.ranges()) {
+            entry.syncRequest.fillGaps(range.begin, range.end, range.value);
+            syncImageSubresources(entry.finalSyncState, range.begin, range.end, range.value, m_imageBarriersScratch);
+        }
+        for (const auto& range : finalSyncState.subresources.ranges())
+            entry.finalSyncState.subresources.assign(range.begin, range.end, range.value);
+        for (auto& barrier : m_imageBarriersScratch) {
+            barrier.setImage(texture->vkImage());
+            barrier.subresourceRange.setAspectMask(texture->subresourceRange().aspectMask);
+            addImageBarrier(barrier);
+        }
+    }
+
+    for (const auto& [slot, buffer, syncReqs, finalSyncState] : secondary.bufferSyncTable().entries())
+    {
+        for (const auto& range : syncReqs.ranges())
+        {
+            BufferSyncRequest syncReq{};
+            syncReq.stageMask = range.value.stageMask;
+            syncReq.accessMask = range.value.accessMask;
+            syncReq.offset = range.begin;
+            syncReq.size = range.end == std::numeric_limits<uint64_t>::max() ? vk::WholeSize : range.end - range.begin;
+            syncBufferUse(buffer, syncReq);
+        }
+        BufferSyncTable::Entry* entry = m_bufferSyncTable.find(slot);
+        assert(entry != nullptr);
+        for (const auto& range : finalSyncState.ranges.ranges())
+            entry->finalSyncState.ranges.assign(range.begin, range.end, range.value);
+    }
+
+    const Statistics secondaryStatistics = secondary.statistics();
+    m_nonReusedRessources.statistics.barrierCount += secondaryStatistics.barrierCount;
+    m_nonReusedRessources.statistics.barrierBatchCount += secondaryStatistics.barrierBatchCount;
+}
+
+VulkanCommandBuffer::ImageSyncTable::Entry& VulkanCommandBuffer::imageSyncEntry(const std::shared_ptr<VulkanTexture>& texture)
+{
+    ImageSyncTable::Entry* entry = m_imageSyncTable.find(texture->slot());
+    if (entry != nullptr)
+        return *entry;
+    ImageSyncTable::Entry& newEntry = m_imageSyncTable.insert(texture);
+    newEntry.syncRequest.clear();
+    newEntry.finalSyncState.mipLevelCount = texture->syncState().mipLevelCount;
+    newEntry.finalSyncState.arrayLayerCount = texture->syncState().arrayLayerCount;
+    newEntry.finalSyncState.subresources.clear();
+    return newEntry;
+}
+
+void VulkanCommandBuffer::syncImageUse(const std::shared_ptr<VulkanTexture>& texture, const ImageSyncRequest& syncReq)
+{
+    ImageSyncTable::Entry* entry = &imageSyncEntry(texture);
+    // the subresources not used yet by this command buffer are synced at submit time
+    forEachImageSyncRange(entry->finalSyncState, syncReq, [&](uint64_t begin, uint64_t end) {
+        entry->syncRequest.fillGaps(begin, end, syncReq);
+    });
+    m_imageBarriersScratch.clear();
+    syncImage(entry->finalSyncState, syncReq, m_imageBarriersScratch); // will update the final sync state
+    for (auto& barrier : m_imageBarriersScratch) {
+        barrier.setImage(texture->vkImage());
+        barrier.subresourceRange.setAspectMask(texture->subresourceRange().aspectMask);
+        addImageBarrier(barrier);
+    }
+}
+
+void VulkanCommandBuffer::syncBufferUse(const std::shared_ptr<VulkanBuffer>& buffer, const BufferSyncRequest& syncReq)
+{
+    const uint64_t end = bufferSyncRangeEnd(syncReq);
+
+    BufferSyncTable::Entry* entry = m_bufferSyncTable.find(buffer->slot());
+    if (entry == nullptr) {
+        BufferSyncTable::Entry& newEntry = m_bufferSyncTable.insert(buffer);
+        newEntry.syncRequest.clear();
+        newEntry.syncRequest.assign(syncReq.offset, end, syncReq);
+        newEntry.finalSyncState.ranges.clear();
+        newEntry.finalSyncState.ranges.assign(syncReq.offset, end, resourceStateAfterSync(syncReq));
+        return;
+    }
+    // the parts of the range not used yet by this command buffer are synced at submit time
+    entry->syncRequest.fillGaps(syncReq.offset, end, syncReq);
+    auto barrier = syncBuffer(entry->finalSyncState, syncReq); // will update the final sync state
+    if (barrier.has_value()) {
+        // barriers of a same batch are not ordered, a second barrier on the same bytes need to wait for the first one
+        auto overlaps = [&](const vk::BufferMemoryBarrier2& b) {
+            const uint64_t bEnd = b.size == vk::WholeSize ? std::numeric_limits<uint64_t>::max() : b.offset + b.size;
+            return b.buffer == buffer->vkBuffer() && b.offset < end && syncReq.offset < bEnd;
+        };
+        if (std::ranges::any_of(m_pendingBufferBarriers, overlaps))
+            flushBarriers();
+        barrier->setBuffer(buffer->vkBuffer());
+        m_pendingBufferBarriers.push_back(*barrier);
+    }
+}
+
+void VulkanCommandBuffer::syncIndexBufferUse(const std::shared_ptr<VulkanBuffer>& buffer)
+{
+    // the indices read by an indirect draw are only known by the GPU
+    BufferSyncRequest syncReq{};
+    syncReq.stageMask = vk::PipelineStageFlagBits2::eVertexInput;
+    syncReq.accessMask = vk::AccessFlagBits2::eIndexRead;
+
+    syncBufferUse(buffer, syncReq);
+}
+
+void VulkanCommandBuffer::syncReadbackBufferCopy(const std::shared_ptr<VulkanBuffer>& buffer, size_t offset, size_t size)
+{
+    BufferSyncRequest syncReq{};
+    syncReq.stageMask = vk::PipelineStageFlagBits2::eHost;
+    syncReq.accessMask = vk::AccessFlagBits2::eHostRead;
+    syncReq.offset = offset;
+    syncReq.size = size;
+
+    syncBufferUse(buffer, syncReq);
+    flushBarriers();
+}
+
+void VulkanCommandBuffer::syncIndirectBufferUse(const std::shared_ptr<VulkanBuffer>& buffer, size_t offset, size_t size)
+{
+    assert(buffer->usages() & BufferUsage::indirectBuffer);
+    assert(offset + size <= buffer->size());
+
+    BufferSyncRequest syncReq{};
+    syncReq.stageMask = vk::PipelineStageFlagBits2::eDrawIndirect;
+    syncReq.accessMask = vk::AccessFlagBits2::eIndirectCommandRead;
+    syncReq.offset = offset;
+    syncReq.size = size;
+
+    syncBufferUse(buffer, syncReq);
+}
+
+void VulkanCommandBuffer::syncParameterBlockUse(const VulkanParameterBlock& pBlock, BindingUsages passUsages)
+{
+    for (auto& [buffer, binding, offset, size] : pBlock.usedBuffers())
+    {
+        const BindingUsages usages = binding.usages & passUsages;
+        if (static_cast<bool>(usages) == false)
+            continue;
+
+        BufferSyncRequest syncReq{};
+        syncReq.stageMask = toVkPipelineStageFlags(usages);
+        syncReq.offset = offset;
+        syncReq.size = size;
+
+        if (static_cast<bool>(usages & (BindingUsage::vertexRead | BindingUsage::fragmentRead | BindingUsage::computeRead)))
+        {
+            switch (binding.type)
+            {
+                case BindingType::constantBuffer:
+                    syncReq.accessMask |= vk::AccessFlagBits2::eUniformRead;
+                    break;
+                case BindingType::structuredBuffer:
+                    syncReq.accessMask |= vk::AccessFlagBits2::eShaderStorageRead;
+                    break;
+                default:
+                    std::unreachable();
+            }
         }
-    } else {
-        m_imageSyncRequests[texture] = syncReq;
-        m_imageFinalSyncStates[texture] = imageStateAfterSync(syncReq);
+        if (static_cast<bool>(usages & (BindingUsage::vertexWrite | BindingUsage::fragmentWrite | BindingUsage::computeWrite))) {
+            assert(binding.type == BindingType::structuredBuffer); // constant buffers are read only
+            syncReq.accessMask |= vk::AccessFlagBits2::eShaderStorageWrite;
+        }
+
+        syncBufferUse(buffer, syncReq);
     }
+
+    for (auto& [texture, binding] : pBlock.usedTextures())
+    {
+        const BindingUsages usages = binding.usages & passUsages;
+        if (static_cast<bool>(usages) == false)
+            continue;
+
+        ImageSyncRequest syncReq{};
+        syncReq.stageMask = toVkPipelineStageFlags(usages);
+        syncReq.preserveContent = true;
+
+        if (binding.type == BindingType::sampledTexture) {
+            assert(static_cast<bool>(usages & (BindingUsage::vertexWrite | BindingUsage::fragmentWrite | BindingUsage::computeWrite)) == false);
+            syncReq.accessMask = vk::AccessFlagBits2::eShaderRead;
+            syncReq.layout = vk::ImageLayout::eShaderReadOnlyOptimal;
+        }
+        else {
+            assert(binding.type == BindingType::storageTexture);
+            if (static_cast<bool>(usages & (BindingUsage::vertexRead | BindingUsage::fragmentRead | BindingUsage::computeRead)))
+                syncReq.accessMask |= vk::AccessFlagBits2::eShaderStorageRead;
+            if (static_cast<bool>(usages & (BindingUsage::vertexWrite | BindingUsage::fragmentWrite | BindingUsage::computeWrite)))
+                syncReq.accessMask |= vk::AccessFlagBits2::eShaderStorageWrite;
+            syncReq.layout = vk::ImageLayout::eGeneral; // the only layout allowing storage reads and writes
+        }
+
+        syncImageUse(texture, syncReq);
+    }
+}
+
+void VulkanCommandBuffer::addImageBarrier(const vk::ImageMemoryBarrier2& barrier)
+{
+    // barriers of a same batch are not ordered, a second barrier on the same subresources need to wait for the first one
+    auto overlaps = [&](const vk::ImageMemoryBarrier2& b) {
+        const vk::ImageSubresourceRange& r1 = b.subresourceRange;
+        const vk::ImageSubresourceRange& r2 = barrier.subresourceRange;
+        // syncImage always produce explicit counts, never vk::RemainingMipLevels or vk::RemainingArrayLayers
+        auto intersect = [](uint32_t base1, uint32_t count1, uint32_t base2, uint32_t count2) {
+            return base1 < base2 + count2 && base2 < base1 + count1;
+        };
+        return b.image == barrier.image
+            && intersect(r1.baseMipLevel, r1.levelCount, r2.baseMipLevel, r2.levelCount)
+            && intersect(r1.baseArrayLayer, r1.layerCount, r2.baseArrayLayer, r2.layerCount);
+    };
+    if (std::ranges::any_of(m_pendingImageBarriers, overlaps))
+        flushBarriers();
+    m_pendingImageBarriers.push_back(barrier);
+}
+
+void VulkanCommandBuffer::flushBarriers()
+{
+    if (m_pendingImageBarriers.empty() && m_pendingBufferBarriers.empty())
+        return;
+    // the uses inside a render pass are synchronized by the primary before vkCmdBeginRendering,
+    // a barrier between two of them would need a self dependency (a pass writing what it already used)
+    assert(isSecondary() == false && m_isInRenderPass == false);
+
+    auto dependencyInfo = vk::DependencyInfo{}
+        .setDependencyFlags(vk::DependencyFlags{});
+
+    if (m_pendingImageBarriers.empty() == false)
+        dependencyInfo.setImageMemoryBarriers(m_pendingImageBarriers);
+    if (m_pendingBufferBarriers.empty() == false)
+        dependencyInfo.setBufferMemoryBarriers(m_pendingBufferBarriers);
+
+    m_vkCommandBuffer.pipelineBarrier2(dependencyInfo);
+
+    countBarriers(static_cast<uint32_t>(m_pendingImageBarriers.size() + m_pendingBufferBarriers.size()));
+    m_pendingImageBarriers.clear();
+    m_pendingBufferBarriers.clear();
 }
 
 }
@@ -19,10 +19,12 @@
 #include "Graphics/Texture.hpp"
 #include "Vulkan/VulkanBuffer.hpp"
 #include "Vulkan/VulkanGraphicsPipeline.hpp"
+#include "Vulkan/VulkanComputePipeline.hpp"
 #include "Vulkan/VulkanSampler.hpp"
 #include "Vulkan/VulkanTexture.hpp"
 #include "Vulkan/VulkanDrawable.hpp"
 #include "Vulkan/VulkanParameterBlock.hpp"
+#include "Vulkan/ResourceSyncTable.hpp"
 #include <memory>
 
 namespace gfx
@@ -32,24 +34,40 @@ class VulkanDevice;
 
 class VulkanCommandBuffer : public CommandBuffer
 {
+public:
+    using ImageSyncTable = ResourceSyncTable<VulkanTexture, ImageSyncRequests, ImageSyncState>;
+    using BufferSyncTable = ResourceSyncTable<VulkanBuffer, BufferSyncRequests, BufferSyncState>;
+
 public:
     VulkanCommandBuffer() = delete;
     VulkanCommandBuffer(const VulkanCommandBuffer&) = delete;
     VulkanCommandBuffer(VulkanCommandBuffer&&) = delete;
 
-    VulkanCommandBuffer(const VulkanDevice*, const std::shared_ptr<vk::CommandPool>&);
-    VulkanCommandBuffer(const VulkanDevice*, const vk::CommandPool&);
+    VulkanCommandBuffer(const VulkanDevice*, const std::shared_ptr<vk::CommandPool>&, QueueType, vk::CommandBufferLevel = vk::CommandBufferLevel::ePrimary, bool isReusable = false);
+    VulkanCommandBuffer(const VulkanDevice*, const vk::CommandPool&, QueueType);
 
-    void beginRenderPass(const Framebuffer&) override;
+    using CommandBuffer::beginRenderPass;
+    void beginRenderPass(const Framebuffer&, RenderPassContents) override;
 
+    std::shared_ptr<CommandBuffer> newSecondaryCommandBuffer() override;
+
+    using CommandBuffer::usePipeline;
     void usePipeline(const std::shared_ptr<const GraphicsPipeline>&) override;
-    void useVertexBuffer(const std::shared_ptr<Buffer>&) override;
+    using CommandBuffer::useVertexBuffer;
+    void useVertexBuffer(const std::shared_ptr<Buffer>&, size_t offset, uint32_t bufferIndex) override;
 
     void setParameterBlock(const std::shared_ptr<const ParameterBlock>&, uint32_t index) override;
     void setPushConstants(const void* data, size_t size) override;
 
-    void drawVertices(uint32_t start, uint32_t count) override;
-    void drawIndexedVertices(const std::shared_ptr<Buffer>& idxBuffer) override;
+    using CommandBuffer::drawVertices;
+    void drawVertices(uint32_t start, uint32_t count, uint32_t instanceCount, uint32_t firstInstance) override;
+    using CommandBuffer::drawIndexedVertices;
+    void drawIndexedVertices(const std::shared_ptr<Buffer>& idxBuffer, IndexType, uint32_t indexCount, uint32_t firstIndex = 0, int32_t vertexOffset = 0, uint32_t instanceCount = 1, uint32_t firstInstance = 0) override;
+
+    void drawIndirect(const std::shared_ptr<Buffer>& indirectBuffer, size_t offset, uint32_t drawCount = 1) override;
+    void drawIndexedIndirect(const std::shared_ptr<Buffer>& idxBuffer, IndexType, const std::shared_ptr<Buffer>& indirectBuffer, size_t offset, uint32_t drawCount = 1) override;
+    void drawIndirectCount(const std::shared_ptr<Buffer>& indirectBuffer, size_t offset, const std::shared_ptr<Buffer>& countBuffer, size_t countOffset, uint32_t maxDrawCount) override;
+    void drawIndexedIndirectCount(const std::shared_ptr<Buffer>& idxBuffer, IndexType, const std::shared_ptr<Buffer>& indirectBuffer, size_t offset, const std::shared_ptr<Buffer>& countBuffer, size_t countOffset, uint32_t maxDrawCount) override;
 
 #if defined(GFX_IMGUI_ENABLED)
     void imGuiRenderDrawData(ImDrawData*) const override;
@@ -57,10 +75,23 @@ public:
 
     void endRenderPass() override;
 
+    void beginComputePass() override;
+
+    void usePipeline(const std::shared_ptr<const ComputePipeline>&) override;
+
+    void dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1) override;
+    void dispatchIndirect(const std::shared_ptr<Buffer>& indirectBuffer, size_t offset) override;
+
+    void endComputePass() override;
+
     void beginBlitPass() override;
 
-    void copyBufferToBuffer(const std::shared_ptr<Buffer>& src, const std::shared_ptr<Buffer>& dst, size_t size) override;
+    using CommandBuffer::copyBufferToBuffer;
+    void copyBufferToBuffer(const std::shared_ptr<Buffer>& src, size_t srcOffset, const std::shared_ptr<Buffer>& dst, size_t dstOffset, size_t size) override;
+    using CommandBuffer::copyBufferToTexture;
     void copyBufferToTexture(const std::shared_ptr<Buffer>& buffer, size_t bufferOffset, const std::shared_ptr<Texture>& texture, uint32_t layerIndex = 0) override;
+    using CommandBuffer::copyTextureToBuffer;
+    void copyTextureToBuffer(const std::shared_ptr<Texture>& texture, const std::shared_ptr<Buffer>& buffer, size_t bufferOffset, uint32_t layerIndex = 0) override;
 
     void endBlitPass() override;
 
@@ -68,55 +99,148 @@ public:
 
     void addSampledTexture(const std::shared_ptr<Texture>&) override; // for imgui
 
+    inline Statistics statistics() const override { return m_nonReusedRessources.statistics; }
+
+    SubmitTicket submitTicket() const override;
+    bool isCompleted() const override;
 
     const vk::CommandBuffer& vkCommandBuffer() const { return m_vkCommandBuffer; }
+    inline QueueType queueType() const { return m_queueType; }
+
+    inline void begin() { m_vkCommandBuffer.begin(vk::CommandBufferBeginInfo{.flags = usageFlags()}); m_isRecording = true; }
+    // a secondary never has pending barriers, its first uses are synchronized by the primary when it is executed
+    inline void end() { flushBarriers(); m_vkCommandBuffer.end(); m_isRecording = false; }
+    inline bool isRecording() const { return m_isRecording; }
 
-    inline void begin() { m_vkCommandBuffer.begin(vk::CommandBufferBeginInfo{.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit}); }
-    inline void end() { m_vkCommandBuffer.end(); }
+    // the barrier is recorded with the other pending barriers before the next action command or at the end of the command buffer
+    void addImageBarrier(const vk::ImageMemoryBarrier2&);
 
-    inline const std::map<std::shared_ptr<VulkanTexture>, ImageSyncRequest>& imageSyncRequests() const { return m_nonReusedRessources.imageSyncRequests; }
-    inline const std::map<std::shared_ptr<VulkanTexture>, ImageSyncState>& imageFinalSyncStates() const { return m_nonReusedRessources.imageFinalSyncStates; }
-    inline const std::map<std::shared_ptr<VulkanBuffer>, BufferSyncRequest>& bufferSyncRequests() const { return m_nonReusedRessources.bufferSyncRequests; }
-    inline const std::map<std::shared_ptr<VulkanBuffer>, BufferSyncState>& bufferFinalSyncStates() const { return m_nonReusedRessources.bufferFinalSyncStates; }
+    inline const ImageSyncTable& imageSyncTable() const { return m_nonReusedRessources.imageSyncTable; }
+    inline const BufferSyncTable& bufferSyncTable() const { return m_nonReusedRessources.bufferSyncTable; }
 
-    inline const std::set<std::shared_ptr<VulkanDrawable>> presentedDrawables() const { return m_nonReusedRessources.presentedDrawables; }
+    inline const std::set<std::shared_ptr<VulkanDrawable>>& presentedDrawables() const { return m_nonReusedRessources.presentedDrawables; }
 
-    inline void reuse() { m_nonReusedRessources = NonReusedRessources(); }
+    void reuse();
 
-    inline void setSignaledTimeValue(uint64_t v) { m_nonReusedRessources.signaledTimeValue = v; }
-    inline const uint64_t& signaledTimeValue() const { return m_nonReusedRessources.signaledTimeValue; }
+    // read by the waiting threads while an other thread submit
+    inline void setSignaledTimeValue(uint64_t v) { m_nonReusedRessources.signaledTimeValue.store(v, std::memory_order_release); }
+    inline uint64_t signaledTimeValue() const { return m_nonReusedRessources.signaledTimeValue.load(std::memory_order_acquire); }
+
+    // submits enqueued for the submission thread and not submitted yet
+    inline void addPendingSubmit() { m_pendingSubmitCount.fetch_add(1, std::memory_order_relaxed); }
+    inline void removePendingSubmit() {
+        m_pendingSubmitCount.fetch_sub(1, std::memory_order_release);
+        m_pendingSubmitCount.notify_all();
+    }
+    inline bool hasPendingSubmits() const { return m_pendingSubmitCount.load(std::memory_order_acquire) != 0; }
+    inline void waitPendingSubmits() const {
+        for (uint32_t count = m_pendingSubmitCount.load(std::memory_order_acquire); count != 0; count = m_pendingSubmitCount.load(std::memory_order_acquire))
+            m_pendingSubmitCount.wait(count, std::memory_order_acquire);
+    }
+
+    inline bool isSecondary() const { return m_level == vk::CommandBufferLevel::eSecondary; }
+    inline bool isReusable() const { return m_isReusable; }
+
+    // account for barriers recorded on behalf of this command buffer outside of it (submit time barriers),
+    // a barrier batch shared by several command buffers is counted once
+    inline void countBarriers(uint32_t barrierCount, uint32_t barrierBatchCount = 1) {
+        m_nonReusedRessources.statistics.barrierCount += barrierCount;
+        m_nonReusedRessources.statistics.barrierBatchCount += barrierBatchCount;
+    }
+
+    // record the pending barriers now, the submit record the barriers of the next command buffer after them
+    void flushBarriers();
 
     ~VulkanCommandBuffer() override = default;
 
 private:
     const VulkanDevice* m_device;
     std::shared_ptr<vk::CommandPool> m_vkCommandPool;
+    QueueType m_queueType;
+    vk::CommandBufferLevel m_level = vk::CommandBufferLevel::ePrimary;
+    // a reusable command buffer can be submitted again before its previous submits are completed
+    bool m_isReusable = false;
+    bool m_isRecording = false;
+    std::atomic<uint32_t> m_pendingSubmitCount = 0;
 
     vk::CommandBuffer m_vkCommandBuffer;
 
+    // every render pass is recorded in secondary command buffers and began at endRenderPass, once the barriers
+    // required by the first uses of the secondaries are known. an inlined pass is recorded in a single implicit secondary
+    // so none of its barriers are recorded inside vkCmdBeginRendering / vkCmdEndRendering
+    struct SecondaryRenderPass
+    {
+        std::vector<vk::RenderingAttachmentInfo> colorAttachments;
+        std::optional<vk::RenderingAttachmentInfo> depthAttachment;
+        // inherited by the secondaries
+        std::vector<vk::Format> colorAttachmentFormats;
+        vk::Format depthAttachmentFormat = vk::Format::eUndefined;
+        vk::Extent2D extent;
+    };
+    bool m_isInRenderPass = false;
+    RenderPassContents m_renderPassContents = RenderPassContents::inlined;
+    SecondaryRenderPass m_secondaryRenderPass;
+    VulkanCommandBuffer* m_inlinedPassCommandBuffer = nullptr; // the render pass commands are forwarded to it, owned by m_secondaries
+
+    // secondaries own their command pool so they can be recorded by other threads, they are kept and reused with the primary
+    std::vector<std::shared_ptr<VulkanCommandBuffer>> m_secondaries;
+    size_t m_usedSecondaryCount = 0;
+    size_t m_passFirstSecondary = 0; // secondaries of the current render pass are [m_passFirstSecondary, m_usedSecondaryCount)
+    std::vector<vk::CommandBuffer> m_secondaryVkCommandBuffers;
+
     struct NonReusedRessources
     {
         std::set<std::shared_ptr<const VulkanGraphicsPipeline>> usedPipelines;
         const VulkanGraphicsPipeline* boundPipeline = nullptr;
+        std::set<std::shared_ptr<const VulkanComputePipeline>> usedComputePipelines;
+        const VulkanComputePipeline* boundComputePipeline = nullptr;
 
         std::set<std::shared_ptr<const VulkanParameterBlock>> usedPBlock;
+        // dispatches are not ordered, the blocks bound in a compute pass are synchronized again before each dispatch
+        bool isInComputePass = false;
+        std::vector<const VulkanParameterBlock*> computePBlocks;
 
-        std::map<std::shared_ptr<VulkanTexture>, ImageSyncRequest> imageSyncRequests;
-        std::map<std::shared_ptr<VulkanTexture>, ImageSyncState> imageFinalSyncStates;
-
-        std::map<std::shared_ptr<VulkanBuffer>, BufferSyncRequest> bufferSyncRequests;
-        std::map<std::shared_ptr<VulkanBuffer>, BufferSyncState> bufferFinalSyncStates;
+        ImageSyncTable imageSyncTable;
+        BufferSyncTable bufferSyncTable;
 
         std::set<std::shared_ptr<VulkanDrawable>> presentedDrawables;
 
-        uint64_t signaledTimeValue = 0;
+        std::atomic<uint64_t> signaledTimeValue = 0;
+
+        Statistics statistics;
     }
     m_nonReusedRessources;
 
+    // barriers are not recorded immediately but flushed in a single pipelineBarrier2 before the next action command
+    std::vector<vk::ImageMemoryBarrier2> m_pendingImageBarriers;
+    std::vector<vk::BufferMemoryBarrier2> m_pendingBufferBarriers;
+    std::vector<vk::ImageMemoryBarrier2> m_imageBarriersScratch;
+
 #if defined(TRACY_ENABLE)
     std::shared_ptr<tracy::VkCtxScope> m_tracyVkCtxScope = nullptr;
 #endif
 
+    inline vk::CommandBufferUsageFlags usageFlags() const {
+        return m_isReusable ? vk::CommandBufferUsageFlagBits::eSimultaneousUse : vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+    }
+
+    ImageSyncTable::Entry& imageSyncEntry(const std::shared_ptr<VulkanTexture>&);
+    // if the resource is already used in the command buffer, update its final state and add the barrier required (if any) to the pending ones
+    // otherwise record the request, it will be synchronized at submit time
+    void syncImageUse(const std::shared_ptr<VulkanTexture>&, const ImageSyncRequest&);
+    void syncBufferUse(const std::shared_ptr<VulkanBuffer>&, const BufferSyncRequest&);
+    void syncIndexBufferUse(const std::shared_ptr<VulkanBuffer>&);
+    void syncIndirectBufferUse(const std::shared_ptr<VulkanBuffer>&, size_t offset, size_t size);
+    // the copies into a readback buffer are made visible to the host, the timeline only make them available to the device
+    void syncReadbackBufferCopy(const std::shared_ptr<VulkanBuffer>&, size_t offset, size_t size);
+    // only the usages in passUsages are synchronized, a block bound in a render pass is not waiting for its compute usages
+    void syncParameterBlockUse(const VulkanParameterBlock&, BindingUsages passUsages);
+
+    std::shared_ptr<VulkanCommandBuffer> beginPassSecondary();
+    void beginSecondary(const SecondaryRenderPass&);
+    // add the resource uses of a secondary command buffer as if they were recorded in this one
+    void mergeSecondaryUses(const VulkanCommandBuffer&);
+
 public:
     VulkanCommandBuffer& operator=(const VulkanCommandBuffer&) = delete;
     VulkanCommandBuffer& operator=(VulkanCommandBuffer&&) = delete;
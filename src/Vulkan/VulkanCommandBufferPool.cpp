@@ -14,19 +14,9 @@
 namespace gfx
 {
 
-VulkanCommandBufferPool::VulkanCommandBufferPool(const VulkanDevice* device, const QueueFamily& queueFamily)
-    : m_device(device)
+VulkanCommandBufferPool::VulkanCommandBufferPool(const VulkanDevice* device, QueueType queueType)
+    : m_device(device), m_queueType(queueType), m_vkCommandPool(m_device->newVkCommandPool(m_queueType))
 {
-    auto commandPoolCreateInfo = vk::CommandPoolCreateInfo{}
-        .setQueueFamilyIndex(queueFamily.index);
-
-    m_vkCommandPool = std::shared_ptr<vk::CommandPool>(
-        new vk::CommandPool(m_device->vkDevice().createCommandPool(commandPoolCreateInfo)), // NOLINT(cppcoreguidelines-owning-memory)
-        [device=m_device](vk::CommandPool* pool){
-            device->vkDevice().destroyCommandPool(*pool);
-            delete pool; // NOLINT(cppcoreguidelines-owning-memory)
-        }
-    );
 }
 
 std::shared_ptr<CommandBuffer> VulkanCommandBufferPool::get()
@@ -37,7 +27,7 @@ std::shared_ptr<CommandBuffer> VulkanCommandBufferPool::get()
         m_availableCommandBuffers.pop_front();
     }
     else {
-        commandBuffer = std::make_shared<VulkanCommandBuffer>(m_device, m_vkCommandPool);
+        commandBuffer = std::make_shared<VulkanCommandBuffer>(m_device, m_vkCommandPool, m_queueType);
     }
     m_usedCommandBuffers.push_back(commandBuffer);
     commandBuffer->begin();
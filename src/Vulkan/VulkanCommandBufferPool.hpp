@@ -12,8 +12,8 @@
 
 #include "Graphics/CommandBufferPool.hpp"
 #include "Graphics/CommandBuffer.hpp"
+#include "Graphics/Enums.hpp"
 
-#include "Vulkan/QueueFamily.hpp"
 #include "Vulkan/VulkanCommandBuffer.hpp"
 
 namespace gfx
@@ -28,7 +28,7 @@ public:
     VulkanCommandBufferPool(const VulkanCommandBufferPool&) = delete;
     VulkanCommandBufferPool(VulkanCommandBufferPool&&) = delete;
 
-    VulkanCommandBufferPool(const VulkanDevice*, const QueueFamily&);
+    VulkanCommandBufferPool(const VulkanDevice*, QueueType);
 
     std::shared_ptr<CommandBuffer> get() override;
     void reset() override;
@@ -37,6 +37,7 @@ public:
 
 private:
     const VulkanDevice* m_device;
+    QueueType m_queueType;
 
     std::shared_ptr<vk::CommandPool> m_vkCommandPool; // buffers can outlive the pool, so the vkCommandPool need to be kept alive
 
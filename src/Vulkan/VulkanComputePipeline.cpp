@@ -0,0 +1,68 @@
+/*
+ * ---------------------------------------------------
+ * VulkanComputePipeline.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 09:36:52
+ * ---------------------------------------------------
+ */
+
+#include "Graphics/ComputePipeline.hpp"
+
+#include "Vulkan/VulkanComputePipeline.hpp"
+#include "Vulkan/VulkanDevice.hpp"
+#include "Vulkan/VulkanShaderFunction.hpp"
+#include "Vulkan/VulkanParameterBlockLayout.hpp"
+
+namespace gfx
+{
+
+VulkanComputePipeline::VulkanComputePipeline(const VulkanDevice* device, const ComputePipeline::Descriptor& desc)
+    : m_device(device)
+{
+    auto* computeFunc = dynamic_cast<VulkanShaderFunction*>(desc.computeShader);
+    assert(computeFunc);
+
+    std::vector<vk::DescriptorSetLayout> descriptorSetLayouts;
+    descriptorSetLayouts.reserve(desc.parameterBlockLayouts.size());
+    for (const auto& aPbl : desc.parameterBlockLayouts) {
+        auto pbl = std::dynamic_pointer_cast<VulkanParameterBlockLayout>(aPbl);
+        assert(pbl);
+        descriptorSetLayouts.push_back(pbl->vkDescriptorSetLayout());
+    }
+    // same layouts as the graphics pipelines, so parameter blocks can be bound to both
+    m_pipelineLayout = m_device->objectCache().pipelineLayout(descriptorSetLayouts);
+
+    PipelineCache& pipelineCache = m_device->pipelineCache();
+
+    auto creationFeedback = vk::PipelineCreationFeedback{};
+    auto creationFeedbackCreateInfo = vk::PipelineCreationFeedbackCreateInfo{}
+        .setPPipelineCreationFeedback(&creationFeedback);
+
+    auto computePipelineCreateInfo = vk::ComputePipelineCreateInfo{}
+        .setStage(vk::PipelineShaderStageCreateInfo{}
+            .setStage(vk::ShaderStageFlagBits::eCompute)
+            .setModule(computeFunc->shaderModule())
+            .setPName(computeFunc->name().c_str()))
+        .setLayout(m_pipelineLayout);
+    if (pipelineCache.hasCreationFeedback())
+        computePipelineCreateInfo.setPNext(&creationFeedbackCreateInfo);
+
+    const auto start = std::chrono::steady_clock::now();
+    auto [result, pipeline] = m_device->vkDevice().createComputePipeline(pipelineCache.vkPipelineCache(), computePipelineCreateInfo);
+    const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    if (result != vk::Result::eSuccess)
+        throw std::runtime_error("failed to create the ComputePipeline");
+    m_vkPipeline = pipeline;
+
+    const bool cacheHit = (creationFeedback.flags & vk::PipelineCreationFeedbackFlagBits::eValid)
+        && (creationFeedback.flags & vk::PipelineCreationFeedbackFlagBits::eApplicationPipelineCacheHit);
+    pipelineCache.recordCreation(cacheHit, duration);
+}
+
+VulkanComputePipeline::~VulkanComputePipeline()
+{
+    m_device->retire(m_vkPipeline);
+}
+
+} // namespace gfx
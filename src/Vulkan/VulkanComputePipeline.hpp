@@ -0,0 +1,46 @@
+/*
+ * ---------------------------------------------------
+ * VulkanComputePipeline.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 09:31:18
+ * ---------------------------------------------------
+ */
+
+#ifndef VULKANCOMPUTEPIPELINE_HPP
+#define VULKANCOMPUTEPIPELINE_HPP
+
+#include "Graphics/ComputePipeline.hpp"
+
+namespace gfx
+{
+
+class VulkanDevice;
+
+class VulkanComputePipeline : public ComputePipeline
+{
+public:
+    VulkanComputePipeline() = delete;
+    VulkanComputePipeline(const VulkanComputePipeline&) = delete;
+    VulkanComputePipeline(VulkanComputePipeline&&) = delete;
+
+    VulkanComputePipeline(const VulkanDevice*, const ComputePipeline::Descriptor&);
+
+    inline const vk::Pipeline& vkPipeline() const { return m_vkPipeline; }
+    inline const vk::PipelineLayout& pipelineLayout() const { return m_pipelineLayout; }
+
+    ~VulkanComputePipeline() override;
+
+private:
+    const VulkanDevice* const m_device;
+    vk::PipelineLayout m_pipelineLayout;
+    vk::Pipeline m_vkPipeline;
+
+public:
+    VulkanComputePipeline& operator=(const VulkanComputePipeline&) = delete;
+    VulkanComputePipeline& operator=(VulkanComputePipeline&&) = delete;
+};
+
+} // namespace gfx
+
+#endif // VULKANCOMPUTEPIPELINE_HPP
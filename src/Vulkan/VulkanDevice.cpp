@@ -25,8 +25,10 @@
 #include "Vulkan/VulkanDrawable.hpp"
 #include "Vulkan/VulkanShaderLib.hpp"
 #include "Vulkan/VulkanGraphicsPipeline.hpp"
+#include "Vulkan/VulkanComputePipeline.hpp"
 #include "Vulkan/VulkanInstance.hpp"
 #include "Vulkan/VulkanTexture.hpp"
+#include "Vulkan/VulkanUploadRing.hpp"
 #include "VulkanParameterBlockLayout.hpp"
 #if defined(GFX_IMGUI_ENABLED)
 # include "Vulkan/imgui_impl_vulkan.h"
@@ -64,12 +66,65 @@ VulkanDevice::VulkanDevice(const VulkanInstance* instance, const VulkanPhysicalD
         .setDescriptorBindingUpdateUnusedWhilePending(vk::True)
         .setDescriptorBindingPartiallyBound(vk::True);
 
-    m_queueFamily = (m_physicalDevice->getQueueFamilies() | std::views::filter([&desc](auto f){ return f.hasCapabilities(desc.deviceDescriptor->queueCaps); })).front();
-    float queuePriority = 1.0f;
-    auto queueCreateInfo = vk::DeviceQueueCreateInfo{}
-        .setQueueFamilyIndex(m_queueFamily.index)
-        .setQueueCount(1)
-        .setPQueuePriorities(&queuePriority);
+    const std::vector<QueueFamily> queueFamilies = m_physicalDevice->getQueueFamilies();
+    const QueueFamily graphicsFamily = (queueFamilies | std::views::filter([&desc](auto f){ return f.hasCapabilities(desc.deviceDescriptor->queueCaps); })).front();
+
+    // each queue is a (family, index in the family) pair, a QueueType without its own queue use the graphics one
+    struct QueueRequest
+    {
+        QueueType type;
+        QueueFamily family;
+        uint32_t indexInFamily;
+    };
+    std::vector<QueueRequest> queueRequests = { QueueRequest{ .type = QueueType::graphics, .family = graphicsFamily, .indexInFamily = 0 } };
+    auto requestQueue = [&queueRequests](QueueType type, const QueueFamily& family) {
+        const auto usedCount = static_cast<uint32_t>(std::ranges::count_if(queueRequests, [&](const QueueRequest& r) { return r.family.index == family.index; }));
+        if (usedCount >= family.queueCount)
+            return false;
+        queueRequests.push_back(QueueRequest{ .type = type, .family = family, .indexInFamily = usedCount });
+        return true;
+    };
+
+    // the async compute queue prefer a family without graphics (dedicated compute hardware), then a second queue of the graphics family
+    if (desc.deviceDescriptor->asyncCompute)
+    {
+        bool hasComputeQueue = false;
+        for (const QueueFamily& family : queueFamilies | std::views::filter([&](const QueueFamily& f) { return f.index != graphicsFamily.index && (f.queueFlags & vk::QueueFlagBits::eCompute); })) {
+            hasComputeQueue = requestQueue(QueueType::compute, family);
+            if (hasComputeQueue)
+                break;
+        }
+        if (hasComputeQueue == false)
+            requestQueue(QueueType::compute, graphicsFamily);
+    }
+
+    // the transfer queue only use a family without graphics and compute (copy engine),
+    // a second queue of the graphics family would execute the copies on the same hardware as the rendering
+    if (desc.deviceDescriptor->asyncTransfer)
+    {
+        auto isCopyEngineFamily = [](const QueueFamily& f) {
+            return (f.queueFlags & vk::QueueFlagBits::eTransfer) && !(f.queueFlags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute));
+        };
+        for (const QueueFamily& family : queueFamilies | std::views::filter(isCopyEngineFamily)) {
+            if (requestQueue(QueueType::transfer, family))
+                break;
+        }
+    }
+
+    const std::array<float, queueTypeCount> queuePriorities = { 1.0f, 1.0f, 1.0f };
+    std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
+    for (const QueueRequest& request : queueRequests)
+    {
+        auto it = std::ranges::find(queueCreateInfos, request.family.index, &vk::DeviceQueueCreateInfo::queueFamilyIndex);
+        if (it == queueCreateInfos.end()) {
+            queueCreateInfos.push_back(vk::DeviceQueueCreateInfo{}
+                .setQueueFamilyIndex(request.family.index)
+                .setQueueCount(1)
+                .setPQueuePriorities(queuePriorities.data()));
+        }
+        else
+            it->queueCount++;
+    }
 
     std::vector<const char*> enabledExtensions = desc.deviceExtensions | std::views::filter([&](const char* ext) {
         if (strcmp(ext, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME) == 0 && m_physicalDevice->getProperties().apiVersion >= vk::ApiVersion13)
@@ -79,11 +134,57 @@ VulkanDevice::VulkanDevice(const VulkanInstance* instance, const VulkanPhysicalD
         return true;
     }) | std::ranges::to<std::vector>();
 
-    vk::PhysicalDeviceFeatures deviceFeatures{};
+    // creation feedback tell if a pipeline was found in the pipeline cache, it is core since 1.3
+    bool hasPipelineCreationFeedback = m_physicalDevice->getProperties().apiVersion >= vk::ApiVersion13;
+    if (hasPipelineCreationFeedback == false && m_physicalDevice->suportExtensions({ VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME })) {
+        enabledExtensions.push_back(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+        hasPipelineCreationFeedback = true;
+    }
 
-    auto deviceCreateInfo = vk::DeviceCreateInfo{}
+    // instance step rates other than 1 need the divisor extension, pipelines using them fail to be created without it
+    auto vertexAttributeDivisorFeatures = vk::PhysicalDeviceVertexAttributeDivisorFeaturesEXT{}
         .setPNext(&descriptorIndexingFeatures)
-        .setQueueCreateInfos(queueCreateInfo)
+        .setVertexAttributeInstanceRateDivisor(vk::True);
+    if (m_physicalDevice->suportExtensions({ VK_EXT_VERTEX_ATTRIBUTE_DIVISOR_EXTENSION_NAME })) {
+        auto features = m_physicalDevice->getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVertexAttributeDivisorFeaturesEXT>();
+        m_hasVertexAttributeDivisor = features.get<vk::PhysicalDeviceVertexAttributeDivisorFeaturesEXT>().vertexAttributeInstanceRateDivisor == vk::True;
+    }
+    if (m_hasVertexAttributeDivisor)
+        enabledExtensions.push_back(VK_EXT_VERTEX_ATTRIBUTE_DIVISOR_EXTENSION_NAME);
+
+    // the count variants of the indirect draws are core since 1.2 but behind a feature bit, the extension enable them
+    m_hasDrawIndirectCount = m_physicalDevice->suportExtensions({ VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME });
+    if (m_hasDrawIndirectCount)
+        enabledExtensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+
+    // with the present ids the swapchains wait their presents to be displayed, only the end of the rendering is waited otherwise
+    auto presentIdFeatures = vk::PhysicalDevicePresentIdFeaturesKHR{}
+        .setPNext(m_hasVertexAttributeDivisor ? static_cast<void*>(&vertexAttributeDivisorFeatures) : static_cast<void*>(&descriptorIndexingFeatures))
+        .setPresentId(vk::True);
+    auto presentWaitFeatures = vk::PhysicalDevicePresentWaitFeaturesKHR{}
+        .setPNext(&presentIdFeatures)
+        .setPresentWait(vk::True);
+    if (desc.deviceDescriptor->queueCaps.present.empty() == false && m_physicalDevice->suportExtensions({ VK_KHR_PRESENT_ID_EXTENSION_NAME, VK_KHR_PRESENT_WAIT_EXTENSION_NAME })) {
+        auto features = m_physicalDevice->getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDevicePresentIdFeaturesKHR, vk::PhysicalDevicePresentWaitFeaturesKHR>();
+        m_hasPresentWait = features.get<vk::PhysicalDevicePresentIdFeaturesKHR>().presentId == vk::True
+            && features.get<vk::PhysicalDevicePresentWaitFeaturesKHR>().presentWait == vk::True;
+    }
+    if (m_hasPresentWait) {
+        enabledExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    }
+
+    // without multiDrawIndirect the indirect draws are recorded one command at a time
+    const vk::PhysicalDeviceFeatures supportedFeatures = m_physicalDevice->getFeatures();
+    m_hasMultiDrawIndirect = supportedFeatures.multiDrawIndirect == vk::True;
+
+    auto deviceFeatures = vk::PhysicalDeviceFeatures{}
+        .setMultiDrawIndirect(supportedFeatures.multiDrawIndirect)
+        .setDrawIndirectFirstInstance(supportedFeatures.drawIndirectFirstInstance);
+
+    auto deviceCreateInfo = vk::DeviceCreateInfo{}
+        .setPNext(m_hasPresentWait ? static_cast<void*>(&presentWaitFeatures) : presentIdFeatures.pNext)
+        .setQueueCreateInfos(queueCreateInfos)
         .setEnabledExtensionCount(static_cast<uint32_t>(enabledExtensions.size()))
         .setPpEnabledExtensionNames(enabledExtensions.data())
         .setPEnabledFeatures(&deviceFeatures);
@@ -91,7 +192,16 @@ VulkanDevice::VulkanDevice(const VulkanInstance* instance, const VulkanPhysicalD
     m_vkDevice = m_physicalDevice->createDevice(deviceCreateInfo);
     VULKAN_HPP_DEFAULT_DISPATCHER.init(m_vkDevice);
 
-    m_queue = m_vkDevice.getQueue(m_queueFamily.index, 0);
+    for (const QueueRequest& request : queueRequests)
+    {
+        auto& queue = m_queues.emplace_back(std::make_unique<Queue>());
+        queue->type = request.type;
+        queue->family = request.family;
+        queue->vkQueue = m_vkDevice.getQueue(request.family.index, request.indexInFamily);
+    }
+    m_queueByType.fill(m_queues.front().get());
+    for (auto& queue : m_queues)
+        m_queueByType[static_cast<size_t>(queue->type)] = queue.get();
 
     VmaVulkanFunctions vulkanFunctions = {};
     vulkanFunctions.vkGetInstanceProcAddr = VULKAN_HPP_DEFAULT_DISPATCHER.vkGetInstanceProcAddr;
@@ -110,14 +220,20 @@ VulkanDevice::VulkanDevice(const VulkanInstance* instance, const VulkanPhysicalD
     if (res != VK_SUCCESS)
         throw std::runtime_error("vmaCreateAllocator failed");
 
-    m_timelineSemaphore = m_vkDevice.createSemaphore(vk::SemaphoreCreateInfo{}
-        .setPNext(vk::SemaphoreTypeCreateInfo{}
-            .setSemaphoreType(vk::SemaphoreType::eTimeline)
-            .setInitialValue(0)));
+    for (auto& queue : m_queues)
+    {
+        queue->timelineSemaphore = m_vkDevice.createSemaphore(vk::SemaphoreCreateInfo{}
+            .setPNext(vk::SemaphoreTypeCreateInfo{}
+                .setSemaphoreType(vk::SemaphoreType::eTimeline)
+                .setInitialValue(0)));
+
+        queue->barrierCommandPool = m_vkDevice.createCommandPool(vk::CommandPoolCreateInfo{}
+            .setQueueFamilyIndex(queue->family.index)
+            .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer));
+    }
 
-    m_barrierCommandPool = m_vkDevice.createCommandPool(vk::CommandPoolCreateInfo{}
-        .setQueueFamilyIndex(m_queueFamily.index)
-        .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer));
+    m_pipelineCache = std::make_unique<PipelineCache>(this, desc.deviceDescriptor->pipelineCachePath, hasPipelineCreationFeedback);
+    m_objectCache = std::make_unique<ObjectCache>(this);
 
     s_tracyVkContext = TracyVkContextHostCalibrated(
         m_instance->vkInstance(),
@@ -125,6 +241,16 @@ VulkanDevice::VulkanDevice(const VulkanInstance* instance, const VulkanPhysicalD
         m_vkDevice,
         (PFN_vkGetInstanceProcAddr)VULKAN_HPP_DEFAULT_DISPATCHER.vkGetInstanceProcAddr,
         (PFN_vkGetDeviceProcAddr)VULKAN_HPP_DEFAULT_DISPATCHER.vkGetDeviceProcAddr);
+
+    m_completionWakeSemaphore = m_vkDevice.createSemaphore(vk::SemaphoreCreateInfo{}
+        .setPNext(vk::SemaphoreTypeCreateInfo{}
+            .setSemaphoreType(vk::SemaphoreType::eTimeline)
+            .setInitialValue(0)));
+
+    m_deferredSubmits = desc.deviceDescriptor->deferredSubmits;
+    m_backgroundDestruction = desc.deviceDescriptor->backgroundDestruction;
+    if (desc.deviceDescriptor->submissionThread)
+        m_submissionThread = std::jthread([this](const std::stop_token& stopToken) { submissionThreadLoop(stopToken); });
 }
 
 std::unique_ptr<Swapchain> VulkanDevice::newSwapchain(const Swapchain::Descriptor& desc) const
@@ -147,6 +273,60 @@ std::unique_ptr<GraphicsPipeline> VulkanDevice::newGraphicsPipeline(const Graphi
     return std::make_unique<VulkanGraphicsPipeline>(this, desc);
 }
 
+GraphicsPipelineFuture VulkanDevice::newGraphicsPipelineAsync(const GraphicsPipeline::Descriptor& desc) const
+{
+    return newGraphicsPipelines(std::span(&desc, 1)).front();
+}
+
+std::vector<GraphicsPipelineFuture> VulkanDevice::newGraphicsPipelines(std::span<const GraphicsPipeline::Descriptor> descs) const
+{
+    using Promises = std::vector<std::promise<std::shared_ptr<GraphicsPipeline>>>;
+
+    WorkerPool& pool = workerPool();
+
+    std::vector<GraphicsPipelineFuture> futures;
+    futures.reserve(descs.size());
+
+    // each group is a single createGraphicsPipelines call and a single job, the driver can already compile a call in parallel.
+    // a batch is only split in a few groups so small batches do not become one pipeline jobs
+    constexpr size_t minGroupSize = 8;
+    constexpr size_t maxGroupCount = 4;
+    const size_t groupCount = std::min({ (descs.size() + minGroupSize - 1) / minGroupSize, maxGroupCount, static_cast<size_t>(pool.threadCount()) });
+    for (size_t group = 0; group < groupCount; group++)
+    {
+        const size_t begin = descs.size() * group / groupCount;
+        const size_t end = descs.size() * (group + 1) / groupCount;
+
+        auto promises = std::make_shared<Promises>(end - begin);
+        for (auto& promise : *promises)
+            futures.push_back(promise.get_future().share());
+
+        pool.post([this, groupDescs = std::vector(descs.begin() + begin, descs.begin() + end), promises]() {
+            try {
+                auto pipelines = VulkanGraphicsPipeline::newGraphicsPipelines(this, groupDescs);
+                for (size_t i = 0; i < pipelines.size(); i++)
+                    (*promises)[i].set_value(std::move(pipelines[i]));
+            }
+            catch (...) {
+                // a failed pipeline fail its whole group as they are created by the same call
+                for (auto& promise : *promises)
+                    promise.set_exception(std::current_exception());
+            }
+        });
+    }
+    return futures;
+}
+
+std::shared_ptr<GraphicsPipeline> VulkanDevice::sharedGraphicsPipeline(const GraphicsPipeline::Descriptor& desc) const
+{
+    return m_objectCache->graphicsPipeline(desc);
+}
+
+std::unique_ptr<ComputePipeline> VulkanDevice::newComputePipeline(const ComputePipeline::Descriptor& desc) const
+{
+    return std::make_unique<VulkanComputePipeline>(this, desc);
+}
+
 std::unique_ptr<Buffer> VulkanDevice::newBuffer(const Buffer::Descriptor& desc) const
 {
     return std::make_unique<VulkanBuffer>(this, desc);
@@ -157,9 +337,17 @@ std::unique_ptr<Texture> VulkanDevice::newTexture(const Texture::Descriptor& des
     return std::make_unique<VulkanTexture>(this, desc);
 }
 
-std::unique_ptr<CommandBufferPool> VulkanDevice::newCommandBufferPool() const
+std::unique_ptr<CommandBufferPool> VulkanDevice::newCommandBufferPool(QueueType queueType) const
 {
-    return std::make_unique<VulkanCommandBufferPool>(this, m_queueFamily);
+    return std::make_unique<VulkanCommandBufferPool>(this, queueType);
+}
+
+std::shared_ptr<CommandBuffer> VulkanDevice::newReusableCommandBuffer(QueueType queueType) const
+{
+    // the command buffer is never reset, it own its pool
+    auto commandBuffer = std::make_shared<VulkanCommandBuffer>(this, newVkCommandPool(queueType), queueType, vk::CommandBufferLevel::ePrimary, true);
+    commandBuffer->begin();
+    return commandBuffer;
 }
 
 std::unique_ptr<ParameterBlockPool> VulkanDevice::newParameterBlockPool(const ParameterBlockPool::Descriptor& descriptor) const
@@ -172,6 +360,76 @@ std::unique_ptr<Sampler> VulkanDevice::newSampler(const Sampler::Descriptor& des
     return std::make_unique<VulkanSampler>(this, desc);
 }
 
+std::unique_ptr<UploadRing> VulkanDevice::newUploadRing(const UploadRing::Descriptor& desc) const
+{
+    return std::make_unique<VulkanUploadRing>(this, desc);
+}
+
+Device::PipelineCacheStatistics VulkanDevice::pipelineCacheStatistics() const
+{
+    return m_pipelineCache->statistics();
+}
+
+void VulkanDevice::savePipelineCache() const
+{
+    m_pipelineCache->save();
+}
+
+Device::SubmitStatistics VulkanDevice::submitStatistics() const
+{
+    return SubmitStatistics{
+        .submitCount = m_submitCount.load(std::memory_order_relaxed),
+        .totalLatency = std::chrono::nanoseconds(m_totalSubmitLatency.load(std::memory_order_relaxed)),
+        .maxLatency = std::chrono::nanoseconds(m_maxSubmitLatency.load(std::memory_order_relaxed))
+    };
+}
+
+Device::DestructionStatistics VulkanDevice::destructionStatistics() const
+{
+    return DestructionStatistics{
+        .pendingCount = m_retirementQueue.pendingCount(),
+        .freedCount = m_retirementQueue.freedCount()
+    };
+}
+
+void VulkanDevice::retire(RetirementQueue::Object object) const
+{
+    // the resources are kept alive by the command buffers until they are completed,
+    // the last value given is enough for the ones used without being tracked (like the resource slots)
+    m_retirementQueue.retire(m_nextSignaledTimeValue.load(std::memory_order_acquire) - 1, std::move(object));
+}
+
+vk::SwapchainKHR VulkanDevice::newVkSwapchain(vk::SwapchainCreateInfoKHR swapchainCreateInfo) const
+{
+    std::scoped_lock lock(m_surfaceSwapchainsMtx);
+    auto it = m_surfaceSwapchains.find(swapchainCreateInfo.surface);
+    if (it != m_surfaceSwapchains.end())
+        swapchainCreateInfo.setOldSwapchain(it->second.vkSwapchain);
+
+    vk::SwapchainKHR vkSwapchain = m_vkDevice.createSwapchainKHR(swapchainCreateInfo);
+
+    if (it == m_surfaceSwapchains.end()) {
+        m_surfaceSwapchains.emplace(swapchainCreateInfo.surface, SurfaceSwapchain{ .vkSwapchain = vkSwapchain });
+        return vkSwapchain;
+    }
+    // the images acquired from the old swapchain can still be presented, it is destroyed once they are released
+    if (it->second.isReleased)
+        retire(it->second.vkSwapchain);
+    it->second = SurfaceSwapchain{ .vkSwapchain = vkSwapchain };
+    return vkSwapchain;
+}
+
+void VulkanDevice::releaseVkSwapchain(const vk::SurfaceKHR& vkSurface, const vk::SwapchainKHR& vkSwapchain) const
+{
+    // the images are retired before, the swapchain is destroyed after them and after the submits presenting them
+    std::scoped_lock lock(m_surfaceSwapchainsMtx);
+    auto it = m_surfaceSwapchains.find(vkSurface);
+    if (it != m_surfaceSwapchains.end() && it->second.vkSwapchain == vkSwapchain)
+        it->second.isReleased = true;
+    else
+        retire(vkSwapchain);
+}
+
 #if defined (GFX_IMGUI_ENABLED)
 void VulkanDevice::imguiInit(std::vector<PixelFormat> colorAttachmentPxFormats, std::optional<PixelFormat> depthAttachmentPxFormat) const
 {
@@ -201,8 +459,8 @@ void VulkanDevice::imguiInit(std::vector<PixelFormat> colorAttachmentPxFormats,
         .Instance = m_instance->vkInstance(),
         .PhysicalDevice = *m_physicalDevice,
         .Device = m_vkDevice,
-        .QueueFamily = m_queueFamily.index,
-        .Queue = m_queue,
+        .QueueFamily = queue(QueueType::graphics).family.index,
+        .Queue = queue(QueueType::graphics).vkQueue,
         .DescriptorPool = VK_NULL_HANDLE,
         .RenderPass = VK_NULL_HANDLE,
         .MinImageCount = 3,
@@ -235,231 +493,909 @@ void VulkanDevice::imguiShutdown()
 
 void VulkanDevice::submitCommandBuffers(const std::shared_ptr<CommandBuffer>& aCommandBuffer)
 {
-    submitCommandBuffers(std::vector<std::shared_ptr<CommandBuffer>>{aCommandBuffer});
+    submitOrEnqueue(std::span(&aCommandBuffer, 1));
 }
 
 void VulkanDevice::submitCommandBuffers(const std::vector<std::shared_ptr<CommandBuffer>>& aCommandBuffers)
 {
+    submitOrEnqueue(aCommandBuffers);
+}
+
+void VulkanDevice::flushSubmits()
+{
+    rethrowSubmitError();
+    if (m_submissionThread.joinable()) {
+        // flushed after the submits enqueued before
+        m_submitQueue.push(SubmitRequest{ .commandBuffers = {}, .enqueueTime = {}, .flush = true });
+        m_enqueuedSubmitCount.fetch_add(1, std::memory_order_release);
+        m_enqueuedSubmitCount.notify_one();
+        return;
+    }
     std::scoped_lock lock(m_submitMtx);
+    flushPendingBatches();
+}
+
+void VulkanDevice::waitCommandBuffer(const CommandBuffer& aCommandBuffer)
+{
+    ZoneScoped;
+    assert(dynamic_cast<const VulkanCommandBuffer*>(&aCommandBuffer) != nullptr);
+    const auto& commandBuffer = static_cast<const VulkanCommandBuffer&>(aCommandBuffer);
+
+    // the command buffer can still be in the queue of the submission thread
+    commandBuffer.waitPendingSubmits();
+    rethrowSubmitError();
+
+    // the submit lock is not taken, the other threads can submit while this one is waiting.
+    // the command buffer is released by the next submit
+    const uint64_t value = commandBuffer.signaledTimeValue();
+    if (value == 0)
+        return; // not submitted, or completed and reused since
+    if (waitTimelineValue(queue(commandBuffer.queueType()), value, std::chrono::nanoseconds::max()) == false)
+        throw std::runtime_error("failed to wait timeline semaphore");
+}
 
-    std::vector<vk::CommandBuffer> vkCommandBuffers;
+bool VulkanDevice::waitCommandBuffer(const CommandBuffer& aCommandBuffer, std::chrono::nanoseconds timeout)
+{
+    ZoneScoped;
+    assert(dynamic_cast<const VulkanCommandBuffer*>(&aCommandBuffer) != nullptr);
+    const auto& commandBuffer = static_cast<const VulkanCommandBuffer&>(aCommandBuffer);
+
+    // the pending submits counter cannot be waited with a timeout, the submission thread notify each processed request
+    const auto start = std::chrono::steady_clock::now();
+    if (commandBuffer.hasPendingSubmits()) {
+        std::unique_lock lock(m_processedSubmitMtx);
+        if (m_processedSubmitCv.wait_for(lock, timeout, [&]() { return commandBuffer.hasPendingSubmits() == false; }) == false)
+            return false;
+    }
+    rethrowSubmitError();
 
-    std::vector<vk::Semaphore> waitSemaphores;
-    std::vector<uint64_t> waitSemaphoreValues;
-    std::vector<vk::PipelineStageFlags> waitDstStageMasks;
+    const uint64_t value = commandBuffer.signaledTimeValue();
+    if (value == 0)
+        return true;
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    return waitTimelineValue(queue(commandBuffer.queueType()), value, timeout - elapsed);
+}
 
-    std::vector<vk::Semaphore> signalSemaphores;
-    std::vector<uint64_t> signalSemaphoreValues;
+void VulkanDevice::waitIdle()
+{
+    if (m_submissionThread.joinable())
+    {
+        // wait for the queue to be empty, so everything enqueued before the call is submitted
+        uint64_t processedCount = m_processedSubmitCount.load(std::memory_order_acquire);
+        while (processedCount != m_enqueuedSubmitCount.load(std::memory_order_acquire)) {
+            m_processedSubmitCount.wait(processedCount, std::memory_order_acquire);
+            processedCount = m_processedSubmitCount.load(std::memory_order_acquire);
+        }
+    }
+
+    std::scoped_lock lock(m_submitMtx);
+
+    flushPendingBatches();
+    m_vkDevice.waitIdle();
+    for (auto& submitted : m_submittedCommandBuffers) {
+        if (submitted.isBarrierCmdBuffer) {
+            submitted.commandBuffer->reuse();
+            queue(submitted.commandBuffer->queueType()).availableBarrierCmdBuffers.push_back(std::move(submitted.commandBuffer));
+        }
+    }
+    m_submittedCommandBuffers.clear();
+    collectRetiredObjects();
+
+    rethrowSubmitError();
+}
+
+bool VulkanDevice::isCompleted(const SubmitTicket& ticket) const
+{
+    if (ticket.value == 0)
+        return true;
+    return m_vkDevice.getSemaphoreCounterValue(queue(ticket.queueType).timelineSemaphore) >= ticket.value;
+}
+
+bool VulkanDevice::waitSubmit(const SubmitTicket& ticket, std::chrono::nanoseconds timeout)
+{
+    ZoneScoped;
+    rethrowSubmitError();
+    if (ticket.value == 0)
+        return true;
+    return waitTimelineValue(queue(ticket.queueType), ticket.value, timeout);
+}
 
-    std::vector<vk::Semaphore> presentWaitSemaphores;
-    std::vector<vk::SwapchainKHR> presentedSwapchains;
-    std::vector<uint32_t> presentedImageIndices;
+void VulkanDevice::addCompletedHandler(const SubmitTicket& ticket, std::function<void()> handler)
+{
+    std::scoped_lock lock(m_completedHandlersMtx);
+    m_completedHandlers.push_back(CompletedHandler{ .ticket = ticket, .handler = std::move(handler) });
+    wakeCompletionThread();
+}
 
-    for (std::shared_ptr<VulkanCommandBuffer> commandBuffer : aCommandBuffers | std::views::transform([](auto& c) { return std::dynamic_pointer_cast<VulkanCommandBuffer>(c); }))
+uint64_t VulkanDevice::completedTimelineValue() const
+{
+    // values are unique across queues but not completed in order, the result is the lowest value of the queues still working.
+    // the last signaled value is read first, a submit done in between has a higher value than everything read
+    std::optional<uint64_t> completedValue;
+    uint64_t lastSignaledTimeValue = 0;
+    for (const auto& queue : m_queues)
     {
-        assert(commandBuffer);
+        // flushPendingBatches store the values in the other order
+        const uint64_t queueFirstPendingTimeValue = queue->firstPendingTimeValue.load(std::memory_order_acquire);
+        const uint64_t queueLastSignaledTimeValue = queue->lastSignaledTimeValue.load(std::memory_order_acquire);
+        const uint64_t queueCompletedValue = m_vkDevice.getSemaphoreCounterValue(queue->timelineSemaphore);
+        if (queueCompletedValue < queueLastSignaledTimeValue)
+            completedValue = std::min(completedValue.value_or(queueCompletedValue), queueCompletedValue);
+        // the deferred batches are not given to the driver yet
+        if (queueFirstPendingTimeValue != 0)
+            completedValue = std::min(completedValue.value_or(queueFirstPendingTimeValue - 1), queueFirstPendingTimeValue - 1);
+        lastSignaledTimeValue = std::max(lastSignaledTimeValue, queueLastSignaledTimeValue);
+    }
+    return completedValue.value_or(lastSignaledTimeValue); // every queue is idle
+}
 
-        std::vector<vk::ImageMemoryBarrier2> imageMemoryBarriers;
-        std::vector<vk::BufferMemoryBarrier2> bufferMemoryBarriers;
+VulkanDevice::~VulkanDevice()
+{
+    m_workerPool.reset(); // finish the background compilations
+    if (m_submissionThread.joinable()) {
+        m_submissionThread.request_stop();
+        // an empty request wake the thread up, it stop once the queue is empty
+        m_submitQueue.push(SubmitRequest{});
+        m_enqueuedSubmitCount.fetch_add(1, std::memory_order_release);
+        m_enqueuedSubmitCount.notify_one();
+        m_submissionThread.join();
+    }
+    try {
+        waitIdle();
+    }
+    catch (...) {
+        // the error is thrown after the device is idle, it cannot be reported by a destructor
+    }
+    if (m_completionThread.joinable()) {
+        // every submit is completed, the remaining handlers are called before the thread stop, even the ones
+        // of tickets never submitted. their errors are not thrown anymore
+        m_completionThread.request_stop();
+        {
+            std::scoped_lock lock(m_completedHandlersMtx);
+            wakeCompletionThread();
+        }
+        m_completionThread.join();
+    }
+    try {
+        m_pipelineCache->save();
+    }
+    catch (...) {
+        // a destructor cannot report it, savePipelineCache() throw the same error
+    }
+    m_pipelineCache.reset();
+    m_objectCache.reset();
+    TracyVkDestroy(s_tracyVkContext);
+    for (auto& queue : m_queues) {
+        queue->availableBarrierCmdBuffers.clear();
+        m_vkDevice.destroyCommandPool(queue->barrierCommandPool);
+        m_vkDevice.destroySemaphore(queue->timelineSemaphore);
+    }
+    m_vkDevice.destroySemaphore(m_completionWakeSemaphore);
+    m_retirementQueue.collect(std::numeric_limits<uint64_t>::max()); // the device is idle
+    for (const auto& [vkSurface, surfaceSwapchain] : m_surfaceSwapchains) {
+        assert(surfaceSwapchain.isReleased); // the swapchains are destroyed before the device
+        m_vkDevice.destroySwapchainKHR(surfaceSwapchain.vkSwapchain);
+    }
+    vmaDestroyAllocator(m_allocator);
+    m_vkDevice.destroy();
+}
 
-        for (auto& [image, syncReq] : commandBuffer->imageSyncRequests())
+WorkerPool& VulkanDevice::workerPool() const
+{
+    std::scoped_lock lock(m_workerPoolMtx);
+    if (m_workerPool == nullptr)
+        m_workerPool = std::make_unique<WorkerPool>(std::max(std::thread::hardware_concurrency(), 2u) - 1); // keep a core for the caller
+    return *m_workerPool;
+}
+
+std::shared_ptr<vk::CommandPool> VulkanDevice::newVkCommandPool(QueueType queueType, vk::CommandPoolCreateFlags flags) const
+{
+    auto commandPoolCreateInfo = vk::CommandPoolCreateInfo{}
+        .setFlags(flags)
+        .setQueueFamilyIndex(queueFamily(queueType).index);
+
+    return std::shared_ptr<vk::CommandPool>(
+        new vk::CommandPool(m_vkDevice.createCommandPool(commandPoolCreateInfo)), // NOLINT(cppcoreguidelines-owning-memory)
+        [device=this](vk::CommandPool* pool){
+            device->vkDevice().destroyCommandPool(*pool);
+            delete pool; // NOLINT(cppcoreguidelines-owning-memory)
+        }
+    );
+}
+
+size_t VulkanDevice::queueIndex(const Queue& aQueue) const
+{
+    for (size_t i = 0; i < m_queues.size(); i++) {
+        if (m_queues[i].get() == &aQueue)
+            return i;
+    }
+    std::unreachable();
+}
+
+std::shared_ptr<VulkanCommandBuffer> VulkanDevice::getBarrierCommandBuffer(Queue& barrierQueue)
+{
+    std::shared_ptr<VulkanCommandBuffer> commandBuffer;
+    if (barrierQueue.availableBarrierCmdBuffers.empty() == false) {
+        commandBuffer = std::move(barrierQueue.availableBarrierCmdBuffers.back());
+        barrierQueue.availableBarrierCmdBuffers.pop_back();
+    }
+    else {
+        // command buffer is implicitly reset when begin is called.
+        // https://docs.vulkan.org/refpages/latest/refpages/source/VkCommandPoolCreateFlagBits.html#_description
+        commandBuffer = std::make_shared<VulkanCommandBuffer>(this, barrierQueue.barrierCommandPool, barrierQueue.type);
+    }
+    commandBuffer->begin();
+    return commandBuffer;
+}
+
+void VulkanDevice::submitOrEnqueue(std::span<const std::shared_ptr<CommandBuffer>> aCommandBuffers)
+{
+    rethrowSubmitError();
+    const auto callTime = std::chrono::steady_clock::now();
+
+    if (m_submissionThread.joinable() == false) {
+        submit(aCommandBuffers, callTime);
+        return;
+    }
+
+    for (const std::shared_ptr<CommandBuffer>& aCommandBuffer : aCommandBuffers) {
+        assert(dynamic_cast<VulkanCommandBuffer*>(aCommandBuffer.get()) != nullptr);
+        static_cast<VulkanCommandBuffer*>(aCommandBuffer.get())->addPendingSubmit();
+    }
+    m_submitQueue.push(SubmitRequest{
+        .commandBuffers = std::vector(aCommandBuffers.begin(), aCommandBuffers.end()),
+        .enqueueTime = callTime
+    });
+    m_enqueuedSubmitCount.fetch_add(1, std::memory_order_release);
+    m_enqueuedSubmitCount.notify_one();
+}
+
+void VulkanDevice::submissionThreadLoop(const std::stop_token& stopToken)
+{
+    while (true)
+    {
+        const uint64_t enqueuedCount = m_enqueuedSubmitCount.load(std::memory_order_acquire);
+
+        // a request pushed before the load is linked, the ones still being pushed notify once they are
+        while (std::optional<SubmitRequest> request = m_submitQueue.pop())
         {
-            // if the buffer use a swapchain image, add its imageAvailableSemaphore to the list of wait semaphores
-            if (auto swapchainImg = dynamic_pointer_cast<SwapchainImage>(image)) {
-                // no ideal to do a linear seach but we need to keep the order for the association with the value
-                if (std::ranges::find(waitSemaphores, swapchainImg->imageAvailableSemaphore()) == waitSemaphores.end()) {
-                    waitSemaphores.push_back(swapchainImg->imageAvailableSemaphore());
-                    waitSemaphoreValues.push_back(0); // not a timeline semaphore, value doesnt matter
-                    waitDstStageMasks.emplace_back(vk::PipelineStageFlagBits::eAllCommands);
+            try {
+                if (request->flush) {
+                    std::scoped_lock lock(m_submitMtx);
+                    flushPendingBatches();
                 }
+                else
+                    submit(request->commandBuffers, request->enqueueTime);
+            }
+            catch (...) {
+                storeSubmitError(std::current_exception());
+            }
+            for (const std::shared_ptr<CommandBuffer>& aCommandBuffer : request->commandBuffers)
+                static_cast<VulkanCommandBuffer*>(aCommandBuffer.get())->removePendingSubmit();
+            m_processedSubmitCount.fetch_add(1, std::memory_order_release);
+            m_processedSubmitCount.notify_all();
+            {
+                // a timed waiter check its command buffer with the lock held, the notification cannot be missed
+                std::scoped_lock lock(m_processedSubmitMtx);
             }
+            m_processedSubmitCv.notify_all();
+        }
+
+        if (stopToken.stop_requested() && m_processedSubmitCount.load(std::memory_order_relaxed) == m_enqueuedSubmitCount.load(std::memory_order_acquire))
+            return;
+        m_enqueuedSubmitCount.wait(enqueuedCount, std::memory_order_acquire);
+    }
+}
+
+void VulkanDevice::storeSubmitError(std::exception_ptr error)
+{
+    // only the first error is kept until it is thrown
+    std::scoped_lock lock(m_submitErrorMtx);
+    if (m_submitError == nullptr)
+        m_submitError = std::move(error);
+    m_hasSubmitError.store(true, std::memory_order_release);
+}
 
-            // define if a barrier is required
-            auto memoryBarrier = syncImage(image->syncState(), syncReq);
-            if (memoryBarrier.has_value()) {
-                memoryBarrier->setImage(image->vkImage());
-                memoryBarrier->setSubresourceRange(image->subresourceRange());
-                imageMemoryBarriers.push_back(memoryBarrier.value());
+void VulkanDevice::rethrowSubmitError()
+{
+    if (m_hasSubmitError.load(std::memory_order_acquire) == false)
+        return;
+    // the error is thrown once, by the first thread to see it
+    std::scoped_lock lock(m_submitErrorMtx);
+    if (m_submitError == nullptr)
+        return;
+    m_hasSubmitError.store(false, std::memory_order_relaxed);
+    std::rethrow_exception(std::exchange(m_submitError, nullptr));
+}
+
+void VulkanDevice::completionThreadLoop(const std::stop_token& stopToken)
+{
+    std::vector<CompletedHandler> completedHandlers;
+    std::vector<vk::Semaphore> waitedSemaphores;
+    std::vector<uint64_t> waitedValues;
+    while (true)
+    {
+        // the device is idle when the stop is requested, the handlers of tickets never completed are called too
+        const bool isStopping = stopToken.stop_requested();
+
+        // read before the handlers, a submit completing in between is seen by the next iteration
+        std::array<uint64_t, queueTypeCount> completedValues = {};
+        for (size_t i = 0; i < m_queues.size(); i++)
+            completedValues[i] = m_vkDevice.getSemaphoreCounterValue(m_queues[i]->timelineSemaphore);
+
+        std::array<uint64_t, queueTypeCount> lowestWaitedValues = {}; // 0 if no handler wait the queue
+        uint64_t wakeValue = 0;
+        {
+            std::scoped_lock lock(m_completedHandlersMtx);
+            wakeValue = m_completionWakeValue;
+            std::erase_if(m_completedHandlers, [&](CompletedHandler& completedHandler) {
+                const size_t index = queueIndex(queue(completedHandler.ticket.queueType));
+                if (completedHandler.ticket.value <= completedValues[index] || isStopping) {
+                    completedHandlers.push_back(std::move(completedHandler));
+                    return true;
+                }
+                if (lowestWaitedValues[index] == 0 || completedHandler.ticket.value < lowestWaitedValues[index])
+                    lowestWaitedValues[index] = completedHandler.ticket.value;
+                return false;
+            });
+        }
+
+        // called without the lock so a handler can add other handlers
+        for (CompletedHandler& completedHandler : completedHandlers) {
+            try {
+                completedHandler.handler();
             }
+            catch (...) {
+                storeSubmitError(std::current_exception());
+            }
+        }
+        completedHandlers.clear();
+
+        if (m_backgroundDestruction && m_retirementQueue.pendingCount() != 0)
+            m_retirementQueue.collect(completedTimelineValue());
+
+        if (isStopping) {
+            // until the handlers stop adding other handlers
+            std::scoped_lock lock(m_completedHandlersMtx);
+            if (m_completedHandlers.empty())
+                return;
+            continue;
+        }
+
+        // woken up by the first completed value or by a handler added after the wake value was read
+        waitedSemaphores.assign(1, m_completionWakeSemaphore);
+        waitedValues.assign(1, wakeValue + 1);
+        for (size_t i = 0; i < m_queues.size(); i++) {
+            if (lowestWaitedValues[i] == 0)
+                continue;
+            waitedSemaphores.push_back(m_queues[i]->timelineSemaphore);
+            waitedValues.push_back(lowestWaitedValues[i]);
+        }
+        auto semaphoreWaitInfo = vk::SemaphoreWaitInfo{}
+            .setFlags(vk::SemaphoreWaitFlagBits::eAny)
+            .setSemaphores(waitedSemaphores)
+            .setValues(waitedValues);
+        if (m_vkDevice.waitSemaphores(semaphoreWaitInfo, std::numeric_limits<uint64_t>::max()) != vk::Result::eSuccess) {
+            storeSubmitError(std::make_exception_ptr(std::runtime_error("completion thread failed to wait timeline semaphores")));
+            return;
+        }
+    }
+}
+
+void VulkanDevice::wakeCompletionThread()
+{
+    if (m_completionThread.joinable() == false) {
+        m_completionThread = std::jthread([this](const std::stop_token& stopToken) { completionThreadLoop(stopToken); });
+        return;
+    }
+    m_completionWakeValue++;
+    m_vkDevice.signalSemaphore(vk::SemaphoreSignalInfo{}
+        .setSemaphore(m_completionWakeSemaphore)
+        .setValue(m_completionWakeValue));
+}
+
+bool VulkanDevice::waitPresentedTimelineValue(uint64_t value, std::chrono::nanoseconds timeout) const
+{
+    auto semaphoreWaitInfo = vk::SemaphoreWaitInfo{}
+        .setSemaphores(queue(QueueType::graphics).timelineSemaphore)
+        .setValues(value);
+    const vk::Result result = m_vkDevice.waitSemaphores(semaphoreWaitInfo, static_cast<uint64_t>(std::max<int64_t>(timeout.count(), 0)));
+    if (result == vk::Result::eTimeout)
+        return false;
+    if (result != vk::Result::eSuccess)
+        throw std::runtime_error("failed to wait timeline semaphore");
+    return true;
+}
+
+bool VulkanDevice::waitTimelineValue(Queue& waitedQueue, uint64_t value, std::chrono::nanoseconds timeout)
+{
+    if (value > waitedQueue.lastSignaledTimeValue.load(std::memory_order_acquire)) {
+        std::scoped_lock lock(m_submitMtx);
+        flushPendingBatches(); // a deferred submit
+    }
+    auto semaphoreWaitInfo = vk::SemaphoreWaitInfo{}
+        .setSemaphores(waitedQueue.timelineSemaphore)
+        .setValues(value);
+    const vk::Result result = m_vkDevice.waitSemaphores(semaphoreWaitInfo, static_cast<uint64_t>(std::max<int64_t>(timeout.count(), 0)));
+    if (result == vk::Result::eTimeout)
+        return false;
+    if (result != vk::Result::eSuccess)
+        throw std::runtime_error("failed to wait timeline semaphore");
+    return true;
+}
+
+void VulkanDevice::collectRetiredObjects()
+{
+    if (m_retirementQueue.pendingCount() == 0)
+        return;
+    const uint64_t completedValue = completedTimelineValue();
+    if (m_backgroundDestruction == false) {
+        m_retirementQueue.collect(completedValue);
+        return;
+    }
+    if (m_retirementQueue.hasCollectable(completedValue)) {
+        std::scoped_lock lock(m_completedHandlersMtx);
+        wakeCompletionThread();
+    }
+}
 
-            // TODO : check if a semaphore is required
-            // (image->syncState().queueIdx != syncReq.queueIdx)
+void VulkanDevice::releaseCompletedCommandBuffers()
+{
+    if (m_submittedCommandBuffers.empty())
+        return;
+    TracyVkCollectHost(s_tracyVkContext);
+
+    // the queues progress independently, release every command buffer completed so far and only them
+    std::array<uint64_t, queueTypeCount> completedValues = {};
+    for (size_t i = 0; i < m_queues.size(); i++)
+        completedValues[i] = m_vkDevice.getSemaphoreCounterValue(m_queues[i]->timelineSemaphore);
+    std::erase_if(m_submittedCommandBuffers, [&](SubmittedCommandBuffer& submitted) {
+        Queue& submittedQueue = queue(submitted.commandBuffer->queueType());
+        if (submitted.commandBuffer->signaledTimeValue() > completedValues[queueIndex(submittedQueue)])
+            return false;
+        if (submitted.isBarrierCmdBuffer) {
+            submitted.commandBuffer->reuse();
+            submittedQueue.availableBarrierCmdBuffers.push_back(std::move(submitted.commandBuffer));
+        }
+        return true;
+    });
+}
+
+void VulkanDevice::submit(std::span<const std::shared_ptr<CommandBuffer>> aCommandBuffers, std::chrono::steady_clock::time_point callTime)
+{
+    ZoneScoped;
+    std::scoped_lock lock(m_submitMtx);
+
+    releaseCompletedCommandBuffers();
+    collectRetiredObjects();
+    if (aCommandBuffers.empty() == false)
+        m_pendingSubmitCallTimes.push_back(callTime);
+
+    // a vulkan device only ever create vulkan command buffers
+    auto commandBufferQueue = [this](const std::shared_ptr<CommandBuffer>& aCommandBuffer) -> Queue& {
+        assert(dynamic_cast<VulkanCommandBuffer*>(aCommandBuffer.get()) != nullptr);
+        assert(static_cast<VulkanCommandBuffer*>(aCommandBuffer.get())->isSecondary() == false); // executed by their primary
+        return queue(static_cast<VulkanCommandBuffer*>(aCommandBuffer.get())->queueType());
+    };
+
+    // consecutive command buffers of a same queue are submitted together, in order
+    size_t begin = 0;
+    while (begin < aCommandBuffers.size())
+    {
+        Queue& submitQueue = commandBufferQueue(aCommandBuffers[begin]);
+        size_t end = begin + 1;
+        while (end < aCommandBuffers.size() && &commandBufferQueue(aCommandBuffers[end]) == &submitQueue)
+            end++;
+        submitToQueue(submitQueue, aCommandBuffers.subspan(begin, end - begin));
+        begin = end;
+    }
+
+    if (m_deferredSubmits == false)
+        flushPendingBatches();
+}
+
+void VulkanDevice::submitToQueue(Queue& submitQueue, std::span<const std::shared_ptr<CommandBuffer>> aCommandBuffers)
+{
+    const size_t submitQueueIdx = queueIndex(submitQueue);
+
+    SubmitScratch& scratch = m_submitScratch;
+    scratch.clear();
+    scratch.crossQueueWaitValues.resize(m_queues.size(), 0);
+
+    scratch.releaseImageBarriers.resize(m_queues.size());
+    scratch.releaseBufferBarriers.resize(m_queues.size());
+
+    // resources last used by a queue of an other family are released by that queue and acquired before the first command buffer.
+    // the resources are then considered as used by the submit queue, the wait on the release submit replace the one of trackQueue
+    for (const std::shared_ptr<CommandBuffer>& aCommandBuffer : aCommandBuffers)
+    {
+        auto* commandBuffer = static_cast<VulkanCommandBuffer*>(aCommandBuffer.get());
+
+        for (const auto& [slot, image, syncReqs, finalSyncState] : commandBuffer->imageSyncTable().entries())
+        {
+            const size_t lastQueueIdx = image->lastSubmitQueueIndex();
+            const uint32_t srcFamily = m_queues[lastQueueIdx]->family.index;
+            if (srcFamily == submitQueue.family.index)
+                continue;
+            auto& releaseBarriers = scratch.releaseImageBarriers[lastQueueIdx];
+            const size_t firstReleaseIdx = releaseBarriers.size();
+            const size_t firstAcquireIdx = scratch.acquireImageBarriers.size();
+            transferImageOwnership(image->syncState(), srcFamily, submitQueue.family.index, releaseBarriers, scratch.acquireImageBarriers);
+            for (size_t i = firstReleaseIdx; i < releaseBarriers.size(); i++)
+                releaseBarriers[i].setImage(image->vkImage()).subresourceRange.setAspectMask(image->subresourceRange().aspectMask);
+            for (size_t i = firstAcquireIdx; i < scratch.acquireImageBarriers.size(); i++)
+                scratch.acquireImageBarriers[i].setImage(image->vkImage()).subresourceRange.setAspectMask(image->subresourceRange().aspectMask);
+            image->setLastSubmitQueueIndex(submitQueueIdx);
+        }
 
-            // the new sync state is the state a the end of the command buffer
-            image->syncState() = commandBuffer->imageFinalSyncStates().at(image);
+        for (const auto& [slot, buffer, syncReqs, finalSyncState] : commandBuffer->bufferSyncTable().entries())
+        {
+            const size_t lastQueueIdx = buffer->lastSubmitQueueIndex();
+            const uint32_t srcFamily = m_queues[lastQueueIdx]->family.index;
+            if (srcFamily == submitQueue.family.index)
+                continue;
+            if (auto barriers = transferBufferOwnership(buffer->syncState(), srcFamily, submitQueue.family.index)) {
+                scratch.releaseBufferBarriers[lastQueueIdx].push_back(barriers->first.setBuffer(buffer->vkBuffer()));
+                scratch.acquireBufferBarriers.push_back(barriers->second.setBuffer(buffer->vkBuffer()));
+            }
+            buffer->setLastSubmitQueueIndex(submitQueueIdx);
         }
+    }
+
+    for (size_t i = 0; i < m_queues.size(); i++)
+    {
+        if (scratch.releaseImageBarriers[i].empty() && scratch.releaseBufferBarriers[i].empty())
+            continue;
+        Queue& releaseQueue = *m_queues[i];
+
+        auto dependencyInfo = vk::DependencyInfo{}
+            .setImageMemoryBarriers(scratch.releaseImageBarriers[i])
+            .setBufferMemoryBarriers(scratch.releaseBufferBarriers[i]);
+
+        std::shared_ptr<VulkanCommandBuffer> releaseCmdBuffer = getBarrierCommandBuffer(releaseQueue);
+        releaseCmdBuffer->vkCommandBuffer().pipelineBarrier2(dependencyInfo);
+        releaseCmdBuffer->end();
+        releaseCmdBuffer->setSignaledTimeValue(m_nextSignaledTimeValue);
+        scratch.crossQueueWaitValues[i] = m_nextSignaledTimeValue;
+        addPendingBatch(releaseQueue, std::span(&releaseCmdBuffer->vkCommandBuffer(), 1), {}, {});
+        m_submittedCommandBuffers.push_back(SubmittedCommandBuffer{ .commandBuffer = std::move(releaseCmdBuffer), .isBarrierCmdBuffer = true });
+    }
+
+    // a resource last used by an other queue is waited with the timeline semaphore of that queue
+    auto trackQueue = [&](auto& resource) {
+        const size_t lastQueueIdx = resource.lastSubmitQueueIndex();
+        if (lastQueueIdx != submitQueueIdx)
+            scratch.crossQueueWaitValues[lastQueueIdx] = std::max(scratch.crossQueueWaitValues[lastQueueIdx], resource.lastSubmitTimelineValue());
+        resource.setLastSubmitTimelineValue(m_nextSignaledTimeValue);
+        resource.setLastSubmitQueueIndex(submitQueueIdx);
+    };
+    // the barriers of a resource not used by the previous command buffers of the batch can be recorded before all of them
+    auto isUsedInBatch = [&](const auto& resource) {
+        return resource.lastSubmitQueueIndex() == submitQueueIdx && resource.lastSubmitTimelineValue() == m_nextSignaledTimeValue;
+    };
+
+    // the user command buffers are ended once the barriers of the next one are known, so they can be recorded at their end
+    // a reusable command buffer is not modified, it is ended at its first submit
+    VulkanCommandBuffer* previousCommandBuffer = nullptr;
+    auto canRecordInPrevious = [&]() { return previousCommandBuffer != nullptr && previousCommandBuffer->isRecording() && previousCommandBuffer->isReusable() == false; };
+    bool isPrologueBatchCounted = false;
+
+    for (const std::shared_ptr<CommandBuffer>& aCommandBuffer : aCommandBuffers)
+    {
+        auto* commandBuffer = static_cast<VulkanCommandBuffer*>(aCommandBuffer.get());
+
+        scratch.imageMemoryBarriers.clear();
+        scratch.bufferMemoryBarriers.clear();
+        const size_t firstPrologueBarrierIdx = scratch.prologueImageBarriers.size() + scratch.prologueBufferBarriers.size();
 
-        for (auto& [buffer, syncReq] : commandBuffer->bufferSyncRequests())
+        for (const auto& [slot, image, syncReqs, finalSyncState] : commandBuffer->imageSyncTable().entries())
         {
-            // define if a barrier is required
-            auto barrier = syncBuffer(buffer->syncState(), syncReq);
-            if (barrier.has_value()) {
-                barrier->setBuffer(buffer->vkBuffer());
-                barrier->setOffset(0);
-                barrier->setSize(vk::WholeSize);
-                bufferMemoryBarriers.push_back(barrier.value());
+            // if the buffer use a swapchain image, add its imageAvailableSemaphore to the list of wait semaphores
+            if (image->isSwapchainImage()) {
+                const vk::Semaphore& imageAvailableSemaphore = static_cast<const SwapchainImage&>(*image).imageAvailableSemaphore();
+                // no ideal to do a linear seach but the semaphores are few
+                if (std::ranges::find(scratch.waitSemaphoreInfos, imageAvailableSemaphore, &vk::SemaphoreSubmitInfo::semaphore) == scratch.waitSemaphoreInfos.end()) {
+                    scratch.waitSemaphoreInfos.push_back(vk::SemaphoreSubmitInfo{}
+                        .setSemaphore(imageAvailableSemaphore)
+                        .setStageMask(vk::PipelineStageFlagBits2::eAllCommands)); // not a timeline semaphore, value doesnt matter
+                }
+            }
+
+            // define if a barrier is required for each subresource range used by the command buffer
+            auto& barriers = isUsedInBatch(*image) ? scratch.imageMemoryBarriers : scratch.prologueImageBarriers;
+            const size_t firstBarrierIdx = barriers.size();
+            for (const auto& range : syncReqs.ranges())
+                syncImageSubresources(image->syncState(), range.begin, range.end, range.value, barriers);
+            for (size_t i = firstBarrierIdx; i < barriers.size(); i++) {
+                barriers[i].setImage(image->vkImage());
+                barriers[i].subresourceRange.setAspectMask(image->subresourceRange().aspectMask);
             }
 
-            // TODO : check if a semaphore is required
+            trackQueue(*image);
 
-            // the new sync state is the state a the end of the command buffer
-            buffer->syncState() = commandBuffer->bufferFinalSyncStates().at(buffer);
+            // the new sync state of the used subresources is the state a the end of the command buffer
+            for (const auto& range : finalSyncState.subresources.ranges())
+                image->syncState().subresources.assign(range.begin, range.end, range.value);
         }
 
-        for (auto& drawable : commandBuffer->presentedDrawables())
+        for (const auto& [slot, buffer, syncReqs, finalSyncState] : commandBuffer->bufferSyncTable().entries())
         {
-            ImageSyncRequest syncReq = {
-                .layout = vk::ImageLayout::ePresentSrcKHR,
-                .preserveContent = true};
-
-            if (auto memoryBarrier = syncImage(drawable->swapchainImage()->syncState(), syncReq))
+            // define if a barrier is required for each range used by the command buffer
+            auto& barriers = isUsedInBatch(*buffer) ? scratch.bufferMemoryBarriers : scratch.prologueBufferBarriers;
+            for (const auto& range : syncReqs.ranges())
             {
-                memoryBarrier->setImage(drawable->swapchainImage()->vkImage());
-                memoryBarrier->setSubresourceRange(drawable->swapchainImage()->subresourceRange());
-
-                // barrier need to be added at the en of the command buffer, before presenting
-                commandBuffer->vkCommandBuffer().pipelineBarrier2(vk::DependencyInfo{}
-                    .setDependencyFlags(vk::DependencyFlags{}) // TODO
-                    .setImageMemoryBarriers(*memoryBarrier));
+                BufferSyncRequest syncReq{};
+                syncReq.stageMask = range.value.stageMask;
+                syncReq.accessMask = range.value.accessMask;
+                syncReq.offset = range.begin;
+                syncReq.size = range.end == std::numeric_limits<uint64_t>::max() ? vk::WholeSize : range.end - range.begin;
+                auto barrier = syncBuffer(buffer->syncState(), syncReq);
+                if (barrier.has_value()) {
+                    barrier->setBuffer(buffer->vkBuffer());
+                    barriers.push_back(barrier.value());
+                }
             }
 
-            signalSemaphores.push_back(drawable->imagePresentableSemaphore());
-            signalSemaphoreValues.push_back(0); // not a timeline semaphore, value doesnt matter
-            presentWaitSemaphores.push_back(drawable->imagePresentableSemaphore());
-            presentedSwapchains.push_back(drawable->swapchain());
-            presentedImageIndices.push_back(drawable->imageIndex());
+            trackQueue(*buffer);
+
+            // the new sync state of the used ranges is the state a the end of the command buffer
+            for (const auto& range : finalSyncState.ranges.ranges())
+                buffer->syncState().ranges.assign(range.begin, range.end, range.value);
+        }
+
+        // the prologue barriers are counted as a single batch, on the first command buffer that need them
+        if (const size_t prologueBarrierCount = scratch.prologueImageBarriers.size() + scratch.prologueBufferBarriers.size() - firstPrologueBarrierIdx; prologueBarrierCount > 0) {
+            commandBuffer->countBarriers(static_cast<uint32_t>(prologueBarrierCount), isPrologueBatchCounted ? 0 : 1);
+            isPrologueBatchCounted = true;
         }
 
-        if (imageMemoryBarriers.empty() == false || bufferMemoryBarriers.empty() == false)
+        if (scratch.imageMemoryBarriers.empty() == false || scratch.bufferMemoryBarriers.empty() == false)
         {
+            // a resource used by a previous command buffer, so there is one
+            assert(previousCommandBuffer != nullptr);
+
             auto dependencyInfo = vk::DependencyInfo{}
-                .setDependencyFlags(vk::DependencyFlags{});
+                .setImageMemoryBarriers(scratch.imageMemoryBarriers)
+                .setBufferMemoryBarriers(scratch.bufferMemoryBarriers);
 
-            if (imageMemoryBarriers.empty() == false)
-                dependencyInfo.setImageMemoryBarriers(imageMemoryBarriers);
-            if (bufferMemoryBarriers.empty() == false)
-                dependencyInfo.setBufferMemoryBarriers(bufferMemoryBarriers);
+            if (canRecordInPrevious()) {
+                previousCommandBuffer->flushBarriers(); // its present barriers are before
+                previousCommandBuffer->vkCommandBuffer().pipelineBarrier2(dependencyInfo);
+            }
+            else {
+                std::shared_ptr<VulkanCommandBuffer> barrierCmdBuffer = getBarrierCommandBuffer(submitQueue);
+                {
+                    TracyVkZone(s_tracyVkContext, barrierCmdBuffer->vkCommandBuffer(), "barrierCmdBuffer");
+                    barrierCmdBuffer->vkCommandBuffer().pipelineBarrier2(dependencyInfo);
+                }
+                barrierCmdBuffer->end();
+                barrierCmdBuffer->setSignaledTimeValue(m_nextSignaledTimeValue);
+                scratch.vkCommandBuffers.push_back(barrierCmdBuffer->vkCommandBuffer());
+                m_submittedCommandBuffers.push_back(SubmittedCommandBuffer{ .commandBuffer = std::move(barrierCmdBuffer), .isBarrierCmdBuffer = true });
+            }
+            commandBuffer->countBarriers(static_cast<uint32_t>(scratch.imageMemoryBarriers.size() + scratch.bufferMemoryBarriers.size()));
+        }
+
+        if (previousCommandBuffer != nullptr && previousCommandBuffer->isRecording())
+            previousCommandBuffer->end();
 
-            std::shared_ptr<VulkanCommandBuffer> barrierCmdBuffer = getBarrierCommandBuffer();
+        for (auto& drawable : commandBuffer->presentedDrawables())
+        {
+            SwapchainImage& swapchainImage = *drawable->swapchainImage();
+
+            ImageSyncRequest syncReq{};
+            syncReq.layout = vk::ImageLayout::ePresentSrcKHR;
+            syncReq.preserveContent = true;
+
+            scratch.presentImageBarriers.clear();
+            syncImage(swapchainImage.syncState(), syncReq, scratch.presentImageBarriers);
+            for (auto& memoryBarrier : scratch.presentImageBarriers)
             {
-                TracyVkZone(s_tracyVkContext, commandBuffer->vkCommandBuffer(), "barrierCmdBuffer");
-                barrierCmdBuffer->vkCommandBuffer().pipelineBarrier2(dependencyInfo);
+                memoryBarrier.setImage(swapchainImage.vkImage());
+                memoryBarrier.subresourceRange.setAspectMask(swapchainImage.subresourceRange().aspectMask);
+
+                // barrier need to be added at the en of the command buffer, before presenting
+                commandBuffer->addImageBarrier(memoryBarrier);
             }
-            barrierCmdBuffer->end();
-            // barrierCmdBuffer is added before the user command buffer
-            barrierCmdBuffer->setSignaledTimeValue(m_nextSignaledTimeValue);
-            vkCommandBuffers.push_back(barrierCmdBuffer->vkCommandBuffer());
-            m_submittedCommandBuffers.push_back(barrierCmdBuffer);
+
+            scratch.signalSemaphoreInfos.push_back(vk::SemaphoreSubmitInfo{}
+                .setSemaphore(drawable->imagePresentableSemaphore())
+                .setStageMask(vk::PipelineStageFlagBits2::eAllCommands)); // not a timeline semaphore, value doesnt matter
+            scratch.presentWaitSemaphores.push_back(drawable->imagePresentableSemaphore());
+            scratch.presentedSwapchains.push_back(drawable->swapchain());
+            scratch.presentedImageIndices.push_back(drawable->imageIndex());
+            scratch.presentTrackers.push_back(&drawable->presentTracker());
         }
 
-        commandBuffer->end();
-        // all the command buffer get submitted in the same call, so they have the same value.
-        // wating on one command buffer will wait all the command buffer of the submit groupe
+        // all the command buffer of the batch signal the same value.
+        // wating on one command buffer will wait all the command buffer of the batch
         commandBuffer->setSignaledTimeValue(m_nextSignaledTimeValue);
-        vkCommandBuffers.push_back(commandBuffer->vkCommandBuffer());
-        m_submittedCommandBuffers.push_back(commandBuffer);
+        scratch.vkCommandBuffers.push_back(commandBuffer->vkCommandBuffer());
+        m_submittedCommandBuffers.push_back(SubmittedCommandBuffer{ .commandBuffer = std::static_pointer_cast<VulkanCommandBuffer>(aCommandBuffer) });
+        previousCommandBuffer = commandBuffer;
     }
+    if (previousCommandBuffer != nullptr && previousCommandBuffer->isRecording())
+        previousCommandBuffer->end();
 
-    // currently useless because it dont make sense to call this function with an empty vector
-    // but it allow to possibly discard command buffers in the future
-    if (vkCommandBuffers.empty() == false)
+    // the ownership acquires and the prologue barriers are two barrier commands, the prologue ones can depend on the acquires
+    const bool hasAcquireBarriers = scratch.acquireImageBarriers.empty() == false || scratch.acquireBufferBarriers.empty() == false;
+    const bool hasPrologueBarriers = scratch.prologueImageBarriers.empty() == false || scratch.prologueBufferBarriers.empty() == false;
+    if (hasAcquireBarriers || hasPrologueBarriers)
     {
-        signalSemaphores.push_back(m_timelineSemaphore);
-        signalSemaphoreValues.push_back(m_nextSignaledTimeValue);
-        m_nextSignaledTimeValue++;
-
-        auto timelineSemaphoreSubmitInfo = vk::TimelineSemaphoreSubmitInfo{}
-            .setWaitSemaphoreValues(waitSemaphoreValues)
-            .setSignalSemaphoreValues(signalSemaphoreValues);
-
-        auto submitInfo = vk::SubmitInfo{}
-            .setPNext(timelineSemaphoreSubmitInfo)
-            .setWaitSemaphores(waitSemaphores)
-            .setWaitDstStageMask(waitDstStageMasks)
-            .setCommandBuffers(vkCommandBuffers)
-            .setSignalSemaphores(signalSemaphores);
+        std::shared_ptr<VulkanCommandBuffer> prologueCmdBuffer = getBarrierCommandBuffer(submitQueue);
+        {
+            TracyVkZone(s_tracyVkContext, prologueCmdBuffer->vkCommandBuffer(), "prologueCmdBuffer");
+            if (hasAcquireBarriers) {
+                prologueCmdBuffer->vkCommandBuffer().pipelineBarrier2(vk::DependencyInfo{}
+                    .setImageMemoryBarriers(scratch.acquireImageBarriers)
+                    .setBufferMemoryBarriers(scratch.acquireBufferBarriers));
+                // counted as a barrier batch of the first command buffer, the one that need the resources first
+                static_cast<VulkanCommandBuffer*>(aCommandBuffers.front().get())->countBarriers(static_cast<uint32_t>(scratch.acquireImageBarriers.size() + scratch.acquireBufferBarriers.size()));
+            }
+            if (hasPrologueBarriers) {
+                prologueCmdBuffer->vkCommandBuffer().pipelineBarrier2(vk::DependencyInfo{}
+                    .setImageMemoryBarriers(scratch.prologueImageBarriers)
+                    .setBufferMemoryBarriers(scratch.prologueBufferBarriers));
+            }
+        }
+        prologueCmdBuffer->end();
+        prologueCmdBuffer->setSignaledTimeValue(m_nextSignaledTimeValue);
+        scratch.vkCommandBuffers.insert(scratch.vkCommandBuffers.begin(), prologueCmdBuffer->vkCommandBuffer());
+        m_submittedCommandBuffers.push_back(SubmittedCommandBuffer{ .commandBuffer = std::move(prologueCmdBuffer), .isBarrierCmdBuffer = true });
+    }
 
-        m_queue.submit(submitInfo);
+    for (size_t i = 0; i < m_queues.size(); i++) {
+        if (scratch.crossQueueWaitValues[i] == 0)
+            continue;
+        scratch.waitSemaphoreInfos.push_back(vk::SemaphoreSubmitInfo{}
+            .setSemaphore(m_queues[i]->timelineSemaphore)
+            .setValue(scratch.crossQueueWaitValues[i])
+            .setStageMask(vk::PipelineStageFlagBits2::eAllCommands));
     }
 
-    // for offscreen rendering or compute only
-    if (presentedSwapchains.empty() == false)
+    addPendingBatch(submitQueue, scratch.vkCommandBuffers, scratch.waitSemaphoreInfos, scratch.signalSemaphoreInfos);
+
+    // for offscreen rendering or compute only. the graphics queue always present, it was checked to support the surfaces
+    if (scratch.presentedSwapchains.empty() == false)
     {
+        flushPendingBatches(); // the present wait the batch
+
+        // the ids are given even without the present wait, the swapchains count the queued presents with them
+        const uint64_t presentedTimeValue = m_nextSignaledTimeValue.load() - 1;
+        for (PresentTracker* tracker : scratch.presentTrackers) {
+            tracker->swapchainMtx().lock();
+            scratch.presentIds.push_back(tracker->queuePresent(presentedTimeValue));
+        }
+        scratch.presentResults.resize(scratch.presentedSwapchains.size());
+
+        auto presentId = vk::PresentIdKHR{}
+            .setPresentIds(scratch.presentIds);
+
         auto presentInfo = vk::PresentInfoKHR{}
-            .setWaitSemaphores(presentWaitSemaphores)
-            .setSwapchains(presentedSwapchains)
-            .setImageIndices(presentedImageIndices);
+            .setPNext(m_hasPresentWait ? &presentId : nullptr)
+            .setWaitSemaphores(scratch.presentWaitSemaphores)
+            .setSwapchains(scratch.presentedSwapchains)
+            .setImageIndices(scratch.presentedImageIndices)
+            .setPResults(scratch.presentResults.data());
+
+        (void)queue(QueueType::graphics).vkQueue.presentKHR(&presentInfo); // the result of each swapchain is checked
+        for (PresentTracker* tracker : scratch.presentTrackers)
+            tracker->swapchainMtx().unlock();
 
-        if (m_queue.presentKHR(&presentInfo) != vk::Result::eSuccess)
-            throw std::runtime_error("failed to present swap chain image!");
+        for (size_t i = 0; i < scratch.presentResults.size(); i++)
+        {
+            switch (scratch.presentResults[i])
+            {
+            case vk::Result::eSuccess:
+                break;
+            case vk::Result::eSuboptimalKHR:
+            case vk::Result::eErrorOutOfDateKHR:
+                scratch.presentTrackers[i]->setOutOfDate(); // the next nextDrawable return nullptr
+                break;
+            default:
+                throw std::runtime_error("failed to present swap chain image!");
+            }
+        }
     }
 }
 
-void VulkanDevice::waitCommandBuffer(const CommandBuffer& aCommandBuffer)
+void VulkanDevice::addPendingBatch(Queue& batchQueue, std::span<const vk::CommandBuffer> vkCommandBuffers, std::span<const vk::SemaphoreSubmitInfo> waits, std::span<const vk::SemaphoreSubmitInfo> signals)
 {
-    ZoneScoped;
-    std::scoped_lock lock(m_submitMtx);
+    for (const vk::CommandBuffer& vkCommandBuffer : vkCommandBuffers)
+        batchQueue.pendingCommandBufferInfos.push_back(vk::CommandBufferSubmitInfo{}.setCommandBuffer(vkCommandBuffer));
+    batchQueue.pendingWaitSemaphoreInfos.insert(batchQueue.pendingWaitSemaphoreInfos.end(), waits.begin(), waits.end());
+    batchQueue.pendingSignalSemaphoreInfos.insert(batchQueue.pendingSignalSemaphoreInfos.end(), signals.begin(), signals.end());
+    batchQueue.pendingSignalSemaphoreInfos.push_back(vk::SemaphoreSubmitInfo{}
+        .setSemaphore(batchQueue.timelineSemaphore)
+        .setValue(m_nextSignaledTimeValue)
+        .setStageMask(vk::PipelineStageFlagBits2::eAllCommands));
+    batchQueue.pendingBatches.push_back(Queue::PendingBatch{
+        .commandBufferCount = static_cast<uint32_t>(vkCommandBuffers.size()),
+        .waitSemaphoreCount = static_cast<uint32_t>(waits.size()),
+        .signalSemaphoreCount = static_cast<uint32_t>(signals.size() + 1)
+    });
+
+    if (batchQueue.firstPendingTimeValue.load(std::memory_order_relaxed) == 0)
+        batchQueue.firstPendingTimeValue.store(m_nextSignaledTimeValue, std::memory_order_release);
+    batchQueue.lastPendingTimeValue = m_nextSignaledTimeValue;
+    m_nextSignaledTimeValue++;
+}
 
-    auto waitedIt = std::ranges::find_if(m_submittedCommandBuffers, [&](auto& c){ return c.get() == &aCommandBuffer; });
-    if (waitedIt != m_submittedCommandBuffers.end())
+void VulkanDevice::flushPendingBatches()
+{
+    // a batch can wait a value signaled by a batch of a queue flushed after it, the timeline semaphores allow the wait before the signal
+    for (auto& flushedQueue : m_queues)
     {
-        auto semaphoreWaitInfo = vk::SemaphoreWaitInfo{}
-            .setSemaphores(m_timelineSemaphore)
-            .setValues((*waitedIt)->signaledTimeValue());
-        if (m_vkDevice.waitSemaphores(semaphoreWaitInfo, std::numeric_limits<uint64_t>::max()) != vk::Result::eSuccess)
-            throw std::runtime_error("failed to wait timeline semaphore");
-        TracyVkCollectHost(s_tracyVkContext);
-        for (auto it = m_submittedCommandBuffers.begin(); it != waitedIt; ++it) {
-            if (m_usedBarrierCmdBuffers.contains(*it)) {
-                auto node = m_usedBarrierCmdBuffers.extract(*it);
-                assert(node);
-                node.value()->reuse();
-                m_availableBarrierCmdBuffers.push_back(std::move(node.value()));
-            }
+        if (flushedQueue->pendingBatches.empty())
+            continue;
+
+        // the submit infos point in the pending vectors, they are built once nothing is added anymore
+        m_flushSubmitInfos.clear();
+        size_t commandBufferIdx = 0;
+        size_t waitIdx = 0;
+        size_t signalIdx = 0;
+        for (const Queue::PendingBatch& batch : flushedQueue->pendingBatches)
+        {
+            m_flushSubmitInfos.push_back(vk::SubmitInfo2{}
+                .setCommandBufferInfoCount(batch.commandBufferCount)
+                .setPCommandBufferInfos(flushedQueue->pendingCommandBufferInfos.data() + commandBufferIdx)
+                .setWaitSemaphoreInfoCount(batch.waitSemaphoreCount)
+                .setPWaitSemaphoreInfos(flushedQueue->pendingWaitSemaphoreInfos.data() + waitIdx)
+                .setSignalSemaphoreInfoCount(batch.signalSemaphoreCount)
+                .setPSignalSemaphoreInfos(flushedQueue->pendingSignalSemaphoreInfos.data() + signalIdx));
+            commandBufferIdx += batch.commandBufferCount;
+            waitIdx += batch.waitSemaphoreCount;
+            signalIdx += batch.signalSemaphoreCount;
         }
-        m_submittedCommandBuffers.erase(m_submittedCommandBuffers.begin(), std::next(waitedIt));
-    }
-}
 
-void VulkanDevice::waitIdle()
-{
-    std::scoped_lock lock(m_submitMtx);
+        flushedQueue->vkQueue.submit2(m_flushSubmitInfos);
+        // read in the other order by completedTimelineValue
+        flushedQueue->lastSignaledTimeValue.store(flushedQueue->lastPendingTimeValue, std::memory_order_release);
+        flushedQueue->firstPendingTimeValue.store(0, std::memory_order_release);
 
-    m_vkDevice.waitIdle();
-    auto it = m_submittedCommandBuffers.end();
-    m_submittedCommandBuffers.erase(m_submittedCommandBuffers.begin(), it);
-    for (auto& commandBuffer : m_usedBarrierCmdBuffers) {
-        commandBuffer->reuse();
-        m_availableBarrierCmdBuffers.push_back(commandBuffer);
+        flushedQueue->pendingBatches.clear();
+        flushedQueue->pendingCommandBufferInfos.clear();
+        flushedQueue->pendingWaitSemaphoreInfos.clear();
+        flushedQueue->pendingSignalSemaphoreInfos.clear();
     }
-    m_availableBarrierCmdBuffers.clear();
-}
 
-VulkanDevice::~VulkanDevice()
-{
-    waitIdle();
-    TracyVkDestroy(s_tracyVkContext);
-    m_vkDevice.destroyCommandPool(m_barrierCommandPool);
-    m_vkDevice.destroySemaphore(m_timelineSemaphore);
-    vmaDestroyAllocator(m_allocator);
-    m_vkDevice.destroy();
+    // only this thread update the statistics, m_submitMtx is locked
+    const auto now = std::chrono::steady_clock::now();
+    for (const auto& callTime : m_pendingSubmitCallTimes)
+    {
+        const int64_t latency = std::chrono::duration_cast<std::chrono::nanoseconds>(now - callTime).count();
+        m_submitCount.fetch_add(1, std::memory_order_relaxed);
+        m_totalSubmitLatency.fetch_add(latency, std::memory_order_relaxed);
+        if (latency > m_maxSubmitLatency.load(std::memory_order_relaxed))
+            m_maxSubmitLatency.store(latency, std::memory_order_relaxed);
+    }
+    m_pendingSubmitCallTimes.clear();
 }
 
-std::shared_ptr<VulkanCommandBuffer> VulkanDevice::getBarrierCommandBuffer()
+void VulkanDevice::SubmitScratch::clear()
 {
-    std::shared_ptr<VulkanCommandBuffer> commandBuffer;
-    if (m_availableBarrierCmdBuffers.empty() == false) {
-        commandBuffer = std::move(m_availableBarrierCmdBuffers.front());
-        m_availableBarrierCmdBuffers.pop_front();
-    }
-    else {
-        // command buffer is implicitly reset when begin is called.
-        // https://docs.vulkan.org/refpages/latest/refpages/source/VkCommandPoolCreateFlagBits.html#_description
-        commandBuffer = std::make_shared<VulkanCommandBuffer>(this, m_barrierCommandPool);
-    }
-    m_usedBarrierCmdBuffers.insert(commandBuffer);
-    commandBuffer->begin();
-    return commandBuffer;
+    // clear keep the capacity, after a few submits no allocation is required anymore
+    vkCommandBuffers.clear();
+    waitSemaphoreInfos.clear();
+    signalSemaphoreInfos.clear();
+    presentWaitSemaphores.clear();
+    presentedSwapchains.clear();
+    presentedImageIndices.clear();
+    presentTrackers.clear();
+    presentIds.clear();
+    presentResults.clear();
+    imageMemoryBarriers.clear();
+    presentImageBarriers.clear();
+    bufferMemoryBarriers.clear();
+    prologueImageBarriers.clear();
+    prologueBufferBarriers.clear();
+    crossQueueWaitValues.clear();
+    acquireImageBarriers.clear();
+    acquireBufferBarriers.clear();
+    for (auto& barriers : releaseImageBarriers)
+        barriers.clear();
+    for (auto& barriers : releaseBufferBarriers)
+        barriers.clear();
 }
 
 } // namespace gfx
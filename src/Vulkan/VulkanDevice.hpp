@@ -14,6 +14,7 @@
 #include "Graphics/Swapchain.hpp"
 #include "Graphics/ShaderLib.hpp"
 #include "Graphics/GraphicsPipeline.hpp"
+#include "Graphics/ComputePipeline.hpp"
 #include "Graphics/Buffer.hpp"
 #include "Graphics/Texture.hpp"
 #include "Graphics/CommandBufferPool.hpp"
@@ -21,8 +22,15 @@
 #include "Graphics/CommandBuffer.hpp"
 #include "Graphics/Enums.hpp"
 
+#include "Vulkan/MpscQueue.hpp"
+#include "Vulkan/ObjectCache.hpp"
+#include "Vulkan/PipelineCache.hpp"
+#include "Vulkan/PresentTracker.hpp"
 #include "Vulkan/QueueFamily.hpp"
+#include "Vulkan/ResourceSlot.hpp"
+#include "Vulkan/RetirementQueue.hpp"
 #include "Vulkan/VulkanCommandBuffer.hpp"
+#include "Vulkan/WorkerPool.hpp"
 
 namespace gfx
 {
@@ -47,16 +55,32 @@ public:
     VulkanDevice(const VulkanInstance*, const VulkanPhysicalDevice*, const Descriptor&);
 
     inline Backend backend() const override { return Backend::vulkan; }
+    inline bool supportsDrawIndirectCount() const override { return m_hasDrawIndirectCount; }
+    inline bool supportsPresentWait() const override { return m_hasPresentWait; }
 
     std::unique_ptr<Swapchain> newSwapchain(const Swapchain::Descriptor&) const override;
     std::unique_ptr<ShaderLib> newShaderLib(const std::filesystem::path&) const override;
     std::unique_ptr<ParameterBlockLayout> newParameterBlockLayout(const ParameterBlockLayout::Descriptor&) const override;
     std::unique_ptr<GraphicsPipeline> newGraphicsPipeline(const GraphicsPipeline::Descriptor&) const override;
+    GraphicsPipelineFuture newGraphicsPipelineAsync(const GraphicsPipeline::Descriptor&) const override;
+    std::vector<GraphicsPipelineFuture> newGraphicsPipelines(std::span<const GraphicsPipeline::Descriptor>) const override;
+    std::shared_ptr<GraphicsPipeline> sharedGraphicsPipeline(const GraphicsPipeline::Descriptor&) const override;
+    std::unique_ptr<ComputePipeline> newComputePipeline(const ComputePipeline::Descriptor&) const override;
     std::unique_ptr<Buffer> newBuffer(const Buffer::Descriptor&) const override;
     std::unique_ptr<Texture> newTexture(const Texture::Descriptor&) const override;
-    std::unique_ptr<CommandBufferPool> newCommandBufferPool() const override;
+    using Device::newCommandBufferPool;
+    std::unique_ptr<CommandBufferPool> newCommandBufferPool(QueueType) const override;
+    using Device::newReusableCommandBuffer;
+    std::shared_ptr<CommandBuffer> newReusableCommandBuffer(QueueType) const override;
     std::unique_ptr<ParameterBlockPool> newParameterBlockPool(const ParameterBlockPool::Descriptor&) const override;
     std::unique_ptr<Sampler> newSampler(const Sampler::Descriptor&) const override;
+    std::unique_ptr<UploadRing> newUploadRing(const UploadRing::Descriptor&) const override;
+
+    PipelineCacheStatistics pipelineCacheStatistics() const override;
+    void savePipelineCache() const override;
+
+    SubmitStatistics submitStatistics() const override;
+    DestructionStatistics destructionStatistics() const override;
 
 #if defined (GFX_IMGUI_ENABLED)
     void imguiInit(std::vector<PixelFormat> colorAttachmentPxFormats, std::optional<PixelFormat> depthAttachmentPxFormat) const override;
@@ -66,15 +90,48 @@ public:
 
     void submitCommandBuffers(const std::shared_ptr<CommandBuffer>&) override;
     void submitCommandBuffers(const std::vector<std::shared_ptr<CommandBuffer>>&) override;
+    void flushSubmits() override;
 
     void waitCommandBuffer(const CommandBuffer&) override;
+    bool waitCommandBuffer(const CommandBuffer&, std::chrono::nanoseconds timeout) override;
     void waitIdle() override;
 
+    bool isCompleted(const SubmitTicket&) const override;
+    bool waitSubmit(const SubmitTicket&, std::chrono::nanoseconds timeout) override;
+    void addCompletedHandler(const SubmitTicket&, std::function<void()>) override;
+
     inline const vk::Device& vkDevice() const { return m_vkDevice; }
     inline const VulkanPhysicalDevice& physicalDevice() const { return *m_physicalDevice; }
 
     inline const VmaAllocator& allocator() const { return m_allocator; }
 
+    inline ResourceSlotAllocator& resourceSlotAllocator() const { return m_resourceSlotAllocator; }
+    inline PipelineCache& pipelineCache() const { return *m_pipelineCache; }
+    inline ObjectCache& objectCache() const { return *m_objectCache; }
+
+    // called by the destructors, the object is destroyed once everything submitted so far is completed
+    void retire(RetirementQueue::Object) const;
+
+    inline bool hasVertexAttributeDivisor() const { return m_hasVertexAttributeDivisor; }
+    inline bool hasMultiDrawIndirect() const { return m_hasMultiDrawIndirect; }
+
+    // the last swapchain of each surface is given as oldSwapchain to the next one created for the surface, so it is kept by
+    // the device until then (or until the device is destroyed) even once released. the replaced ones are retired once released
+    vk::SwapchainKHR newVkSwapchain(vk::SwapchainCreateInfoKHR) const;
+    void releaseVkSwapchain(const vk::SurfaceKHR&, const vk::SwapchainKHR&) const;
+
+    // command buffers can outlive the object that created them, so the pool is destroyed with its last reference
+    std::shared_ptr<vk::CommandPool> newVkCommandPool(QueueType, vk::CommandPoolCreateFlags = {}) const;
+
+    // family of the queue the command buffers of a QueueType are submitted to
+    inline const QueueFamily& queueFamily(QueueType type) const { return queue(type).family; }
+
+    // every submit signaling a value lower or equal is completed, whatever the queue it was submitted to
+    uint64_t completedTimelineValue() const;
+
+    // the batches of the presents are flushed before presenting, their value is waited without the submit lock
+    bool waitPresentedTimelineValue(uint64_t value, std::chrono::nanoseconds timeout) const;
+
     ~VulkanDevice() override;
 
 public:
@@ -84,21 +141,175 @@ private:
     const VulkanInstance* const m_instance = nullptr;
     const VulkanPhysicalDevice* const m_physicalDevice = nullptr;
 
-    QueueFamily m_queueFamily;
+    // each queue signal its own timeline semaphore, the values come from the same counter so they are unique across queues
+    struct Queue
+    {
+        QueueType type;
+        QueueFamily family;
+        vk::Queue vkQueue;
+        vk::Semaphore timelineSemaphore;
+        std::atomic<uint64_t> lastSignaledTimeValue = 0; // last value given to the driver
+
+        vk::CommandPool barrierCommandPool;
+        std::vector<std::shared_ptr<VulkanCommandBuffer>> availableBarrierCmdBuffers;
+
+        // batches not given to the driver yet, all submitted by the next vkQueueSubmit2 of the queue.
+        // each batch signal its own value so the command buffers are still waited independently
+        struct PendingBatch
+        {
+            uint32_t commandBufferCount;
+            uint32_t waitSemaphoreCount;
+            uint32_t signalSemaphoreCount;
+        };
+        std::vector<PendingBatch> pendingBatches;
+        std::vector<vk::CommandBufferSubmitInfo> pendingCommandBufferInfos;
+        std::vector<vk::SemaphoreSubmitInfo> pendingWaitSemaphoreInfos;
+        std::vector<vk::SemaphoreSubmitInfo> pendingSignalSemaphoreInfos;
+        std::atomic<uint64_t> firstPendingTimeValue = 0; // 0 if there is no pending batch
+        uint64_t lastPendingTimeValue = 0;
+    };
+
     vk::Device m_vkDevice;
-    vk::Queue m_queue;
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    static constexpr size_t queueTypeCount = 3;
+    std::array<Queue*, queueTypeCount> m_queueByType = {}; // indexed by QueueType, a type without its own queue use the graphics one
     VmaAllocator m_allocator = VK_NULL_HANDLE;
-    vk::Semaphore m_timelineSemaphore;
+    bool m_hasVertexAttributeDivisor = false;
+    bool m_hasDrawIndirectCount = false;
+    bool m_hasMultiDrawIndirect = false;
+    bool m_hasPresentWait = false;
     std::mutex m_submitMtx;
+    mutable ResourceSlotAllocator m_resourceSlotAllocator;
+    mutable RetirementQueue m_retirementQueue{this};
+    bool m_backgroundDestruction = false;
+    struct SurfaceSwapchain
+    {
+        vk::SwapchainKHR vkSwapchain;
+        bool isReleased = false; // the VulkanSwapchain and its images are destroyed
+    };
+    mutable std::mutex m_surfaceSwapchainsMtx;
+    mutable std::map<vk::SurfaceKHR, SurfaceSwapchain> m_surfaceSwapchains;
+
+    std::unique_ptr<PipelineCache> m_pipelineCache;
+    std::unique_ptr<ObjectCache> m_objectCache;
+
+    // created on first use so a device that never compile in the background does not start threads
+    mutable std::mutex m_workerPoolMtx;
+    mutable std::unique_ptr<WorkerPool> m_workerPool;
+
+    // kept alive until they are completed, released by the next submit or waitIdle
+    struct SubmittedCommandBuffer
+    {
+        std::shared_ptr<VulkanCommandBuffer> commandBuffer;
+        bool isBarrierCmdBuffer = false;
+    };
+    std::vector<SubmittedCommandBuffer> m_submittedCommandBuffers;
+    std::atomic<uint64_t> m_nextSignaledTimeValue = 1; // only incremented with m_submitMtx locked, read by retire
+
+    // storage reused by every submit so the steady state does not allocate, only used with m_submitMtx locked
+    struct SubmitScratch
+    {
+        std::vector<vk::CommandBuffer> vkCommandBuffers;
+
+        std::vector<vk::SemaphoreSubmitInfo> waitSemaphoreInfos;
+        std::vector<vk::SemaphoreSubmitInfo> signalSemaphoreInfos; // the binary ones, the timeline one is added with the batch
+
+        std::vector<vk::Semaphore> presentWaitSemaphores;
+        std::vector<vk::SwapchainKHR> presentedSwapchains;
+        std::vector<uint32_t> presentedImageIndices;
+        std::vector<PresentTracker*> presentTrackers;
+        std::vector<uint64_t> presentIds;
+        std::vector<vk::Result> presentResults;
+
+        std::vector<vk::ImageMemoryBarrier2> imageMemoryBarriers;
+        std::vector<vk::ImageMemoryBarrier2> presentImageBarriers;
+        std::vector<vk::BufferMemoryBarrier2> bufferMemoryBarriers;
+
+        // barriers of the resources not used by the previous command buffers of the batch,
+        // recorded together in the prologue command buffer at the front of the batch
+        std::vector<vk::ImageMemoryBarrier2> prologueImageBarriers;
+        std::vector<vk::BufferMemoryBarrier2> prologueBufferBarriers;
+
+        std::vector<uint64_t> crossQueueWaitValues; // indexed like m_queues, 0 if there is nothing to wait
+
+        // queue family ownership transfers, the acquire barriers are recorded before the barriers of the command buffer
+        // and the release ones are submitted to the queue that used the resources last, indexed like m_queues
+        std::vector<vk::ImageMemoryBarrier2> acquireImageBarriers;
+        std::vector<vk::BufferMemoryBarrier2> acquireBufferBarriers;
+        std::vector<std::vector<vk::ImageMemoryBarrier2>> releaseImageBarriers;
+        std::vector<std::vector<vk::BufferMemoryBarrier2>> releaseBufferBarriers;
+
+        void clear();
+    }
+    m_submitScratch;
+
+    bool m_deferredSubmits = false;
+    std::vector<vk::SubmitInfo2> m_flushSubmitInfos;
+    std::vector<std::chrono::steady_clock::time_point> m_pendingSubmitCallTimes; // latency is measured when the batches are flushed
+
+    // only used when the device has a submission thread. the counters are compared by waitIdle to know if
+    // everything enqueued is submitted, the enqueued one is also the value the thread wait on to be woken up
+    struct SubmitRequest
+    {
+        std::vector<std::shared_ptr<CommandBuffer>> commandBuffers;
+        std::chrono::steady_clock::time_point enqueueTime;
+        bool flush = false; // flushSubmits
+    };
+    MpscQueue<SubmitRequest> m_submitQueue;
+    std::atomic<uint64_t> m_enqueuedSubmitCount = 0;
+    std::atomic<uint64_t> m_processedSubmitCount = 0;
+    std::mutex m_processedSubmitMtx; // only for the timed waits, atomic waits have no timeout
+    std::condition_variable m_processedSubmitCv;
+    std::atomic<bool> m_hasSubmitError = false; // checked without locking m_submitErrorMtx
+    std::mutex m_submitErrorMtx;
+    std::exception_ptr m_submitError;
+    std::jthread m_submissionThread;
+
+    // the completion thread is started by the first handler, it wait for the lowest ticket of each queue
+    // and for the wake up semaphore, signaled from the host when a handler is added or the device destroyed.
+    // with Descriptor::backgroundDestruction it also destroy the retired objects, the submits wake it up when some are completed
+    struct CompletedHandler
+    {
+        SubmitTicket ticket;
+        std::function<void()> handler;
+    };
+    std::mutex m_completedHandlersMtx;
+    std::vector<CompletedHandler> m_completedHandlers;
+    vk::Semaphore m_completionWakeSemaphore;
+    uint64_t m_completionWakeValue = 0;
+    std::jthread m_completionThread;
 
-    vk::CommandPool m_barrierCommandPool;
-    std::deque<std::shared_ptr<VulkanCommandBuffer>> m_availableBarrierCmdBuffers;
-    std::set<std::shared_ptr<VulkanCommandBuffer>> m_usedBarrierCmdBuffers;
+    std::atomic<uint32_t> m_submitCount = 0;
+    std::atomic<int64_t> m_totalSubmitLatency = 0; // nanoseconds
+    std::atomic<int64_t> m_maxSubmitLatency = 0;
 
-    std::deque<std::shared_ptr<VulkanCommandBuffer>> m_submittedCommandBuffers;
-    uint64_t m_nextSignaledTimeValue = 1;
+    inline Queue& queue(QueueType type) const { return *m_queueByType[static_cast<size_t>(type)]; }
+    size_t queueIndex(const Queue&) const;
 
-    std::shared_ptr<VulkanCommandBuffer> getBarrierCommandBuffer();
+    // submit on the calling thread or enqueue for the submission thread
+    void submitOrEnqueue(std::span<const std::shared_ptr<CommandBuffer>>);
+    void submissionThreadLoop(const std::stop_token&);
+    // thrown by the next submit or wait, from the submission and completion threads
+    void storeSubmitError(std::exception_ptr);
+    void rethrowSubmitError();
+    void completionThreadLoop(const std::stop_token&);
+    // signal m_completionWakeSemaphore or start the thread, m_completedHandlersMtx must be locked
+    void wakeCompletionThread();
+    // destroy the completed retired objects, or wake the completion thread up to do it
+    void collectRetiredObjects();
+    // flush the submit first if it is deferred
+    bool waitTimelineValue(Queue&, uint64_t value, std::chrono::nanoseconds timeout);
+    void submit(std::span<const std::shared_ptr<CommandBuffer>>, std::chrono::steady_clock::time_point callTime);
+    // the completed command buffers are released and the barrier command buffers made available again, m_submitMtx must be locked
+    void releaseCompletedCommandBuffers();
+    // the command buffers are all for the same queue, they are added as one batch to the pending batches of the queue
+    void submitToQueue(Queue&, std::span<const std::shared_ptr<CommandBuffer>>);
+    // the batch signal m_nextSignaledTimeValue on the timeline semaphore of the queue, then the value is incremented
+    void addPendingBatch(Queue&, std::span<const vk::CommandBuffer>, std::span<const vk::SemaphoreSubmitInfo> waits, std::span<const vk::SemaphoreSubmitInfo> signals);
+    // one vkQueueSubmit2 per queue with pending batches, m_submitMtx must be locked
+    void flushPendingBatches();
+    WorkerPool& workerPool() const;
+    std::shared_ptr<VulkanCommandBuffer> getBarrierCommandBuffer(Queue&);
 
 public:
     VulkanDevice& operator=(const VulkanDevice&) = delete;
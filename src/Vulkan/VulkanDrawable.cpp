@@ -13,8 +13,8 @@
 namespace gfx
 {
 
-VulkanDrawable::VulkanDrawable(const VulkanDevice* device)
-    : m_device(device)
+VulkanDrawable::VulkanDrawable(const VulkanDevice* device, const std::shared_ptr<PresentTracker>& presentTracker)
+    : m_device(device), m_presentTracker(presentTracker)
 {
     m_imageAvailableSemaphore = m_device->vkDevice().createSemaphore(vk::SemaphoreCreateInfo{});
 
@@ -36,7 +36,7 @@ void VulkanDrawable::setSwapchainImage(const std::shared_ptr<SwapchainImage>& sw
 
 VulkanDrawable::~VulkanDrawable()
 {
-    m_device->vkDevice().destroySemaphore(m_imageAvailableSemaphore);
+    m_device->retire(m_imageAvailableSemaphore); // can be waited by a submit not completed yet
 }
 
 }
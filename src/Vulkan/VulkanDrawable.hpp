@@ -13,6 +13,7 @@
 #include "Graphics/Drawable.hpp"
 #include "Graphics/Texture.hpp"
 
+#include "Vulkan/PresentTracker.hpp"
 #include "Vulkan/SwapchainImage.hpp"
 #include "Vulkan/VulkanTexture.hpp"
 
@@ -28,7 +29,7 @@ public:
     VulkanDrawable(const VulkanDrawable&) = delete;
     VulkanDrawable(VulkanDrawable&&) = delete;
 
-    VulkanDrawable(const VulkanDevice*);
+    VulkanDrawable(const VulkanDevice*, const std::shared_ptr<PresentTracker>&);
 
     inline std::shared_ptr<Texture> texture() const override { return m_swapchainImage; }
     inline std::shared_ptr<VulkanTexture> vulkanTexture() const { return m_swapchainImage; }
@@ -39,6 +40,8 @@ public:
     inline const vk::SwapchainKHR& swapchain() const { return m_swapchainImage->swapchain(); }
     inline uint32_t imageIndex() const { return m_imageIndex; }
 
+    inline PresentTracker& presentTracker() const { return *m_presentTracker; }
+
     inline const vk::Semaphore& imageAvailableSemaphore() const { return m_imageAvailableSemaphore; }
     inline const vk::Semaphore& imagePresentableSemaphore() const { return m_swapchainImage->imagePresentableSemaphore(); }
 
@@ -47,6 +50,7 @@ public:
 private:
     const VulkanDevice* m_device;
     vk::Semaphore m_imageAvailableSemaphore;
+    std::shared_ptr<PresentTracker> m_presentTracker; // the drawable can be presented after the swapchain is destroyed
 
     std::shared_ptr<SwapchainImage> m_swapchainImage;
     uint32_t m_imageIndex = 0;
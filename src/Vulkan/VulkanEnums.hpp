@@ -65,6 +65,10 @@ constexpr vk::PresentModeKHR toVkPresentModeKHR(PresentMode pmd)
         return vk::PresentModeKHR::eFifo;
     case PresentMode::mailbox:
         return vk::PresentModeKHR::eMailbox;
+    case PresentMode::immediate:
+        return vk::PresentModeKHR::eImmediate;
+    case PresentMode::fifoRelaxed:
+        return vk::PresentModeKHR::eFifoRelaxed;
     default:
         throw std::runtime_error("not implemented");
     }
@@ -78,6 +82,10 @@ constexpr PresentMode toPresentMode(vk::PresentModeKHR pmd)
         return PresentMode::fifo;
     case vk::PresentModeKHR::eMailbox:
         return PresentMode::mailbox;
+    case vk::PresentModeKHR::eImmediate:
+        return PresentMode::immediate;
+    case vk::PresentModeKHR::eFifoRelaxed:
+        return PresentMode::fifoRelaxed;
     default:
         throw std::runtime_error("not implemented");
     }
@@ -104,6 +112,21 @@ constexpr vk::Format toVkFormat(VertexAttributeFormat fmt)
         return vk::Format::eR32G32Sfloat;
     case VertexAttributeFormat::float3:
         return vk::Format::eR32G32B32Sfloat;
+    case VertexAttributeFormat::float4:
+        return vk::Format::eR32G32B32A32Sfloat;
+    default:
+        throw std::runtime_error("not implemented");
+    }
+}
+
+constexpr vk::VertexInputRate toVkVertexInputRate(VertexStepFunction stepFunction)
+{
+    switch (stepFunction)
+    {
+    case VertexStepFunction::perVertex:
+        return vk::VertexInputRate::eVertex;
+    case VertexStepFunction::perInstance:
+        return vk::VertexInputRate::eInstance;
     default:
         throw std::runtime_error("not implemented");
     }
@@ -125,6 +148,8 @@ constexpr vk::BufferUsageFlags toVkBufferUsageFlags(BufferUsages use)
         vkUsages |= vk::BufferUsageFlagBits::eTransferSrc;
     if (use & BufferUsage::copyDestination)
         vkUsages |= vk::BufferUsageFlagBits::eTransferDst;
+    if (use & BufferUsage::indirectBuffer)
+        vkUsages |= vk::BufferUsageFlagBits::eIndirectBuffer;
 
     return vkUsages;
 }
@@ -141,6 +166,8 @@ constexpr vk::DescriptorType toVkDescriptorType(BindingType tpe)
         return vk::DescriptorType::eSampledImage;
     case BindingType::sampler:
         return vk::DescriptorType::eSampler;
+    case BindingType::storageTexture:
+        return vk::DescriptorType::eStorageImage;
     default:
         throw std::runtime_error("not implemented");
     }
@@ -158,10 +185,28 @@ constexpr vk::ShaderStageFlags toVkShaderStageFlags(BindingUsages use)
         vkShaderStageFlags |= vk::ShaderStageFlagBits::eFragment;
     if (use & BindingUsage::fragmentWrite)
         vkShaderStageFlags |= vk::ShaderStageFlagBits::eFragment;
+    if (use & BindingUsage::computeRead)
+        vkShaderStageFlags |= vk::ShaderStageFlagBits::eCompute;
+    if (use & BindingUsage::computeWrite)
+        vkShaderStageFlags |= vk::ShaderStageFlagBits::eCompute;
 
     return vkShaderStageFlags;
 }
 
+constexpr vk::PipelineStageFlags2 toVkPipelineStageFlags(BindingUsages use)
+{
+    vk::PipelineStageFlags2 vkPipelineStageFlags;
+
+    if ((use & BindingUsage::vertexRead) || (use & BindingUsage::vertexWrite))
+        vkPipelineStageFlags |= vk::PipelineStageFlagBits2::eVertexShader;
+    if ((use & BindingUsage::fragmentRead) || (use & BindingUsage::fragmentWrite))
+        vkPipelineStageFlags |= vk::PipelineStageFlagBits2::eFragmentShader;
+    if ((use & BindingUsage::computeRead) || (use & BindingUsage::computeWrite))
+        vkPipelineStageFlags |= vk::PipelineStageFlagBits2::eComputeShader;
+
+    return vkPipelineStageFlags;
+}
+
 constexpr vk::ImageUsageFlags toVkImageUsageFlags(TextureUsages use)
 {
     vk::ImageUsageFlags vkUsages;
@@ -174,6 +219,10 @@ constexpr vk::ImageUsageFlags toVkImageUsageFlags(TextureUsages use)
         vkUsages |= vk::ImageUsageFlagBits::eDepthStencilAttachment;
     if (use & TextureUsage::copyDestination)
         vkUsages |= vk::ImageUsageFlagBits::eTransferDst;
+    if (use & TextureUsage::shaderWrite)
+        vkUsages |= vk::ImageUsageFlagBits::eStorage;
+    if (use & TextureUsage::copySource)
+        vkUsages |= vk::ImageUsageFlagBits::eTransferSrc;
 
     return vkUsages;
 }
@@ -184,6 +233,8 @@ constexpr vk::ImageAspectFlags toVkImageAspectFlags(TextureUsages use)
 
     if (use & TextureUsage::shaderRead)
         vkImgAspectFlags |= vk::ImageAspectFlagBits::eColor;
+    if (use & TextureUsage::shaderWrite)
+        vkImgAspectFlags |= vk::ImageAspectFlagBits::eColor;
     if (use & TextureUsage::colorAttachment)
         vkImgAspectFlags |= vk::ImageAspectFlagBits::eColor;
     if (use & TextureUsage::depthStencilAttachment)
@@ -235,6 +286,19 @@ constexpr vk::CullModeFlags toVkCullModeFlags(CullMode cullMode)
     }
 }
 
+constexpr vk::IndexType toVkIndexType(IndexType type)
+{
+    switch (type)
+    {
+    case IndexType::uint16:
+        return vk::IndexType::eUint16;
+    case IndexType::uint32:
+        return vk::IndexType::eUint32;
+    default:
+        throw std::runtime_error("not implemented");
+    }
+}
+
 }
 
 #endif // VULKANENUMS_HPP
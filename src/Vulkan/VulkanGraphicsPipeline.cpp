@@ -16,16 +16,50 @@
 #include "VulkanParameterBlockLayout.hpp"
 #include "vulkan/vulkan.hpp"
 #include <cassert>
+#include <chrono>
 #include <ranges>
 
 namespace gfx
 {
 
-VulkanGraphicsPipeline::VulkanGraphicsPipeline(const VulkanDevice* device, const GraphicsPipeline::Descriptor& desc)
-    : m_device(device)
+// everything a vk::GraphicsPipelineCreateInfo point to, so several can be alive at the same time for a batched creation
+struct VulkanGraphicsPipeline::CreateInfo
+{
+    std::array<vk::PipelineShaderStageCreateInfo, 2> shaderStages;
+    std::array<vk::DynamicState, 2> dynamicStates;
+    vk::PipelineDynamicStateCreateInfo dynamicStateCreateInfo;
+    std::vector<vk::VertexInputBindingDescription> vertexInputBindingDescriptions;
+    std::vector<vk::VertexInputBindingDivisorDescriptionEXT> vertexInputBindingDivisors;
+    std::vector<vk::VertexInputAttributeDescription> vertexInputAttributeDescriptions;
+    vk::PipelineVertexInputDivisorStateCreateInfoEXT vertexInputDivisorStateCreateInfo;
+    vk::PipelineVertexInputStateCreateInfo vertexInputStateCreateInfo;
+    vk::PipelineInputAssemblyStateCreateInfo inputAssemblyStateCreateInfo;
+    vk::PipelineViewportStateCreateInfo viewportStateCreateInfo;
+    vk::PipelineRasterizationStateCreateInfo rasterizationStateCreateInfo;
+    vk::PipelineMultisampleStateCreateInfo multisampleStateCreateInfo;
+    vk::PipelineDepthStencilStateCreateInfo depthStencilStateCreateInfo;
+    std::vector<vk::PipelineColorBlendAttachmentState> colorBlendAttachmentStates;
+    vk::PipelineColorBlendStateCreateInfo colorBlendStateCreateInfo;
+    std::vector<vk::Format> colorAttachmentFormats;
+    vk::PipelineRenderingCreateInfo pipelineRenderingCreateInfo;
+    vk::PipelineCreationFeedback creationFeedback;
+    vk::PipelineCreationFeedbackCreateInfo creationFeedbackCreateInfo;
+
+    vk::GraphicsPipelineCreateInfo graphicsPipelineCreateInfo;
+
+    CreateInfo(const GraphicsPipeline::Descriptor&, vk::PipelineLayout, bool withCreationFeedback);
+    CreateInfo(const CreateInfo&) = delete;
+    CreateInfo(CreateInfo&&) = delete;
+    CreateInfo& operator=(const CreateInfo&) = delete;
+    CreateInfo& operator=(CreateInfo&&) = delete;
+};
+
+VulkanGraphicsPipeline::CreateInfo::CreateInfo(const GraphicsPipeline::Descriptor& desc, vk::PipelineLayout pipelineLayout, bool withCreationFeedback)
 {
     auto* vertFunc = dynamic_cast<VulkanShaderFunction*>(desc.vertexShader);
     auto* fragFunc = dynamic_cast<VulkanShaderFunction*>(desc.fragmentShader);
+    if (vertFunc == nullptr || fragFunc == nullptr)
+        throw std::runtime_error("a GraphicsPipeline need a vertex and a fragment shader");
 
     auto vertShaderStageCreateInfo = vk::PipelineShaderStageCreateInfo{}
         .setStage(vk::ShaderStageFlagBits::eVertex)
@@ -37,33 +71,38 @@ VulkanGraphicsPipeline::VulkanGraphicsPipeline(const VulkanDevice* device, const
         .setModule(fragFunc->shaderModule())
         .setPName(fragFunc->name().c_str());
 
-    std::array<vk::PipelineShaderStageCreateInfo, 2> shaderStages = { vertShaderStageCreateInfo, fragShaderStageCreateInfo };
+    shaderStages = { vertShaderStageCreateInfo, fragShaderStageCreateInfo };
 
-    std::array<vk::DynamicState, 2> dynamicStates = {
+    dynamicStates = {
         vk::DynamicState::eViewport,
         vk::DynamicState::eScissor
     };
 
-    auto dynamicStateCreateInfo = vk::PipelineDynamicStateCreateInfo{}
+    dynamicStateCreateInfo = vk::PipelineDynamicStateCreateInfo{}
         .setDynamicStates(dynamicStates);
 
-    std::array<vk::VertexInputBindingDescription, 1> vertexInputBindingDescriptions;
-    std::vector<vk::VertexInputAttributeDescription> vertexInputAttributeDescriptions;
-    vk::PipelineVertexInputStateCreateInfo vertexInputStateCreateInfo;
-
     if (auto& vertexLayout =  desc.vertexLayout)
     {
-        vertexInputBindingDescriptions = {
-            vk::VertexInputBindingDescription{}
-                .setBinding(0)
-                .setStride(static_cast<uint32_t>(vertexLayout->stride))
-                .setInputRate(vk::VertexInputRate::eVertex)
-        };
+        vertexInputBindingDescriptions.resize(vertexLayout->buffers.size());
+        for (uint32_t i = 0; auto& buffer : vertexLayout->buffers) {
+            vertexInputBindingDescriptions[i] = vk::VertexInputBindingDescription{}
+                .setBinding(i)
+                .setStride(static_cast<uint32_t>(buffer.stride))
+                .setInputRate(toVkVertexInputRate(buffer.stepFunction));
+            // a rate of 1 is the default instance rate, only the other ones need VK_EXT_vertex_attribute_divisor
+            if (buffer.stepFunction == VertexStepFunction::perInstance && buffer.stepRate != 1) {
+                vertexInputBindingDivisors.push_back(vk::VertexInputBindingDivisorDescriptionEXT{}
+                    .setBinding(i)
+                    .setDivisor(buffer.stepRate));
+            }
+            i++;
+        }
         vertexInputAttributeDescriptions.resize(vertexLayout->attributes.size());
         for (uint32_t i = 0; auto& attribute : vertexLayout->attributes) {
+            assert(attribute.bufferIndex < vertexLayout->buffers.size());
             vertexInputAttributeDescriptions[i] = vk::VertexInputAttributeDescription{}
                 .setLocation(i)
-                .setBinding(0)
+                .setBinding(attribute.bufferIndex)
                 .setFormat(toVkFormat(attribute.format))
                 .setOffset(static_cast<uint32_t>(attribute.offset));
             i++;
@@ -71,6 +110,11 @@ VulkanGraphicsPipeline::VulkanGraphicsPipeline(const VulkanDevice* device, const
         vertexInputStateCreateInfo = vk::PipelineVertexInputStateCreateInfo()
             .setVertexBindingDescriptions(vertexInputBindingDescriptions)
             .setVertexAttributeDescriptions(vertexInputAttributeDescriptions);
+        if (vertexInputBindingDivisors.empty() == false) {
+            vertexInputDivisorStateCreateInfo = vk::PipelineVertexInputDivisorStateCreateInfoEXT{}
+                .setVertexBindingDivisors(vertexInputBindingDivisors);
+            vertexInputStateCreateInfo.setPNext(&vertexInputDivisorStateCreateInfo);
+        }
     }
     else
     {
@@ -79,15 +123,15 @@ VulkanGraphicsPipeline::VulkanGraphicsPipeline(const VulkanDevice* device, const
             .setVertexAttributeDescriptions(nullptr);
     }
 
-    auto inputAssemblyStateCreateInfo = vk::PipelineInputAssemblyStateCreateInfo{}
+    inputAssemblyStateCreateInfo = vk::PipelineInputAssemblyStateCreateInfo{}
         .setTopology(vk::PrimitiveTopology::eTriangleList)
         .setPrimitiveRestartEnable(false);
 
-    auto viewportStateCreateInfo = vk::PipelineViewportStateCreateInfo{}
+    viewportStateCreateInfo = vk::PipelineViewportStateCreateInfo{}
         .setViewportCount(1)
         .setScissorCount(1);
 
-    auto rasterizationStateCreateInfo = vk::PipelineRasterizationStateCreateInfo{}
+    rasterizationStateCreateInfo = vk::PipelineRasterizationStateCreateInfo{}
         .setDepthClampEnable(false)
         .setRasterizerDiscardEnable(false)
         .setPolygonMode(vk::PolygonMode::eFill)
@@ -96,11 +140,11 @@ VulkanGraphicsPipeline::VulkanGraphicsPipeline(const VulkanDevice* device, const
         .setFrontFace(vk::FrontFace::eCounterClockwise)
         .setDepthBiasEnable(false);
 
-    auto multisampleStateCreateInfo = vk::PipelineMultisampleStateCreateInfo{}
+    multisampleStateCreateInfo = vk::PipelineMultisampleStateCreateInfo{}
         .setSampleShadingEnable(false)
         .setRasterizationSamples(vk::SampleCountFlagBits::e1);
 
-    auto depthStencilStateCreateInfo = vk::PipelineDepthStencilStateCreateInfo{}
+    depthStencilStateCreateInfo = vk::PipelineDepthStencilStateCreateInfo{}
         .setDepthTestEnable(vk::True)
         .setDepthWriteEnable(vk::True)
         .setDepthCompareOp(vk::CompareOp::eLess)
@@ -137,45 +181,29 @@ VulkanGraphicsPipeline::VulkanGraphicsPipeline(const VulkanDevice* device, const
             .setAlphaBlendOp(vk::BlendOp::eAdd);
     }
 
-    std::vector<vk::PipelineColorBlendAttachmentState> colorBlendAttachmentStates(desc.colorAttachmentPxFormats.size(), colorBlendAttachmentState);
+    colorBlendAttachmentStates.assign(desc.colorAttachmentPxFormats.size(), colorBlendAttachmentState);
 
-    auto colorBlendStateCreateInfo = vk::PipelineColorBlendStateCreateInfo{}
+    colorBlendStateCreateInfo = vk::PipelineColorBlendStateCreateInfo{}
         .setLogicOpEnable(false)
         .setAttachments(colorBlendAttachmentStates);
 
-    std::vector<vk::DescriptorSetLayout> descriptorSetLayouts;
-    if (desc.parameterBlockLayouts.empty() == false)
-    {
-        descriptorSetLayouts.reserve(desc.parameterBlockLayouts.size());
-        for (const auto& pbl : desc.parameterBlockLayouts | std::views::transform([](const auto& aPbl) { return std::dynamic_pointer_cast<VulkanParameterBlockLayout>(aPbl); })) {
-            assert(pbl);
-            descriptorSetLayouts.push_back(pbl->vkDescriptorSetLayout());
-        }
-    }
-
-    auto pushConstantRange = vk::PushConstantRange{}
-        .setStageFlags(vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment)
-        .setOffset(0)
-        .setSize(128);
-
-    auto pipelineLayoutCreateInfo = vk::PipelineLayoutCreateInfo{}
-        .setSetLayouts(descriptorSetLayouts)
-        .setPushConstantRanges(pushConstantRange);
-
-    m_pipelineLayout = m_device->vkDevice().createPipelineLayout(pipelineLayoutCreateInfo);
-
-    std::vector<vk::Format> colorAttachmentFormats;
     colorAttachmentFormats.reserve(desc.colorAttachmentPxFormats.size());
     for (PixelFormat pxf : desc.colorAttachmentPxFormats)
         colorAttachmentFormats.push_back(toVkFormat(pxf));
 
-    auto pipelineRenderingCreateInfo = vk::PipelineRenderingCreateInfo{}
+    pipelineRenderingCreateInfo = vk::PipelineRenderingCreateInfo{}
         .setColorAttachmentFormats(colorAttachmentFormats);
 
     if (desc.depthAttachmentPxFormat.has_value())
         pipelineRenderingCreateInfo.setDepthAttachmentFormat(toVkFormat(desc.depthAttachmentPxFormat.value()));
 
-    auto graphicsPipelineCreateInfo = vk::GraphicsPipelineCreateInfo()
+    creationFeedback = vk::PipelineCreationFeedback{};
+    creationFeedbackCreateInfo = vk::PipelineCreationFeedbackCreateInfo{}
+        .setPPipelineCreationFeedback(&creationFeedback);
+    if (withCreationFeedback)
+        pipelineRenderingCreateInfo.setPNext(&creationFeedbackCreateInfo);
+
+    graphicsPipelineCreateInfo = vk::GraphicsPipelineCreateInfo()
         .setStages(shaderStages)
         .setPVertexInputState(&vertexInputStateCreateInfo)
         .setPInputAssemblyState(&inputAssemblyStateCreateInfo)
@@ -185,19 +213,90 @@ VulkanGraphicsPipeline::VulkanGraphicsPipeline(const VulkanDevice* device, const
         .setPDepthStencilState(&depthStencilStateCreateInfo)
         .setPColorBlendState(&colorBlendStateCreateInfo)
         .setPDynamicState(&dynamicStateCreateInfo)
-        .setLayout(m_pipelineLayout)
+        .setLayout(pipelineLayout)
         .setPNext(&pipelineRenderingCreateInfo);
+}
 
-    auto [result, pipelines] = m_device->vkDevice().createGraphicsPipelines(vk::PipelineCache{}, graphicsPipelineCreateInfo);
-    if (result != vk::Result::eSuccess)
+VulkanGraphicsPipeline::VulkanGraphicsPipeline(const VulkanDevice* device, const GraphicsPipeline::Descriptor& desc)
+    : m_device(device)
+{
+    m_pipelineLayout = sharedPipelineLayout(m_device, desc);
+    std::array<std::unique_ptr<CreateInfo>, 1> createInfos = { std::make_unique<CreateInfo>(desc, m_pipelineLayout, m_device->pipelineCache().hasCreationFeedback()) };
+    m_vkPipeline = newVkPipelines(m_device, createInfos).front();
+}
+
+std::vector<std::unique_ptr<VulkanGraphicsPipeline>> VulkanGraphicsPipeline::newGraphicsPipelines(const VulkanDevice* device, std::span<const GraphicsPipeline::Descriptor> descs)
+{
+    const bool withCreationFeedback = device->pipelineCache().hasCreationFeedback();
+
+    std::vector<vk::PipelineLayout> pipelineLayouts;
+    std::vector<std::unique_ptr<CreateInfo>> createInfos;
+    pipelineLayouts.reserve(descs.size());
+    createInfos.reserve(descs.size());
+
+    for (const auto& desc : descs) {
+        pipelineLayouts.push_back(sharedPipelineLayout(device, desc));
+        createInfos.push_back(std::make_unique<CreateInfo>(desc, pipelineLayouts.back(), withCreationFeedback));
+    }
+    std::vector<vk::Pipeline> vkPipelines = newVkPipelines(device, createInfos);
+
+    std::vector<std::unique_ptr<VulkanGraphicsPipeline>> pipelines;
+    pipelines.reserve(descs.size());
+    for (size_t i = 0; i < descs.size(); i++)
+        pipelines.push_back(std::unique_ptr<VulkanGraphicsPipeline>(new VulkanGraphicsPipeline(device, pipelineLayouts[i], vkPipelines[i])));
+    return pipelines;
+}
+
+VulkanGraphicsPipeline::VulkanGraphicsPipeline(const VulkanDevice* device, vk::PipelineLayout pipelineLayout, vk::Pipeline vkPipeline)
+    : m_device(device), m_pipelineLayout(pipelineLayout), m_vkPipeline(vkPipeline)
+{
+}
+
+vk::PipelineLayout VulkanGraphicsPipeline::sharedPipelineLayout(const VulkanDevice* device, const GraphicsPipeline::Descriptor& desc)
+{
+    std::vector<vk::DescriptorSetLayout> descriptorSetLayouts;
+    descriptorSetLayouts.reserve(desc.parameterBlockLayouts.size());
+    for (const auto& pbl : desc.parameterBlockLayouts | std::views::transform([](const auto& aPbl) { return std::dynamic_pointer_cast<VulkanParameterBlockLayout>(aPbl); })) {
+        assert(pbl);
+        descriptorSetLayouts.push_back(pbl->vkDescriptorSetLayout());
+    }
+    return device->objectCache().pipelineLayout(descriptorSetLayouts);
+}
+
+std::vector<vk::Pipeline> VulkanGraphicsPipeline::newVkPipelines(const VulkanDevice* device, std::span<const std::unique_ptr<CreateInfo>> createInfos)
+{
+    PipelineCache& pipelineCache = device->pipelineCache();
+
+    if (device->hasVertexAttributeDivisor() == false && std::ranges::any_of(createInfos, [](const auto& createInfo) { return createInfo->vertexInputBindingDivisors.empty() == false; }))
+        throw std::runtime_error("vertex step rate other than 1 is not supported by the device");
+
+    std::vector<vk::GraphicsPipelineCreateInfo> graphicsPipelineCreateInfos;
+    graphicsPipelineCreateInfos.reserve(createInfos.size());
+    for (const auto& createInfo : createInfos)
+        graphicsPipelineCreateInfos.push_back(createInfo->graphicsPipelineCreateInfo);
+
+    const auto start = std::chrono::steady_clock::now();
+    auto [result, pipelines] = device->vkDevice().createGraphicsPipelines(pipelineCache.vkPipelineCache(), graphicsPipelineCreateInfos);
+    const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    if (result != vk::Result::eSuccess) {
+        for (auto& pipeline : pipelines)
+            device->vkDevice().destroyPipeline(pipeline);
         throw std::runtime_error("failed to create the GraphicsPipeline");
-    m_vkPipeline = std::move(pipelines.front());
+    }
+
+    // the driver can compile a batch in parallel, the time of the call is shared between the pipelines
+    for (const auto& createInfo : createInfos) {
+        const vk::PipelineCreationFeedback& feedback = createInfo->creationFeedback;
+        const bool cacheHit = (feedback.flags & vk::PipelineCreationFeedbackFlagBits::eValid)
+            && (feedback.flags & vk::PipelineCreationFeedbackFlagBits::eApplicationPipelineCacheHit);
+        pipelineCache.recordCreation(cacheHit, duration / static_cast<int64_t>(createInfos.size()));
+    }
+    return pipelines;
 }
 
 VulkanGraphicsPipeline::~VulkanGraphicsPipeline()
 {
-    m_device->vkDevice().destroyPipeline(m_vkPipeline);
-    m_device->vkDevice().destroyPipelineLayout(m_pipelineLayout);
+    m_device->retire(m_vkPipeline);
 }
 
 }
@@ -26,16 +26,28 @@ public:
 
     VulkanGraphicsPipeline(const VulkanDevice*, const GraphicsPipeline::Descriptor&);
 
+    // all the pipelines are created with a single createGraphicsPipelines call
+    static std::vector<std::unique_ptr<VulkanGraphicsPipeline>> newGraphicsPipelines(const VulkanDevice*, std::span<const GraphicsPipeline::Descriptor>);
+
+    // pipelines with equivalent parameter block layouts share the same vk::PipelineLayout, owned by the device
+    static vk::PipelineLayout sharedPipelineLayout(const VulkanDevice*, const GraphicsPipeline::Descriptor&);
+
     inline const vk::Pipeline& vkPipeline() const { return m_vkPipeline; }
     inline const vk::PipelineLayout& pipelineLayout() const { return m_pipelineLayout; }
 
     ~VulkanGraphicsPipeline() override;
 
 private:
+    struct CreateInfo;
+
     const VulkanDevice* const m_device;
     vk::PipelineLayout m_pipelineLayout;
     vk::Pipeline m_vkPipeline;
 
+    VulkanGraphicsPipeline(const VulkanDevice*, vk::PipelineLayout, vk::Pipeline);
+
+    static std::vector<vk::Pipeline> newVkPipelines(const VulkanDevice*, std::span<const std::unique_ptr<CreateInfo>>);
+
 public:
     VulkanGraphicsPipeline& operator=(const VulkanGraphicsPipeline&) = delete;
     VulkanGraphicsPipeline& operator=(VulkanGraphicsPipeline&&) = delete;
@@ -45,14 +45,16 @@ VulkanParameterBlock::VulkanParameterBlock(const VulkanDevice* device, const std
     }
 }
 
-void VulkanParameterBlock::setBinding(uint32_t idx, const std::shared_ptr<Buffer>& aBuffer)
+void VulkanParameterBlock::setBinding(uint32_t idx, const std::shared_ptr<Buffer>& aBuffer, size_t offset, size_t size)
 {
     auto buffer = std::dynamic_pointer_cast<VulkanBuffer>(aBuffer);
+    assert(buffer);
+    assert(offset + size <= buffer->size());
 
     auto bufferDescriptorInfo = vk::DescriptorBufferInfo{}
         .setBuffer(buffer->vkBuffer())
-        .setOffset(0)
-        .setRange(vk::WholeSize);
+        .setOffset(offset)
+        .setRange(size);
 
     auto writeDescriptorSet = vk::WriteDescriptorSet{}
         .setDstSet(m_descriptorSet)
@@ -64,9 +66,11 @@ void VulkanParameterBlock::setBinding(uint32_t idx, const std::shared_ptr<Buffer
 
     m_device->vkDevice().updateDescriptorSets(writeDescriptorSet, {});
     auto& usedBuffers = m_usedBuffers.at(idx);
-    usedBuffers.insert_or_assign(0, UsedResource<VulkanBuffer>{
+    usedBuffers.insert_or_assign(0, UsedBuffer{
         .resource = buffer,
-        .binding = m_layout->bindings().at(idx)
+        .binding = m_layout->bindings().at(idx),
+        .offset = offset,
+        .size = size
     });
 }
 
@@ -82,8 +86,11 @@ void VulkanParameterBlock::setBinding(uint32_t idx, uint32_t arrayIndex, const s
 
 void VulkanParameterBlock::setBinding(uint32_t idx, uint32_t firstArrayIndex, std::span<const std::shared_ptr<Texture>> textures)
 {
-    assert(m_layout->bindings().at(idx).type == BindingType::sampledTexture);
+    const BindingType bindingType = m_layout->bindings().at(idx).type;
+    assert(bindingType == BindingType::sampledTexture || bindingType == BindingType::storageTexture);
     assert(firstArrayIndex + textures.size() <= m_layout->bindings().at(idx).count);
+    // storage images are read and written in the general layout, see VulkanCommandBuffer::syncParameterBlockUse
+    const vk::ImageLayout imageLayout = bindingType == BindingType::storageTexture ? vk::ImageLayout::eGeneral : vk::ImageLayout::eShaderReadOnlyOptimal;
 
     std::vector<vk::DescriptorImageInfo> descriptorImageInfos;
     descriptorImageInfos.reserve(textures.size());
@@ -92,10 +99,11 @@ void VulkanParameterBlock::setBinding(uint32_t idx, uint32_t firstArrayIndex, st
     for (uint32_t i = 0; const auto& texturePtr : textures) {
         auto texture = std::dynamic_pointer_cast<VulkanTexture>(texturePtr);
         assert(texture);
+        assert(bindingType != BindingType::storageTexture || (texture->usages() & TextureUsage::shaderWrite));
 
         descriptorImageInfos.push_back(vk::DescriptorImageInfo{}
             .setImageView(texture->vkImageView())
-            .setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal));
+            .setImageLayout(imageLayout));
         usedTextures.insert_or_assign(firstArrayIndex + i, UsedResource<VulkanTexture>{
             .resource = texture,
             .binding = m_layout->bindings().at(idx)
@@ -108,7 +116,7 @@ void VulkanParameterBlock::setBinding(uint32_t idx, uint32_t firstArrayIndex, st
         .setDstBinding(idx)
         .setDstArrayElement(firstArrayIndex)
         .setDescriptorCount(static_cast<uint32_t>(descriptorImageInfos.size()))
-        .setDescriptorType(vk::DescriptorType::eSampledImage)
+        .setDescriptorType(toVkDescriptorType(bindingType))
         .setImageInfo(descriptorImageInfos);
 
     m_device->vkDevice().updateDescriptorSets(writeDescriptorSet, {});
@@ -147,7 +155,7 @@ void VulkanParameterBlock::clearBinding(uint32_t idx, uint32_t firstArrayIndex,
     assert(count > 0);
     assert(firstArrayIndex + count <= m_layout->bindings().at(idx).count);
 
-    auto eraseBindingRange = [firstArrayIndex, count]<typename T>(std::unordered_map<uint32_t, UsedResource<T>>& resources) {
+    auto eraseBindingRange = [firstArrayIndex, count]<typename T>(std::unordered_map<uint32_t, T>& resources) {
         std::erase_if(resources, [firstArrayIndex, count](const auto& entry) {
             return entry.first >= firstArrayIndex &&
                 entry.first < firstArrayIndex + count;
@@ -161,6 +169,7 @@ void VulkanParameterBlock::clearBinding(uint32_t idx, uint32_t firstArrayIndex,
         eraseBindingRange(m_usedBuffers.at(idx));
         break;
     case BindingType::sampledTexture:
+    case BindingType::storageTexture:
         eraseBindingRange(m_usedTextures.at(idx));
         break;
     case BindingType::sampler:
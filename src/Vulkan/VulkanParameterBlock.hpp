@@ -37,6 +37,14 @@ public:
         ParameterBlockBinding binding;
     };
 
+    struct UsedBuffer
+    {
+        std::shared_ptr<VulkanBuffer> resource;
+        ParameterBlockBinding binding;
+        vk::DeviceSize offset = 0;
+        vk::DeviceSize size = vk::WholeSize; // bound range
+    };
+
 public:
     VulkanParameterBlock() = default;
     VulkanParameterBlock(const VulkanParameterBlock&) = delete;
@@ -46,7 +54,8 @@ public:
 
     inline std::shared_ptr<ParameterBlockLayout> layout() const override { return m_layout; }
 
-    void setBinding(uint32_t idx, const std::shared_ptr<Buffer>&) override;
+    using ParameterBlock::setBinding;
+    void setBinding(uint32_t idx, const std::shared_ptr<Buffer>&, size_t offset, size_t size) override;
 
     void setBinding(uint32_t idx, const std::shared_ptr<Texture>&) override;
     void setBinding(uint32_t idx, uint32_t arrayIndex, const std::shared_ptr<Texture>&) override;
@@ -72,7 +81,7 @@ private:
 
     vk::DescriptorSet m_descriptorSet;
 
-    std::vector<std::unordered_map<uint32_t, UsedResource<VulkanBuffer>>> m_usedBuffers;
+    std::vector<std::unordered_map<uint32_t, UsedBuffer>> m_usedBuffers;
     std::vector<std::unordered_map<uint32_t, UsedResource<VulkanTexture>>> m_usedTextures;
     std::vector<std::unordered_map<uint32_t, UsedResource<VulkanSampler>>> m_usedSamplers;
 
@@ -8,11 +8,8 @@
  */
 
 #include "Vulkan/VulkanParameterBlockLayout.hpp"
-#include "Graphics/Enums.hpp"
-#include "Vulkan/VulkanEnums.hpp"
 #include "Vulkan/VulkanDevice.hpp"
 
-#include <algorithm>
 #include <cassert>
 
 namespace gfx
@@ -23,43 +20,7 @@ VulkanParameterBlockLayout::VulkanParameterBlockLayout(const VulkanDevice* devic
 {
     assert(m_device);
 
-    std::vector<vk::DescriptorSetLayoutBinding> vkBindings;
-    std::vector<vk::DescriptorBindingFlags> bindingFlags;
-    vkBindings.reserve(desc.bindings.size());
-    bindingFlags.reserve(desc.bindings.size());
-
-    for (uint32_t i = 0; const auto& binding : desc.bindings) {
-        assert(binding.count > 0);
-        assert(binding.type == BindingType::sampledTexture || binding.count == 1);
-
-        vkBindings.push_back(vk::DescriptorSetLayoutBinding{}
-            .setBinding(i++)
-            .setDescriptorType(toVkDescriptorType(binding.type))
-            .setDescriptorCount(binding.count)
-            .setStageFlags(toVkShaderStageFlags(binding.usages)));
-
-        if (binding.count > 1)
-            bindingFlags.push_back(vk::DescriptorBindingFlagBits::eUpdateAfterBind | vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending | vk::DescriptorBindingFlagBits::ePartiallyBound);
-        else
-            bindingFlags.emplace_back();
-    }
-
-    auto bindingFlagsCreateInfo = vk::DescriptorSetLayoutBindingFlagsCreateInfo{}
-        .setBindingFlags(bindingFlags);
-
-    auto descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo{}
-        .setPNext(&bindingFlagsCreateInfo)
-        .setBindings(vkBindings);
-
-    if (std::ranges::any_of(bindingFlags, [](const vk::DescriptorBindingFlags& e) -> bool { return static_cast<bool>(e);}))
-        descriptorSetLayoutCreateInfo.setFlags(vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool);
-
-    m_vkDescriptorSetLayout = m_device->vkDevice().createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
-}
-
-VulkanParameterBlockLayout::~VulkanParameterBlockLayout()
-{
-    m_device->vkDevice().destroyDescriptorSetLayout(m_vkDescriptorSetLayout);
+    m_vkDescriptorSetLayout = m_device->objectCache().descriptorSetLayout(desc);
 }
 
 } // namespace gfx
@@ -27,9 +27,10 @@ public:
     VulkanParameterBlockLayout(const VulkanDevice*, const ParameterBlockLayout::Descriptor&);
 
     inline const std::vector<ParameterBlockBinding>& bindings() const override { return m_bindings; };
+    // shared by all the layouts created with the same bindings, owned by the device
     inline const vk::DescriptorSetLayout& vkDescriptorSetLayout() const { return m_vkDescriptorSetLayout; }
 
-    ~VulkanParameterBlockLayout() override;
+    ~VulkanParameterBlockLayout() override = default;
 
 private:
     const VulkanDevice* m_device;
@@ -40,7 +40,7 @@ VulkanParameterBlockPool::VulkanParameterBlockPool(const VulkanDevice* device, c
     m_descriptorPool = std::shared_ptr<vk::DescriptorPool>(
         new vk::DescriptorPool(m_device->vkDevice().createDescriptorPool(descriptorPoolCreateInfo)),
         [device=m_device](vk::DescriptorPool* pool){
-            device->vkDevice().destroyDescriptorPool(*pool);
+            device->retire(*pool);
             delete pool; // NOLINT(cppcoreguidelines-owning-memory)
         }
     );
@@ -40,7 +40,7 @@ VulkanSampler::VulkanSampler(const VulkanDevice* device, const Sampler::Descript
 
 VulkanSampler::~VulkanSampler()
 {
-    m_device->vkDevice().destroySampler(m_vkSampler);
+    m_device->retire(m_vkSampler);
 }
 
 }
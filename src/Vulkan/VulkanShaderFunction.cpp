@@ -12,8 +12,8 @@
 namespace gfx
 {
 
-VulkanShaderFunction::VulkanShaderFunction(const vk::ShaderModule* shaderModule, const std::string& name)
-    : m_shaderModule(shaderModule), m_name(name)
+VulkanShaderFunction::VulkanShaderFunction(const vk::ShaderModule* shaderModule, uint64_t shaderModuleId, const std::string& name)
+    : m_shaderModule(shaderModule), m_shaderModuleId(shaderModuleId), m_name(name)
 {
 }
 
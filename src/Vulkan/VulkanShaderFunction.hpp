@@ -22,15 +22,18 @@ public:
     VulkanShaderFunction(const VulkanShaderFunction&) = delete;
     VulkanShaderFunction(VulkanShaderFunction&&) = default;
 
-    VulkanShaderFunction(const vk::ShaderModule*, const std::string&);
+    VulkanShaderFunction(const vk::ShaderModule*, uint64_t shaderModuleId, const std::string&);
 
     const vk::ShaderModule& shaderModule(void) const { return *m_shaderModule; }
+    // identical SPIR-V share the same id, used to find equivalent pipelines
+    uint64_t shaderModuleId(void) const { return m_shaderModuleId; }
     const std::string& name(void) const { return m_name; }
 
     ~VulkanShaderFunction() = default;
 
 private:
     const vk::ShaderModule* m_shaderModule;
+    uint64_t m_shaderModuleId;
     std::string m_name;
 
 public:
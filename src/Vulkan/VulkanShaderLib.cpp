@@ -20,11 +20,7 @@ VulkanShaderLib::VulkanShaderLib(const VulkanDevice* device, const std::filesyst
     if (m_spirvBytes.empty())
         throw std::runtime_error("No SPIR-V shader found in the package");
 
-    auto shaderModuleCreateInfo = vk::ShaderModuleCreateInfo{}
-        .setCodeSize(m_spirvBytes.size())
-        .setPCode(std::bit_cast<const uint32_t*>(m_spirvBytes.data()));
-
-    m_vkShaderModule = m_device->vkDevice().createShaderModule(shaderModuleCreateInfo);
+    m_shaderModule = m_device->objectCache().shaderModule(m_spirvBytes);
 }
 
 VulkanShaderFunction& VulkanShaderLib::getFunction(const std::string& name)
@@ -32,7 +28,7 @@ VulkanShaderFunction& VulkanShaderLib::getFunction(const std::string& name)
     auto it = m_shaderFunctions.find(name);
     if (it == m_shaderFunctions.end())
     {
-        auto [newIt, res] = m_shaderFunctions.emplace(name, VulkanShaderFunction(&m_vkShaderModule, name));
+        auto [newIt, res] = m_shaderFunctions.emplace(name, VulkanShaderFunction(&m_shaderModule->vkShaderModule, m_shaderModule->id, name));
         assert(res);
         it = newIt;
     }
@@ -42,7 +38,6 @@ VulkanShaderFunction& VulkanShaderLib::getFunction(const std::string& name)
 VulkanShaderLib::~VulkanShaderLib()
 {
     m_shaderFunctions.clear();
-    m_device->vkDevice().destroyShaderModule(m_vkShaderModule);
 }
 
 } // namespace gfx
@@ -12,6 +12,7 @@
 
 #include "Graphics/ShaderLib.hpp"
 
+#include "Vulkan/ObjectCache.hpp"
 #include "Vulkan/VulkanShaderFunction.hpp"
 
 namespace gfx
@@ -34,7 +35,7 @@ public:
 
 private:
     const VulkanDevice* m_device;
-    vk::ShaderModule m_vkShaderModule;
+    std::shared_ptr<const ObjectCache::ShaderModule> m_shaderModule; // shared with the libs loaded from the same SPIR-V
 
     std::map<std::string, VulkanShaderFunction> m_shaderFunctions;
 
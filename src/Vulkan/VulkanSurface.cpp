@@ -57,6 +57,8 @@ const std::set<PresentMode> VulkanSurface::supportedPresentModes(const Device& _
         {
         case vk::PresentModeKHR::eFifo:
         case vk::PresentModeKHR::eMailbox:
+        case vk::PresentModeKHR::eImmediate:
+        case vk::PresentModeKHR::eFifoRelaxed:
             modes.insert(toPresentMode(mode));
         default:
             break;
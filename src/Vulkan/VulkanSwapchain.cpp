@@ -22,6 +22,19 @@
 namespace gfx
 {
 
+namespace
+{
+
+// nanoseconds::max is the infinite timeout, UINT64_MAX for vulkan
+uint64_t toVkTimeout(std::chrono::nanoseconds timeout)
+{
+    if (timeout == std::chrono::nanoseconds::max())
+        return std::numeric_limits<uint64_t>::max();
+    return static_cast<uint64_t>(std::max<int64_t>(timeout.count(), 0));
+}
+
+}
+
 VulkanSwapchain::VulkanSwapchain(const VulkanDevice* device, const Descriptor& desc) : m_device(device)
 {
     assert(desc.surface);
@@ -49,6 +62,11 @@ VulkanSwapchain::VulkanSwapchain(const VulkanDevice* device, const Descriptor& d
     }
 
 
+    // the drawables can be copied for screenshots when the surface allow it
+    TextureUsages swapchainImageUsages = TextureUsage::colorAttachment;
+    if (surfaceCapabilities.supportedUsageFlags & vk::ImageUsageFlagBits::eTransferSrc)
+        swapchainImageUsages |= TextureUsage::copySource;
+
     auto swapchainCreateInfo = vk::SwapchainCreateInfoKHR{}
         .setSurface(vkSurface)
         .setMinImageCount(desc.imageCount)
@@ -56,30 +74,25 @@ VulkanSwapchain::VulkanSwapchain(const VulkanDevice* device, const Descriptor& d
         .setImageColorSpace(toVkColorSpaceKHR(desc.pixelFormat))
         .setImageExtent(extent)
         .setImageArrayLayers(1)
-        .setImageUsage(vk::ImageUsageFlagBits::eColorAttachment)
+        .setImageUsage(toVkImageUsageFlags(swapchainImageUsages))
         .setPreTransform(surfaceCapabilities.currentTransform)
         .setPresentMode(toVkPresentModeKHR(desc.presentMode))
         .setClipped(vk::True);
 
-    static std::map<const vk::SurfaceKHR*, vk::SwapchainKHR> s_oldSwapchains;
-    if (s_oldSwapchains.contains(&vkSurface))
-        swapchainCreateInfo.setOldSwapchain(s_oldSwapchains[&vkSurface]);
-
-    auto vkSwapchain = m_device->vkDevice().createSwapchainKHR(swapchainCreateInfo);
+    // released once the last image is destroyed, the images can outlive the swapchain in the submitted command buffers
     auto vkSwapchainPtr = std::shared_ptr<vk::SwapchainKHR>(
-        new vk::SwapchainKHR(std::move(vkSwapchain)),
-        [device=m_device](vk::SwapchainKHR* ptr){
-            device->vkDevice().destroySwapchainKHR(*ptr);
+        new vk::SwapchainKHR(m_device->newVkSwapchain(swapchainCreateInfo)),
+        [device=m_device, vkSurface](vk::SwapchainKHR* ptr){
+            device->releaseVkSwapchain(vkSurface, *ptr);
             delete ptr; // NOLINT
         }
     );
     m_vkSwapchain = vkSwapchainPtr.get();
-    s_oldSwapchains[&vkSurface] = *m_vkSwapchain;
 
     m_swapchainImagesDescriptor = {
         .width = extent.width, .height = extent.height,
         .pixelFormat = desc.pixelFormat,
-        .usages = TextureUsage::colorAttachment,
+        .usages = swapchainImageUsages,
         .storageMode = ResourceStorageMode::deviceLocal
     };
 
@@ -87,33 +100,121 @@ VulkanSwapchain::VulkanSwapchain(const VulkanDevice* device, const Descriptor& d
         | std::views::transform([&](vk::Image& vkImage) { return std::make_shared<SwapchainImage>(m_device, std::move(vkImage), vkSwapchainPtr, m_swapchainImagesDescriptor); })
         | std::ranges::to<std::vector>();
 
+    m_presentTracker = std::make_shared<PresentTracker>();
     m_drawables.resize(desc.drawableCount);
     for (auto& drawable : m_drawables)
-        drawable = std::make_shared<VulkanDrawable>(m_device);
+        drawable = std::make_shared<VulkanDrawable>(m_device, m_presentTracker);
 }
 
-std::shared_ptr<Drawable> VulkanSwapchain::nextDrawable()
+std::shared_ptr<Drawable> VulkanSwapchain::nextDrawable(std::chrono::nanoseconds timeout)
 {
     ZoneScoped;
-    std::shared_ptr<VulkanDrawable> drawable = m_drawables.at(m_nextDrawableIndex);
+    pollPresents();
 
-    uint64_t timeout = std::numeric_limits<uint64_t>::max();
+    std::shared_ptr<VulkanDrawable> drawable = m_drawables.at(m_nextDrawableIndex);
     auto& semaphore = drawable->imageAvailableSemaphore();
 
-    auto [result, value] = m_device->vkDevice().acquireNextImageKHR(*m_vkSwapchain, timeout, semaphore, nullptr);
+    const auto acquireStart = std::chrono::steady_clock::now();
+    vk::ResultValue<uint32_t> acquireResult(vk::Result::eSuccess, 0);
+    try {
+        acquireResult = m_device->vkDevice().acquireNextImageKHR(*m_vkSwapchain, toVkTimeout(timeout), semaphore, nullptr);
+    }
+    catch (const vk::OutOfDateKHRError&) {
+        acquireResult.result = vk::Result::eErrorOutOfDateKHR;
+    }
+    m_lastAcquireDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - acquireStart);
 
-    switch (result)
+    switch (acquireResult.result)
     {
     case vk::Result::eSuccess:
-        drawable->setSwapchainImage(m_swapchainImages[value], value);
+        drawable->setSwapchainImage(m_swapchainImages[acquireResult.value], acquireResult.value);
         m_nextDrawableIndex = (m_nextDrawableIndex + 1) % m_drawables.size();
         return drawable;
+    case vk::Result::eTimeout:
+    case vk::Result::eNotReady:
+        return nullptr;
     case vk::Result::eSuboptimalKHR:
     case vk::Result::eErrorOutOfDateKHR:
+        m_presentTracker->setOutOfDate();
         return nullptr;
     default:
         throw std::runtime_error("Failed to acquire swapchain image!");
     }
 }
 
+bool VulkanSwapchain::waitPresents(uint32_t maxPendingPresents, std::chrono::nanoseconds timeout)
+{
+    ZoneScoped;
+    const uint64_t lastQueuedId = m_presentTracker->lastQueuedId();
+    if (lastQueuedId <= maxPendingPresents)
+        return true;
+    const uint64_t waitedId = lastQueuedId - maxPendingPresents;
+    if (m_presentTracker->lastCompletedId() >= waitedId)
+        return true;
+
+    if (m_device->supportsPresentWait())
+    {
+        // the present is already queued, it cannot be waiting for the lock
+        vk::Result result = vk::Result::eSuccess;
+        try {
+            std::scoped_lock lock(m_presentTracker->swapchainMtx());
+            result = m_device->vkDevice().waitForPresentKHR(*m_vkSwapchain, waitedId, toVkTimeout(timeout));
+        }
+        catch (const vk::OutOfDateKHRError&) {
+            result = vk::Result::eErrorOutOfDateKHR;
+        }
+        if (result == vk::Result::eTimeout)
+            return false;
+        if (result == vk::Result::eErrorOutOfDateKHR)
+            m_presentTracker->setOutOfDate(); // the presents will never be displayed
+        m_presentTracker->setCompleted(waitedId, result != vk::Result::eErrorOutOfDateKHR);
+        return true;
+    }
+
+    if (m_device->waitPresentedTimelineValue(m_presentTracker->timelineValue(waitedId), timeout) == false)
+        return false;
+    m_presentTracker->setCompleted(waitedId, false);
+    return true;
+}
+
+Swapchain::FrameStatistics VulkanSwapchain::frameStatistics() const
+{
+    return FrameStatistics{
+        .acquireDuration = m_lastAcquireDuration,
+        .presentToDisplayDuration = m_presentTracker->lastPresentToDisplayDuration(),
+        .queueDepth = m_presentTracker->pendingCount()
+    };
+}
+
+void VulkanSwapchain::pollPresents()
+{
+    const uint64_t lastQueuedId = m_presentTracker->lastQueuedId();
+    uint64_t presentId = m_presentTracker->lastCompletedId() + 1;
+
+    if (m_device->supportsPresentWait())
+    {
+        // presents are displayed in order, the first one not displayed yet stop the loop
+        std::scoped_lock lock(m_presentTracker->swapchainMtx());
+        for (; presentId <= lastQueuedId; presentId++) {
+            vk::Result result = vk::Result::eSuccess;
+            try {
+                result = m_device->vkDevice().waitForPresentKHR(*m_vkSwapchain, presentId, 0);
+            }
+            catch (const vk::OutOfDateKHRError&) {
+                m_presentTracker->setOutOfDate();
+                return;
+            }
+            if (result == vk::Result::eTimeout)
+                return;
+            m_presentTracker->setCompleted(presentId, true);
+        }
+        return;
+    }
+
+    for (; presentId <= lastQueuedId; presentId++) {
+        if (m_device->isCompleted(SubmitTicket{ .value = m_presentTracker->timelineValue(presentId), .queueType = QueueType::graphics }) == false)
+            return;
+        m_presentTracker->setCompleted(presentId, false);
+    }
+}
 } // namespace gfx
@@ -13,6 +13,7 @@
 #include "Graphics/Swapchain.hpp"
 #include "Graphics/Drawable.hpp"
 
+#include "Vulkan/PresentTracker.hpp"
 #include "Vulkan/SwapchainImage.hpp"
 #include "Vulkan/VulkanDrawable.hpp"
 #include <vector>
@@ -33,10 +34,22 @@ public:
 
     inline const Texture::Descriptor& drawablesTextureDescriptor() const override { return m_swapchainImagesDescriptor; }
 
-    std::shared_ptr<Drawable> nextDrawable() override;
+    using Swapchain::nextDrawable;
+    std::shared_ptr<Drawable> nextDrawable(std::chrono::nanoseconds timeout) override;
+
+    inline bool isOutOfDate() const override { return m_presentTracker->isOutOfDate(); }
+
+    using Swapchain::waitPresents;
+    bool waitPresents(uint32_t maxPendingPresents, std::chrono::nanoseconds timeout) override;
+
+    FrameStatistics frameStatistics() const override;
 
     ~VulkanSwapchain() override = default;
 
+private:
+    // complete the presents already displayed (or rendered) without blocking
+    void pollPresents();
+
 private:
     const VulkanDevice* m_device;
     Texture::Descriptor m_swapchainImagesDescriptor;
@@ -46,6 +59,9 @@ private:
     std::vector<std::shared_ptr<VulkanDrawable>> m_drawables;
     uint32_t m_nextDrawableIndex = 0;
 
+    std::shared_ptr<PresentTracker> m_presentTracker;
+    std::chrono::nanoseconds m_lastAcquireDuration{0};
+
 public:
     VulkanSwapchain& operator=(const VulkanSwapchain&) = delete;
     VulkanSwapchain& operator=(VulkanSwapchain&&) = delete;
@@ -50,6 +50,9 @@ VulkanTexture::VulkanTexture(const VulkanDevice* device, vk::Image&& vkImage, co
         .setSubresourceRange(m_subresourceRange);
 
     m_vkImageView = m_device->vkDevice().createImageView(imageViewCreateInfo);
+
+    m_syncState = newImageSyncState(m_subresourceRange.levelCount, m_subresourceRange.layerCount);
+    m_slot = m_device->resourceSlotAllocator().allocate();
 }
 
 VulkanTexture::VulkanTexture(const VulkanDevice* device, const Texture::Descriptor& desc)
@@ -60,6 +63,7 @@ VulkanTexture::VulkanTexture(const VulkanDevice* device, const Texture::Descript
       m_usages(desc.usages),
       m_storageMode(desc.storageMode)
 {
+    assert(desc.storageMode != ResourceStorageMode::readback); // textures are read back through a buffer
     VmaAllocationCreateInfo allocationCreateInfo = { .usage = VMA_MEMORY_USAGE_AUTO, };
     if (desc.storageMode == ResourceStorageMode::hostVisible)
         allocationCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
@@ -77,7 +81,7 @@ VulkanTexture::VulkanTexture(const VulkanDevice* device, const Texture::Descript
         .setSamples(vk::SampleCountFlagBits::e1)
         .setTiling(vk::ImageTiling::eOptimal)
         .setUsage(toVkImageUsageFlags(desc.usages))
-        .setSharingMode(vk::SharingMode::eExclusive)
+        .setSharingMode(vk::SharingMode::eExclusive) // the device transfer the ownership when an other queue family use it
         .setInitialLayout(vk::ImageLayout::eUndefined);
 
     VkImage image = VK_NULL_HANDLE;
@@ -103,6 +107,9 @@ VulkanTexture::VulkanTexture(const VulkanDevice* device, const Texture::Descript
         .setSubresourceRange(m_subresourceRange);
 
     m_vkImageView = m_device->vkDevice().createImageView(imageViewCreateInfo);
+
+    m_syncState = newImageSyncState(m_subresourceRange.levelCount, m_subresourceRange.layerCount);
+    m_slot = m_device->resourceSlotAllocator().allocate();
 }
 
 #if defined (GFX_IMGUI_ENABLED)
@@ -125,9 +132,9 @@ VulkanTexture::~VulkanTexture()
     if (m_imTextureId.has_value())
         ImGui_ImplVulkan_RemoveTexture(std::bit_cast<VkDescriptorSet>(*m_imTextureId));
 #endif
-    m_device->vkDevice().destroyImageView(m_vkImageView);
-    if (m_allocation != VK_NULL_HANDLE)
-        vmaDestroyImage(m_device->allocator(), m_vkImage, m_allocation);
+    // the swapchain images retire their view themselves, it must be destroyed before the swapchain they release
+    if (m_isSwapchainImage == false)
+        m_device->retire(RetirementQueue::Texture{ .vkImage = m_vkImage, .vkImageView = m_vkImageView, .allocation = m_allocation, .slot = m_slot });
 }
 
 } // namespace gfx
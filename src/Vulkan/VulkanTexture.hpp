@@ -15,6 +15,7 @@
 #include "Graphics/Sampler.hpp"
 
 #include "Vulkan/Sync.hpp"
+#include "Vulkan/ResourceSlot.hpp"
 #include "Vulkan/VulkanSampler.hpp"
 
 namespace gfx
@@ -51,6 +52,17 @@ public:
 
     inline ImageSyncState& syncState() { return m_syncState; }
 
+    // same as VulkanBuffer, a submit to an other queue than the last one wait for it
+    inline uint64_t lastSubmitTimelineValue() const { return m_lastSubmitTimelineValue; }
+    inline void setLastSubmitTimelineValue(uint64_t v) { m_lastSubmitTimelineValue = v; }
+    inline size_t lastSubmitQueueIndex() const { return m_lastSubmitQueueIndex; }
+    inline void setLastSubmitQueueIndex(size_t i) { m_lastSubmitQueueIndex = i; }
+
+    inline const ResourceSlot& slot() const { return m_slot; }
+
+    // allow the submit path to identify swapchain images without a dynamic cast
+    inline bool isSwapchainImage() const { return m_isSwapchainImage; }
+
     ~VulkanTexture() override;
 
 protected:
@@ -69,6 +81,10 @@ protected:
     vk::ImageView m_vkImageView;
 
     ImageSyncState m_syncState;
+    uint64_t m_lastSubmitTimelineValue = 0;
+    size_t m_lastSubmitQueueIndex = 0;
+    bool m_isSwapchainImage = false;
+    ResourceSlot m_slot;
 
 #if defined (GFX_IMGUI_ENABLED)
     std::optional<uint64_t> m_imTextureId;
@@ -0,0 +1,81 @@
+/*
+ * ---------------------------------------------------
+ * VulkanUploadRing.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 18:27:12
+ * ---------------------------------------------------
+ */
+
+#include "Graphics/UploadRing.hpp"
+#include "Graphics/Buffer.hpp"
+
+#include "Vulkan/VulkanUploadRing.hpp"
+#include "Vulkan/VulkanBuffer.hpp"
+#include "Vulkan/VulkanDevice.hpp"
+
+namespace gfx
+{
+
+VulkanUploadRing::VulkanUploadRing(const VulkanDevice* device, const UploadRing::Descriptor& desc)
+    : m_device(device), m_descriptor(desc)
+{
+    assert(m_device);
+    assert(m_descriptor.blockSize > 0);
+
+    m_blocks.push_back(newBlock(m_descriptor.blockSize));
+}
+
+BufferSlice VulkanUploadRing::allocate(size_t size, size_t alignment)
+{
+    assert(size > 0);
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    // cannot fit in any block, the slice get its own buffer
+    if (size > m_descriptor.blockSize)
+        return BufferSlice{ .buffer = newBlock(size), .offset = 0, .size = size };
+
+    size_t offset = (m_currentOffset + alignment - 1) & ~(alignment - 1);
+    if (offset + size > m_descriptor.blockSize)
+    {
+        // look for a free block, starting after the current one so the oldest blocks are tried first
+        size_t i = 1;
+        for (; i <= m_blocks.size(); i++) {
+            if (isReusable(m_blocks[(m_currentBlockIdx + i) % m_blocks.size()]))
+                break;
+        }
+        if (i <= m_blocks.size())
+            m_currentBlockIdx = (m_currentBlockIdx + i) % m_blocks.size();
+        else {
+            // every block is in use, the ring grow
+            m_currentBlockIdx++;
+            m_blocks.insert(std::next(m_blocks.begin(), static_cast<std::ptrdiff_t>(m_currentBlockIdx)), newBlock(m_descriptor.blockSize));
+        }
+        offset = 0;
+    }
+
+    m_currentOffset = offset + size;
+    return BufferSlice{ .buffer = m_blocks[m_currentBlockIdx], .offset = offset, .size = size };
+}
+
+bool VulkanUploadRing::isReusable(const std::shared_ptr<VulkanBuffer>& block)
+{
+    // slices and the command buffers recording them keep a reference to the block
+    if (block.use_count() > 1)
+        return false;
+    if (block->lastSubmitTimelineValue() <= m_completedTimelineValue)
+        return true;
+    m_completedTimelineValue = m_device->completedTimelineValue();
+    return block->lastSubmitTimelineValue() <= m_completedTimelineValue;
+}
+
+std::shared_ptr<VulkanBuffer> VulkanUploadRing::newBlock(size_t size) const
+{
+    return std::make_shared<VulkanBuffer>(m_device, Buffer::Descriptor{
+        .size = size,
+        .usages = m_descriptor.usages,
+        .storageMode = ResourceStorageMode::hostVisible
+    });
+}
+
+} // namespace gfx
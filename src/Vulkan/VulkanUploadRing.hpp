@@ -0,0 +1,60 @@
+/*
+ * ---------------------------------------------------
+ * VulkanUploadRing.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 18:21:37
+ * ---------------------------------------------------
+ */
+
+#ifndef VULKANUPLOADRING_HPP
+#define VULKANUPLOADRING_HPP
+
+#include "Graphics/UploadRing.hpp"
+#include "Graphics/Buffer.hpp"
+
+#include "Vulkan/VulkanBuffer.hpp"
+
+namespace gfx
+{
+
+class VulkanDevice;
+
+class VulkanUploadRing : public UploadRing
+{
+public:
+    VulkanUploadRing() = delete;
+    VulkanUploadRing(const VulkanUploadRing&) = delete;
+    VulkanUploadRing(VulkanUploadRing&&) = delete;
+
+    VulkanUploadRing(const VulkanDevice*, const UploadRing::Descriptor&);
+
+    BufferSlice allocate(size_t size, size_t alignment = defaultAlignment) override;
+
+    inline uint32_t blockCount() const override { return static_cast<uint32_t>(m_blocks.size()); }
+
+    ~VulkanUploadRing() override = default;
+
+private:
+    const VulkanDevice* m_device;
+    UploadRing::Descriptor m_descriptor;
+
+    std::vector<std::shared_ptr<VulkanBuffer>> m_blocks;
+    size_t m_currentBlockIdx = 0;
+    size_t m_currentOffset = 0;
+
+    // only refreshed when a block look busy, most checks do not query the semaphore
+    uint64_t m_completedTimelineValue = 0;
+
+    // the block is not referenced outside of the ring (no slice, no command buffer) and the gpu is done with it
+    bool isReusable(const std::shared_ptr<VulkanBuffer>&);
+    std::shared_ptr<VulkanBuffer> newBlock(size_t size) const;
+
+public:
+    VulkanUploadRing& operator=(const VulkanUploadRing&) = delete;
+    VulkanUploadRing& operator=(VulkanUploadRing&&) = delete;
+};
+
+} // namespace gfx
+
+#endif // VULKANUPLOADRING_HPP
@@ -0,0 +1,61 @@
+/*
+ * ---------------------------------------------------
+ * WorkerPool.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 16:11:20
+ * ---------------------------------------------------
+ */
+
+#include "Vulkan/WorkerPool.hpp"
+
+namespace gfx
+{
+
+WorkerPool::WorkerPool(uint32_t threadCount)
+{
+    assert(threadCount > 0);
+    m_threads.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; i++)
+        m_threads.emplace_back(&WorkerPool::workerLoop, this);
+}
+
+void WorkerPool::post(std::function<void()>&& task)
+{
+    {
+        std::scoped_lock lock(m_mtx);
+        assert(m_stop == false);
+        m_tasks.push_back(std::move(task));
+    }
+    m_cv.notify_one();
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::scoped_lock lock(m_mtx);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto& thread : m_threads)
+        thread.join();
+}
+
+void WorkerPool::workerLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(m_mtx);
+            m_cv.wait(lock, [this]{ return m_stop || m_tasks.empty() == false; });
+            if (m_tasks.empty())
+                return; // stopped and nothing left to run
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+
+} // namespace gfx
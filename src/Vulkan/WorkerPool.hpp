@@ -0,0 +1,50 @@
+/*
+ * ---------------------------------------------------
+ * WorkerPool.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * Date: 2026/10/17 16:05:37
+ * ---------------------------------------------------
+ */
+
+#ifndef WORKERPOOL_HPP
+#define WORKERPOOL_HPP
+
+namespace gfx
+{
+
+// fixed set of threads running tasks in submission order.
+// the destructor run the remaining tasks before joining the threads
+class WorkerPool
+{
+public:
+    WorkerPool() = delete;
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool(WorkerPool&&) = delete;
+
+    WorkerPool(uint32_t threadCount);
+
+    inline uint32_t threadCount() const { return static_cast<uint32_t>(m_threads.size()); }
+
+    void post(std::function<void()>&&);
+
+    ~WorkerPool();
+
+private:
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    std::deque<std::function<void()>> m_tasks;
+    bool m_stop = false;
+
+    void workerLoop();
+
+public:
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    WorkerPool& operator=(WorkerPool&&) = delete;
+};
+
+} // namespace gfx
+
+#endif // WORKERPOOL_HPP
@@ -32,6 +32,14 @@
 #include <ctime>      // IWYU pragma: keep
 #include <mutex>      // IWYU pragma: keep
 #include <numeric>    // IWYU pragma: keep
+#include <limits>     // IWYU pragma: keep
+#include <span>       // IWYU pragma: keep
+#include <thread>     // IWYU pragma: keep
+#include <condition_variable> // IWYU pragma: keep
+#include <future>     // IWYU pragma: keep
+#include <functional> // IWYU pragma: keep
+#include <atomic>     // IWYU pragma: keep
+#include <variant>    // IWYU pragma: keep
 
 #if defined(GFX_BUILD_METAL)
 #if defined(__OBJC__)
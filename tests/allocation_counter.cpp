@@ -0,0 +1,45 @@
+/*
+ * ---------------------------------------------------
+ * allocation_counter.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "allocation_counter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    thread_local std::size_t s_allocationCount = 0;
+}
+
+void* operator new(std::size_t size)
+{
+    ++s_allocationCount;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace gfx_test
+{
+
+std::size_t allocationCount()
+{
+    return s_allocationCount;
+}
+
+}
@@ -0,0 +1,22 @@
+/*
+ * ---------------------------------------------------
+ * allocation_counter.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#ifndef ALLOCATION_COUNTER_HPP
+#define ALLOCATION_COUNTER_HPP
+
+#include <cstddef>
+
+namespace gfx_test
+{
+
+// number of global operator new calls made by the current thread
+std::size_t allocationCount();
+
+} // namespace gfx_test
+
+#endif // ALLOCATION_COUNTER_HPP
@@ -0,0 +1,79 @@
+/*
+ * ---------------------------------------------------
+ * test_compute_queue.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "vulkan_device_test.hpp"
+
+#include "Graphics/Buffer.hpp"
+#include "Graphics/CommandBuffer.hpp"
+#include "Graphics/CommandBufferPool.hpp"
+#include "Graphics/Device.hpp"
+#include "Graphics/Enums.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace gfx_test
+{
+
+#if defined(GFX_BUILD_VULKAN)
+class compute_queue : public VulkanDeviceTest
+{
+protected:
+    compute_queue() : VulkanDeviceTest(gfx::Device::Descriptor{ .queueCaps = { .graphics = true, .compute = true, .transfer = false, .present = {} }, .asyncCompute = true }) {}
+};
+
+// the copy recorded on the compute pool must be complete before the graphics one read its destination,
+// whether the device has a second queue or the compute pool fall back to the graphics queue
+TEST_F(compute_queue, vulkan_writes_are_visible_to_graphics)
+{
+    std::unique_ptr<gfx::CommandBufferPool> computeCommandBufferPool = device->newCommandBufferPool(gfx::QueueType::compute);
+    std::unique_ptr<gfx::CommandBufferPool> graphicsCommandBufferPool = device->newCommandBufferPool(gfx::QueueType::graphics);
+
+    constexpr std::size_t valueCount = 64;
+    std::shared_ptr<gfx::Buffer> srcBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = valueCount * sizeof(uint32_t),
+        .usages = gfx::BufferUsage::copySource,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+    std::shared_ptr<gfx::Buffer> intermediateBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = valueCount * sizeof(uint32_t),
+        .usages = gfx::BufferUsage::copySource | gfx::BufferUsage::copyDestination,
+        .storageMode = gfx::ResourceStorageMode::deviceLocal
+    });
+    std::shared_ptr<gfx::Buffer> dstBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = valueCount * sizeof(uint32_t),
+        .usages = gfx::BufferUsage::copyDestination,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+    for (uint32_t i = 0; i < valueCount; i++)
+        srcBuffer->content<uint32_t>()[i] = i * 3 + 1;
+
+    std::shared_ptr<gfx::CommandBuffer> computeCommandBuffer = computeCommandBufferPool->get();
+    computeCommandBuffer->beginBlitPass();
+    computeCommandBuffer->copyBufferToBuffer(srcBuffer, intermediateBuffer, srcBuffer->size());
+    computeCommandBuffer->endBlitPass();
+
+    std::shared_ptr<gfx::CommandBuffer> graphicsCommandBuffer = graphicsCommandBufferPool->get();
+    graphicsCommandBuffer->beginBlitPass();
+    graphicsCommandBuffer->copyBufferToBuffer(intermediateBuffer, dstBuffer, intermediateBuffer->size());
+    graphicsCommandBuffer->endBlitPass();
+
+    device->submitCommandBuffers({ computeCommandBuffer, graphicsCommandBuffer });
+    device->waitCommandBuffer(*graphicsCommandBuffer);
+
+    for (uint32_t i = 0; i < valueCount; i++)
+        EXPECT_EQ(dstBuffer->content<uint32_t>()[i], i * 3 + 1);
+
+    device->waitIdle();
+}
+#endif
+
+}
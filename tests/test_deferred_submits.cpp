@@ -0,0 +1,92 @@
+/*
+ * ---------------------------------------------------
+ * test_deferred_submits.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "vulkan_device_test.hpp"
+
+#include "Graphics/Buffer.hpp"
+#include "Graphics/CommandBuffer.hpp"
+#include "Graphics/CommandBufferPool.hpp"
+#include "Graphics/Device.hpp"
+#include "Graphics/Enums.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace gfx_test
+{
+
+#if defined(GFX_BUILD_VULKAN)
+class deferred_submits : public VulkanDeviceTest
+{
+protected:
+    deferred_submits() : VulkanDeviceTest(gfx::Device::Descriptor{
+        .queueCaps = { .graphics = true, .compute = false, .transfer = false, .present = {} },
+        .deferredSubmits = true
+    }) {}
+};
+
+// the barriers of the resources not used earlier in the batch share the prologue, the others are recorded at the end of the previous command buffer
+TEST_F(deferred_submits, vulkan_coalesced)
+{
+    std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = device->newCommandBufferPool();
+
+    std::shared_ptr<gfx::Buffer> srcBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = sizeof(uint32_t),
+        .usages = gfx::BufferUsage::copySource,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+    std::vector<std::shared_ptr<gfx::Buffer>> dstBuffers;
+    for (int i = 0; i < 3; i++) {
+        dstBuffers.push_back(device->newBuffer(gfx::Buffer::Descriptor{
+            .size = sizeof(uint32_t),
+            .usages = gfx::BufferUsage::copyDestination,
+            .storageMode = gfx::ResourceStorageMode::hostVisible
+        }));
+    }
+
+    auto recordCopy = [&](const std::shared_ptr<gfx::Buffer>& dstBuffer) {
+        std::shared_ptr<gfx::CommandBuffer> commandBuffer = commandBufferPool->get();
+        commandBuffer->beginBlitPass();
+        commandBuffer->copyBufferToBuffer(srcBuffer, dstBuffer, sizeof(uint32_t));
+        commandBuffer->endBlitPass();
+        return commandBuffer;
+    };
+
+    *srcBuffer->content<uint32_t>() = 1;
+    std::vector<std::shared_ptr<gfx::CommandBuffer>> firstFrame = { recordCopy(dstBuffers[0]), recordCopy(dstBuffers[1]), recordCopy(dstBuffers[2]) };
+    device->submitCommandBuffers(firstFrame);
+    EXPECT_EQ(device->submitStatistics().submitCount, 0u); // not flushed yet
+    device->waitCommandBuffer(*firstFrame.back()); // flush the pending batches
+    EXPECT_EQ(device->submitStatistics().submitCount, 1u);
+    for (auto& dstBuffer : dstBuffers)
+        EXPECT_EQ(*dstBuffer->content<uint32_t>(), 1u);
+
+    *srcBuffer->content<uint32_t>() = 2;
+    std::vector<std::shared_ptr<gfx::CommandBuffer>> secondFrame = { recordCopy(dstBuffers[0]), recordCopy(dstBuffers[1]), recordCopy(dstBuffers[2]), recordCopy(dstBuffers[0]) };
+    device->submitCommandBuffers(secondFrame);
+
+    EXPECT_EQ(secondFrame[0]->statistics(), (gfx::CommandBuffer::Statistics{ .barrierCount = 1, .barrierBatchCount = 1 }));
+    EXPECT_EQ(secondFrame[1]->statistics(), (gfx::CommandBuffer::Statistics{ .barrierCount = 1, .barrierBatchCount = 0 }));
+    EXPECT_EQ(secondFrame[2]->statistics(), (gfx::CommandBuffer::Statistics{ .barrierCount = 1, .barrierBatchCount = 0 }));
+    EXPECT_EQ(secondFrame[3]->statistics(), (gfx::CommandBuffer::Statistics{ .barrierCount = 1, .barrierBatchCount = 1 }));
+
+    device->flushSubmits();
+    device->waitCommandBuffer(*secondFrame.back());
+    EXPECT_EQ(device->submitStatistics().submitCount, 2u);
+    for (auto& dstBuffer : dstBuffers)
+        EXPECT_EQ(*dstBuffer->content<uint32_t>(), 2u);
+
+    device->waitIdle();
+    commandBufferPool->reset();
+}
+#endif
+
+}
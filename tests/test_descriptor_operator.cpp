@@ -7,6 +7,7 @@
  */
 
 #include "Graphics/Buffer.hpp"
+#include "Graphics/ComputePipeline.hpp"
 #include "Graphics/Device.hpp"
 #include "Graphics/Enums.hpp"
 #include "Graphics/GraphicsPipeline.hpp"
@@ -164,4 +165,16 @@ TEST(descriptor_operator, graphics_pipeline_descriptor)
     expectDescriptorComparableInMap(lhs, rhs);
 }
 
+TEST(descriptor_operator, compute_pipeline_descriptor)
+{
+    gfx::ComputePipeline::Descriptor lhs {};
+    lhs.computeShader = nullptr;
+    lhs.threadGroupSize = { 32, 1, 1 };
+
+    gfx::ComputePipeline::Descriptor rhs = lhs;
+    rhs.threadGroupSize = { 64, 1, 1 };
+
+    expectDescriptorComparableInMap(lhs, rhs);
+}
+
 }
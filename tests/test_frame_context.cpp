@@ -0,0 +1,77 @@
+/*
+ * ---------------------------------------------------
+ * test_frame_context.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "vulkan_device_test.hpp"
+
+#include "Graphics/Buffer.hpp"
+#include "Graphics/CommandBuffer.hpp"
+#include "Graphics/Device.hpp"
+#include "Graphics/Enums.hpp"
+#include "Graphics/FrameContext.hpp"
+#include "Graphics/UploadRing.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace gfx_test
+{
+
+#if defined(GFX_BUILD_VULKAN)
+using frame_context = VulkanDeviceTest;
+
+TEST_F(frame_context, vulkan_frames_are_recycled)
+{
+    constexpr uint32_t frameCount = 16;
+
+    std::shared_ptr<gfx::Buffer> dstBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = sizeof(uint32_t),
+        .usages = gfx::BufferUsage::copyDestination,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+
+    gfx::FrameContext frameContext(*device, gfx::FrameContext::Descriptor{
+        .frameInFlightCount = 2,
+        .pools = {},
+        .uploadRing = gfx::UploadRing::Descriptor{ .blockSize = 4096, .usages = gfx::BufferUsage::copySource }
+    });
+
+    for (uint32_t i = 0; i < frameCount; i++)
+    {
+        // the frame count change while frames are in flight
+        if (i == frameCount / 2)
+            frameContext.setFrameInFlightCount(3);
+        if (i == frameCount * 3 / 4)
+            frameContext.setFrameInFlightCount(1);
+
+        frameContext.beginFrame();
+        EXPECT_LT(frameContext.frameIndex(), frameContext.frameInFlightCount());
+
+        std::shared_ptr<gfx::CommandBuffer> commandBuffer = frameContext.get();
+        commandBuffer->beginBlitPass();
+        commandBuffer->copyBufferToBuffer(frameContext.uploadRing().upload(i), dstBuffer);
+        commandBuffer->endBlitPass();
+        device->submitCommandBuffers(commandBuffer);
+
+        frameContext.endFrame();
+    }
+
+    // with a single frame in flight, beginFrame wait for the previous frame
+    frameContext.beginFrame();
+    EXPECT_EQ(*dstBuffer->content<uint32_t>(), frameCount - 1);
+    frameContext.endFrame();
+
+    const gfx::FrameContext::Statistics statistics = frameContext.statistics();
+    EXPECT_EQ(statistics.frameCount, frameCount + 1);
+    EXPECT_GE(statistics.totalWaitDuration, statistics.maxWaitDuration);
+    EXPECT_GE(statistics.maxWaitDuration, statistics.lastWaitDuration);
+}
+#endif
+
+}
@@ -0,0 +1,132 @@
+/*
+ * ---------------------------------------------------
+ * test_parallel_recording.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "vulkan_device_test.hpp"
+
+#include "Graphics/Buffer.hpp"
+#include "Graphics/CommandBuffer.hpp"
+#include "Graphics/Device.hpp"
+#include "Graphics/Enums.hpp"
+#include "Graphics/Framebuffer.hpp"
+#include "Graphics/GraphicsPipeline.hpp"
+#include "Graphics/PerThreadPools.hpp"
+#include "Graphics/ShaderLib.hpp"
+#include "Graphics/Texture.hpp"
+#include "Graphics/VertexLayout.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gfx_test
+{
+
+#if defined(GFX_BUILD_VULKAN)
+using parallel_recording = VulkanDeviceTest;
+
+// 50k draws split between 1 to 16 threads, each recording its own primary command buffer.
+// the recording time of each thread count is reported as a test property
+TEST_F(parallel_recording, vulkan_threads_record_their_own_part)
+{
+    constexpr uint32_t drawCount = 50'000;
+    constexpr uint32_t vertexBufferCount = 1'024;
+
+    std::unique_ptr<gfx::ShaderLib> shaderLib = device->newShaderLib(TEST_SHADER_SLIB);
+    std::shared_ptr<gfx::GraphicsPipeline> pipeline = device->newGraphicsPipeline(gfx::GraphicsPipeline::Descriptor{
+        .vertexLayout = gfx::VertexLayout{
+            .buffers = { gfx::VertexBufferLayout{ .stride = sizeof(float) * 2 } },
+            .attributes = { gfx::VertexAttribute{ .format = gfx::VertexAttributeFormat::float2, .offset = 0 } }
+        },
+        .vertexShader = &shaderLib->getFunction("vertexMain"),
+        .fragmentShader = &shaderLib->getFunction("fragmentMain"),
+        .colorAttachmentPxFormats = { gfx::PixelFormat::RGBA8Unorm }
+    });
+
+    std::vector<std::shared_ptr<gfx::Buffer>> vertexBuffers;
+    for (uint32_t i = 0; i < vertexBufferCount; i++) {
+        vertexBuffers.push_back(device->newBuffer(gfx::Buffer::Descriptor{
+            .size = sizeof(float) * 2 * 3,
+            .usages = gfx::BufferUsage::vertexBuffer,
+            .storageMode = gfx::ResourceStorageMode::hostVisible
+        }));
+        std::ranges::fill(std::span(vertexBuffers.back()->content<float>(), 6), 0.0f);
+    }
+
+    gfx::Framebuffer framebuffer = {
+        .colorAttachments = {
+            gfx::Framebuffer::Attachment{
+                .loadAction = gfx::LoadAction::load,
+                .texture = device->newTexture(gfx::Texture::Descriptor{
+                    .width = 16, .height = 16,
+                    .pixelFormat = gfx::PixelFormat::RGBA8Unorm,
+                    .usages = gfx::TextureUsage::colorAttachment,
+                    .storageMode = gfx::ResourceStorageMode::deviceLocal
+                })
+            }
+        }
+    };
+
+    gfx::PerThreadPools pools(*device, gfx::PerThreadPools::Descriptor{});
+
+    for (uint32_t threadCount : { 1u, 2u, 4u, 8u, 16u })
+    {
+        // each thread draw its own part of the frame in its own render pass
+        std::vector<std::shared_ptr<gfx::CommandBuffer>> commandBuffers(threadCount);
+        const auto start = std::chrono::steady_clock::now();
+        {
+            std::vector<std::jthread> threads;
+            for (uint32_t t = 0; t < threadCount; t++) {
+                threads.emplace_back([&, t]() {
+                    const uint32_t begin = drawCount * t / threadCount;
+                    const uint32_t end = drawCount * (t + 1) / threadCount;
+                    std::shared_ptr<gfx::CommandBuffer> commandBuffer = pools.get();
+                    commandBuffer->beginRenderPass(framebuffer);
+                    commandBuffer->usePipeline(pipeline);
+                    for (uint32_t i = begin; i < end; i++) {
+                        commandBuffer->useVertexBuffer(vertexBuffers[i % vertexBufferCount]);
+                        commandBuffer->drawVertices(0, 3);
+                    }
+                    commandBuffer->endRenderPass();
+                    commandBuffers[t] = std::move(commandBuffer);
+                });
+            }
+        }
+        const auto recordDuration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        RecordProperty("record_us_" + std::to_string(threadCount) + "_threads", recordDuration.count());
+
+        // every thread got its own command buffer
+        for (uint32_t t = 0; t < threadCount; t++) {
+            ASSERT_NE(commandBuffers[t], nullptr);
+            for (uint32_t u = 0; u < t; u++)
+                EXPECT_NE(commandBuffers[t], commandBuffers[u]);
+        }
+
+        device->submitCommandBuffers(commandBuffers);
+        EXPECT_TRUE(device->waitCommandBuffer(*commandBuffers.back(), std::chrono::seconds(10)));
+
+        // each thread got its own pools, even if it reuse the id of a thread of the previous iteration
+        EXPECT_EQ(pools.threadCount(), threadCount);
+
+        commandBuffers.clear();
+        device->waitIdle();
+        // the threads are finished, their pools are destroyed
+        pools.reset();
+        EXPECT_EQ(pools.threadCount(), 0u);
+    }
+}
+#endif
+
+}
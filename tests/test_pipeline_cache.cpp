@@ -0,0 +1,76 @@
+/*
+ * ---------------------------------------------------
+ * test_pipeline_cache.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "vulkan_device_test.hpp"
+
+#include "Graphics/Device.hpp"
+#include "Graphics/Instance.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+namespace gfx_test
+{
+
+#if defined(GFX_BUILD_VULKAN)
+class pipeline_cache : public VulkanDeviceTest
+{
+protected:
+    static std::filesystem::path cachePath() { return std::filesystem::temp_directory_path() / "gfx_test" / "pipeline_cache.bin"; }
+
+    pipeline_cache() : VulkanDeviceTest(gfx::Device::Descriptor{
+        .queueCaps = { .graphics = true, .compute = false, .transfer = false, .present = {} },
+        .pipelineCachePath = cachePath()
+    }) {}
+
+    // the device is created without a cache file
+    void SetUp() override
+    {
+        std::filesystem::remove(cachePath());
+        VulkanDeviceTest::SetUp();
+    }
+
+    // the device save the cache when destroyed
+    void TearDown() override
+    {
+        device.reset();
+        std::filesystem::remove(cachePath());
+    }
+};
+
+TEST_F(pipeline_cache, vulkan_save_and_reload)
+{
+    const std::filesystem::path cachePath = pipeline_cache::cachePath();
+
+    EXPECT_EQ(device->pipelineCacheStatistics(), gfx::Device::PipelineCacheStatistics{});
+
+    device->savePipelineCache();
+    ASSERT_TRUE(std::filesystem::exists(cachePath));
+    EXPECT_FALSE(std::filesystem::exists(std::filesystem::path(cachePath) += ".tmp"));
+
+    // the saved file is valid for the same device
+    device.reset();
+    EXPECT_NO_THROW(device = instance->newDevice(deviceDescriptor));
+    device.reset();
+
+    // an invalid file is ignored and overwritten at destruction
+    {
+        std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+        file << "not a pipeline cache";
+    }
+    const auto invalidSize = std::filesystem::file_size(cachePath);
+    EXPECT_NO_THROW(device = instance->newDevice(deviceDescriptor));
+    device.reset();
+    EXPECT_NE(std::filesystem::file_size(cachePath), invalidSize);
+}
+#endif
+
+}
@@ -0,0 +1,142 @@
+/*
+ * ---------------------------------------------------
+ * test_pipeline_compile.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "vulkan_device_test.hpp"
+
+#include "Graphics/Device.hpp"
+#include "Graphics/Enums.hpp"
+#include "Graphics/GraphicsPipeline.hpp"
+#include "Graphics/ShaderLib.hpp"
+#include "Graphics/VertexLayout.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace gfx_test
+{
+
+#if defined(GFX_BUILD_VULKAN)
+class pipeline_compile : public VulkanDeviceTest
+{
+protected:
+    void SetUp() override
+    {
+        VulkanDeviceTest::SetUp();
+        if (IsSkipped())
+            return;
+        shaderLib = device->newShaderLib(TEST_SHADER_SLIB);
+    }
+
+    // every index in [0, 27) give a different descriptor
+    gfx::GraphicsPipeline::Descriptor descriptor(size_t index) const
+    {
+        constexpr gfx::PixelFormat pixelFormats[] = { gfx::PixelFormat::RGBA8Unorm, gfx::PixelFormat::BGRA8Unorm, gfx::PixelFormat::BGRA8Unorm_sRGB };
+        constexpr gfx::CullMode cullModes[] = { gfx::CullMode::none, gfx::CullMode::front, gfx::CullMode::back };
+        constexpr gfx::BlendOperation blendOperations[] = { gfx::BlendOperation::blendingOff, gfx::BlendOperation::srcA_plus_1_minus_srcA, gfx::BlendOperation::one_minus_srcA_plus_srcA };
+
+        return gfx::GraphicsPipeline::Descriptor{
+            .vertexLayout = gfx::VertexLayout{
+                .buffers = { gfx::VertexBufferLayout{ .stride = sizeof(float) * 2 } },
+                .attributes = { gfx::VertexAttribute{ .format = gfx::VertexAttributeFormat::float2, .offset = 0 } }
+            },
+            .vertexShader = &shaderLib->getFunction("vertexMain"),
+            .fragmentShader = &shaderLib->getFunction("fragmentMain"),
+            .colorAttachmentPxFormats = { pixelFormats[index % 3] },
+            .blendOperation = blendOperations[index / 3 % 3],
+            .cullMode = cullModes[index / 9 % 3]
+        };
+    }
+
+    std::unique_ptr<gfx::ShaderLib> shaderLib;
+};
+
+TEST_F(pipeline_compile, vulkan_batch_futures)
+{
+    constexpr size_t pipelineCount = 20;
+
+    std::vector<gfx::GraphicsPipeline::Descriptor> descriptors;
+    for (size_t i = 0; i < pipelineCount; i++)
+        descriptors.push_back(descriptor(i));
+
+    std::vector<gfx::GraphicsPipelineFuture> futures = device->newGraphicsPipelines(descriptors);
+    ASSERT_EQ(futures.size(), pipelineCount);
+
+    // one pipeline per descriptor, in the order of the descriptors
+    std::set<gfx::GraphicsPipeline*> pipelines;
+    for (auto& future : futures) {
+        ASSERT_NE(future.get(), nullptr);
+        pipelines.insert(future.get().get());
+    }
+    EXPECT_EQ(pipelines.size(), pipelineCount);
+
+    gfx::GraphicsPipelineFuture future = device->newGraphicsPipelineAsync(descriptor(0));
+    EXPECT_NE(future.get(), nullptr);
+}
+
+TEST_F(pipeline_compile, vulkan_error_is_thrown_by_the_futures)
+{
+    gfx::GraphicsPipeline::Descriptor invalidDescriptor = descriptor(0);
+    invalidDescriptor.fragmentShader = nullptr;
+
+    EXPECT_THROW(device->newGraphicsPipelineAsync(invalidDescriptor).get(), std::runtime_error);
+
+    // a batch smaller than a group is compiled by a single call, the error fail all of it
+    std::vector<gfx::GraphicsPipeline::Descriptor> descriptors = { descriptor(0), invalidDescriptor, descriptor(1) };
+    for (auto& future : device->newGraphicsPipelines(descriptors))
+        EXPECT_THROW(future.get(), std::runtime_error);
+
+    // the workers are still usable
+    EXPECT_NE(device->newGraphicsPipelineAsync(descriptor(0)).get(), nullptr);
+}
+
+TEST_F(pipeline_compile, vulkan_cache_statistics)
+{
+    constexpr size_t pipelineCount = 12;
+
+    std::vector<gfx::GraphicsPipeline::Descriptor> descriptors;
+    for (size_t i = 0; i < pipelineCount; i++)
+        descriptors.push_back(descriptor(i));
+
+    const gfx::Device::PipelineCacheStatistics before = device->pipelineCacheStatistics();
+    for (auto& future : device->newGraphicsPipelines(descriptors))
+        future.wait();
+    const gfx::Device::PipelineCacheStatistics compiled = device->pipelineCacheStatistics();
+    EXPECT_EQ(compiled.hitCount + compiled.missCount - before.hitCount - before.missCount, pipelineCount);
+
+    // the same pipelines again, found in the cache when the driver report it (creation feedback), counted as misses otherwise
+    for (auto& future : device->newGraphicsPipelines(descriptors))
+        future.wait();
+    const gfx::Device::PipelineCacheStatistics recompiled = device->pipelineCacheStatistics();
+    EXPECT_EQ(recompiled.hitCount + recompiled.missCount - compiled.hitCount - compiled.missCount, pipelineCount);
+    EXPECT_GE(recompiled.hitCount, compiled.hitCount);
+}
+
+TEST_F(pipeline_compile, vulkan_shared_pipelines)
+{
+    std::shared_ptr<gfx::GraphicsPipeline> pipeline = device->sharedGraphicsPipeline(descriptor(0));
+    ASSERT_NE(pipeline, nullptr);
+
+    // equal descriptors give the same living pipeline, different ones a new pipeline
+    EXPECT_EQ(device->sharedGraphicsPipeline(descriptor(0)), pipeline);
+    EXPECT_NE(device->sharedGraphicsPipeline(descriptor(1)), pipeline);
+
+    // the shaders are compared by code, a second library loaded from the same file share the pipelines
+    std::unique_ptr<gfx::ShaderLib> otherShaderLib = device->newShaderLib(TEST_SHADER_SLIB);
+    gfx::GraphicsPipeline::Descriptor otherDescriptor = descriptor(0);
+    otherDescriptor.vertexShader = &otherShaderLib->getFunction("vertexMain");
+    otherDescriptor.fragmentShader = &otherShaderLib->getFunction("fragmentMain");
+    EXPECT_EQ(device->sharedGraphicsPipeline(otherDescriptor), pipeline);
+}
+#endif
+
+}
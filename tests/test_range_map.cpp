@@ -0,0 +1,149 @@
+/*
+ * ---------------------------------------------------
+ * test_range_map.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "Vulkan/RangeMap.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace gfx_test
+{
+
+using IntRangeMap = gfx::RangeMap<int>;
+using Ranges = std::vector<IntRangeMap::Range>;
+
+TEST(range_map, assign_disjoint)
+{
+    IntRangeMap map;
+    map.assign(64, 128, 2);
+    map.assign(0, 32, 1);
+    map.assign(256, 512, 3);
+    EXPECT_EQ(map.ranges(), (Ranges{ {0, 32, 1}, {64, 128, 2}, {256, 512, 3} }));
+}
+
+TEST(range_map, assign_empty_range)
+{
+    IntRangeMap map;
+    map.assign(16, 16, 1);
+    EXPECT_TRUE(map.empty());
+}
+
+TEST(range_map, assign_merge_adjacent_equal)
+{
+    IntRangeMap map;
+    map.assign(0, 32, 1);
+    map.assign(64, 128, 1);
+    map.assign(32, 64, 1);
+    EXPECT_EQ(map.ranges(), (Ranges{ {0, 128, 1} }));
+}
+
+TEST(range_map, assign_no_merge_adjacent_different)
+{
+    IntRangeMap map;
+    map.assign(0, 32, 1);
+    map.assign(32, 64, 2);
+    EXPECT_EQ(map.ranges(), (Ranges{ {0, 32, 1}, {32, 64, 2} }));
+}
+
+TEST(range_map, assign_split)
+{
+    IntRangeMap map;
+    map.assign(0, 256, 1);
+    map.assign(64, 128, 2);
+    EXPECT_EQ(map.ranges(), (Ranges{ {0, 64, 1}, {64, 128, 2}, {128, 256, 1} }));
+
+    map.assign(64, 128, 1);
+    EXPECT_EQ(map.ranges(), (Ranges{ {0, 256, 1} }));
+}
+
+TEST(range_map, assign_overwrite_many)
+{
+    IntRangeMap map;
+    map.assign(0, 32, 1);
+    map.assign(32, 64, 2);
+    map.assign(64, 96, 3);
+    map.assign(96, 128, 4);
+    map.assign(16, 112, 5);
+    EXPECT_EQ(map.ranges(), (Ranges{ {0, 16, 1}, {16, 112, 5}, {112, 128, 4} }));
+
+    map.assign(0, 128, 6);
+    EXPECT_EQ(map.ranges(), (Ranges{ {0, 128, 6} }));
+}
+
+TEST(range_map, assign_whole_size)
+{
+    constexpr uint64_t wholeEnd = std::numeric_limits<uint64_t>::max();
+    IntRangeMap map;
+    map.assign(0, 64, 1);
+    map.assign(128, 256, 2);
+    map.assign(32, wholeEnd, 3);
+    EXPECT_EQ(map.ranges(), (Ranges{ {0, 32, 1}, {32, wholeEnd, 3} }));
+}
+
+TEST(range_map, fill_gaps)
+{
+    IntRangeMap map;
+    map.assign(32, 64, 1);
+    map.assign(96, 128, 2);
+    map.fillGaps(0, 160, 3);
+    EXPECT_EQ(map.ranges(), (Ranges{ {0, 32, 3}, {32, 64, 1}, {64, 96, 3}, {96, 128, 2}, {128, 160, 3} }));
+}
+
+TEST(range_map, fill_gaps_merge)
+{
+    IntRangeMap map;
+    map.assign(32, 64, 1);
+    map.assign(96, 128, 1);
+    map.fillGaps(0, 160, 1);
+    EXPECT_EQ(map.ranges(), (Ranges{ {0, 160, 1} }));
+}
+
+TEST(range_map, fill_gaps_covered)
+{
+    IntRangeMap map;
+    map.assign(0, 128, 1);
+    map.fillGaps(32, 64, 2);
+    EXPECT_EQ(map.ranges(), (Ranges{ {0, 128, 1} }));
+}
+
+TEST(range_map, for_each_overlap_clipped)
+{
+    IntRangeMap map;
+    map.assign(0, 32, 1);
+    map.assign(32, 64, 2);
+    map.assign(128, 256, 3);
+
+    Ranges overlapped;
+    map.forEachOverlap(16, 160, [&](const IntRangeMap::Range& range) { overlapped.push_back(range); });
+    EXPECT_EQ(overlapped, (Ranges{ {16, 32, 1}, {32, 64, 2}, {128, 160, 3} }));
+
+    overlapped.clear();
+    map.forEachOverlap(64, 128, [&](const IntRangeMap::Range& range) { overlapped.push_back(range); });
+    EXPECT_TRUE(overlapped.empty());
+}
+
+TEST(range_map, transform_values_merge)
+{
+    IntRangeMap map;
+    map.assign(0, 32, 1);
+    map.assign(32, 64, 2);
+    map.assign(64, 96, 3);
+    map.assign(128, 256, 4);
+
+    map.transformValues([](int value) { return value < 3 ? 0 : value; });
+    EXPECT_EQ(map.ranges(), (Ranges{ {0, 64, 0}, {64, 96, 3}, {128, 256, 4} }));
+
+    // not contiguous ranges are not merged
+    map.transformValues([](int) { return 5; });
+    EXPECT_EQ(map.ranges(), (Ranges{ {0, 96, 5}, {128, 256, 5} }));
+}
+
+}
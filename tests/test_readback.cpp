@@ -0,0 +1,151 @@
+/*
+ * ---------------------------------------------------
+ * test_readback.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "vulkan_device_test.hpp"
+
+#include "Graphics/Buffer.hpp"
+#include "Graphics/CommandBuffer.hpp"
+#include "Graphics/CommandBufferPool.hpp"
+#include "Graphics/Device.hpp"
+#include "Graphics/Enums.hpp"
+#include "Graphics/Framebuffer.hpp"
+#include "Graphics/ReadbackRing.hpp"
+#include "Graphics/Texture.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace gfx_test
+{
+
+#if defined(GFX_BUILD_VULKAN)
+using readback = VulkanDeviceTest;
+
+namespace
+{
+
+constexpr uint32_t textureSize = 16;
+constexpr size_t imageSize = textureSize * textureSize * sizeof(uint32_t);
+
+// clear the texture, RGBA8Unorm so the pixels are 0xAABBGGRR
+void recordClear(gfx::CommandBuffer& commandBuffer, const std::shared_ptr<gfx::Texture>& texture, const std::array<float, 4>& color)
+{
+    commandBuffer.beginRenderPass(gfx::Framebuffer{
+        .colorAttachments = {
+            gfx::Framebuffer::Attachment{
+                .loadAction = gfx::LoadAction::clear,
+                .clearColor = color,
+                .texture = texture
+            }
+        }
+    });
+    commandBuffer.endRenderPass();
+}
+
+uint32_t countPixels(const gfx::BufferSlice& slice, uint32_t expected)
+{
+    uint32_t count = 0;
+    for (size_t i = 0; i < textureSize * textureSize; i++) {
+        if (slice.content<uint32_t>()[i] == expected)
+            count++;
+    }
+    return count;
+}
+
+}
+
+TEST_F(readback, vulkan_copy_texture_to_buffer)
+{
+    std::shared_ptr<gfx::Texture> texture = device->newTexture(gfx::Texture::Descriptor{
+        .width = textureSize, .height = textureSize,
+        .pixelFormat = gfx::PixelFormat::RGBA8Unorm,
+        .usages = gfx::TextureUsage::colorAttachment | gfx::TextureUsage::copySource
+    });
+    std::shared_ptr<gfx::Buffer> buffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = imageSize,
+        .usages = gfx::BufferUsage::copyDestination,
+        .storageMode = gfx::ResourceStorageMode::readback
+    });
+
+    std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = device->newCommandBufferPool();
+    std::shared_ptr<gfx::CommandBuffer> commandBuffer = commandBufferPool->get();
+
+    recordClear(*commandBuffer, texture, { 1.0f, 0.0f, 0.0f, 1.0f });
+    commandBuffer->beginBlitPass();
+    commandBuffer->copyTextureToBuffer(texture, buffer);
+    commandBuffer->endBlitPass();
+    device->submitCommandBuffers(commandBuffer);
+
+    ASSERT_TRUE(device->waitSubmit(commandBuffer->submitTicket(), std::chrono::seconds(10)));
+    EXPECT_EQ(countPixels(gfx::BufferSlice{ .buffer = buffer, .offset = 0, .size = imageSize }, 0xFF0000FF), textureSize * textureSize);
+
+    commandBufferPool->reset();
+}
+
+TEST_F(readback, vulkan_readback_ring)
+{
+    constexpr uint32_t slotCount = 2;
+
+    std::shared_ptr<gfx::Texture> texture = device->newTexture(gfx::Texture::Descriptor{
+        .width = textureSize, .height = textureSize,
+        .pixelFormat = gfx::PixelFormat::RGBA8Unorm,
+        .usages = gfx::TextureUsage::colorAttachment | gfx::TextureUsage::copySource
+    });
+
+    gfx::ReadbackRing readbackRing(*device, gfx::ReadbackRing::Descriptor{ .slotSize = imageSize, .slotCount = slotCount });
+    EXPECT_FALSE(readbackRing.tryRead().has_value());
+
+    std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = device->newCommandBufferPool();
+    std::array<gfx::SubmitTicket, slotCount> tickets;
+
+    // one capture of a different color per slot, in flight together
+    for (uint32_t i = 0; i < slotCount; i++)
+    {
+        std::optional<gfx::BufferSlice> slot = readbackRing.acquire();
+        ASSERT_TRUE(slot.has_value());
+        EXPECT_EQ(slot->offset % gfx::ReadbackRing::slotAlignment, 0u);
+
+        std::shared_ptr<gfx::CommandBuffer> commandBuffer = commandBufferPool->get();
+        recordClear(*commandBuffer, texture, { 0.0f, i == 0 ? 1.0f : 0.0f, i == 0 ? 0.0f : 1.0f, 1.0f });
+        commandBuffer->beginBlitPass();
+        commandBuffer->copyTextureToBuffer(texture, *slot);
+        commandBuffer->endBlitPass();
+        device->submitCommandBuffers(commandBuffer);
+
+        tickets[i] = commandBuffer->submitTicket();
+        readbackRing.commit(tickets[i]);
+    }
+
+    // every slot is in flight, the readback is dropped instead of waiting
+    EXPECT_FALSE(readbackRing.acquire().has_value());
+    EXPECT_EQ(readbackRing.statistics().droppedCount, 1u);
+
+    const std::array<uint32_t, slotCount> expectedPixels = { 0xFF00FF00, 0xFFFF0000 };
+    for (uint32_t i = 0; i < slotCount; i++)
+    {
+        ASSERT_TRUE(device->waitSubmit(tickets[i], std::chrono::seconds(10)));
+        std::optional<gfx::BufferSlice> slot = readbackRing.tryRead();
+        ASSERT_TRUE(slot.has_value());
+        EXPECT_EQ(countPixels(*slot, expectedPixels[i]), textureSize * textureSize);
+        readbackRing.release();
+    }
+
+    EXPECT_FALSE(readbackRing.tryRead().has_value());
+    EXPECT_TRUE(readbackRing.acquire().has_value());
+    EXPECT_EQ(readbackRing.statistics().readCount, slotCount);
+
+    commandBufferPool->reset();
+}
+#endif
+
+}
@@ -0,0 +1,69 @@
+/*
+ * ---------------------------------------------------
+ * test_retirement.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "vulkan_device_test.hpp"
+
+#include "Graphics/Buffer.hpp"
+#include "Graphics/CommandBuffer.hpp"
+#include "Graphics/CommandBufferPool.hpp"
+#include "Graphics/Device.hpp"
+#include "Graphics/Enums.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace gfx_test
+{
+
+#if defined(GFX_BUILD_VULKAN)
+using retirement = VulkanDeviceTest;
+
+TEST_F(retirement, vulkan_destroyed_resources_are_retired)
+{
+    std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = device->newCommandBufferPool();
+
+    std::shared_ptr<gfx::Buffer> srcBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = sizeof(uint32_t),
+        .usages = gfx::BufferUsage::copySource,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+    std::shared_ptr<gfx::Buffer> dstBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = sizeof(uint32_t),
+        .usages = gfx::BufferUsage::copyDestination,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+
+    std::shared_ptr<gfx::CommandBuffer> commandBuffer = commandBufferPool->get();
+    commandBuffer->beginBlitPass();
+    commandBuffer->copyBufferToBuffer(srcBuffer, dstBuffer, sizeof(uint32_t));
+    commandBuffer->endBlitPass();
+    device->submitCommandBuffers(commandBuffer);
+    device->waitCommandBuffer(*commandBuffer);
+
+    const gfx::Device::DestructionStatistics initialStatistics = device->destructionStatistics();
+
+    // the command buffer keep the buffers alive until it is reused
+    srcBuffer.reset();
+    dstBuffer.reset();
+    EXPECT_EQ(device->destructionStatistics(), initialStatistics);
+
+    commandBuffer.reset();
+    commandBufferPool->reset();
+    EXPECT_EQ(device->destructionStatistics().pendingCount, initialStatistics.pendingCount + 2);
+    EXPECT_EQ(device->destructionStatistics().freedCount, initialStatistics.freedCount);
+
+    // destroyed by the next submit or wait
+    device->waitIdle();
+    EXPECT_EQ(device->destructionStatistics().pendingCount, 0u);
+    EXPECT_EQ(device->destructionStatistics().freedCount, initialStatistics.freedCount + initialStatistics.pendingCount + 2);
+}
+#endif
+
+}
@@ -0,0 +1,61 @@
+/*
+ * ---------------------------------------------------
+ * test_reusable_command_buffers.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "vulkan_device_test.hpp"
+
+#include "Graphics/Buffer.hpp"
+#include "Graphics/CommandBuffer.hpp"
+#include "Graphics/Device.hpp"
+#include "Graphics/Enums.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace gfx_test
+{
+
+#if defined(GFX_BUILD_VULKAN)
+using reusable_command_buffers = VulkanDeviceTest;
+
+// recorded once, the barriers between the submits are computed again each time
+TEST_F(reusable_command_buffers, vulkan_replay)
+{
+    std::shared_ptr<gfx::Buffer> srcBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = sizeof(uint32_t),
+        .usages = gfx::BufferUsage::copySource,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+    std::shared_ptr<gfx::Buffer> dstBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = sizeof(uint32_t),
+        .usages = gfx::BufferUsage::copyDestination,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+
+    std::shared_ptr<gfx::CommandBuffer> commandBuffer = device->newReusableCommandBuffer();
+    commandBuffer->beginBlitPass();
+    commandBuffer->copyBufferToBuffer(srcBuffer, dstBuffer, sizeof(uint32_t));
+    commandBuffer->endBlitPass();
+
+    for (uint32_t i = 1; i <= 3; i++)
+    {
+        *srcBuffer->content<uint32_t>() = i;
+        device->submitCommandBuffers(commandBuffer);
+        device->waitCommandBuffer(*commandBuffer);
+        EXPECT_EQ(*dstBuffer->content<uint32_t>(), i);
+    }
+
+    // the first submit is the first use of the buffers, the next ones wait for the previous copy
+    EXPECT_EQ(commandBuffer->statistics(), (gfx::CommandBuffer::Statistics{ .barrierCount = 2, .barrierBatchCount = 2 }));
+
+    device->waitIdle();
+}
+#endif
+
+}
@@ -0,0 +1,86 @@
+/*
+ * ---------------------------------------------------
+ * test_secondary_command_buffers.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "vulkan_device_test.hpp"
+
+#include "Graphics/Buffer.hpp"
+#include "Graphics/CommandBuffer.hpp"
+#include "Graphics/CommandBufferPool.hpp"
+#include "Graphics/Device.hpp"
+#include "Graphics/Enums.hpp"
+#include "Graphics/Framebuffer.hpp"
+#include "Graphics/Texture.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace gfx_test
+{
+
+#if defined(GFX_BUILD_VULKAN)
+using secondary_command_buffers = VulkanDeviceTest;
+
+// the secondaries are recorded on other threads, their first uses are synchronized by the primary when they are executed
+TEST_F(secondary_command_buffers, vulkan_uses_are_merged)
+{
+    std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = device->newCommandBufferPool();
+
+    std::shared_ptr<gfx::Buffer> srcBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = 256,
+        .usages = gfx::BufferUsage::copySource,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+    std::shared_ptr<gfx::Buffer> vertexBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = 256,
+        .usages = gfx::BufferUsage::vertexBuffer | gfx::BufferUsage::copyDestination,
+        .storageMode = gfx::ResourceStorageMode::deviceLocal
+    });
+    std::shared_ptr<gfx::Texture> colorTexture = device->newTexture(gfx::Texture::Descriptor{
+        .width = 16, .height = 16,
+        .pixelFormat = gfx::PixelFormat::RGBA8Unorm,
+        .usages = gfx::TextureUsage::colorAttachment,
+        .storageMode = gfx::ResourceStorageMode::deviceLocal
+    });
+
+    std::shared_ptr<gfx::CommandBuffer> commandBuffer = commandBufferPool->get();
+    commandBuffer->beginBlitPass();
+    commandBuffer->copyBufferToBuffer(srcBuffer, vertexBuffer, srcBuffer->size());
+    commandBuffer->endBlitPass();
+
+    gfx::Framebuffer framebuffer = {
+        .colorAttachments = {
+            gfx::Framebuffer::Attachment{
+                .loadAction = gfx::LoadAction::clear,
+                .clearColor = { 0.0f, 0.0f, 0.0f, 0.0f },
+                .texture = colorTexture
+            }
+        }
+    };
+    commandBuffer->beginRenderPass(framebuffer, gfx::RenderPassContents::secondaryCommandBuffers);
+    std::vector<std::shared_ptr<gfx::CommandBuffer>> secondaries = { commandBuffer->newSecondaryCommandBuffer(), commandBuffer->newSecondaryCommandBuffer() };
+    {
+        std::vector<std::jthread> threads;
+        for (auto& secondary : secondaries)
+            threads.emplace_back([&]() { secondary->useVertexBuffer(vertexBuffer); });
+    }
+    commandBuffer->endRenderPass();
+
+    // the vertex read of the first secondary wait for the copy, the second one read after a read
+    EXPECT_EQ(commandBuffer->statistics(), (gfx::CommandBuffer::Statistics{ .barrierCount = 1, .barrierBatchCount = 1 }));
+
+    device->submitCommandBuffers(commandBuffer);
+    device->waitCommandBuffer(*commandBuffer);
+
+    commandBufferPool->reset();
+}
+#endif
+
+}
@@ -0,0 +1,87 @@
+/*
+ * ---------------------------------------------------
+ * test_submission_thread.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "vulkan_device_test.hpp"
+
+#include "Graphics/Buffer.hpp"
+#include "Graphics/CommandBuffer.hpp"
+#include "Graphics/Device.hpp"
+#include "Graphics/Enums.hpp"
+#include "Graphics/PerThreadPools.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace gfx_test
+{
+
+#if defined(GFX_BUILD_VULKAN)
+class submission_thread : public VulkanDeviceTest
+{
+protected:
+    submission_thread() : VulkanDeviceTest(gfx::Device::Descriptor{
+        .queueCaps = { .graphics = true, .compute = false, .transfer = false, .present = {} },
+        .submissionThread = true
+    }) {}
+};
+
+// several threads submit through the submission thread, each one waiting its own command buffer
+TEST_F(submission_thread, vulkan_concurrent_submits)
+{
+    constexpr uint32_t threadCount = 4;
+    constexpr uint32_t submitPerThread = 64;
+
+    std::shared_ptr<gfx::Buffer> srcBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = threadCount * submitPerThread * sizeof(uint32_t),
+        .usages = gfx::BufferUsage::copySource,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+    std::shared_ptr<gfx::Buffer> dstBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = threadCount * submitPerThread * sizeof(uint32_t),
+        .usages = gfx::BufferUsage::copyDestination,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+    for (uint32_t i = 0; i < threadCount * submitPerThread; i++)
+        srcBuffer->content<uint32_t>()[i] = i;
+
+    gfx::PerThreadPools pools(*device, gfx::PerThreadPools::Descriptor{});
+    {
+        std::vector<std::jthread> threads;
+        for (uint32_t t = 0; t < threadCount; t++) {
+            threads.emplace_back([&, t]() {
+        for (uint32_t i = t * submitPerThread; i < (t + 1) * submitPerThread; i++) {
+                    std::shared_ptr<gfx::CommandBuffer> commandBuffer = pools.get();
+                    commandBuffer->beginBlitPass();
+                    commandBuffer->copyBufferToBuffer(srcBuffer, i * sizeof(uint32_t), dstBuffer, i * sizeof(uint32_t), sizeof(uint32_t));
+                    commandBuffer->endBlitPass();
+                    device->submitCommandBuffers(commandBuffer);
+                    device->waitCommandBuffer(*commandBuffer);
+                    EXPECT_EQ(dstBuffer->content<uint32_t>()[i], i);
+        }
+            });
+        }
+    }
+    device->waitIdle();
+
+    const gfx::Device::SubmitStatistics statistics = device->submitStatistics();
+    EXPECT_EQ(statistics.submitCount, threadCount * submitPerThread);
+    // every submit went through the queue of the submission thread, so it has a latency
+    EXPECT_GT(statistics.maxLatency, std::chrono::nanoseconds(0));
+    EXPECT_GE(statistics.totalLatency, statistics.maxLatency);
+    EXPECT_LE(statistics.totalLatency, statistics.maxLatency * statistics.submitCount);
+
+    pools.reset();
+}
+#endif
+
+}
@@ -0,0 +1,75 @@
+/*
+ * ---------------------------------------------------
+ * test_submit_allocations.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "allocation_counter.hpp"
+#include "vulkan_device_test.hpp"
+
+#include "Graphics/Buffer.hpp"
+#include "Graphics/CommandBuffer.hpp"
+#include "Graphics/CommandBufferPool.hpp"
+#include "Graphics/Device.hpp"
+#include "Graphics/Enums.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory>
+
+namespace gfx_test
+{
+
+#if defined(GFX_BUILD_VULKAN)
+using submit_allocations = VulkanDeviceTest;
+
+TEST_F(submit_allocations, vulkan_steady_state)
+{
+    constexpr int warmupIterations = 16;
+    constexpr int measuredIterations = 1000;
+
+    std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = device->newCommandBufferPool();
+    std::shared_ptr<gfx::Buffer> srcBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = 256,
+        .usages = gfx::BufferUsage::copySource,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+    std::shared_ptr<gfx::Buffer> dstBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = 256,
+        .usages = gfx::BufferUsage::copyDestination,
+        .storageMode = gfx::ResourceStorageMode::deviceLocal
+    });
+
+    std::size_t submitAllocations = 0;
+
+    // dstBuffer is written by every command buffer, so each submit (except the first one) require a barrier command buffer
+    auto recordAndSubmit = [&]() {
+        std::shared_ptr<gfx::CommandBuffer> commandBuffer = commandBufferPool->get();
+        commandBuffer->beginBlitPass();
+        commandBuffer->copyBufferToBuffer(srcBuffer, dstBuffer, srcBuffer->size());
+        commandBuffer->endBlitPass();
+
+        const std::size_t allocationsBefore = allocationCount();
+        device->submitCommandBuffers(commandBuffer);
+        submitAllocations += allocationCount() - allocationsBefore;
+
+        device->waitCommandBuffer(*commandBuffer);
+        commandBufferPool->reset();
+    };
+
+    for (int i = 0; i < warmupIterations; i++)
+        recordAndSubmit();
+
+    submitAllocations = 0;
+
+    for (int i = 0; i < measuredIterations; i++)
+        recordAndSubmit();
+
+    EXPECT_EQ(submitAllocations, 0u);
+}
+#endif
+
+}
@@ -0,0 +1,126 @@
+/*
+ * ---------------------------------------------------
+ * test_submit_completion.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "vulkan_device_test.hpp"
+
+#include "Graphics/Buffer.hpp"
+#include "Graphics/CommandBuffer.hpp"
+#include "Graphics/CommandBufferPool.hpp"
+#include "Graphics/Device.hpp"
+#include "Graphics/Enums.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace gfx_test
+{
+
+#if defined(GFX_BUILD_VULKAN)
+class submit_completion : public VulkanDeviceTest
+{
+protected:
+    submit_completion() : VulkanDeviceTest(gfx::Device::Descriptor{
+        .queueCaps = { .graphics = true, .compute = false, .transfer = false, .present = {} },
+        .deferredSubmits = true
+    }) {}
+};
+
+TEST_F(submit_completion, vulkan_polled_and_notified)
+{
+    std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = device->newCommandBufferPool();
+
+    std::shared_ptr<gfx::Buffer> srcBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = sizeof(uint32_t),
+        .usages = gfx::BufferUsage::copySource,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+    std::shared_ptr<gfx::Buffer> dstBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = sizeof(uint32_t),
+        .usages = gfx::BufferUsage::copyDestination,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+    *srcBuffer->content<uint32_t>() = 1;
+
+    auto recordCopy = [&]() {
+        std::shared_ptr<gfx::CommandBuffer> commandBuffer = commandBufferPool->get();
+        commandBuffer->beginBlitPass();
+        commandBuffer->copyBufferToBuffer(srcBuffer, dstBuffer, sizeof(uint32_t));
+        commandBuffer->endBlitPass();
+        return commandBuffer;
+    };
+
+    EXPECT_TRUE(device->isCompleted(gfx::SubmitTicket{}));
+
+    std::shared_ptr<gfx::CommandBuffer> first = recordCopy();
+    EXPECT_TRUE(first->isCompleted()); // not submitted
+    device->submitCommandBuffers(first);
+    const gfx::SubmitTicket firstTicket = first->submitTicket();
+    EXPECT_NE(firstTicket, gfx::SubmitTicket{});
+    EXPECT_FALSE(first->isCompleted()); // deferred, never completed before a flush
+
+    std::promise<void> handlerCalled;
+    device->addCompletedHandler(firstTicket, [&]() { handlerCalled.set_value(); });
+
+    std::shared_ptr<gfx::CommandBuffer> second = recordCopy();
+    device->submitCommandBuffers(second);
+    EXPECT_GT(second->submitTicket(), firstTicket);
+
+    // the wait flush the deferred submits
+    EXPECT_TRUE(device->waitCommandBuffer(*second, std::chrono::seconds(10)));
+    EXPECT_TRUE(second->isCompleted());
+    EXPECT_TRUE(device->isCompleted(firstTicket)); // same queue, completed in order
+    EXPECT_TRUE(device->waitSubmit(firstTicket, std::chrono::nanoseconds(0)));
+    EXPECT_EQ(handlerCalled.get_future().wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    EXPECT_EQ(*dstBuffer->content<uint32_t>(), 1u);
+
+    // a handler added after the completion is still called
+    std::promise<void> lateHandlerCalled;
+    device->addCompletedHandler(firstTicket, [&]() { lateHandlerCalled.set_value(); });
+    EXPECT_EQ(lateHandlerCalled.get_future().wait_for(std::chrono::seconds(10)), std::future_status::ready);
+
+    device->waitIdle();
+    commandBufferPool->reset();
+}
+
+TEST_F(submit_completion, vulkan_handler_error_is_thrown)
+{
+    std::promise<void> throwingHandlerCalled;
+    device->addCompletedHandler(gfx::SubmitTicket{}, [&]() {
+        throwingHandlerCalled.set_value();
+        throw std::runtime_error("handler failed");
+    });
+    ASSERT_EQ(throwingHandlerCalled.get_future().wait_for(std::chrono::seconds(10)), std::future_status::ready);
+
+    // handled after the error is stored
+    std::promise<void> nextHandlerCalled;
+    device->addCompletedHandler(gfx::SubmitTicket{}, [&]() { nextHandlerCalled.set_value(); });
+    ASSERT_EQ(nextHandlerCalled.get_future().wait_for(std::chrono::seconds(10)), std::future_status::ready);
+
+    EXPECT_THROW(device->waitIdle(), std::runtime_error);
+    EXPECT_NO_THROW(device->waitIdle()); // thrown once
+}
+
+TEST_F(submit_completion, vulkan_remaining_handlers_are_called_at_destruction)
+{
+    bool handlerCalled = false;
+    // never submitted, never completed
+    device->addCompletedHandler(gfx::SubmitTicket{ .value = std::numeric_limits<uint64_t>::max() }, [&]() { handlerCalled = true; });
+    EXPECT_FALSE(handlerCalled);
+
+    device.reset(); // the completion thread is joined
+    EXPECT_TRUE(handlerCalled);
+}
+#endif
+
+}
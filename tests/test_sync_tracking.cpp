@@ -0,0 +1,268 @@
+/*
+ * ---------------------------------------------------
+ * test_sync_tracking.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "vulkan_device_test.hpp"
+
+#include "Graphics/Buffer.hpp"
+#include "Graphics/CommandBuffer.hpp"
+#include "Graphics/CommandBufferPool.hpp"
+#include "Graphics/Device.hpp"
+#include "Graphics/Enums.hpp"
+#include "Graphics/Framebuffer.hpp"
+#include "Graphics/GraphicsPipeline.hpp"
+#include "Graphics/ShaderLib.hpp"
+#include "Graphics/Texture.hpp"
+#include "Graphics/VertexLayout.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace gfx_test
+{
+
+#if defined(GFX_BUILD_VULKAN)
+using sync_tracking = VulkanDeviceTest;
+
+// 10k indexed draws, each with its own vertex buffer use, timed per draw. the per draw std::map lookups
+// of the previous tracking (keyed by shared_ptr, one map for the requests and one for the final states)
+// are timed on the same buffers as the baseline. both are reported as test properties
+TEST_F(sync_tracking, vulkan_record_10k_draws)
+{
+    constexpr std::size_t drawCount = 10'000;
+    constexpr std::size_t vertexBufferCount = 1'024;
+    constexpr int frameCount = 20; // the first one is a warm-up
+
+    std::unique_ptr<gfx::ShaderLib> shaderLib = device->newShaderLib(TEST_SHADER_SLIB);
+    std::shared_ptr<gfx::GraphicsPipeline> pipeline = device->newGraphicsPipeline(gfx::GraphicsPipeline::Descriptor{
+        .vertexLayout = gfx::VertexLayout{
+            .buffers = { gfx::VertexBufferLayout{ .stride = sizeof(float) * 2 } },
+            .attributes = { gfx::VertexAttribute{ .format = gfx::VertexAttributeFormat::float2, .offset = 0 } }
+        },
+        .vertexShader = &shaderLib->getFunction("vertexMain"),
+        .fragmentShader = &shaderLib->getFunction("fragmentMain"),
+        .colorAttachmentPxFormats = { gfx::PixelFormat::RGBA8Unorm }
+    });
+
+    std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = device->newCommandBufferPool();
+
+    std::vector<std::shared_ptr<gfx::Buffer>> vertexBuffers;
+    for (std::size_t i = 0; i < vertexBufferCount; i++) {
+        vertexBuffers.push_back(device->newBuffer(gfx::Buffer::Descriptor{
+            .size = sizeof(float) * 2 * 3,
+            .usages = gfx::BufferUsage::vertexBuffer,
+            .storageMode = gfx::ResourceStorageMode::hostVisible
+        }));
+        std::ranges::fill(std::span(vertexBuffers.back()->content<float>(), 6), 0.0f);
+    }
+    std::shared_ptr<gfx::Buffer> indexBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = sizeof(uint16_t) * 3,
+        .usages = gfx::BufferUsage::indexBuffer,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+    for (uint16_t i = 0; i < 3; i++)
+        indexBuffer->content<uint16_t>()[i] = i;
+
+    gfx::Framebuffer framebuffer = {
+        .colorAttachments = {
+            gfx::Framebuffer::Attachment{
+                .loadAction = gfx::LoadAction::load,
+                .texture = device->newTexture(gfx::Texture::Descriptor{
+                    .width = 16, .height = 16,
+                    .pixelFormat = gfx::PixelFormat::RGBA8Unorm,
+                    .usages = gfx::TextureUsage::colorAttachment,
+                    .storageMode = gfx::ResourceStorageMode::deviceLocal
+                })
+            }
+        }
+    };
+
+    std::chrono::nanoseconds recordDuration{0};
+    for (int frame = 0; frame < frameCount; frame++)
+    {
+        std::shared_ptr<gfx::CommandBuffer> commandBuffer = commandBufferPool->get();
+
+        const auto start = std::chrono::steady_clock::now();
+        commandBuffer->beginRenderPass(framebuffer);
+        commandBuffer->usePipeline(pipeline);
+        for (std::size_t i = 0; i < drawCount; i++) {
+            commandBuffer->useVertexBuffer(vertexBuffers[i % vertexBufferCount]);
+            commandBuffer->drawIndexedVertices(indexBuffer, gfx::IndexType::uint16, 3);
+        }
+        commandBuffer->endRenderPass();
+        if (frame > 0)
+            recordDuration += std::chrono::steady_clock::now() - start;
+
+        // every resource is first used by the pass, synchronized at submit time
+        EXPECT_EQ(commandBuffer->statistics(), gfx::CommandBuffer::Statistics{});
+
+        device->submitCommandBuffers(commandBuffer);
+        EXPECT_TRUE(device->waitCommandBuffer(*commandBuffer, std::chrono::seconds(10)));
+
+        commandBufferPool->reset();
+    }
+
+    struct MapSyncState
+    {
+        uint64_t stageMask = 0;
+        uint64_t accessMask = 0;
+    };
+    std::map<std::shared_ptr<gfx::Buffer>, MapSyncState> syncRequests;
+    std::map<std::shared_ptr<gfx::Buffer>, MapSyncState> finalSyncStates;
+    std::chrono::nanoseconds mapDuration{0};
+    for (int frame = 0; frame < frameCount; frame++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < drawCount; i++) {
+            // the vertex buffer and the index buffer of each draw
+            for (const std::shared_ptr<gfx::Buffer>& buffer : { vertexBuffers[i % vertexBufferCount], indexBuffer }) {
+                syncRequests.try_emplace(buffer, MapSyncState{ .stageMask = 1, .accessMask = 1 });
+                finalSyncStates[buffer] = MapSyncState{ .stageMask = 1, .accessMask = 1 };
+            }
+        }
+        syncRequests.clear();
+        finalSyncStates.clear();
+        if (frame > 0)
+            mapDuration += std::chrono::steady_clock::now() - start;
+    }
+
+    const auto timedDrawCount = static_cast<int64_t>(drawCount * (frameCount - 1));
+    RecordProperty("flat_tracking_record_ns_per_draw", recordDuration.count() / timedDrawCount);
+    RecordProperty("map_tracking_lookups_ns_per_draw", mapDuration.count() / timedDrawCount);
+}
+
+TEST_F(sync_tracking, vulkan_barriers_are_batched)
+{
+    std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = device->newCommandBufferPool();
+
+    gfx::Buffer::Descriptor bufferDescriptor = {
+        .size = 256,
+        .usages = gfx::BufferUsage::copySource | gfx::BufferUsage::copyDestination,
+        .storageMode = gfx::ResourceStorageMode::deviceLocal
+    };
+    std::shared_ptr<gfx::Buffer> bufferA = device->newBuffer(bufferDescriptor);
+    std::shared_ptr<gfx::Buffer> bufferB = device->newBuffer(bufferDescriptor);
+
+    std::shared_ptr<gfx::CommandBuffer> commandBuffer = commandBufferPool->get();
+    commandBuffer->beginBlitPass();
+    commandBuffer->copyBufferToBuffer(bufferA, bufferB, bufferDescriptor.size);
+    // read after write on B and write after read on A, both barriers are recorded in the same batch
+    commandBuffer->copyBufferToBuffer(bufferB, bufferA, bufferDescriptor.size);
+    commandBuffer->endBlitPass();
+
+    EXPECT_EQ(commandBuffer->statistics(), (gfx::CommandBuffer::Statistics{ .barrierCount = 2, .barrierBatchCount = 1 }));
+
+    device->submitCommandBuffers(commandBuffer);
+    device->waitCommandBuffer(*commandBuffer);
+
+    // first use of both buffers on the device, no submit time barrier is required
+    EXPECT_EQ(commandBuffer->statistics(), (gfx::CommandBuffer::Statistics{ .barrierCount = 2, .barrierBatchCount = 1 }));
+
+    commandBufferPool->reset();
+    EXPECT_EQ(commandBuffer->statistics(), gfx::CommandBuffer::Statistics{});
+}
+
+TEST_F(sync_tracking, vulkan_cube_faces_are_tracked_independently)
+{
+    std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = device->newCommandBufferPool();
+
+    constexpr uint32_t faceSize = 16;
+    constexpr std::size_t faceBytes = faceSize * faceSize * 4; // RGBA8Unorm
+
+    std::shared_ptr<gfx::Buffer> stagingBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = faceBytes * 6,
+        .usages = gfx::BufferUsage::copySource,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+    std::shared_ptr<gfx::Texture> cubeTexture = device->newTexture(gfx::Texture::Descriptor{
+        .type = gfx::TextureType::textureCube,
+        .width = faceSize, .height = faceSize,
+        .pixelFormat = gfx::PixelFormat::RGBA8Unorm,
+        .usages = gfx::TextureUsage::copyDestination | gfx::TextureUsage::shaderRead,
+        .storageMode = gfx::ResourceStorageMode::deviceLocal
+    });
+
+    std::shared_ptr<gfx::CommandBuffer> commandBuffer = commandBufferPool->get();
+    commandBuffer->beginBlitPass();
+    // each copy write a different layer of the cube and read a different range of the buffer
+    for (uint32_t face = 0; face < 6; face++)
+        commandBuffer->copyBufferToTexture(stagingBuffer, faceBytes * face, cubeTexture, face);
+    commandBuffer->endBlitPass();
+
+    EXPECT_EQ(commandBuffer->statistics(), gfx::CommandBuffer::Statistics{});
+
+    device->submitCommandBuffers(commandBuffer);
+    device->waitCommandBuffer(*commandBuffer);
+
+    commandBufferPool->reset();
+}
+// the uses of an inlined render pass are synchronized before the pass begin, with the barriers of its attachments
+TEST_F(sync_tracking, vulkan_render_pass_barriers_are_batched_before_the_pass)
+{
+    std::unique_ptr<gfx::CommandBufferPool> commandBufferPool = device->newCommandBufferPool();
+
+    std::shared_ptr<gfx::Buffer> srcBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = 256,
+        .usages = gfx::BufferUsage::copySource,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+    gfx::Buffer::Descriptor vertexBufferDescriptor = {
+        .size = 256,
+        .usages = gfx::BufferUsage::vertexBuffer | gfx::BufferUsage::copyDestination,
+        .storageMode = gfx::ResourceStorageMode::deviceLocal
+    };
+    std::shared_ptr<gfx::Buffer> vertexBufferA = device->newBuffer(vertexBufferDescriptor);
+    std::shared_ptr<gfx::Buffer> vertexBufferB = device->newBuffer(vertexBufferDescriptor);
+    std::shared_ptr<gfx::Texture> colorTexture = device->newTexture(gfx::Texture::Descriptor{
+        .width = 16, .height = 16,
+        .pixelFormat = gfx::PixelFormat::RGBA8Unorm,
+        .usages = gfx::TextureUsage::colorAttachment,
+        .storageMode = gfx::ResourceStorageMode::deviceLocal
+    });
+    gfx::Framebuffer framebuffer = {
+        .colorAttachments = {
+            gfx::Framebuffer::Attachment{
+                .loadAction = gfx::LoadAction::load,
+                .texture = colorTexture
+            }
+        }
+    };
+
+    std::shared_ptr<gfx::CommandBuffer> commandBuffer = commandBufferPool->get();
+    // first use of the attachment, synchronized at submit time
+    commandBuffer->beginRenderPass(framebuffer);
+    commandBuffer->endRenderPass();
+
+    commandBuffer->beginBlitPass();
+    commandBuffer->copyBufferToBuffer(srcBuffer, vertexBufferA, srcBuffer->size());
+    commandBuffer->copyBufferToBuffer(srcBuffer, vertexBufferB, srcBuffer->size());
+    commandBuffer->endBlitPass();
+
+    // the attachment is written again and both vertex buffers are read after the copies
+    commandBuffer->beginRenderPass(framebuffer);
+    commandBuffer->useVertexBuffer(vertexBufferA);
+    commandBuffer->useVertexBuffer(vertexBufferB, 0, 1);
+    commandBuffer->endRenderPass();
+
+    EXPECT_EQ(commandBuffer->statistics(), (gfx::CommandBuffer::Statistics{ .barrierCount = 3, .barrierBatchCount = 1 }));
+
+    device->submitCommandBuffers(commandBuffer);
+    device->waitCommandBuffer(*commandBuffer);
+
+    commandBufferPool->reset();
+}
+#endif
+
+}
@@ -0,0 +1,88 @@
+/*
+ * ---------------------------------------------------
+ * test_transfer_queue.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "vulkan_device_test.hpp"
+
+#include "Graphics/Buffer.hpp"
+#include "Graphics/CommandBuffer.hpp"
+#include "Graphics/CommandBufferPool.hpp"
+#include "Graphics/Device.hpp"
+#include "Graphics/Enums.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace gfx_test
+{
+
+#if defined(GFX_BUILD_VULKAN)
+class transfer_queue : public VulkanDeviceTest
+{
+protected:
+    transfer_queue() : VulkanDeviceTest(gfx::Device::Descriptor{ .queueCaps = { .graphics = true, .compute = false, .transfer = true, .present = {} }, .asyncTransfer = true }) {}
+};
+
+TEST_F(transfer_queue, vulkan_ownership_round_trip)
+{
+    std::unique_ptr<gfx::CommandBufferPool> transferCommandBufferPool = device->newCommandBufferPool(gfx::QueueType::transfer);
+    std::unique_ptr<gfx::CommandBufferPool> graphicsCommandBufferPool = device->newCommandBufferPool(gfx::QueueType::graphics);
+
+    constexpr std::size_t valueCount = 64;
+    std::shared_ptr<gfx::Buffer> srcBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = valueCount * sizeof(uint32_t),
+        .usages = gfx::BufferUsage::copySource,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+    std::shared_ptr<gfx::Buffer> firstBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = valueCount * sizeof(uint32_t),
+        .usages = gfx::BufferUsage::copySource | gfx::BufferUsage::copyDestination,
+        .storageMode = gfx::ResourceStorageMode::deviceLocal
+    });
+    std::shared_ptr<gfx::Buffer> secondBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = valueCount * sizeof(uint32_t),
+        .usages = gfx::BufferUsage::copySource | gfx::BufferUsage::copyDestination,
+        .storageMode = gfx::ResourceStorageMode::deviceLocal
+    });
+    std::shared_ptr<gfx::Buffer> dstBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = valueCount * sizeof(uint32_t),
+        .usages = gfx::BufferUsage::copyDestination,
+        .storageMode = gfx::ResourceStorageMode::hostVisible
+    });
+    for (uint32_t i = 0; i < valueCount; i++)
+        srcBuffer->content<uint32_t>()[i] = i * 5 + 2;
+
+    // transfer -> graphics -> transfer, each queue acquire the buffers the other one released
+    std::shared_ptr<gfx::CommandBuffer> uploadCommandBuffer = transferCommandBufferPool->get();
+    uploadCommandBuffer->beginBlitPass();
+    uploadCommandBuffer->copyBufferToBuffer(srcBuffer, firstBuffer, srcBuffer->size());
+    uploadCommandBuffer->endBlitPass();
+
+    std::shared_ptr<gfx::CommandBuffer> graphicsCommandBuffer = graphicsCommandBufferPool->get();
+    graphicsCommandBuffer->beginBlitPass();
+    graphicsCommandBuffer->copyBufferToBuffer(firstBuffer, secondBuffer, firstBuffer->size());
+    graphicsCommandBuffer->endBlitPass();
+
+    std::shared_ptr<gfx::CommandBuffer> readbackCommandBuffer = transferCommandBufferPool->get();
+    readbackCommandBuffer->beginBlitPass();
+    readbackCommandBuffer->copyBufferToBuffer(secondBuffer, dstBuffer, secondBuffer->size());
+    readbackCommandBuffer->endBlitPass();
+
+    device->submitCommandBuffers({ uploadCommandBuffer, graphicsCommandBuffer, readbackCommandBuffer });
+    device->waitCommandBuffer(*readbackCommandBuffer);
+
+    for (uint32_t i = 0; i < valueCount; i++)
+        EXPECT_EQ(dstBuffer->content<uint32_t>()[i], i * 5 + 2);
+
+    device->waitIdle();
+}
+#endif
+
+}
@@ -0,0 +1,90 @@
+/*
+ * ---------------------------------------------------
+ * test_upload_ring.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "vulkan_device_test.hpp"
+
+#include "Graphics/Buffer.hpp"
+#include "Graphics/CommandBuffer.hpp"
+#include "Graphics/CommandBufferPool.hpp"
+#include "Graphics/Device.hpp"
+#include "Graphics/Enums.hpp"
+#include "Graphics/UploadRing.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace gfx_test
+{
+
+#if defined(GFX_BUILD_VULKAN)
+using upload_ring = VulkanDeviceTest;
+
+TEST_F(upload_ring, vulkan_steady_state)
+{
+    constexpr int framesInFlight = 3;
+    constexpr int frameCount = 64;
+    constexpr size_t blockSize = 4096;
+    constexpr size_t sliceSize = 1000;
+
+    std::unique_ptr<gfx::UploadRing> uploadRing = device->newUploadRing(gfx::UploadRing::Descriptor{
+        .blockSize = blockSize,
+        .usages = gfx::BufferUsage::copySource
+    });
+    std::shared_ptr<gfx::Buffer> dstBuffer = device->newBuffer(gfx::Buffer::Descriptor{
+        .size = sliceSize * 4,
+        .usages = gfx::BufferUsage::copyDestination,
+        .storageMode = gfx::ResourceStorageMode::deviceLocal
+    });
+
+    struct Frame
+    {
+        std::unique_ptr<gfx::CommandBufferPool> commandBufferPool;
+        gfx::CommandBuffer* lastCommandBuffer = nullptr;
+    };
+    std::array<Frame, framesInFlight> frames;
+    for (auto& frame : frames)
+        frame.commandBufferPool = device->newCommandBufferPool();
+
+    uint32_t blockCountAfterWarmup = 0;
+    for (int i = 0; i < frameCount; i++)
+    {
+        Frame& frame = frames.at(i % framesInFlight);
+        if (frame.lastCommandBuffer != nullptr) {
+            device->waitCommandBuffer(*frame.lastCommandBuffer);
+            frame.commandBufferPool->reset();
+        }
+
+        std::shared_ptr<gfx::CommandBuffer> commandBuffer = frame.commandBufferPool->get();
+        commandBuffer->beginBlitPass();
+        for (size_t j = 0; j < 4; j++) {
+            gfx::BufferSlice slice = uploadRing->allocate(sliceSize);
+            ASSERT_EQ(slice.offset % gfx::UploadRing::defaultAlignment, 0u);
+            ASSERT_LE(slice.offset + slice.size, slice.buffer->size());
+            slice.content<std::byte>()[0] = static_cast<std::byte>(j);
+            commandBuffer->copyBufferToBuffer(slice, dstBuffer, j * sliceSize);
+        }
+        commandBuffer->endBlitPass();
+        device->submitCommandBuffers(commandBuffer);
+        frame.lastCommandBuffer = commandBuffer.get();
+
+        if (i == framesInFlight * 2)
+            blockCountAfterWarmup = uploadRing->blockCount();
+    }
+    device->waitIdle();
+
+    // once every frame in flight has its blocks, the ring only recycle
+    EXPECT_GT(blockCountAfterWarmup, 0u);
+    EXPECT_EQ(uploadRing->blockCount(), blockCountAfterWarmup);
+}
+#endif
+
+}
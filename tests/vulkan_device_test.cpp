@@ -0,0 +1,36 @@
+/*
+ * ---------------------------------------------------
+ * vulkan_device_test.cpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#include "vulkan_device_test.hpp"
+
+#if defined(GFX_BUILD_VULKAN)
+
+#include <exception>
+
+namespace gfx_test
+{
+
+gfx::Device::Descriptor VulkanDeviceTest::defaultDeviceDescriptor()
+{
+    return gfx::Device::Descriptor{ .queueCaps = { .graphics = true, .compute = false, .transfer = false, .present = {} } };
+}
+
+void VulkanDeviceTest::SetUp()
+{
+    try {
+        instance = gfx::Instance::newVulkanInstance(gfx::Instance::Descriptor{});
+        device = instance->newDevice(deviceDescriptor);
+    }
+    catch (const std::exception& e) {
+        GTEST_SKIP() << "no usable vulkan device: " << e.what();
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,47 @@
+/*
+ * ---------------------------------------------------
+ * vulkan_device_test.hpp
+ *
+ * Author: Thomas Choquet <semoir.dense-0h@icloud.com>
+ * ---------------------------------------------------
+ */
+
+#ifndef VULKAN_DEVICE_TEST_HPP
+#define VULKAN_DEVICE_TEST_HPP
+
+#if defined(GFX_BUILD_VULKAN)
+
+#include "Graphics/Device.hpp"
+#include "Graphics/Instance.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+namespace gfx_test
+{
+
+// create a vulkan device before each test and skip the test if there is no usable one.
+// the test files alias it with the name of their suite (using upload_ring = VulkanDeviceTest;),
+// a suite needing an other device derive it and pass its descriptor
+class VulkanDeviceTest : public testing::Test
+{
+protected:
+    // graphics queue only
+    static gfx::Device::Descriptor defaultDeviceDescriptor();
+
+    VulkanDeviceTest() : VulkanDeviceTest(defaultDeviceDescriptor()) {}
+    explicit VulkanDeviceTest(const gfx::Device::Descriptor& descriptor) : deviceDescriptor(descriptor) {}
+
+    void SetUp() override;
+
+    const gfx::Device::Descriptor deviceDescriptor;
+    std::unique_ptr<gfx::Instance> instance;
+    std::unique_ptr<gfx::Device> device; // destroyed before the instance
+};
+
+} // namespace gfx_test
+
+#endif // GFX_BUILD_VULKAN
+
+#endif // VULKAN_DEVICE_TEST_HPP